@@ -20,6 +20,9 @@ private:
     Bytes script_;          // Contract script
     Bytes checksum_;        // Checksum
     
+    /// Calculate the checksum of the fields before it
+    Bytes calculateChecksum() const;
+    
 public:
     /// Constructor
     NefFile();
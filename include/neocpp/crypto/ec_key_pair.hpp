@@ -14,10 +14,21 @@ class ECPrivateKey;
 class ECPublicKey;
 class ECDSASignature;
 
-/// Represents an EC private key
+/// Represents an EC private key.
+///
+/// The OpenSSL key and the derived public key are created on first use and kept
+/// (immutable, shared by copies), so signing with a hot key does no per-call setup.
+/// A key may be used from several threads at once.
 class ECPrivateKey {
 private:
+    /// Native key state
+    struct Native;
+    
     std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE> key_;
+    mutable SharedPtr<const Native> native_;
+    
+    /// Get the native key, creating it on first use
+    SharedPtr<const Native> getNative() const;
     
 public:
     /// Generate a random private key
@@ -25,16 +36,24 @@ public:
     
     /// Construct from bytes
     /// @param bytes The private key bytes (32 bytes)
+    /// @throws IllegalArgumentException if the key is not in [1, n-1]
     explicit ECPrivateKey(const Bytes& bytes);
     
     /// Construct from array
     /// @param key The private key array
+    /// @throws IllegalArgumentException if the key is not in [1, n-1]
     explicit ECPrivateKey(const std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE>& key);
     
     /// Construct from hex string
     /// @param hex The hex-encoded private key
     explicit ECPrivateKey(const std::string& hex);
     
+    /// Copy constructor; the copy shares the native key
+    ECPrivateKey(const ECPrivateKey& other);
+    
+    /// Copy assignment operator
+    ECPrivateKey& operator=(const ECPrivateKey& other);
+    
     /// Get the private key bytes
     /// @return The private key as bytes
     Bytes getBytes() const;
@@ -53,10 +72,20 @@ public:
     SharedPtr<ECDSASignature> sign(const Bytes& message) const;
 };
 
-/// Represents an EC public key
+/// Represents an EC public key.
+///
+/// The OpenSSL key used by verify() is created on first use and kept (immutable,
+/// shared by copies). A key may be used from several threads at once.
 class ECPublicKey {
 private:
+    /// Native key state
+    struct Native;
+    
     ECPoint point_;
+    mutable SharedPtr<const Native> native_;
+    
+    /// Get the native key, creating it on first use
+    SharedPtr<const Native> getNative() const;
     
 public:
     /// Construct from ECPoint
@@ -71,6 +100,12 @@ public:
     /// @param hex The hex-encoded public key
     explicit ECPublicKey(const std::string& hex);
     
+    /// Copy constructor; the copy shares the native key
+    ECPublicKey(const ECPublicKey& other);
+    
+    /// Copy assignment operator
+    ECPublicKey& operator=(const ECPublicKey& other);
+    
     /// Get the EC point
     /// @return The EC point
     const ECPoint& getPoint() const { return point_; }
@@ -1,11 +1,28 @@
 #pragma once
 
 #include <string>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
 #include "neocpp/types/types.hpp"
+#include "neocpp/neo_constants.hpp"
 
 namespace neocpp {
 
-/// Hash utilities for cryptographic operations
+/// Implementations of HashUtils::sha256Batch
+enum class Sha256BatchKernel {
+    Auto,       ///< The fastest one the CPU supports
+    Portable,   ///< One message at a time through OpenSSL
+    Avx2,       ///< Eight messages at a time, one per AVX2 lane
+    ShaNi       ///< Two interleaved messages at a time with the x86 SHA extensions
+};
+
+/// Hash utilities for cryptographic operations.
+///
+/// Every digest has an overload taking a pointer and a length and writing into a
+/// fixed-size array, which hashes in place without allocating; the Bytes overloads
+/// return the same digests.
 class HashUtils {
 public:
     /// Compute SHA256 hash
@@ -33,6 +50,61 @@ public:
     /// @return The Keccak256 hash (32 bytes)
     static Bytes keccak256(const Bytes& data);
     
+    /// Compute SHA256 hash without allocating
+    /// @param data The data to hash
+    /// @param length The number of bytes to hash
+    /// @param hash Receives the SHA256 hash
+    static void sha256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash);
+    
+    /// Compute double SHA256 hash without allocating
+    /// @param data The data to hash
+    /// @param length The number of bytes to hash
+    /// @param hash Receives the double SHA256 hash
+    static void doubleSha256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash);
+    
+    /// Compute RIPEMD160 hash without allocating
+    /// @param data The data to hash
+    /// @param length The number of bytes to hash
+    /// @param hash Receives the RIPEMD160 hash
+    static void ripemd160(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH160_SIZE>& hash);
+    
+    /// Compute SHA256 then RIPEMD160 hash without allocating
+    /// @param data The data to hash
+    /// @param length The number of bytes to hash
+    /// @param hash Receives the hash
+    static void sha256ThenRipemd160(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH160_SIZE>& hash);
+    
+    /// Compute Keccak256 hash without allocating
+    /// @param data The data to hash
+    /// @param length The number of bytes to hash
+    /// @param hash Receives the Keccak256 hash
+    static void keccak256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash);
+    
+    /// Compute the SHA256 hashes of many independent messages at once. Small messages,
+    /// such as transactions, verification scripts and checksummed payloads, are hashed
+    /// without the per-call overhead of sha256(). The kernel is chosen at runtime from
+    /// the CPU's features; without SHA extensions, AVX2 is used only when every message
+    /// fits one padded block (55 bytes), and OpenSSL otherwise.
+    /// @param messages The messages
+    /// @param lengths The length of each message in bytes
+    /// @param count The number of messages
+    /// @param hashes Receives the hash of each message
+    /// @param kernel The implementation to use; Auto unless testing or benchmarking
+    /// @throws IllegalArgumentException if the CPU does not support the requested kernel
+    static void sha256Batch(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                            std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes,
+                            Sha256BatchKernel kernel = Sha256BatchKernel::Auto);
+    
+    /// Compute the SHA256 hashes of many independent messages at once
+    /// @param messages The messages
+    /// @return The hash of each message
+    static std::vector<std::array<uint8_t, NeoConstants::HASH256_SIZE>> sha256Batch(const std::vector<Bytes>& messages);
+    
+    /// Check whether sha256Batch() can use a kernel on this CPU
+    /// @param kernel The kernel
+    /// @return True if it is supported; Auto and Portable always are
+    static bool isSha256BatchKernelSupported(Sha256BatchKernel kernel);
+    
     /// Compute HMAC-SHA256
     /// @param key The HMAC key
     /// @param data The data to authenticate
@@ -40,4 +112,55 @@ public:
     static Bytes hmacSha256(const Bytes& key, const Bytes& data);
 };
 
+/// Incremental SHA256 over data that arrives in parts, such as the output of a
+/// BinaryWriter, so that it does not have to be joined into one buffer first.
+///
+/// A hasher starts ready for data; finalize() returns the hash and starts over.
+/// A hasher is not thread-safe, but separate hashers can be used concurrently.
+class Sha256Hasher {
+public:
+    /// Constructor
+    /// @throws CryptoException if the digest cannot be initialized
+    Sha256Hasher();
+    
+    /// Destructor
+    ~Sha256Hasher();
+    
+    Sha256Hasher(Sha256Hasher&& other) noexcept;
+    Sha256Hasher& operator=(Sha256Hasher&& other) noexcept;
+    Sha256Hasher(const Sha256Hasher&) = delete;
+    Sha256Hasher& operator=(const Sha256Hasher&) = delete;
+    
+    /// Add data to the hash
+    /// @param data The data
+    /// @param length The number of bytes
+    /// @throws CryptoException on failure
+    void update(const uint8_t* data, size_t length);
+    
+    /// Add data to the hash
+    /// @param data The data
+    /// @throws CryptoException on failure
+    void update(const Bytes& data);
+    
+    /// Finish the hash of all data added since construction or the last finalize()
+    /// @param hash Receives the SHA256 hash
+    /// @throws CryptoException on failure
+    void finalize(std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash);
+    
+    /// Finish the hash of all data added since construction or the last finalize()
+    /// @return The SHA256 hash (32 bytes)
+    /// @throws CryptoException on failure
+    Bytes finalize();
+    
+    /// Discard the data added so far
+    /// @throws CryptoException on failure
+    void reset();
+    
+private:
+    /// Native digest state
+    struct Context;
+    
+    std::unique_ptr<Context> context_;
+};
+
 } // namespace neocpp
\ No newline at end of file
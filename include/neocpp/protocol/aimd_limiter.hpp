@@ -0,0 +1,114 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+
+namespace neocpp {
+
+/// Configuration for the adaptive concurrency limiter
+struct AimdLimiterConfig {
+    /// Default number of requests allowed in flight at first
+    static constexpr size_t DEFAULT_INITIAL_LIMIT = 20;
+
+    /// Default lower bound of the limit
+    static constexpr size_t DEFAULT_MIN_LIMIT = 1;
+
+    /// Default upper bound of the limit
+    static constexpr size_t DEFAULT_MAX_LIMIT = 200;
+
+    /// Default factor applied to the limit on overload
+    static constexpr double DEFAULT_BACKOFF_RATIO = 0.9;
+
+    /// Default multiple of the fastest observed latency that counts as overload
+    static constexpr double DEFAULT_LATENCY_TOLERANCE = 2.0;
+
+    /// Default length of the window over which the fastest latency is taken, in milliseconds
+    static constexpr int64_t DEFAULT_MIN_LATENCY_WINDOW_MS = 30000;
+
+    /// Number of requests allowed in flight at first
+    size_t initialLimit = DEFAULT_INITIAL_LIMIT;
+
+    /// The limit never drops below this
+    size_t minLimit = DEFAULT_MIN_LIMIT;
+
+    /// The limit never grows beyond this
+    size_t maxLimit = DEFAULT_MAX_LIMIT;
+
+    /// Factor applied to the limit when a request was dropped or too slow
+    double backoffRatio = DEFAULT_BACKOFF_RATIO;
+
+    /// Latencies above this multiple of the fastest recently observed one count as overload
+    double latencyTolerance = DEFAULT_LATENCY_TOLERANCE;
+
+    /// The fastest latency is taken over the current and the previous window of this
+    /// length, so that a single fast sample does not keep counting every later request
+    /// as overload once the node or the network got slower
+    std::chrono::milliseconds minLatencyWindow = std::chrono::milliseconds(DEFAULT_MIN_LATENCY_WINDOW_MS);
+
+    /// Fixed latency above which a request counts as overload (zero derives it from latencyTolerance)
+    std::chrono::milliseconds latencyTarget = std::chrono::milliseconds(0);
+};
+
+/// Limits the number of requests in flight, adapting the limit with additive
+/// increase / multiplicative decrease. Each request that completes quickly while
+/// the limit is in use grows the limit by 1/limit (about one per round trip); a
+/// request that was dropped or exceeded the latency target shrinks it by
+/// backoffRatio, at most once per fastest recent round trip. Requests over the limit wait in a
+/// FIFO queue instead of piling onto a slow node.
+class AimdLimiter {
+public:
+    using Task = std::function<void()>;
+
+    /// Constructor
+    /// @param config The limiter configuration
+    explicit AimdLimiter(const AimdLimiterConfig& config = AimdLimiterConfig());
+
+    /// Run a task once a slot is free: immediately if the limit allows, otherwise when an
+    /// earlier request releases its slot. The task must eventually lead to one release().
+    /// @param start Starts the request
+    void acquire(Task start);
+
+    /// Release a slot and adapt the limit
+    /// @param latency How long the request took
+    /// @param dropped Whether the request failed because of overload (timeout, 429, 503, ...)
+    void release(std::chrono::steady_clock::duration latency, bool dropped);
+
+    /// Release a slot without adapting the limit, for a request that was never sent
+    /// (for example one rejected by an open circuit breaker)
+    void release();
+
+    /// Get the current limit
+    size_t getLimit() const;
+
+    /// Get the number of requests in flight
+    size_t getInFlight() const;
+
+    /// Get the number of requests waiting for a slot
+    size_t getQueued() const;
+
+    /// Get the configuration
+    const AimdLimiterConfig& getConfig() const { return config_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    AimdLimiterConfig config_;
+    mutable std::mutex mutex_;
+    double limit_;
+    size_t inFlight_;
+    std::deque<Task> queue_;
+    Clock::duration minLatency_;
+    Clock::duration previousMinLatency_;
+    Clock::time_point windowStart_;
+    Clock::time_point lastDecrease_;
+
+    /// Start queued tasks while the limit allows. A task that completes synchronously
+    /// releases again from inside this loop; that nested call leaves the starting to
+    /// this one, so the stack does not grow with the queue.
+    void startQueued();
+};
+
+} // namespace neocpp
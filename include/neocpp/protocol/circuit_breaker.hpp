@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace neocpp {
+
+/// Configuration for a circuit breaker
+struct CircuitBreakerConfig {
+    /// Default number of consecutive failures that open the circuit
+    static constexpr uint32_t DEFAULT_FAILURE_THRESHOLD = 5;
+
+    /// Default time the circuit stays open in milliseconds
+    static constexpr int64_t DEFAULT_OPEN_DURATION_MS = 5000;
+
+    /// Consecutive failures that open the circuit
+    uint32_t failureThreshold = DEFAULT_FAILURE_THRESHOLD;
+
+    /// Time requests are rejected before a single trial request is let through
+    std::chrono::milliseconds openDuration = std::chrono::milliseconds(DEFAULT_OPEN_DURATION_MS);
+};
+
+/// Stops sending requests to an endpoint that keeps failing.
+///
+/// Closed: requests pass and consecutive failures are counted. Open: requests are
+/// rejected without being sent until openDuration has passed. Half-open: one trial
+/// request passes; its success closes the circuit, its failure opens it again.
+class CircuitBreaker {
+public:
+    enum class State {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    /// Constructor
+    /// @param config The breaker configuration
+    explicit CircuitBreaker(const CircuitBreakerConfig& config = CircuitBreakerConfig());
+
+    /// Check whether a request may be sent now. In the half-open state only the
+    /// first caller is allowed; it must report its outcome.
+    /// @return True if the request may be sent
+    bool allowRequest();
+
+    /// Report a request that reached the endpoint and was served
+    void recordSuccess();
+
+    /// Report a request the endpoint failed to serve
+    void recordFailure();
+
+    /// Report a request that was abandoned before its outcome was known
+    void recordAbandoned();
+
+    /// Get the current state
+    State getState() const;
+
+    /// Get the number of requests rejected while the circuit was open
+    uint64_t getRejectedCount() const { return rejected_; }
+
+    /// Get the configuration
+    const CircuitBreakerConfig& getConfig() const { return config_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    CircuitBreakerConfig config_;
+    mutable std::mutex mutex_;
+    State state_;
+    uint32_t failures_;
+    bool trialInFlight_;
+    Clock::time_point openedAt_;
+    std::atomic<uint64_t> rejected_;
+};
+
+} // namespace neocpp
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "neocpp/utils/histogram.hpp"
+
+namespace neocpp {
+
+/// Configuration of an AdaptivePollSchedule
+struct AdaptivePollingConfig {
+    /// Default shortest delay between polls in milliseconds
+    static constexpr int64_t DEFAULT_MIN_INTERVAL_MS = 100;
+
+    /// Default weight of a new observation in the learned block interval and deviation
+    static constexpr double DEFAULT_SMOOTHING = 0.2;
+
+    /// Block interval assumed until intervals have been observed
+    std::chrono::milliseconds expectedBlockInterval = std::chrono::milliseconds(15000);
+
+    /// Shortest delay between polls, used while a block is due
+    std::chrono::milliseconds minInterval = std::chrono::milliseconds(DEFAULT_MIN_INTERVAL_MS);
+
+    /// Longest delay between polls
+    std::chrono::milliseconds maxInterval = std::chrono::milliseconds(15000);
+
+    /// Weight of a new observation in the learned block interval and deviation, in (0, 1]
+    double smoothing = DEFAULT_SMOOTHING;
+};
+
+/// Decides when to poll for the next block, from the timestamps of the blocks seen.
+///
+/// The interval between blocks and its mean deviation are learned from block
+/// timestamps (exponentially weighted averages, seeded with the expected interval and a
+/// tenth of it). After a block, the schedule sleeps until the next one may come, i.e.
+/// until it is due minus twice the deviation, and then polls at the minimum interval.
+/// When the block is late, the delay grows with how late it is, so a stalled chain is
+/// not polled at the minimum interval.
+///
+/// Block timestamps are compared with the local clock, so both should be synchronized
+/// (NTP); the detection latency is the local time at detection minus the block
+/// timestamp. All methods are thread-safe.
+class AdaptivePollSchedule {
+public:
+    /// Constructor
+    /// @param config The configuration
+    /// @throws IllegalArgumentException if the intervals or the smoothing are out of range
+    explicit AdaptivePollSchedule(const AdaptivePollingConfig& config = AdaptivePollingConfig());
+
+    /// Record a new chain head
+    /// @param index The block index
+    /// @param blockTimeMs The block timestamp in milliseconds since the Unix epoch
+    /// @param detectedAtMs The local time the block was detected, in milliseconds since the Unix epoch
+    /// @param live Whether a poll saw the block appear; false for the first block seen and
+    ///             for blocks from catching up, which count neither for latency nor for the interval
+    void onBlock(uint32_t index, int64_t blockTimeMs, int64_t detectedAtMs, bool live);
+
+    /// Get the delay before the next poll
+    /// @param nowMs The local time in milliseconds since the Unix epoch
+    /// @return The delay
+    std::chrono::milliseconds nextDelay(int64_t nowMs) const;
+
+    /// Get the learned interval between blocks
+    std::chrono::milliseconds getBlockInterval() const { return std::chrono::milliseconds(blockIntervalMs_.load()); }
+    
+    /// Get the learned mean deviation of the interval between blocks
+    std::chrono::milliseconds getBlockIntervalDeviation() const { return std::chrono::milliseconds(deviationMs_.load()); }
+
+    /// Get the detection latencies of live blocks, in milliseconds
+    const Histogram& getDetectionLatency() const { return detectionLatency_; }
+
+    /// Get the detection latency of the last live block in milliseconds
+    uint64_t getLastDetectionLatency() const { return lastDetectionLatency_; }
+
+private:
+    AdaptivePollingConfig config_;
+    std::atomic<int64_t> blockIntervalMs_;
+    std::atomic<int64_t> deviationMs_;
+    std::atomic<int64_t> lastBlockTimeMs_;
+    std::atomic<int64_t> lastIndex_;
+    std::atomic<uint64_t> lastDetectionLatency_;
+    Histogram detectionLatency_;
+};
+
+} // namespace neocpp
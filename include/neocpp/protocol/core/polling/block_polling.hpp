@@ -6,29 +6,98 @@
 #include <atomic>
 #include <chrono>
 #include <vector>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <nlohmann/json.hpp>
 #include "neocpp/types/types.hpp"
+#include "neocpp/utils/event_dispatcher.hpp"
+#include "neocpp/protocol/core/polling/adaptive_poll_schedule.hpp"
 
 namespace neocpp {
 
 // Forward declaration
 class NeoRpcClient;
 
-/// Block polling service for monitoring new blocks
+/// Block polling service for monitoring new blocks.
+///
+/// The blocks form a gap-free stream: every height from the start height up to the
+/// chain head is reported exactly once, strictly in height order, even when several
+/// blocks arrive between two polls. Without a start height the stream begins at the
+/// head found by the first poll. When block subscribers are registered, missing
+/// blocks are fetched with getblock in JSON-RPC batches, several batches in flight
+/// at once, so a stream far behind the head catches up quickly.
+///
+/// Failed polls are reported to the error handler and retried with exponential
+/// backoff (starting at the poll interval), so an unreachable node is not hammered.
+/// The stream resumes at the first height not yet delivered.
+///
+/// By default the node is polled at a fixed interval. With setAdaptivePolling() the
+/// delay follows an AdaptivePollSchedule instead: sparse right after a block, tight
+/// when the next one is due. That detects blocks sooner with fewer polls.
+///
+/// Subscribers run on a thread pool through an EventDispatcher, each with its own
+/// bounded queue, so a slow subscriber does not stall polling or the others. Each
+/// subscriber sees its heights in order; with the default Block overflow policy it
+/// sees every height, and polling waits while its queue is full. Subscribing and
+/// unsubscribing are safe at any time.
 class BlockPolling {
+public:
+    /// Default upper bound of the delay between failed polls in milliseconds
+    static constexpr int64_t DEFAULT_MAX_BACKOFF_MS = 30000;
+    
+    /// Default number of blocks requested in one batch
+    static constexpr size_t DEFAULT_BATCH_SIZE = 50;
+    
+    /// Default number of batches in flight while catching up
+    static constexpr size_t DEFAULT_BATCHES_IN_FLIGHT = 4;
+    
+    /// Default number of threads running the subscribers
+    static constexpr size_t DEFAULT_DISPATCH_THREADS = 2;
+    
+    /// Receives a verbose block object
+    using BlockHandler = std::function<void(const nlohmann::json&)>;
+    
 private:
+    /// A new height, with its block when block subscribers are registered
+    struct BlockEvent {
+        uint32_t index = 0;
+        SharedPtr<const nlohmann::json> block;
+    };
+    
     SharedPtr<NeoRpcClient> rpcClient_;
-    std::vector<std::function<void(uint32_t)>> callbacks_;
+    SharedPtr<ThreadPool> dispatchPool_;
+    std::unique_ptr<EventDispatcher<BlockEvent>> dispatcher_;
+    std::atomic<size_t> blockSubscribers_;
+    std::mutex subscribersMutex_;
+    std::set<uint64_t> blockSubscriptions_;
     std::atomic<bool> running_;
     std::atomic<uint32_t> lastBlockIndex_;
+    std::atomic<int64_t> nextHeight_;
+    int64_t lastSeenHead_;
+    int64_t headBlockTime_;
+    std::atomic<uint64_t> pollCount_;
+    SharedPtr<AdaptivePollSchedule> schedule_;
+    size_t batchSize_;
+    size_t batchesInFlight_;
     std::unique_ptr<std::thread> pollingThread_;
     std::chrono::milliseconds pollInterval_;
+    std::chrono::milliseconds maxBackoff_;
+    std::function<void(const std::exception&)> errorHandler_;
+    std::atomic<uint32_t> consecutiveErrors_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
     
 public:
     /// Constructor
     /// @param rpcClient The RPC client
     /// @param pollInterval The polling interval in milliseconds
+    /// @param dispatchPool The pool running the subscribers (nullptr creates a pool of
+    ///                     DEFAULT_DISPATCH_THREADS threads for this poller)
     explicit BlockPolling(const SharedPtr<NeoRpcClient>& rpcClient, 
-                         std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000));
+                         std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000),
+                         const SharedPtr<ThreadPool>& dispatchPool = nullptr);
     
     /// Destructor
     ~BlockPolling();
@@ -44,27 +113,100 @@ public:
     bool isRunning() const { return running_; }
     
     /// Subscribe to block updates
-    /// @param callback The callback function
-    void subscribe(std::function<void(uint32_t)> callback);
+    /// @param callback Called with the index of every new block, in height order
+    /// @param options The subscriber's queue capacity and overflow policy
+    /// @return The subscription ID
+    uint64_t subscribe(std::function<void(uint32_t)> callback, const SubscriberOptions& options = SubscriberOptions());
+    
+    /// Subscribe to full blocks
+    /// @param handler Called with every new block (as returned by getblock with verbose
+    ///                output), in height order
+    /// @param options The subscriber's queue capacity and overflow policy
+    /// @return The subscription ID
+    uint64_t subscribeBlocks(BlockHandler handler, const SubscriberOptions& options = SubscriberOptions());
+    
+    /// Cancel a subscription. Its queued heights are discarded; a running callback is
+    /// waited for, unless called from that callback.
+    /// @param subscriptionId The ID returned by subscribe() or subscribeBlocks()
+    void unsubscribe(uint64_t subscriptionId);
     
     /// Clear all subscriptions
     void clearSubscriptions();
     
+    /// Get the queue depth, drop count and lag of a subscriber
+    /// @param subscriptionId The subscription ID
+    /// @return The metrics
+    /// @throws IllegalArgumentException if there is no such subscription
+    SubscriberStats getSubscriberStats(uint64_t subscriptionId) const { return dispatcher_->getStats(subscriptionId); }
+    
+    /// Wait until the subscribers handled every height reported so far
+    /// @param timeout The longest time to wait
+    /// @return False if heights were still queued after the timeout
+    bool waitIdle(std::chrono::milliseconds timeout) { return dispatcher_->waitIdle(timeout); }
+    
     /// Get last block index
-    /// @return The last block index
+    /// @return The index of the last block handed to the subscribers
     uint32_t getLastBlockIndex() const { return lastBlockIndex_; }
     
+    /// Set the checkpoint the stream starts from, e.g. the height after the last block
+    /// an indexer stored. Set it before start().
+    /// @param height The first block height to report
+    void setStartHeight(uint32_t height) { nextHeight_ = height; }
+    
+    /// Get the height of the next block to report
+    /// @return The height, or -1 before the first poll when no start height is set
+    int64_t getNextHeight() const { return nextHeight_; }
+    
+    /// Set how missing blocks are fetched while catching up. Set it before start().
+    /// @param batchSize The number of blocks requested in one batch
+    /// @param batchesInFlight The number of batches requested ahead of the delivered height
+    /// @throws IllegalArgumentException if either value is zero
+    void setCatchUpWindow(size_t batchSize, size_t batchesInFlight);
+    
     /// Set poll interval
     /// @param interval The interval in milliseconds
     void setPollInterval(std::chrono::milliseconds interval) { pollInterval_ = interval; }
     
+    /// Align polls with block production instead of polling at a fixed interval.
+    /// Call it before start().
+    /// @param config The expected block interval and the bounds of the poll delay
+    void setAdaptivePolling(const AdaptivePollingConfig& config);
+    
+    /// Get the adaptive schedule, for its learned block interval and detection latency
+    /// @return The schedule, or nullptr when polling at a fixed interval
+    SharedPtr<AdaptivePollSchedule> getAdaptiveSchedule() const { return schedule_; }
+    
+    /// Get the number of getblockcount polls so far
+    uint64_t getPollCount() const { return pollCount_; }
+    
+    /// Set the upper bound of the delay between failed polls
+    /// @param maxBackoff The maximum delay
+    void setMaxBackoff(std::chrono::milliseconds maxBackoff) { maxBackoff_ = maxBackoff; }
+    
+    /// Set the handler receiving the errors of failed polls. Set it before start().
+    /// @param handler The error handler
+    void setErrorHandler(std::function<void(const std::exception&)> handler) { errorHandler_ = std::move(handler); }
+    
+    /// Get the number of polls that failed in a row
+    /// @return The consecutive error count, reset by the next successful poll
+    uint32_t getConsecutiveErrors() const { return consecutiveErrors_; }
+    
 private:
     /// Polling loop
     void pollLoop();
     
+    /// Report every height from the next one up to the head
+    /// @param head The index of the newest block
+    void catchUp(uint32_t head);
+    
+    /// Report a failed poll to the error handler
+    /// @param error The error
+    void reportError(const std::exception& error);
+    
     /// Notify subscribers
     /// @param blockIndex The new block index
-    void notifySubscribers(uint32_t blockIndex);
+    /// @param block The block, when block subscribers are registered
+    void notifySubscribers(uint32_t blockIndex, SharedPtr<const nlohmann::json> block);
 };
 
 } // namespace neocpp
\ No newline at end of file
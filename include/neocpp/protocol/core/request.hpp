@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <nlohmann/json.hpp>
 #include "neocpp/types/types.hpp"
 
@@ -15,7 +16,7 @@ private:
     std::string method_;
     nlohmann::json params_;
     int id_;
-    static int nextId_;
+    static std::atomic<int> nextId_;
     
 public:
     /// Constructor
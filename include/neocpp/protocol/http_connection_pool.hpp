@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+/// Connection pool statistics
+struct HttpPoolStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t idleHandles = 0;
+
+    /// Get the ratio of acquisitions served from the pool
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+/// Pool of reusable keep-alive HTTP handles for a single endpoint.
+/// All handles of a pool share DNS cache, TLS sessions and live connections,
+/// so repeated requests to the same node skip the TCP and TLS handshakes.
+class HttpConnectionPool {
+public:
+    /// Default maximum number of idle handles kept
+    static constexpr size_t DEFAULT_MAX_SIZE = 16;
+
+    /// Default idle timeout in milliseconds
+    static constexpr int64_t DEFAULT_IDLE_TIMEOUT_MS = 60000;
+
+    /// Constructor
+    /// @param maxSize The maximum number of idle handles kept
+    /// @param idleTimeout Handles and connections idle for longer are closed
+    explicit HttpConnectionPool(size_t maxSize = DEFAULT_MAX_SIZE,
+                                std::chrono::milliseconds idleTimeout = std::chrono::milliseconds(DEFAULT_IDLE_TIMEOUT_MS));
+
+    /// Destructor
+    ~HttpConnectionPool();
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    /// Initialize libcurl once per process; everything that creates CURL handles calls
+    /// this first. The library is cleaned up at exit.
+    static void initializeCurl();
+
+    /// Get the shared pool for an endpoint, creating it on first use
+    /// @param url The endpoint URL (scheme, host and port select the pool)
+    /// @return The pool for the endpoint
+    static SharedPtr<HttpConnectionPool> forEndpoint(const std::string& url);
+
+    /// Acquire a handle, reusing an idle one if available
+    /// @return The handle (a CURL easy handle)
+    void* acquire();
+
+    /// Return a handle to the pool
+    /// @param handle The handle previously obtained from acquire()
+    void release(void* handle);
+
+    /// Close all idle handles
+    void clear();
+
+    /// Set the maximum number of idle handles kept
+    void setMaxSize(size_t maxSize);
+    size_t getMaxSize() const { return maxSize_; }
+
+    /// Set the idle timeout
+    void setIdleTimeout(std::chrono::milliseconds idleTimeout);
+    std::chrono::milliseconds getIdleTimeout() const;
+
+    /// Get pool statistics
+    HttpPoolStats getStats() const;
+
+    /// Reset hit/miss/eviction counters
+    void resetStats();
+
+private:
+    struct IdleHandle {
+        void* handle;
+        std::chrono::steady_clock::time_point releasedAt;
+    };
+
+    struct Share;
+
+    mutable std::mutex mutex_;
+    std::vector<IdleHandle> idle_;
+    std::atomic<size_t> maxSize_;
+    std::atomic<int64_t> idleTimeoutMs_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> evictions_;
+    std::unique_ptr<Share> share_;
+
+    /// Close idle handles past the idle timeout (mutex must be held)
+    void evictExpiredLocked(std::chrono::steady_clock::time_point now);
+
+    /// Apply pool-wide options to a fresh or reset handle
+    void prepareHandle(void* handle) const;
+
+    /// Destroy a handle
+    static void destroyHandle(void* handle);
+};
+
+} // namespace neocpp
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+/// Background event loop that drives many HTTP transfers concurrently on a single thread.
+/// Transfers are configured CURL easy handles; completion handlers run on the loop thread
+/// and should return quickly.
+class HttpEventLoop {
+public:
+    /// Completion handler, receives the CURLcode of the finished transfer
+    using CompletionHandler = std::function<void(int resultCode)>;
+
+    /// Constructor, starts the loop thread
+    HttpEventLoop();
+
+    /// Destructor, aborts outstanding transfers and joins the loop thread
+    ~HttpEventLoop();
+
+    HttpEventLoop(const HttpEventLoop&) = delete;
+    HttpEventLoop& operator=(const HttpEventLoop&) = delete;
+
+    /// Get the process-wide default event loop
+    /// @return The shared event loop
+    static SharedPtr<HttpEventLoop> getDefault();
+
+    /// Submit a configured transfer
+    /// @param handle The CURL easy handle to perform
+    /// @param onComplete Called on the loop thread once the transfer finished or failed
+    /// @return The transfer ID
+    uint64_t submit(void* handle, CompletionHandler onComplete);
+
+    /// Cancel a transfer; its handler is invoked with an aborted result code.
+    /// Has no effect if the transfer already completed.
+    /// @param transferId The ID returned by submit()
+    void cancel(uint64_t transferId);
+
+    /// Get the number of transfers submitted but not yet completed
+    size_t getInFlight() const { return inFlight_; }
+
+    /// Check whether the caller runs on the thread of any event loop, i.e. inside a
+    /// completion handler, where blocking on another transfer would stall the loop
+    static bool isLoopThread();
+
+private:
+    struct Pending {
+        uint64_t id;
+        void* handle;
+        CompletionHandler onComplete;
+    };
+
+    struct Multi;
+
+    std::unique_ptr<Multi> multi_;
+    std::mutex mutex_;
+    std::vector<Pending> submitted_;
+    std::vector<uint64_t> cancelled_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> inFlight_;
+    std::atomic<uint64_t> nextTransferId_;
+    std::thread thread_;
+
+    /// Loop thread body
+    void run();
+
+    /// Wake the loop thread from its poll
+    void wakeup();
+};
+
+} // namespace neocpp
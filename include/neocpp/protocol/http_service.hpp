@@ -4,48 +4,173 @@
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <future>
+#include <mutex>
+#include <atomic>
 #include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+#include "neocpp/protocol/http_connection_pool.hpp"
+#include "neocpp/protocol/http_event_loop.hpp"
+#include "neocpp/protocol/circuit_breaker.hpp"
+#include "neocpp/protocol/rpc_transport.hpp"
 
 namespace neocpp {
 
-/// HTTP response structure
-struct HttpResponse {
-    int statusCode;
-    std::string body;
-    std::unordered_map<std::string, std::string> headers;
-    std::string error;
-    
-    bool isSuccess() const { return statusCode >= 200 && statusCode < 300; }
+/// Byte counters of an HTTP service, before and after content encoding
+struct HttpTransferStats {
+    /// Request body bytes before compression
+    uint64_t requestBytes = 0;
+    
+    /// Request body bytes sent on the wire
+    uint64_t requestWireBytes = 0;
+    
+    /// Response body bytes after decompression
+    uint64_t responseBytes = 0;
+    
+    /// Response body bytes received on the wire
+    uint64_t responseWireBytes = 0;
+    
+    /// Get the fraction of body bytes saved by compression in both directions
+    double getSavings() const {
+        uint64_t plain = requestBytes + responseBytes;
+        uint64_t wire = requestWireBytes + responseWireBytes;
+        return plain == 0 || wire >= plain ? 0.0 : 1.0 - static_cast<double>(wire) / static_cast<double>(plain);
+    }
+    
+    HttpTransferStats& operator+=(const HttpTransferStats& other) {
+        requestBytes += other.requestBytes;
+        requestWireBytes += other.requestWireBytes;
+        responseBytes += other.responseBytes;
+        responseWireBytes += other.responseWireBytes;
+        return *this;
+    }
 };
 
-/// HTTP service for making requests
-class HttpService {
-private:
-    std::string baseUrl_;
-    
+/// HTTP service for making requests; the network RpcTransport.
+/// All methods may be called concurrently; each request borrows its own handle from the pool.
+///
+/// Responses are requested with every content encoding libcurl supports (gzip, deflate
+/// and, depending on the build, br and zstd) and decompressed transparently. Request
+/// bodies are only compressed when enabled with setRequestCompressionThreshold(), since
+/// not every node accepts a gzip Content-Encoding.
+///
+/// A node on the same host can be reached over a Unix domain socket with a
+/// "unix://" URL such as "unix:///run/neo/rpc.sock", which skips the TCP/IP
+/// stack on every request.
+class HttpService : public RpcTransport {
 public:
     using Headers = std::unordered_map<std::string, std::string>;
     using ResponseCallback = std::function<void(const HttpResponse&)>;
     
+    /// Default request timeout in seconds
+    static constexpr int DEFAULT_TIMEOUT_SECONDS = 30;
+    
+    /// URL scheme selecting a Unix domain socket; the rest of the URL is the socket path
+    static constexpr const char* UNIX_SCHEME = "unix://";
+    
+private:
+    std::string baseUrl_;
+    std::string requestUrl_;
+    std::string unixSocketPath_;
+    SharedPtr<HttpConnectionPool> pool_;
+    SharedPtr<HttpEventLoop> eventLoop_;
+    std::atomic<int> timeoutSeconds_;
+    mutable std::mutex mutex_;
+    Headers defaultHeaders_;
+    SharedPtr<CircuitBreaker> circuitBreaker_;
+    std::atomic<bool> acceptEncoding_;
+    std::atomic<size_t> compressionThreshold_;
+    
+    /// Shared with transfers in flight, which may outlive the service
+    struct Counters {
+        std::atomic<uint64_t> requestBytes{0};
+        std::atomic<uint64_t> requestWireBytes{0};
+        std::atomic<uint64_t> responseBytes{0};
+        std::atomic<uint64_t> responseWireBytes{0};
+    };
+    SharedPtr<Counters> counters_;
+    
+public:    
     /// Constructor
+    /// @param baseUrl The node URL: http(s)://host[:port][/path] or unix://<socket path>
     explicit HttpService(const std::string& baseUrl);
     
     /// Destructor
-    ~HttpService();
+    ~HttpService() override;
     
     /// Get the base URL
-    const std::string& getUrl() const { return baseUrl_; }
+    const std::string& getUrl() const override { return baseUrl_; }
+    
+    /// Get the Unix domain socket requests are sent over
+    /// @return The socket path, or an empty string for a TCP endpoint
+    const std::string& getUnixSocketPath() const { return unixSocketPath_; }
+    
+    /// Get the connection pool used for requests
+    /// @return The connection pool (shared by all services on the same endpoint)
+    SharedPtr<HttpConnectionPool> getConnectionPool() const;
+    
+    /// Set the connection pool used for requests
+    /// @param pool The connection pool
+    void setConnectionPool(const SharedPtr<HttpConnectionPool>& pool);
+    
+    /// Get connection pool statistics
+    /// @return The pool hit/miss counts
+    HttpPoolStats getPoolStats() const { return getConnectionPool()->getStats(); }
+    
+    /// Get the event loop driving asynchronous requests
+    /// @return The event loop (the process-wide default unless replaced)
+    SharedPtr<HttpEventLoop> getEventLoop() const;
+    
+    /// Set the event loop driving asynchronous requests
+    /// @param eventLoop The event loop
+    void setEventLoop(const SharedPtr<HttpEventLoop>& eventLoop);
     
     /// Set timeout for requests
     /// @param seconds Timeout in seconds
     void setTimeout(int seconds);
     
+    /// Get timeout for requests
+    /// @return Timeout in seconds
+    int getTimeout() const { return timeoutSeconds_; }
+    
+    /// Check whether compressed responses are requested
+    bool isAcceptingEncoding() const { return acceptEncoding_; }
+    
+    /// Request compressed responses (enabled by default)
+    /// @param enabled Whether to send Accept-Encoding
+    void setAcceptEncoding(bool enabled) { acceptEncoding_ = enabled; }
+    
+    /// Get the body size from which requests are gzip-compressed
+    /// @return The threshold in bytes, or 0 when request compression is disabled
+    size_t getRequestCompressionThreshold() const { return compressionThreshold_; }
+    
+    /// Compress request bodies of at least the given size with gzip. Requires zlib and
+    /// a node that accepts Content-Encoding: gzip.
+    /// @param bytes The threshold in bytes, or 0 to disable request compression
+    void setRequestCompressionThreshold(size_t bytes);
+    
+    /// Get the byte counters of all requests sent through this service
+    HttpTransferStats getTransferStats() const;
+    
+    /// Get the circuit breaker guarding this endpoint
+    /// @return The breaker, or nullptr if none is installed
+    SharedPtr<CircuitBreaker> getCircuitBreaker() const;
+    
+    /// Guard this endpoint with a circuit breaker. While it is open, requests fail
+    /// immediately with a status 0 response instead of being sent.
+    /// @param breaker The breaker, or nullptr to remove it
+    void setCircuitBreaker(const SharedPtr<CircuitBreaker>& breaker);
+    
     /// Set default headers
     /// @param headers The headers to set
     void setDefaultHeaders(const Headers& headers);
     
+    /// Get default headers
+    /// @return The headers sent with every request
+    Headers getDefaultHeaders() const;
+    
     /// Perform GET request
-    /// @param url The URL
+    /// @param url The URL (absolute, or relative to the base URL)
     /// @param headers Optional additional headers
     /// @return The response
     HttpResponse get(const std::string& url, const Headers& headers = {});
@@ -63,6 +188,11 @@ public:
     /// @return The JSON response
     nlohmann::json post(const nlohmann::json& data, const std::string& endpoint = "");
     
+    /// Perform a JSON POST to the base URL, parsing the reply while it is received
+    /// @param body The JSON request body
+    /// @return The response, with the parsed reply in HttpResponse::json
+    HttpResponse postJson(const std::string& body) override;
+    
     /// Perform JSON GET request
     /// @param endpoint The endpoint
     /// @return The JSON response
@@ -85,14 +215,92 @@ public:
     /// @param url The URL
     /// @param callback The response callback
     /// @param headers Optional additional headers
-    void getAsync(const std::string& url, ResponseCallback callback, const Headers& headers = {});
+    /// @return Transfer ID, for cancel()
+    uint64_t getAsync(const std::string& url, ResponseCallback callback, const Headers& headers = {});
     
     /// Perform async POST request
     /// @param url The URL
     /// @param body The request body
     /// @param callback The response callback
     /// @param headers Optional additional headers
-    void postAsync(const std::string& url, const std::string& body, ResponseCallback callback, const Headers& headers = {});
+    /// @return Transfer ID, for cancel()
+    uint64_t postAsync(const std::string& url, const std::string& body, ResponseCallback callback, const Headers& headers = {});
+    
+    /// Perform an async JSON POST to the base URL, parsing the reply while it is received
+    /// @param body The JSON request body
+    /// @param callback The response callback, with the parsed reply in HttpResponse::json
+    /// @return Transfer ID, for cancel()
+    uint64_t postJsonAsync(const std::string& body, ResponseCallback callback) override;
+    
+    /// Abort an asynchronous request; its callback receives a response with an error
+    /// @param transferId The ID returned by getAsync() or postAsync()
+    void cancel(uint64_t transferId) override;
+    
+    /// Perform async GET request
+    /// @param url The URL
+    /// @param headers Optional additional headers
+    /// @return Future resolving to the response
+    std::future<HttpResponse> getAsync(const std::string& url, const Headers& headers = {});
+    
+    /// Perform async POST request
+    /// @param url The URL
+    /// @param body The request body
+    /// @param headers Optional additional headers
+    /// @return Future resolving to the response
+    std::future<HttpResponse> postAsync(const std::string& url, const std::string& body, const Headers& headers = {});
+    
+    /// Perform async JSON-RPC POST request
+    /// @param data The JSON data
+    /// @param endpoint Optional endpoint (default empty)
+    /// @return Future resolving to the JSON response, or holding an RpcException
+    std::future<nlohmann::json> postJsonAsync(const nlohmann::json& data, const std::string& endpoint = "");
+    
+    /// Parse the body of a JSON response. The response is left unchanged and may be
+    /// parsed again.
+    /// @param response The HTTP response
+    /// @return The parsed JSON
+    /// @throws RpcException on transport errors or malformed JSON
+    static nlohmann::json parseJsonResponse(const HttpResponse& response);
+
+    /// Parse the body of a JSON response that is no longer needed. A document parsed
+    /// while the body was received is moved out rather than copied unless another copy
+    /// of the response shares it.
+    /// @param response The HTTP response
+    /// @return The parsed JSON
+    /// @throws RpcException on transport errors or malformed JSON
+    static nlohmann::json parseJsonResponse(HttpResponse&& response);
+    
+    /// Get the headers sent with JSON requests
+    static const Headers& jsonHeaders();
+    
+private:
+    /// Resolve a URL relative to the base URL
+    std::string resolveUrl(const std::string& url) const;
+    
+    /// Add one transfer to the byte counters
+    static void recordTransfer(Counters& counters, uint64_t requestBytes, uint64_t requestWireBytes,
+                               uint64_t responseBytes, uint64_t responseWireBytes);
+    
+    /// Compress a request body in place if it reaches the threshold
+    /// @param body The body
+    /// @param headers The request headers, which receive the Content-Encoding
+    void encodeBody(std::string& body, Headers& headers) const;
+    
+    /// Build the response of a request rejected by the circuit breaker
+    HttpResponse circuitOpenResponse() const;
+    
+    /// Merge default headers with per-request headers
+    Headers mergeHeaders(const Headers& headers) const;
+    
+    /// Perform a request on the calling thread
+    /// @param streamJson Whether to parse a 2xx body as JSON while it is received
+    HttpResponse perform(const char* method, const std::string& url, const std::string& body, const Headers& headers,
+                         bool streamJson = false);
+    
+    /// Perform a request on the event loop
+    /// @param streamJson Whether to parse a 2xx body as JSON while it is received
+    uint64_t performAsync(const char* method, const std::string& url, const std::string& body,
+                          const Headers& headers, ResponseCallback callback, bool streamJson = false);
 };
 
 } // namespace neocpp
\ No newline at end of file
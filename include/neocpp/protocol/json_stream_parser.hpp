@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace neocpp {
+
+/// Incremental JSON parser that accepts a document in arbitrary chunks, such as
+/// the pieces of an HTTP body handed over by libcurl, and builds the value while
+/// the rest is still being received. Unlike nlohmann::json::parse it never needs
+/// the whole text in one buffer.
+///
+/// Numbers follow nlohmann's rules: integers become number_unsigned when
+/// non-negative and number_integer otherwise, falling back to number_float when
+/// they do not fit; duplicate object keys keep the last value.
+class JsonStreamParser {
+public:
+    /// Constructor
+    JsonStreamParser();
+
+    /// Parse the next chunk of the document
+    /// @param data The chunk
+    /// @param size The chunk length
+    /// @return False once the input is known to be invalid
+    bool feed(const char* data, size_t size);
+
+    /// Signal the end of the input
+    /// @return True if exactly one complete value was parsed
+    bool finish();
+
+    /// Check whether the input was found to be invalid
+    bool hasError() const { return !error_.empty(); }
+
+    /// Get the reason the input is invalid
+    const std::string& getError() const { return error_; }
+
+    /// Get the number of bytes parsed so far
+    size_t getBytesConsumed() const { return consumed_; }
+
+    /// Get the parsed document; complete only after finish() returned true
+    nlohmann::json& getDocument() { return document_; }
+
+private:
+    enum class State {
+        Value,        ///< Expecting a value
+        FirstValue,   ///< Expecting a value or ']' right after '['
+        Key,          ///< Expecting a key string
+        FirstKey,     ///< Expecting a key string or '}' right after '{'
+        Colon,        ///< Expecting ':' after a key
+        AfterValue,   ///< Expecting ',' or a closing bracket, or the end of the input
+        String,       ///< Inside a string
+        Escape,       ///< After a backslash inside a string
+        Unicode,      ///< Inside a \uXXXX escape
+        Number,       ///< Inside a number
+        Literal,      ///< Inside true, false or null
+        Done          ///< The top-level value is complete
+    };
+
+    nlohmann::json document_;
+    std::vector<nlohmann::json*> stack_;
+    std::string key_;
+    std::string token_;
+    State state_;
+    bool stringIsKey_;
+    uint32_t unicode_;
+    int unicodeDigits_;
+    uint32_t highSurrogate_;
+    int utf8Pending_;
+    unsigned char utf8Lower_;
+    unsigned char utf8Upper_;
+    const char* literal_;
+    size_t literalMatched_;
+    size_t consumed_;
+    std::string error_;
+
+    /// Process one character; the caller advances the position when true is returned
+    bool step(char c);
+
+    /// Store a completed scalar value in the current container
+    void addValue(nlohmann::json&& value);
+
+    /// Open an array or object in the current container
+    void openContainer(nlohmann::json&& container);
+
+    /// Close the innermost container
+    bool closeContainer(char bracket);
+
+    /// Convert the collected number token
+    bool finishNumber();
+
+    /// Complete a \uXXXX escape
+    bool finishUnicode();
+
+    /// Check a non-ASCII byte inside a string against the UTF-8 encoding rules
+    bool stepUtf8(unsigned char byte);
+
+    /// Record a syntax error
+    bool fail(const std::string& message);
+};
+
+} // namespace neocpp
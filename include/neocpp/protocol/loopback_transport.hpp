@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <nlohmann/json.hpp>
+#include "neocpp/protocol/rpc_transport.hpp"
+
+namespace neocpp {
+
+/// In-process transport that answers JSON-RPC calls from canned results without
+/// touching the network. Replies are assembled from pre-serialized results, so a
+/// client running against it spends its time in its own serialization, parsing and
+/// allocation, which makes it suitable for measuring SDK overhead in isolation.
+///
+/// Calls complete on the calling thread. Each element of a batch is answered on its
+/// own; methods without a result or handler get a "Method not found" error.
+class LoopbackTransport : public RpcTransport {
+public:
+    /// Computes the result of a call from its parameters
+    using Handler = std::function<nlohmann::json(const nlohmann::json& params)>;
+
+    /// Default URL reported by getUrl()
+    static constexpr const char* DEFAULT_URL = "loopback://";
+
+    /// Constructor
+    /// @param url The URL to report
+    explicit LoopbackTransport(const std::string& url = DEFAULT_URL);
+
+    /// Answer a method with a fixed result
+    /// @param method The method name
+    /// @param result The result
+    void setResult(const std::string& method, const nlohmann::json& result);
+
+    /// Answer a method with a JSON-RPC error
+    /// @param method The method name
+    /// @param code The error code
+    /// @param message The error message
+    void setError(const std::string& method, int code, const std::string& message);
+
+    /// Answer a method by computing the result from the parameters
+    /// @param method The method name
+    /// @param handler Returns the result; an exception it throws becomes an internal error (-32603)
+    void setHandler(const std::string& method, Handler handler);
+
+    /// Get the number of JSON-RPC calls answered, counting each batch element
+    uint64_t getCallCount() const { return calls_; }
+
+    const std::string& getUrl() const override { return url_; }
+
+    HttpResponse postJson(const std::string& body) override;
+
+    uint64_t postJsonAsync(const std::string& body, ResponseCallback callback) override;
+
+private:
+    /// How one method is answered
+    struct Answer {
+        std::string member;   ///< "result" or "error"
+        std::string json;     ///< The serialized member value
+        Handler handler;
+    };
+
+    std::string url_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, SharedPtr<const Answer>> answers_;
+    std::atomic<uint64_t> calls_;
+
+    /// Install the answer for a method
+    void setAnswer(const std::string& method, SharedPtr<const Answer> answer);
+
+    /// Append the reply to one call
+    void answer(const nlohmann::json& call, std::string& out);
+};
+
+} // namespace neocpp
@@ -6,9 +6,13 @@
 #include "neocpp/types/hash160.hpp"
 #include "neocpp/protocol/neo_rpc_client.hpp"
 #include "neocpp/protocol/http_service.hpp"
+#include "neocpp/protocol/rpc_transport.hpp"
 
 namespace neocpp {
 
+// Forward declaration
+class BlockPolling;
+
 /// Configuration for NeoCpp client
 struct NeoCppConfig {
     /// Default block time in milliseconds (15 seconds on Neo N3)
@@ -42,27 +46,27 @@ struct NeoCppConfig {
 class NeoCpp {
 private:
     NeoCppConfig config_;
-    SharedPtr<HttpService> httpService_;
+    SharedPtr<RpcTransport> transport_;
     SharedPtr<NeoRpcClient> rpcClient_;
     
 public:
-    /// Constructor with configuration and HTTP service
+    /// Constructor with configuration and transport
     /// @param config The configuration to use
-    /// @param httpService The HTTP service for network communication
-    NeoCpp(const NeoCppConfig& config, SharedPtr<HttpService> httpService);
+    /// @param transport The transport for requests, e.g. an HttpService
+    NeoCpp(const NeoCppConfig& config, SharedPtr<RpcTransport> transport);
     
     /// Constructor with URL only (uses default configuration)
     /// @param url The RPC endpoint URL
     explicit NeoCpp(const std::string& url);
     
     /// Static factory method to build a NeoCpp instance
-    /// @param httpService The HTTP service to use
+    /// @param transport The transport to use: an HttpService, or e.g. a LoopbackTransport
     /// @param config The configuration (optional, defaults to new one)
     /// @return A new NeoCpp instance
-    static SharedPtr<NeoCpp> build(SharedPtr<HttpService> httpService, const NeoCppConfig& config = NeoCppConfig());
+    static SharedPtr<NeoCpp> build(SharedPtr<RpcTransport> transport, const NeoCppConfig& config = NeoCppConfig());
     
     /// Static factory method to build a NeoCpp instance from URL
-    /// @param url The RPC endpoint URL
+    /// @param url The RPC endpoint URL, or unix://<socket path> for a node on the same host
     /// @param config The configuration (optional, defaults to new one)
     /// @return A new NeoCpp instance
     static SharedPtr<NeoCpp> build(const std::string& url, const NeoCppConfig& config = NeoCppConfig());
@@ -107,6 +111,12 @@ public:
     /// @return The RPC client
     SharedPtr<const NeoRpcClient> getRpcClient() const { return rpcClient_; }
     
+    /// Create a block poller on this client, aligned with block production: it learns
+    /// the block interval starting from blockInterval and polls at most every
+    /// pollingInterval. Subscribe to it, then start it.
+    /// @return The poller
+    SharedPtr<BlockPolling> createBlockPolling();
+    
     // Convenience methods that delegate to RPC client
     
     /// Get the current block count
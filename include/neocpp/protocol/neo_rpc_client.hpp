@@ -4,10 +4,20 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <future>
+#include <mutex>
+#include <atomic>
 #include <nlohmann/json.hpp>
 #include "neocpp/types/types.hpp"
 #include "neocpp/types/hash256.hpp"
 #include "neocpp/types/hash160.hpp"
+#include "neocpp/protocol/rpc_batcher.hpp"
+#include "neocpp/protocol/rpc_single_flight.hpp"
+#include "neocpp/protocol/rpc_response_cache.hpp"
+#include "neocpp/protocol/rpc_endpoint_set.hpp"
+#include "neocpp/protocol/rpc_policy.hpp"
+#include "neocpp/protocol/rpc_transport.hpp"
+#include "neocpp/protocol/core/response.hpp"
 
 namespace neocpp {
 
@@ -15,6 +25,7 @@ namespace neocpp {
 class Transaction;
 class Block;
 class HttpService;
+class ThreadPool;
 class NeoGetVersionResponse;
 class NeoGetBlockResponse;
 class NeoGetRawTransactionResponse;
@@ -26,26 +37,149 @@ class NeoGetPeersResponse;
 class NeoGetUnclaimedGasResponse;
 class NeoGetWalletBalanceResponse;
 
-/// Neo RPC client for interacting with Neo nodes
+/// Neo RPC client for interacting with Neo nodes.
+///
+/// Thread safety: one client may be shared by any number of threads. Request IDs are
+/// allocated atomically and every call borrows its own handle from the endpoint's
+/// connection pool. The setters swap configuration under a lock; calls already in
+/// flight complete against the previous URL or executor.
+///
+/// Concurrent identical read-only calls (same method and parameters) share a single
+/// outstanding request unless deduplication is turned off.
+///
+/// A client built from several URLs balances calls across them (see RpcEndpointSet).
+/// With getEndpoints()->enableHedging(), slow read-only calls are also sent to a second node.
+///
+/// With setPolicy(), transient failures are retried with backoff, failing endpoints are
+/// cut off by circuit breakers and the number of requests in flight adapts to latency.
+///
+/// A client built on an RpcTransport other than HttpService, such as LoopbackTransport
+/// or ReplayTransport, runs without a network; circuit breakers and transfer
+/// statistics then do not apply.
 class NeoRpcClient {
 private:
+    mutable std::mutex mutex_;
     std::string url_;
-    SharedPtr<HttpService> httpService_;
-    int requestId_;
+    SharedPtr<RpcTransport> transport_;
+    SharedPtr<ThreadPool> executor_;
+    SharedPtr<RpcBatcher> batcher_;
+    SharedPtr<RpcSingleFlight> singleFlight_;
+    SharedPtr<RpcResponseCache> cache_;
+    SharedPtr<RpcEndpointSet> endpoints_;
+    SharedPtr<RpcPolicy> policy_;
+    std::atomic<bool> broadcastWrites_;
+    std::atomic<bool> deduplicate_;
+    std::atomic<int> requestId_;
+    std::atomic<size_t> batchChunkSize_;
     
 public:
+    /// Default maximum number of requests sent in one batch POST
+    static constexpr size_t DEFAULT_BATCH_CHUNK_SIZE = 500;
+    
     /// Constructor
-    /// @param url The RPC endpoint URL
+    /// @param url The RPC endpoint URL, or unix://<socket path> for a node on the same host
     explicit NeoRpcClient(const std::string& url);
     
+    /// Constructor for a set of equivalent nodes. Each call goes to the fastest healthy
+    /// node that is not lagging behind the others, failing over on transport errors.
+    /// @param urls The RPC endpoint URLs (at least one)
+    /// @param config The load balancing configuration
+    NeoRpcClient(const std::vector<std::string>& urls, const RpcEndpointConfig& config = RpcEndpointConfig());
+    
+    /// Constructor for a client sending its requests through a given transport
+    /// @param transport The transport
+    explicit NeoRpcClient(const SharedPtr<RpcTransport>& transport);
+    
     /// Destructor
     ~NeoRpcClient() = default;
     
     /// Get the RPC URL
-    const std::string& getUrl() const { return url_; }
+    std::string getUrl() const;
+    
+    /// Set the RPC URL, leaving multi-endpoint mode
+    void setUrl(const std::string& url);
+    
+    /// Get the endpoint set
+    /// @return The endpoints, or nullptr when bound to a single URL
+    SharedPtr<RpcEndpointSet> getEndpoints() const;
+    
+    /// Check whether writes are sent to every endpoint
+    bool isBroadcastingWrites() const { return broadcastWrites_; }
+    
+    /// Send sendrawtransaction and submitblock to every endpoint at once (multi-endpoint
+    /// mode only). The call completes with the first reply that is not an error.
+    /// @param enabled Whether to broadcast
+    void setBroadcastWrites(bool enabled) { broadcastWrites_ = enabled; }
+    
+    /// Get the resilience policy
+    /// @return The policy, or nullptr when none is set
+    SharedPtr<RpcPolicy> getPolicy() const;
+    
+    /// Apply a resilience policy (retries, per-endpoint circuit breakers and an adaptive
+    /// concurrency limit) to every request, including batches
+    /// @param policy The policy, or nullptr to send requests unguarded
+    void setPolicy(const SharedPtr<RpcPolicy>& policy);
+    
+    /// Get the transport used for requests (the first endpoint's in multi-endpoint mode)
+    /// @return The transport
+    SharedPtr<RpcTransport> getTransport() const;
+    
+    /// Get the HTTP service used for requests
+    /// @return The HTTP service, or nullptr when the transport is not an HttpService
+    SharedPtr<HttpService> getHttpService() const;
+    
+    /// Get the byte counters of the client's HTTP services, summed over all endpoints.
+    /// Request compression is configured on each service (see HttpService).
+    /// @return Body bytes before and after content encoding
+    HttpTransferStats getTransferStats() const;
+    
+    /// Get the executor that parses asynchronous responses
+    /// @return The executor (the process-wide default pool unless replaced)
+    SharedPtr<ThreadPool> getExecutor() const;
+    
+    /// Set the executor that parses asynchronous responses
+    /// @param executor The executor
+    void setExecutor(const SharedPtr<ThreadPool>& executor);
+    
+    /// Coalesce single calls made within a short window into JSON-RPC batch requests.
+    /// Explicit sendBatch calls are unaffected.
+    /// @param config The batching window and maximum batch size
+    void enableBatching(const RpcBatchingConfig& config = RpcBatchingConfig());
+    
+    /// Send every call as its own request again; queued calls are still flushed
+    void disableBatching();
+    
+    /// Get the active batcher, for inspecting its metrics
+    /// @return The batcher, or nullptr when batching is disabled
+    SharedPtr<RpcBatcher> getBatcher() const;
     
-    /// Set the RPC URL
-    void setUrl(const std::string& url) { url_ = url; }
+    /// Get the maximum number of requests sendBatch puts in one POST
+    size_t getBatchChunkSize() const { return batchChunkSize_; }
+    
+    /// Set the maximum number of requests sendBatch puts in one POST.
+    /// Larger batches are split into chunks that are sent in parallel.
+    /// @param chunkSize The chunk size (must be positive)
+    void setBatchChunkSize(size_t chunkSize);
+    
+    /// Check whether concurrent identical read-only calls share one request
+    bool isDeduplicationEnabled() const { return deduplicate_; }
+    
+    /// Enable or disable sharing of concurrent identical read-only calls
+    /// @param enabled Whether to deduplicate
+    void setDeduplication(bool enabled) { deduplicate_ = enabled; }
+    
+    /// Get the table of shared in-flight calls, for inspecting its metrics
+    SharedPtr<RpcSingleFlight> getSingleFlight() const { return singleFlight_; }
+    
+    /// Get the response cache
+    /// @return The cache, or nullptr when caching is disabled
+    SharedPtr<RpcResponseCache> getResponseCache() const;
+    
+    /// Cache results of read-only calls. Results that never change are kept until
+    /// evicted; results that depend on chain height are kept until the next block,
+    /// so the cache should be invalidated through RpcResponseCache::invalidateOn.
+    /// @param cache The cache (e.g. an LruResponseCache), or nullptr to disable caching
+    void setResponseCache(const SharedPtr<RpcResponseCache>& cache);
     
     // Node methods
     
@@ -265,12 +399,104 @@ public:
     /// @return The response
     nlohmann::json sendRequest(const std::string& method, const nlohmann::json& params = nlohmann::json::array());
     
-    /// Send batch of JSON-RPC requests
+    /// Send batch of JSON-RPC requests. Replies are matched to requests by id, so the
+    /// node may answer in any order; a failed entry does not affect the others.
     /// @param requests The batch of requests
-    /// @return The responses
-    std::vector<nlohmann::json> sendBatch(const std::vector<std::pair<std::string, nlohmann::json>>& requests);
+    /// @return One response per request, in request order, each holding a result or an error
+    std::vector<SharedPtr<Response>> sendBatch(const std::vector<std::pair<std::string, nlohmann::json>>& requests);
+    
+    // Asynchronous methods
+    //
+    // Each returns immediately; the request is performed on the HTTP event loop and the
+    // response is parsed on the executor. Errors are delivered through the future.
+    
+    std::future<SharedPtr<NeoGetVersionResponse>> getVersionAsync();
+    std::future<int> getConnectionCountAsync();
+    std::future<SharedPtr<NeoGetPeersResponse>> getPeersAsync();
+    std::future<nlohmann::json> validateAddressAsync(const std::string& address);
+    
+    std::future<Hash256> getBestBlockHashAsync();
+    std::future<SharedPtr<NeoGetBlockResponse>> getBlockAsync(const Hash256& hash, bool verbose = true);
+    std::future<SharedPtr<NeoGetBlockResponse>> getBlockAsync(uint32_t index, bool verbose = true);
+    std::future<uint32_t> getBlockCountAsync();
+    std::future<Hash256> getBlockHashAsync(uint32_t index);
+    std::future<nlohmann::json> getBlockHeaderAsync(const Hash256& hash, bool verbose = true);
+    std::future<nlohmann::json> getBlockHeaderAsync(uint32_t index, bool verbose = true);
+    std::future<SharedPtr<NeoGetRawTransactionResponse>> getRawTransactionAsync(const Hash256& txId, bool verbose = true);
+    std::future<uint32_t> getTransactionHeightAsync(const Hash256& txId);
+    
+    std::future<SharedPtr<NeoGetContractStateResponse>> getContractStateAsync(const Hash160& scriptHash);
+    std::future<SharedPtr<NeoGetNep17BalancesResponse>> getNep17BalancesAsync(const std::string& address);
+    std::future<nlohmann::json> getNep17TransfersAsync(const std::string& address, uint64_t startTime = 0, uint64_t endTime = 0);
+    std::future<std::string> getStorageAsync(const Hash160& scriptHash, const std::string& key);
+    std::future<nlohmann::json> findStorageAsync(const Hash160& scriptHash, const std::string& prefix);
+    
+    std::future<SharedPtr<NeoInvokeResultResponse>> invokeFunctionAsync(const Hash160& scriptHash,
+                                                                        const std::string& method,
+                                                                        const nlohmann::json& params = nlohmann::json::array(),
+                                                                        const nlohmann::json& signers = nlohmann::json::array());
+    std::future<SharedPtr<NeoInvokeResultResponse>> invokeScriptAsync(const Bytes& script,
+                                                                      const nlohmann::json& signers = nlohmann::json::array());
+    std::future<SharedPtr<NeoInvokeResultResponse>> invokeScriptAsync(const std::string& base64Script,
+                                                                      const nlohmann::json& signers = nlohmann::json::array());
+    
+    std::future<Hash256> sendRawTransactionAsync(const SharedPtr<Transaction>& transaction);
+    std::future<Hash256> sendRawTransactionAsync(const std::string& hex);
+    std::future<int64_t> calculateNetworkFeeAsync(const SharedPtr<Transaction>& transaction);
+    std::future<SharedPtr<NeoGetApplicationLogResponse>> getApplicationLogAsync(const Hash256& txId);
+    
+    std::future<SharedPtr<NeoGetUnclaimedGasResponse>> getUnclaimedGasAsync(const std::string& address);
+    std::future<SharedPtr<NeoGetWalletBalanceResponse>> getWalletBalanceAsync(const Hash160& assetHash, const std::string& address);
+    
+    std::future<std::vector<std::string>> getCommitteeAsync();
+    std::future<std::vector<nlohmann::json>> getNextBlockValidatorsAsync();
+    
+    std::future<nlohmann::json> getStateRootAsync(uint32_t index);
+    std::future<nlohmann::json> getProofAsync(const Hash256& rootHash, const Hash160& contractHash, const std::string& key);
+    std::future<bool> verifyProofAsync(const Hash256& rootHash, const std::string& proof);
+    std::future<nlohmann::json> getStateHeightAsync();
+    
+    std::future<nlohmann::json> traverseIteratorAsync(const std::string& sessionId, const std::string& iteratorId, uint32_t count);
+    std::future<bool> terminateSessionAsync(const std::string& sessionId);
+    
+    /// Send raw JSON-RPC request asynchronously
+    /// @param method The RPC method name
+    /// @param params The parameters
+    /// @return Future resolving to the result
+    std::future<nlohmann::json> sendRequestAsync(const std::string& method, const nlohmann::json& params = nlohmann::json::array());
+    
+    /// Send batch of JSON-RPC requests asynchronously
+    /// @param requests The batch of requests
+    /// @return Future resolving to one response per request, in request order
+    std::future<std::vector<SharedPtr<Response>>> sendBatchAsync(const std::vector<std::pair<std::string, nlohmann::json>>& requests);
     
 private:
+    /// Send a request on the event loop and convert its result on the executor
+    template<typename T, typename Convert>
+    std::future<T> callAsync(const std::string& method, const nlohmann::json& params, Convert convert);
+    
+    /// Post a JSON-RPC payload on the event loop (through the batcher for single
+    /// requests when batching is enabled) and hand the reply over on the executor
+    void send(const nlohmann::json& payload, RpcBatcher::ReplyHandler onReply);
+    
+    /// Perform a single request on the calling thread and return the reply object
+    nlohmann::json exchange(const nlohmann::json& request);
+    
+    /// Get the single-flight key for a call, or an empty string if it must not be shared
+    std::string sharedCallKey(const std::string& method, const nlohmann::json& params) const;
+
+    /// Create a batcher posting through the endpoint set, or the transport without one
+    static SharedPtr<RpcBatcher> makeBatcher(const SharedPtr<RpcTransport>& transport,
+                                             const SharedPtr<RpcEndpointSet>& endpoints,
+                                             const SharedPtr<RpcPolicy>& policy,
+                                             const RpcBatchingConfig& config);
+    
+    /// Install the policy's circuit breaker on a transport that is an HTTP service, or remove it
+    static void guard(const SharedPtr<RpcTransport>& transport, const SharedPtr<RpcPolicy>& policy);
+    
+    /// Post a payload through the endpoint set or the transport, broadcasting writes if enabled
+    void transmit(const nlohmann::json& payload, RpcTransport::ResponseCallback callback);
+
     /// Generate next request ID
     int getNextRequestId();
     
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <iosfwd>
+#include <mutex>
+#include <atomic>
+#include <nlohmann/json.hpp>
+#include "neocpp/protocol/rpc_transport.hpp"
+
+namespace neocpp {
+
+/// One recorded JSON-RPC call: the request object and the reply object
+struct RpcExchange {
+    nlohmann::json request;
+    nlohmann::json response;
+};
+
+/// Transport that forwards calls to another transport and records every call that
+/// got a JSON-RPC reply. Batches are recorded call by call, matched by id. Transport
+/// failures are passed on but not recorded.
+///
+/// The recording is written as JSON lines, one {"request": ..., "response": ...}
+/// object per call, which ReplayTransport::load() reads back.
+class RecordingTransport : public RpcTransport {
+public:
+    /// Constructor
+    /// @param inner The transport that serves the calls
+    explicit RecordingTransport(SharedPtr<RpcTransport> inner);
+
+    /// Get the calls recorded so far
+    std::vector<RpcExchange> getExchanges() const;
+
+    /// Write the recording as JSON lines
+    /// @param out The stream to write to
+    void save(std::ostream& out) const;
+
+    /// Write the recording to a file as JSON lines
+    /// @param path The file path
+    /// @throws IllegalStateException if the file cannot be written
+    void save(const std::string& path) const;
+
+    const std::string& getUrl() const override { return inner_->getUrl(); }
+
+    HttpResponse postJson(const std::string& body) override;
+
+    uint64_t postJsonAsync(const std::string& body, ResponseCallback callback) override;
+
+    void cancel(uint64_t transferId) override { inner_->cancel(transferId); }
+
+private:
+    /// Shared with requests in flight, which may outlive the transport
+    struct Log {
+        std::mutex mutex;
+        std::vector<RpcExchange> exchanges;
+    };
+
+    SharedPtr<RpcTransport> inner_;
+    SharedPtr<Log> log_;
+
+    /// Record the calls of one request body with their replies
+    static void record(Log& log, const std::string& body, const HttpResponse& response);
+};
+
+/// Transport that answers calls from a recording, for deterministic replays of
+/// captured traffic. A call is matched on method and parameters; its id is replaced
+/// with the id of the call being answered. Identical calls get the recorded replies
+/// in recording order, and the last one again once they run out.
+///
+/// A batch is answered call by call. A request with a call that was never recorded
+/// fails like a transport error (status 0), so it cannot be mistaken for a reply.
+class ReplayTransport : public RpcTransport {
+public:
+    /// Default URL reported by getUrl()
+    static constexpr const char* DEFAULT_URL = "replay://";
+
+    /// Constructor
+    /// @param exchanges The recorded calls
+    /// @param url The URL to report
+    explicit ReplayTransport(const std::vector<RpcExchange>& exchanges, const std::string& url = DEFAULT_URL);
+
+    /// Read a recording written by RecordingTransport
+    /// @param in The stream to read from
+    /// @param url The URL to report
+    /// @throws IllegalArgumentException if a line is not a recorded call
+    static SharedPtr<ReplayTransport> load(std::istream& in, const std::string& url = DEFAULT_URL);
+
+    /// Read a recording file written by RecordingTransport
+    /// @param path The file path
+    /// @param url The URL to report
+    /// @throws IllegalArgumentException if the file cannot be read or a line is not a recorded call
+    static SharedPtr<ReplayTransport> load(const std::string& path, const std::string& url = DEFAULT_URL);
+
+    /// Get the number of calls that found no recorded reply
+    uint64_t getMissCount() const { return misses_; }
+
+    const std::string& getUrl() const override { return url_; }
+
+    HttpResponse postJson(const std::string& body) override;
+
+    uint64_t postJsonAsync(const std::string& body, ResponseCallback callback) override;
+
+private:
+    /// Replies recorded for one method and parameter list
+    struct Replies {
+        std::vector<nlohmann::json> responses;
+        size_t next = 0;
+    };
+
+    std::string url_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Replies> replies_;
+    std::atomic<uint64_t> misses_;
+
+    /// Build the lookup key of a call
+    static std::string key(const nlohmann::json& call);
+
+    /// Find the reply to one call
+    /// @return False if none was recorded
+    bool answer(const nlohmann::json& call, nlohmann::json& reply);
+};
+
+} // namespace neocpp
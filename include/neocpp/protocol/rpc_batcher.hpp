@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <exception>
+#include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+#include "neocpp/utils/histogram.hpp"
+
+namespace neocpp {
+
+/// Configuration for automatic JSON-RPC batching
+struct RpcBatchingConfig {
+    /// Default time a request may wait for companions
+    static constexpr int64_t DEFAULT_WINDOW_MICROS = 2000;
+
+    /// Default maximum number of requests per batch
+    static constexpr size_t DEFAULT_MAX_BATCH_SIZE = 50;
+
+    /// How long the first request of a batch waits for others to join
+    std::chrono::microseconds window = std::chrono::microseconds(DEFAULT_WINDOW_MICROS);
+
+    /// A batch is sent as soon as it holds this many requests
+    size_t maxBatchSize = DEFAULT_MAX_BATCH_SIZE;
+};
+
+/// Coalesces JSON-RPC requests from concurrent callers into batch POSTs
+/// and routes each reply back to its caller by id.
+class RpcBatcher {
+public:
+    /// Receives the reply object for one request, or the error that prevented it
+    using ReplyHandler = std::function<void(const nlohmann::json& reply, std::exception_ptr error)>;
+
+    /// Sends a payload (a request object or a batch array) and reports the parsed reply
+    using Sender = std::function<void(const nlohmann::json& payload, ReplyHandler onReply)>;
+
+    /// Constructor
+    /// @param sender The function performing the HTTP round trip
+    /// @param config The batching configuration
+    RpcBatcher(Sender sender, const RpcBatchingConfig& config = RpcBatchingConfig());
+
+    /// Destructor, flushes queued requests and stops the flusher thread
+    ~RpcBatcher();
+
+    RpcBatcher(const RpcBatcher&) = delete;
+    RpcBatcher& operator=(const RpcBatcher&) = delete;
+
+    /// Queue a request
+    /// @param request The JSON-RPC request object (must carry a unique id)
+    /// @param onReply Called with the matching reply object
+    void submit(const nlohmann::json& request, ReplyHandler onReply);
+
+    /// Queue a request
+    /// @param request The JSON-RPC request object (must carry a unique id)
+    /// @return Future resolving to the matching reply object
+    std::future<nlohmann::json> submit(const nlohmann::json& request);
+
+    /// Get the configuration
+    const RpcBatchingConfig& getConfig() const { return config_; }
+
+    /// Get the number of batches sent
+    uint64_t getBatchCount() const { return batchSizes_.getCount(); }
+
+    /// Get the distribution of requests per batch
+    const Histogram& getBatchSizeHistogram() const { return batchSizes_; }
+
+    /// Get the distribution of time requests spent waiting in the window, in microseconds
+    const Histogram& getWindowWaitHistogram() const { return windowWaits_; }
+
+private:
+    struct Pending {
+        nlohmann::json request;
+        ReplyHandler onReply;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    Sender sender_;
+    RpcBatchingConfig config_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Pending> pending_;
+    bool stopping_;
+    Histogram batchSizes_;
+    Histogram windowWaits_;
+    std::thread flusher_;
+
+    /// Flusher thread body
+    void flushLoop();
+
+    /// Send one batch and route its replies
+    void dispatch(std::vector<Pending> batch);
+};
+
+} // namespace neocpp
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <cstdint>
+#include "neocpp/types/types.hpp"
+#include "neocpp/protocol/http_service.hpp"
+#include "neocpp/utils/histogram.hpp"
+
+namespace neocpp {
+
+/// Configuration for load balancing across several RPC endpoints
+struct RpcEndpointConfig {
+    /// Default interval between health probes in milliseconds
+    static constexpr int64_t DEFAULT_PROBE_INTERVAL_MS = 5000;
+
+    /// Default number of blocks a node may trail the highest one
+    static constexpr uint32_t DEFAULT_MAX_BLOCK_LAG = 2;
+
+    /// Default weight of the newest sample in the moving averages
+    static constexpr double DEFAULT_EWMA_ALPHA = 0.2;
+
+    /// Default number of consecutive failures after which a node is unhealthy
+    static constexpr uint32_t DEFAULT_UNHEALTHY_AFTER = 3;
+
+    /// Interval between background getblockcount probes (zero disables probing)
+    std::chrono::milliseconds probeInterval = std::chrono::milliseconds(DEFAULT_PROBE_INTERVAL_MS);
+
+    /// Nodes further behind the highest known block count are skipped
+    uint32_t maxBlockLag = DEFAULT_MAX_BLOCK_LAG;
+
+    /// Weight of the newest sample in the latency and error rate averages
+    double ewmaAlpha = DEFAULT_EWMA_ALPHA;
+
+    /// Consecutive failures after which a node is skipped until a probe succeeds
+    uint32_t unhealthyAfter = DEFAULT_UNHEALTHY_AFTER;
+};
+
+/// Configuration for hedged requests
+struct RpcHedgingConfig {
+    /// Default latency percentile after which a hedge is sent
+    static constexpr double DEFAULT_PERCENTILE = 95.0;
+
+    /// Default hedge delay in milliseconds until enough latencies were observed
+    static constexpr int64_t DEFAULT_INITIAL_DELAY_MS = 50;
+
+    /// Default lower bound of the hedge delay in milliseconds
+    static constexpr int64_t DEFAULT_MIN_DELAY_MS = 2;
+
+    /// Default number of observed latencies before the percentile is trusted
+    static constexpr uint64_t DEFAULT_MIN_SAMPLES = 20;
+
+    /// Default length of a latency window in milliseconds
+    static constexpr int64_t DEFAULT_WINDOW_MS = 10000;
+
+    /// A hedge is sent once a request has been outstanding longer than this latency percentile
+    double percentile = DEFAULT_PERCENTILE;
+
+    /// Hedge delay used until minSamples latencies were observed
+    std::chrono::milliseconds initialDelay = std::chrono::milliseconds(DEFAULT_INITIAL_DELAY_MS);
+
+    /// Lower bound of the hedge delay, so fast nodes are not hedged constantly
+    std::chrono::milliseconds minDelay = std::chrono::milliseconds(DEFAULT_MIN_DELAY_MS);
+
+    /// Number of observed latencies before the percentile is trusted
+    uint64_t minSamples = DEFAULT_MIN_SAMPLES;
+
+    /// The hedge delay is derived from the latencies of the current and the previous
+    /// window only, so that it follows nodes getting faster or slower
+    std::chrono::milliseconds window = std::chrono::milliseconds(DEFAULT_WINDOW_MS);
+};
+
+/// Hedged request counters
+struct RpcHedgeStats {
+    uint64_t requests = 0;
+    uint64_t fired = 0;
+    uint64_t won = 0;
+
+    /// Get the ratio of requests that sent a hedge
+    double fireRatio() const {
+        return requests == 0 ? 0.0 : static_cast<double>(fired) / static_cast<double>(requests);
+    }
+
+    /// Get the ratio of hedges that answered first
+    double winRatio() const {
+        return fired == 0 ? 0.0 : static_cast<double>(won) / static_cast<double>(fired);
+    }
+};
+
+/// Snapshot of one endpoint's health
+struct RpcEndpointStats {
+    std::string url;
+    double latencyMs = 0.0;
+    double errorRate = 0.0;
+    uint32_t blockCount = 0;
+    bool healthy = true;
+    uint64_t requests = 0;
+};
+
+/// A set of equivalent RPC endpoints. Each request goes to the healthy, up-to-date
+/// node with the best moving average of latency and error rate, and fails over to
+/// the next one when the transport fails. A background thread probes every node's
+/// block count so that lagging or dead nodes are skipped.
+class RpcEndpointSet : public std::enable_shared_from_this<RpcEndpointSet> {
+public:
+    /// Constructor, starts the probe thread. The set must be owned by a SharedPtr,
+    /// which asynchronous requests use to keep it alive.
+    /// @param urls The endpoint URLs (at least one)
+    /// @param config The balancing configuration
+    explicit RpcEndpointSet(const std::vector<std::string>& urls,
+                            const RpcEndpointConfig& config = RpcEndpointConfig());
+
+    /// Destructor, stops the probe thread. Probe replies that arrive later are dropped.
+    ~RpcEndpointSet();
+
+    RpcEndpointSet(const RpcEndpointSet&) = delete;
+    RpcEndpointSet& operator=(const RpcEndpointSet&) = delete;
+
+    /// Post a JSON body to the best endpoint, failing over on transport errors
+    /// @param body The request body
+    /// @return The response of the first endpoint that answered
+    HttpResponse post(const std::string& body);
+
+    /// Post a JSON body to the best endpoint asynchronously, failing over on transport errors
+    /// @param body The request body
+    /// @param callback Called with the response of the first endpoint that answered
+    void postAsync(const std::string& body, HttpService::ResponseCallback callback);
+
+    /// Post a JSON body to every endpoint at once
+    /// @param body The request body
+    /// @param callback Called once, with the first reply free of JSON-RPC errors if any,
+    ///        otherwise with the first successful HTTP response, otherwise the last failure
+    void broadcastAsync(const std::string& body, HttpService::ResponseCallback callback);
+
+    /// Post a JSON body to the best endpoint and, if it has not answered within the hedge
+    /// delay, to the next best one too. The first answer wins and the other is cancelled.
+    /// Only use this for idempotent requests.
+    /// @param body The request body
+    /// @param callback Called once with the winning response
+    void hedgedPostAsync(const std::string& body, HttpService::ResponseCallback callback);
+
+    /// Hedge idempotent requests sent through this set
+    /// @param config The hedging configuration
+    void enableHedging(const RpcHedgingConfig& config = RpcHedgingConfig());
+
+    /// Stop hedging requests
+    void disableHedging();
+
+    /// Check whether requests are hedged
+    bool isHedging() const;
+
+    /// Get the current hedge delay, derived from recently observed latencies
+    std::chrono::microseconds getHedgeDelay() const;
+
+    /// Get the hedged request counters
+    RpcHedgeStats getHedgeStats() const;
+
+    /// Get the distribution of all successful request latencies, in microseconds
+    const Histogram& getLatencyHistogram() const { return latencies_; }
+
+    /// Probe every endpoint's block count now. Does not block; the replies are
+    /// recorded on the event loop thread.
+    /// @return Becomes ready once every endpoint answered or failed
+    std::future<void> probe();
+
+    /// Get the number of endpoints
+    size_t size() const { return endpoints_.size(); }
+
+    /// Get the HTTP service of an endpoint
+    /// @param index The endpoint index
+    SharedPtr<HttpService> getHttpService(size_t index) const;
+
+    /// Get a snapshot of every endpoint's health
+    std::vector<RpcEndpointStats> getStats() const;
+
+    /// Get the configuration
+    const RpcEndpointConfig& getConfig() const { return config_; }
+
+private:
+    struct Endpoint {
+        SharedPtr<HttpService> httpService;
+        RpcEndpointStats stats;
+        uint32_t consecutiveFailures = 0;
+    };
+
+    /// Shared with the probe thread and probe callbacks, which must not keep the set
+    /// alive: the destructor clears the set pointer, after which neither touches it
+    struct ProbeState {
+        std::recursive_mutex mutex;
+        std::condition_variable_any condition;
+        RpcEndpointSet* set;
+    };
+
+    RpcEndpointConfig config_;
+    std::vector<Endpoint> endpoints_;
+    mutable std::mutex mutex_;
+    SharedPtr<ProbeState> probes_;
+    bool hedging_;
+    RpcHedgingConfig hedgingConfig_;
+    Histogram latencies_;
+    Histogram recentLatencies_[2];
+    size_t currentWindow_;
+    std::chrono::steady_clock::time_point windowStart_;
+    std::atomic<uint64_t> hedgedRequests_;
+    std::atomic<uint64_t> hedgesFired_;
+    std::atomic<uint64_t> hedgesWon_;
+    std::thread prober_;
+
+    /// Pick the best endpoint not yet tried, or size() if none is left
+    size_t select(const std::vector<bool>& tried) const;
+
+    /// Record the outcome of a request
+    void record(size_t index, std::chrono::steady_clock::duration latency, bool success);
+
+    /// Start a new latency window if the current one is over; requires mutex_
+    void rotateLatencyWindows(std::chrono::steady_clock::time_point now);
+
+    /// Raise an endpoint's latency average for a request that was abandoned after a delay
+    void recordSlow(size_t index, std::chrono::steady_clock::duration elapsed);
+
+    /// Try endpoints in order of preference until one answers
+    void attemptAsync(const std::string& body, HttpService::ResponseCallback callback,
+                      SharedPtr<std::vector<bool>> tried);
+
+    /// Probe thread body, runs until the set is destroyed
+    static void probeLoop(SharedPtr<ProbeState> probes, std::chrono::milliseconds interval);
+
+    /// Check whether a response means the node could not serve the request
+    static bool isTransportFailure(const HttpResponse& response);
+};
+
+} // namespace neocpp
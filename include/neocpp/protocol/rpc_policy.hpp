@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include "neocpp/types/types.hpp"
+#include "neocpp/protocol/http_service.hpp"
+#include "neocpp/protocol/circuit_breaker.hpp"
+#include "neocpp/protocol/aimd_limiter.hpp"
+
+namespace neocpp {
+
+/// Configuration for retrying transient RPC failures
+struct RpcRetryConfig {
+    /// Default number of attempts per request, including the first
+    static constexpr uint32_t DEFAULT_MAX_ATTEMPTS = 3;
+
+    /// Default delay before the first retry in milliseconds
+    static constexpr int64_t DEFAULT_INITIAL_BACKOFF_MS = 100;
+
+    /// Default upper bound of the retry delay in milliseconds
+    static constexpr int64_t DEFAULT_MAX_BACKOFF_MS = 2000;
+
+    /// Attempts per request, including the first (1 disables retries)
+    uint32_t maxAttempts = DEFAULT_MAX_ATTEMPTS;
+
+    /// Delay before the first retry; doubled for every further retry
+    std::chrono::milliseconds initialBackoff = std::chrono::milliseconds(DEFAULT_INITIAL_BACKOFF_MS);
+
+    /// Upper bound of the retry delay
+    std::chrono::milliseconds maxBackoff = std::chrono::milliseconds(DEFAULT_MAX_BACKOFF_MS);
+
+    /// Also retry sendrawtransaction and submitblock. Off by default, because a retry of a
+    /// write the node did apply comes back as an "already exists" error.
+    bool retryWrites = false;
+};
+
+/// Configuration for the RPC policy layer
+struct RpcPolicyConfig {
+    RpcRetryConfig retry;
+    CircuitBreakerConfig circuitBreaker;
+    AimdLimiterConfig limiter;
+
+    /// Whether the number of requests in flight is limited
+    bool limitConcurrency = true;
+};
+
+/// Resilience policy applied to every RPC request of a NeoRpcClient:
+/// - transient failures (transport errors, timeouts, HTTP 429 and 5xx) are retried
+///   with exponential backoff and jitter;
+/// - each endpoint gets a CircuitBreaker, so a dead node is failed fast;
+/// - an AimdLimiter bounds the requests in flight and shrinks the bound when
+///   latency climbs, so a slow node is not buried under queued requests.
+class RpcPolicy : public std::enable_shared_from_this<RpcPolicy> {
+public:
+    /// Starts one attempt of a request and reports its response
+    using Attempt = std::function<void(HttpService::ResponseCallback)>;
+
+    /// Constructor. The policy must be owned by a SharedPtr.
+    /// @param config The policy configuration
+    explicit RpcPolicy(const RpcPolicyConfig& config = RpcPolicyConfig());
+
+    /// Run a request under the policy
+    /// @param attempt Starts one attempt; called again for every retry
+    /// @param callback Called once with the final response
+    /// @param idempotent Whether the request may be retried (writes only if retryWrites is set)
+    void execute(Attempt attempt, HttpService::ResponseCallback callback, bool idempotent);
+
+    /// Get the circuit breaker for an endpoint, creating it on first use
+    /// @param url The endpoint URL
+    SharedPtr<CircuitBreaker> getCircuitBreaker(const std::string& url);
+
+    /// Get the concurrency limiter
+    /// @return The limiter, or nullptr when concurrency is not limited
+    SharedPtr<AimdLimiter> getLimiter() const { return limiter_; }
+
+    /// Get the number of retries sent
+    uint64_t getRetryCount() const { return retries_; }
+
+    /// Get the configuration
+    const RpcPolicyConfig& getConfig() const { return config_; }
+
+    /// Compute the delay before a retry: exponential backoff capped at maxBackoff, of
+    /// which the upper half is randomized so that clients do not retry in lockstep
+    /// @param config The retry configuration
+    /// @param retry The retry number, starting at 0
+    /// @return The delay
+    static std::chrono::milliseconds backoff(const RpcRetryConfig& config, uint32_t retry);
+
+    /// Check whether a response is a failure worth retrying
+    static bool isTransient(const HttpResponse& response) { return response.isTransientFailure(); }
+
+private:
+    struct Call;
+
+    RpcPolicyConfig config_;
+    SharedPtr<AimdLimiter> limiter_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, SharedPtr<CircuitBreaker>> breakers_;
+    std::atomic<uint64_t> retries_;
+
+    /// Start the next attempt of a call
+    void run(const SharedPtr<Call>& call);
+};
+
+} // namespace neocpp
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+class BlockPolling;
+
+/// Response cache statistics
+struct RpcCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    /// Get the ratio of lookups served from the cache
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+/// Cache of JSON-RPC results, keyed by method and parameters.
+/// Implementations must be safe to use from several threads.
+class RpcResponseCache {
+public:
+    /// How long a cached result stays valid
+    enum class Lifetime {
+        /// The result can never change (e.g. a block hash by index)
+        Immutable,
+        /// The result may change with every new block (e.g. a balance)
+        UntilNextBlock
+    };
+
+    virtual ~RpcResponseCache() = default;
+
+    /// Look up a result
+    /// @param key The call key
+    /// @param result Receives the cached result on a hit
+    /// @return True on a hit
+    virtual bool get(const std::string& key, nlohmann::json& result) = 0;
+
+    /// Store a result
+    /// @param key The call key
+    /// @param result The result
+    /// @param lifetime How long the result stays valid
+    /// @param generation The block generation observed before the request was sent;
+    ///        UntilNextBlock results from an older generation are discarded
+    virtual void put(const std::string& key, const nlohmann::json& result, Lifetime lifetime, uint64_t generation) = 0;
+
+    /// Get the current block generation
+    virtual uint64_t getGeneration() const = 0;
+
+    /// Drop every UntilNextBlock result and advance the generation
+    /// @param blockIndex The index of the new block
+    virtual void onNewBlock(uint32_t blockIndex) = 0;
+
+    /// Drop every result
+    virtual void clear() = 0;
+
+    /// Get statistics
+    virtual RpcCacheStats getStats() const = 0;
+
+    /// Invalidate this cache whenever the poller sees a new block
+    /// @param cache The cache
+    /// @param polling The block poller
+    static void invalidateOn(const SharedPtr<RpcResponseCache>& cache, BlockPolling& polling);
+};
+
+/// Least-recently-used response cache bounded by the serialized size of its results.
+///
+/// UntilNextBlock results also expire after a maximum age. This bounds staleness when
+/// no poller invalidates the cache, and lets a BlockPolling that reads the chain height
+/// through the same client still see it move.
+class LruResponseCache : public RpcResponseCache {
+public:
+    /// Default memory budget in bytes
+    static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+    /// Default maximum age of UntilNextBlock results in milliseconds
+    static constexpr int64_t DEFAULT_MAX_VOLATILE_AGE_MS = 1000;
+
+    /// Constructor
+    /// @param maxBytes The memory budget; least recently used results are evicted beyond it
+    /// @param maxVolatileAge The maximum age of UntilNextBlock results
+    explicit LruResponseCache(size_t maxBytes = DEFAULT_MAX_BYTES,
+                              std::chrono::milliseconds maxVolatileAge = std::chrono::milliseconds(DEFAULT_MAX_VOLATILE_AGE_MS));
+
+    bool get(const std::string& key, nlohmann::json& result) override;
+    void put(const std::string& key, const nlohmann::json& result, Lifetime lifetime, uint64_t generation) override;
+    uint64_t getGeneration() const override;
+    void onNewBlock(uint32_t blockIndex) override;
+    void clear() override;
+    RpcCacheStats getStats() const override;
+
+    /// Get the memory budget in bytes
+    size_t getMaxBytes() const;
+
+    /// Set the memory budget in bytes, evicting results beyond it
+    /// @param maxBytes The budget
+    void setMaxBytes(size_t maxBytes);
+
+private:
+    struct Entry {
+        std::string key;
+        nlohmann::json result;
+        Lifetime lifetime;
+        size_t bytes;
+        std::chrono::steady_clock::time_point storedAt;
+    };
+
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t maxBytes_;
+    std::chrono::milliseconds maxVolatileAge_;
+    size_t bytes_;
+    uint64_t generation_;
+    RpcCacheStats stats_;
+
+    /// Remove an entry (requires lock)
+    void erase(std::list<Entry>::iterator it);
+
+    /// Evict least recently used entries until within budget (requires lock)
+    void evict();
+};
+
+} // namespace neocpp
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "neocpp/protocol/rpc_batcher.hpp"
+
+namespace neocpp {
+
+/// Lets concurrent identical calls share one outstanding request.
+///
+/// The first caller for a key becomes the leader and performs the request; callers
+/// arriving while it is in flight only register their handler. When the leader
+/// completes, every registered handler receives the same reply and the key is
+/// forgotten, so the next call starts a fresh request.
+class RpcSingleFlight {
+public:
+    using ReplyHandler = RpcBatcher::ReplyHandler;
+
+    /// Build the key identifying a call
+    /// @param method The RPC method name
+    /// @param params The parameters (object keys are serialized in sorted order)
+    /// @return The key
+    static std::string makeKey(const std::string& method, const nlohmann::json& params);
+
+    /// Register interest in the call identified by key
+    /// @param key The call key
+    /// @param onReply Called with the shared reply
+    /// @return True if the caller is the leader and must perform the call, then call complete()
+    bool join(const std::string& key, ReplyHandler onReply);
+
+    /// Deliver the leader's reply to every caller of key
+    /// @param key The call key
+    /// @param reply The reply object (ignored when error is set)
+    /// @param error The error that prevented the reply, if any
+    void complete(const std::string& key, const nlohmann::json& reply, std::exception_ptr error);
+
+    /// Get the number of calls currently in flight
+    size_t getInFlight() const;
+
+    /// Get the number of calls that were served by joining another call
+    uint64_t getSharedCount() const { return sharedCount_; }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<ReplyHandler>> calls_;
+    std::atomic<uint64_t> sharedCount_{0};
+};
+
+} // namespace neocpp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+/// HTTP response structure. Transports that do not speak HTTP report a reply as
+/// status 200 and a failure to deliver the request as status 0 with an error.
+struct HttpResponse {
+    int statusCode = 0;
+    std::string body;
+    std::unordered_map<std::string, std::string> headers;
+    std::string error;
+
+    /// Document parsed while the body was received (JSON requests with a 2xx status only).
+    /// The body is then left empty; if the document was invalid, json holds a discarded
+    /// value and the body holds the parse error. Use HttpService::parseJsonResponse.
+    SharedPtr<nlohmann::json> json;
+
+    /// Set when the request was never sent because the endpoint's circuit breaker is open
+    bool circuitOpen = false;
+
+    bool isSuccess() const { return statusCode >= 200 && statusCode < 300; }
+
+    /// Check whether the server could not serve the request right now
+    /// (a transport error or timeout, 429 Too Many Requests, or a 5xx status)
+    bool isTransientFailure() const {
+        return !error.empty() || statusCode == 0 || statusCode == 429 || statusCode >= 500;
+    }
+};
+
+/// Carries JSON-RPC request bodies to a node and hands back the replies.
+///
+/// HttpService is the network implementation. LoopbackTransport answers in process
+/// from canned results, and ReplayTransport answers from a recorded session, so that
+/// a NeoRpcClient can be exercised without a node. Implementations must allow
+/// concurrent calls.
+class RpcTransport {
+public:
+    using ResponseCallback = std::function<void(const HttpResponse&)>;
+
+    /// Destructor
+    virtual ~RpcTransport() = default;
+
+    /// Get the URL identifying the endpoint
+    virtual const std::string& getUrl() const = 0;
+
+    /// Send a JSON-RPC request or batch and wait for the reply
+    /// @param body The JSON request body
+    /// @return The response
+    virtual HttpResponse postJson(const std::string& body) = 0;
+
+    /// Send a JSON-RPC request or batch without waiting. The callback may run on
+    /// the calling thread before this returns.
+    /// @param body The JSON request body
+    /// @param callback The response callback
+    /// @return Transfer ID, for cancel()
+    virtual uint64_t postJsonAsync(const std::string& body, ResponseCallback callback) = 0;
+
+    /// Abort an asynchronous request; its callback receives a response with an error.
+    /// Transports that complete requests immediately ignore this.
+    /// @param transferId The ID returned by postJsonAsync()
+    virtual void cancel(uint64_t transferId) { (void)transferId; }
+};
+
+} // namespace neocpp
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <exception>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+// Forward declarations
+class NeoRpcClient;
+class BlockPolling;
+class WebSocketConnection;
+
+/// Events a node pushes over its WebSocket endpoint
+enum class SubscriptionEvent {
+    BlockAdded,                  ///< block_added: the new block
+    TransactionAdded,            ///< transaction_added: a transaction entering the mempool
+    NotificationFromExecution,   ///< notification_from_execution: a contract notification
+    TransactionExecuted          ///< transaction_executed: the application log of a transaction
+};
+
+/// Configuration for a SubscriptionClient
+struct SubscriptionConfig {
+    /// Default delay before the first reconnect attempt in milliseconds
+    static constexpr int64_t DEFAULT_RECONNECT_DELAY_MS = 500;
+
+    /// Default upper bound of the reconnect delay in milliseconds
+    static constexpr int64_t DEFAULT_MAX_RECONNECT_DELAY_MS = 30000;
+
+    /// Default time allowed for connecting in milliseconds
+    static constexpr int64_t DEFAULT_CONNECT_TIMEOUT_MS = 5000;
+
+    /// Default interval between keep-alive pings in milliseconds
+    static constexpr int64_t DEFAULT_PING_INTERVAL_MS = 20000;
+
+    /// Default number of failed connection attempts before polling takes over
+    static constexpr uint32_t DEFAULT_FALLBACK_AFTER_FAILURES = 3;
+
+    /// Delay before the first reconnect attempt; doubled for every further attempt
+    std::chrono::milliseconds reconnectDelay = std::chrono::milliseconds(DEFAULT_RECONNECT_DELAY_MS);
+
+    /// Upper bound of the reconnect delay
+    std::chrono::milliseconds maxReconnectDelay = std::chrono::milliseconds(DEFAULT_MAX_RECONNECT_DELAY_MS);
+
+    /// Time allowed for connecting and for the WebSocket handshake
+    std::chrono::milliseconds connectTimeout = std::chrono::milliseconds(DEFAULT_CONNECT_TIMEOUT_MS);
+
+    /// Interval between keep-alive pings while connected
+    std::chrono::milliseconds pingInterval = std::chrono::milliseconds(DEFAULT_PING_INTERVAL_MS);
+
+    /// Failed connection attempts in a row after which BlockPolling delivers events
+    /// until a connection succeeds
+    uint32_t fallbackAfterFailures = DEFAULT_FALLBACK_AFTER_FAILURES;
+
+    /// Poll interval of the fallback
+    std::chrono::milliseconds fallbackPollInterval = std::chrono::milliseconds(1000);
+};
+
+/// Client for the JSON-RPC subscription API of a node's WebSocket endpoint
+/// (neo-go's /ws: subscribe, unsubscribe and event notifications). Events are
+/// pushed as they happen instead of being polled for.
+///
+/// Subscriptions may be added before or after start(). After a lost connection the
+/// client reconnects with exponential backoff and subscribes again; events that
+/// happen while disconnected are not delivered.
+///
+/// When the node has no WebSocket endpoint (the upgrade is refused outright, the subscribe
+/// method is unknown, or several connection attempts in a row fail), a BlockPolling
+/// on the RPC client takes over: blocks are fetched with getblock and, for
+/// notification and execution subscriptions, their application logs with
+/// getapplicationlog. Mempool transactions cannot be polled, so transaction_added
+/// subscriptions stay silent meanwhile. Polling ends as soon as a connection succeeds.
+///
+/// Handlers run on the client's thread, one event at a time, and should return quickly.
+class SubscriptionClient {
+public:
+    /// Receives the event payload (the first element of the notification's params)
+    using EventHandler = std::function<void(const nlohmann::json&)>;
+
+    /// Constructor
+    /// @param url The WebSocket URL, e.g. ws://localhost:10332/ws
+    /// @param rpcClient The RPC client used by the polling fallback (nullptr disables it)
+    /// @param config The configuration
+    SubscriptionClient(const std::string& url, const SharedPtr<NeoRpcClient>& rpcClient,
+                       const SubscriptionConfig& config = SubscriptionConfig());
+
+    /// Destructor; stops the client
+    ~SubscriptionClient();
+
+    SubscriptionClient(const SubscriptionClient&) = delete;
+    SubscriptionClient& operator=(const SubscriptionClient&) = delete;
+
+    /// Connect and keep the subscriptions alive until stop()
+    void start();
+
+    /// Close the connection and stop polling
+    void stop();
+
+    /// Check whether the client is running
+    bool isRunning() const { return running_; }
+
+    /// Check whether events are currently pushed over a WebSocket connection
+    bool isConnected() const { return connected_; }
+
+    /// Check whether the polling fallback currently delivers events
+    bool isPolling() const { return polling_; }
+
+    /// Subscribe to an event
+    /// @param event The event
+    /// @param handler Called with each matching event
+    /// @param filter Optional filter, as accepted by the node: block_added {"primary", "since",
+    ///               "till"}, transaction_added {"sender", "signer"}, notification_from_execution
+    ///               {"contract", "name"}, transaction_executed {"state", "container"}
+    /// @return The subscription ID, for unsubscribe()
+    uint64_t subscribe(SubscriptionEvent event, EventHandler handler, const nlohmann::json& filter = nullptr);
+
+    /// Cancel a subscription
+    /// @param subscriptionId The ID returned by subscribe()
+    void unsubscribe(uint64_t subscriptionId);
+
+    /// Set the handler receiving connection errors and events the node reports missed.
+    /// Set it before start().
+    /// @param handler The error handler
+    void setErrorHandler(std::function<void(const std::exception&)> handler) { errorHandler_ = std::move(handler); }
+
+    /// Get the number of times a lost connection was established again
+    uint64_t getReconnectCount() const { return reconnects_; }
+
+    /// Get the name of an event in the node's API
+    static const char* eventName(SubscriptionEvent event);
+
+    /// Check an event payload against a subscription filter, as the node does
+    /// @param event The event
+    /// @param filter The filter (null matches everything)
+    /// @param payload The event payload
+    static bool matches(SubscriptionEvent event, const nlohmann::json& filter, const nlohmann::json& payload);
+
+private:
+    /// One subscription
+    struct Subscription {
+        SubscriptionEvent event;
+        EventHandler handler;
+        nlohmann::json filter;
+        std::string serverId;   ///< ID assigned by the node on the current connection
+    };
+
+    std::string url_;
+    SharedPtr<NeoRpcClient> rpcClient_;
+    SubscriptionConfig config_;
+    std::function<void(const std::exception&)> errorHandler_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::map<uint64_t, Subscription> subscriptions_;
+    std::map<int64_t, uint64_t> pendingSubscribes_;   ///< request ID -> subscription ID
+    uint64_t nextSubscriptionId_;
+    int64_t nextRequestId_;
+    SharedPtr<WebSocketConnection> connection_;
+    SharedPtr<BlockPolling> poller_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> connected_;
+    std::atomic<bool> polling_;
+    std::atomic<bool> unsupported_;
+    std::atomic<uint64_t> reconnects_;
+    std::unique_ptr<std::thread> thread_;
+
+    /// Connection loop
+    void run();
+
+    /// Serve one connection until it closes
+    void serve(const SharedPtr<WebSocketConnection>& connection);
+
+    /// Send a subscribe request for a subscription
+    void sendSubscribe(const SharedPtr<WebSocketConnection>& connection, uint64_t subscriptionId,
+                       const Subscription& subscription);
+
+    /// Handle one message from the node
+    void handleMessage(const SharedPtr<WebSocketConnection>& connection, const std::string& message);
+
+    /// Deliver an event to the matching subscriptions
+    void dispatch(SubscriptionEvent event, const nlohmann::json& payload);
+
+    /// Start the polling fallback
+    void startPolling();
+
+    /// Stop the polling fallback
+    void stopPolling();
+
+    /// Deliver the events of a polled block
+    void onPolledBlock(const nlohmann::json& block);
+
+    /// Report an error to the error handler
+    void reportError(const std::exception& error);
+};
+
+} // namespace neocpp
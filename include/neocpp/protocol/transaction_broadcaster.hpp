@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "neocpp/types/types.hpp"
+#include "neocpp/types/hash256.hpp"
+#include "neocpp/protocol/core/polling/adaptive_poll_schedule.hpp"
+
+namespace neocpp {
+
+// Forward declarations
+class NeoRpcClient;
+class BlockPolling;
+class Transaction;
+
+/// Configuration for a TransactionBroadcaster
+struct BroadcastConfig {
+    /// Default number of blocks without inclusion after which a transaction is sent again
+    static constexpr uint32_t DEFAULT_REBROADCAST_AFTER_BLOCKS = 2;
+
+    /// Nodes that must accept a transaction (or already hold it) for it to be tracked;
+    /// with fewer, its future fails as soon as every node has answered. Must be between
+    /// 1 and the number of nodes.
+    size_t minAccepted = 1;
+
+    /// Blocks without inclusion after which a transaction is sent to every node again,
+    /// in case a mempool dropped it (0 never sends it again)
+    uint32_t rebroadcastAfterBlocks = DEFAULT_REBROADCAST_AFTER_BLOCKS;
+
+    /// Poll schedule of the block watcher the broadcaster creates itself
+    AdaptivePollingConfig polling;
+};
+
+/// Outcome of a broadcast transaction
+enum class BroadcastStatus {
+    Included,   ///< The transaction is in a block
+    Expired     ///< Its validUntilBlock passed without it being included
+};
+
+/// Result of TransactionBroadcaster::broadcast()
+struct BroadcastResult {
+    Hash256 hash;                       ///< The transaction ID, in the byte order nodes print it
+    BroadcastStatus status = BroadcastStatus::Included;
+    uint32_t blockIndex = 0;            ///< The block including the transaction, or the block it expired at
+    size_t accepted = 0;                ///< Nodes that accepted it on first submission
+    size_t alreadyKnown = 0;            ///< Nodes that already held it
+    std::vector<std::string> rejections; ///< "url: error" of every node that refused it
+    uint32_t rebroadcasts = 0;          ///< Times it was sent to every node again
+    std::chrono::milliseconds elapsed{0}; ///< Time from broadcast() until the outcome was known
+};
+
+/// Sends signed transactions to several nodes at once and reports when they are
+/// included in a block.
+///
+/// broadcast() posts sendrawtransaction to every node in parallel, so the transaction
+/// enters the network through whichever node relays it fastest. A node answering that
+/// it already holds the transaction (in its mempool or ledger) counts as having it,
+/// not as a rejection. Inclusion is detected from the block stream of a BlockPolling:
+/// every new block is matched against all pending transactions at once, so the number
+/// of RPC calls does not grow with the number of transactions in flight (no
+/// getapplicationlog per transaction). The future resolves when a block includes the
+/// transaction, or as Expired after the block at its validUntilBlock.
+///
+/// Each NeoRpcClient counts as one node and is sent to through its transport.
+/// Blocks from another source, such as a SubscriptionClient's BlockAdded events, can be
+/// fed with onBlock() in addition.
+class TransactionBroadcaster {
+public:
+    /// Constructor that watches blocks with its own BlockPolling on the first node,
+    /// starting at the current height
+    /// @param nodes The nodes to send to
+    /// @param config The configuration
+    /// @throws IllegalArgumentException if there is no node, or minAccepted is zero or
+    ///         exceeds the number of nodes
+    /// @throws RpcException if the block height cannot be read
+    explicit TransactionBroadcaster(const std::vector<SharedPtr<NeoRpcClient>>& nodes,
+                                    const BroadcastConfig& config = BroadcastConfig());
+
+    /// Constructor that watches blocks with an existing BlockPolling. The poller must be
+    /// running before the first broadcast; it is not stopped by the broadcaster.
+    /// @param nodes The nodes to send to
+    /// @param watcher The block stream used to detect inclusion
+    /// @param config The configuration
+    /// @throws IllegalArgumentException if there is no node or no watcher, or minAccepted
+    ///         is zero or exceeds the number of nodes
+    TransactionBroadcaster(const std::vector<SharedPtr<NeoRpcClient>>& nodes,
+                           const SharedPtr<BlockPolling>& watcher,
+                           const BroadcastConfig& config = BroadcastConfig());
+
+    /// Destructor; pending futures fail with IllegalStateException
+    ~TransactionBroadcaster();
+
+    TransactionBroadcaster(const TransactionBroadcaster&) = delete;
+    TransactionBroadcaster& operator=(const TransactionBroadcaster&) = delete;
+
+    /// Send a signed transaction to every node and track its inclusion. Broadcasting a
+    /// transaction that is still pending does not send it again.
+    /// @param transaction The signed transaction
+    /// @return Resolves when the transaction is included or expired; fails with
+    ///         RpcException if fewer than minAccepted nodes took it
+    std::future<BroadcastResult> broadcast(const SharedPtr<Transaction>& transaction);
+
+    /// Send a serialized transaction to every node and track its inclusion
+    /// @param base64Transaction The transaction as sent with sendrawtransaction
+    /// @param hash The transaction ID as nodes print it, e.g. parsed with Hash256::fromHexString.
+    ///        This is Transaction::getHash() with its bytes reversed.
+    /// @param validUntilBlock The last block that may include the transaction
+    /// @return Resolves when the transaction is included or expired; fails with
+    ///         RpcException if fewer than minAccepted nodes took it
+    std::future<BroadcastResult> broadcast(const std::string& base64Transaction, const Hash256& hash,
+                                           uint32_t validUntilBlock);
+
+    /// Match a block against the pending transactions. Called for every block of the
+    /// watcher; blocks seen twice are harmless.
+    /// @param block The block as returned by getblock with verbose output
+    void onBlock(const nlohmann::json& block);
+
+    /// Get the number of transactions waiting for inclusion
+    size_t getPendingCount() const;
+
+    /// Get the number of nodes
+    size_t getNodeCount() const { return nodes_.size(); }
+
+    /// Get the block watcher
+    SharedPtr<BlockPolling> getWatcher() const { return watcher_; }
+
+private:
+    /// Pending transactions and the node transports, shared with reply callbacks
+    /// that may outlive the broadcaster
+    struct State;
+
+    std::vector<SharedPtr<NeoRpcClient>> nodes_;
+    SharedPtr<BlockPolling> watcher_;
+    bool ownsWatcher_;
+    uint64_t subscriptionId_;
+    SharedPtr<State> state_;
+
+    /// Subscribe to the watcher's blocks
+    void watch();
+};
+
+} // namespace neocpp
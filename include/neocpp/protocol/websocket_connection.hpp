@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace neocpp {
+
+/// Minimal RFC 6455 WebSocket client for JSON-RPC subscriptions: text messages,
+/// fragmentation, ping/pong and the closing handshake, over ws:// or wss:// (TLS with
+/// certificate and host name verification through OpenSSL).
+///
+/// One thread reads with receive(); sendText() may be called from any thread.
+/// interrupt() may also be called from any thread and makes a blocked receive()
+/// return, after which the reading thread calls close().
+class WebSocketConnection {
+public:
+    /// Result of waiting for a message
+    enum class ReadResult {
+        Message,   ///< A complete text or binary message was received
+        Timeout,   ///< No complete message arrived in time
+        Closed     ///< The connection is closed
+    };
+
+    /// Largest message accepted; bigger ones close the connection
+    static constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    /// Constructor
+    WebSocketConnection();
+
+    /// Destructor
+    ~WebSocketConnection();
+
+    WebSocketConnection(const WebSocketConnection&) = delete;
+    WebSocketConnection& operator=(const WebSocketConnection&) = delete;
+
+    /// Connect and perform the opening handshake
+    /// @param url The ws:// or wss:// URL
+    /// @param timeout The time allowed for connecting and for the handshake
+    /// @throws IllegalArgumentException if the URL is not a WebSocket URL
+    /// @throws NetworkException if the connection fails or the upgrade fails temporarily
+    /// @throws UnsupportedOperationException if the server refuses to upgrade, e.g. with 404 or 426
+    void connect(const std::string& url, std::chrono::milliseconds timeout);
+
+    /// Check whether the connection is open
+    bool isOpen() const { return open_; }
+
+    /// Send a text message
+    /// @param text The message
+    /// @throws NetworkException if the connection is closed or the write fails
+    void sendText(const std::string& text);
+
+    /// Send a ping; the server's pong is consumed by receive()
+    void ping();
+
+    /// Wait for the next message. Pings are answered while waiting.
+    /// @param message Receives the message
+    /// @param timeout The longest time to wait
+    /// @return Whether a message arrived, the wait timed out or the connection closed
+    ReadResult receive(std::string& message, std::chrono::milliseconds timeout);
+
+    /// Make a blocked receive() return Closed; safe to call from any thread
+    void interrupt();
+
+    /// Send a close frame if still open and release the socket
+    void close();
+
+private:
+    struct Tls;
+
+    int fd_;
+    Tls* tls_;
+    std::atomic<bool> open_;
+    std::mutex writeMutex_;
+    std::mutex fdMutex_;
+    std::string buffer_;
+    std::string fragments_;
+
+    /// Read what is available into the buffer
+    /// @return False once the connection is closed
+    bool fill(std::chrono::milliseconds timeout);
+
+    /// Read from the socket or the TLS session
+    long readSome(char* data, size_t size);
+
+    /// Write everything, under the write lock
+    void writeAll(const std::string& data);
+
+    /// Send one masked frame
+    void sendFrame(uint8_t opcode, const std::string& payload);
+
+    /// Perform the HTTP upgrade
+    void handshake(const std::string& host, const std::string& path);
+};
+
+} // namespace neocpp
@@ -3,7 +3,9 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <array>
 #include "neocpp/types/types.hpp"
+#include "neocpp/neo_constants.hpp"
 #include "neocpp/script/op_code.hpp"
 
 namespace neocpp {
@@ -101,6 +103,16 @@ public:
     static Bytes buildVerificationScript(const Bytes& encodedPublicKey);
     static Bytes buildVerificationScript(const SharedPtr<ECPublicKey>& publicKey);
     
+    /// Size of the verification script of a single compressed public key:
+    /// the pushed key followed by SYSCALL System.Crypto.CheckSig
+    static constexpr size_t SINGLE_SIG_VERIFICATION_SCRIPT_SIZE = 1 + NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED + 5;
+    
+    /// Build the verification script of a single compressed public key without allocating
+    /// @param encodedPublicKey The compressed public key (33 bytes)
+    /// @param script Receives the verification script, the same as buildVerificationScript() returns
+    static void buildVerificationScript(const uint8_t* encodedPublicKey,
+                                        std::array<uint8_t, SINGLE_SIG_VERIFICATION_SCRIPT_SIZE>& script);
+    
     /// Build a multi-signature verification script
     /// @param publicKeys The public keys
     /// @param signingThreshold The minimum number of signatures required
@@ -9,16 +9,43 @@
 
 namespace neocpp {
 
-/// Binary writer for Neo serialization
+class Sha256Hasher;
+
+/// Binary writer for Neo serialization.
+///
+/// Writes go to an internal buffer, to a stream, or into a Sha256Hasher. A hashing
+/// writer hashes while serializing: it only collects small writes in a buffer of
+/// HASH_CHUNK_SIZE bytes and passes large ones straight to the hasher, so the
+/// serialized form is never held in memory as a whole.
 class BinaryWriter {
 private:
     std::vector<uint8_t> buffer_;
     std::ostream* stream_;
+    Sha256Hasher* hasher_;
+    
+    /// Pass the buffered bytes on to the hasher
+    void flushToHasher();
     
 public:
-    BinaryWriter() : stream_(nullptr) {}
-    explicit BinaryWriter(std::ostream& stream) : stream_(&stream) {}
-    ~BinaryWriter() = default;
+    /// Bytes a hashing writer collects before passing them on to its hasher
+    static constexpr size_t HASH_CHUNK_SIZE = 256;
+    
+    BinaryWriter() : stream_(nullptr), hasher_(nullptr) {}
+    explicit BinaryWriter(std::ostream& stream) : stream_(&stream), hasher_(nullptr) {}
+    
+    /// Constructor for a writer that hashes what is written. Call flush() (or destroy
+    /// the writer) before finalizing the hasher.
+    /// @param hasher The hasher, which must outlive the writer
+    explicit BinaryWriter(Sha256Hasher& hasher);
+    
+    /// Destructor; flushes a hashing writer
+    ~BinaryWriter();
+    
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
+    
+    /// Pass everything written so far on to the hasher of a hashing writer
+    void flush();
     
     /// Write a single byte
     void writeByte(uint8_t value);
@@ -67,7 +94,7 @@ public:
         }
     }
     
-    /// Get the written bytes
+    /// Get the written bytes (not available for stream and hashing writers)
     const Bytes& toArray() const { return buffer_; }
     
     /// Get the current size of the buffer
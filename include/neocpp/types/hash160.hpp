@@ -68,6 +68,11 @@ public:
     /// @return The address corresponding to this script hash
     std::string toAddress() const;
     
+    /// Writes the address corresponding to this script hash. Reusing the string across
+    /// calls avoids allocating once it has grown to address length.
+    /// @param address Receives the address
+    void toAddress(std::string& address) const;
+    
     /// Creates a script hash from the given address.
     /// @param address The address from which to derive the script hash
     /// @return The script hash
@@ -78,12 +83,19 @@ public:
     /// @return The script hash
     static Hash160 fromScript(const Bytes& script);
     
+    /// Creates a script hash from the given script without allocating.
+    /// @param script The script to calculate the script hash for
+    /// @param length The size of the script in bytes
+    /// @return The script hash
+    static Hash160 fromScript(const uint8_t* script, size_t length);
+    
     /// Creates a script hash from the given script in hexadecimal string form.
     /// @param script The script to calculate the script hash for
     /// @return The script hash
     static Hash160 fromScript(const std::string& script);
     
-    /// Creates a script hash from the given public key.
+    /// Creates a script hash from the given public key. Compressed keys are hashed
+    /// without allocating.
     /// @param encodedPublicKey The encoded public key
     /// @return The script hash
     static Hash160 fromPublicKey(const Bytes& encodedPublicKey);
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <array>
 #include "neocpp/types/types.hpp"
+#include "neocpp/neo_constants.hpp"
 
 namespace neocpp {
 
@@ -13,6 +15,13 @@ public:
     /// @return The Neo address
     static std::string scriptHashToAddress(const Bytes& scriptHash);
     
+    /// Convert a script hash to an address without allocating once the output
+    /// string has grown to address length
+    /// @param scriptHash The script hash in big-endian order
+    /// @param address Receives the Neo address
+    static void scriptHashToAddress(const std::array<uint8_t, NeoConstants::HASH160_SIZE>& scriptHash,
+                                    std::string& address);
+    
     /// Convert an address to a script hash
     /// @param address The Neo address
     /// @return The script hash in big-endian order
@@ -14,6 +14,13 @@ public:
     /// @return The Base58 encoded string
     static std::string encode(const Bytes& data);
     
+    /// Encode bytes to a Base58 string, reusing the string's storage. Inputs of up to
+    /// 64 bytes are encoded without allocating once the string has grown large enough.
+    /// @param data The data to encode
+    /// @param length The number of bytes to encode
+    /// @param encoded Receives the Base58 encoded string
+    static void encode(const uint8_t* data, size_t length, std::string& encoded);
+    
     /// Decode Base58 string to bytes
     /// @param encoded The Base58 encoded string
     /// @return The decoded bytes
@@ -24,6 +31,12 @@ public:
     /// @return The Base58Check encoded string
     static std::string encodeCheck(const Bytes& data);
     
+    /// Encode bytes to a Base58Check string, reusing the string's storage like encode()
+    /// @param data The data to encode
+    /// @param length The number of bytes to encode
+    /// @param encoded Receives the Base58Check encoded string
+    static void encodeCheck(const uint8_t* data, size_t length, std::string& encoded);
+    
     /// Decode Base58Check string to bytes (verifies checksum)
     /// @param encoded The Base58Check encoded string
     /// @return The decoded bytes
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "neocpp/exceptions.hpp"
+
+namespace neocpp {
+
+/// Bounded lock-free queue for any number of producers and consumers
+/// (Vyukov's array-based MPMC queue). Each cell carries a sequence number telling
+/// producers and consumers whose turn it is, so neither side ever takes a lock.
+/// @tparam T The element type; must be default constructible and movable
+template <typename T>
+class BoundedQueue {
+public:
+    /// Constructor
+    /// @param capacity The maximum number of elements, rounded up to a power of two
+    /// @throws IllegalArgumentException if the capacity is zero
+    explicit BoundedQueue(size_t capacity) {
+        if (capacity == 0) {
+            throw IllegalArgumentException("Queue capacity must be positive");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_.store(0, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /// Append an element unless the queue is full
+    /// @param value The element
+    /// @return False if the queue is full; the value is left untouched then
+    bool tryPush(T& value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Remove the oldest element unless the queue is empty
+    /// @param value Receives the element
+    /// @return False if the queue is empty
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Get the number of elements; only a snapshot while other threads use the queue
+    size_t size() const {
+        size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+        size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /// Check whether the queue is empty; only a snapshot while other threads use the queue
+    bool empty() const { return size() == 0; }
+
+    /// Get the maximum number of elements
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // Producers and consumers work on separate cache lines
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(CACHE_LINE) std::atomic<size_t> enqueuePos_;
+    alignas(CACHE_LINE) std::atomic<size_t> dequeuePos_;
+};
+
+} // namespace neocpp
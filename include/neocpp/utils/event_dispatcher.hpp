@@ -0,0 +1,366 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "neocpp/types/types.hpp"
+#include "neocpp/utils/bounded_queue.hpp"
+#include "neocpp/utils/histogram.hpp"
+#include "neocpp/utils/thread_pool.hpp"
+#include "neocpp/exceptions.hpp"
+
+namespace neocpp {
+
+/// What publishing does when a subscriber's queue is full
+enum class OverflowPolicy {
+    Block,        ///< Wait until the subscriber made room; nothing is lost
+    DropOldest,   ///< Discard the oldest queued event
+    Coalesce      ///< Keep only the newest of the events that did not fit
+};
+
+/// Queue settings of one subscriber
+struct SubscriberOptions {
+    /// Default queue capacity
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+    /// Maximum number of queued events (rounded up to a power of two)
+    size_t queueCapacity = DEFAULT_QUEUE_CAPACITY;
+
+    /// Policy when the queue is full
+    OverflowPolicy overflow = OverflowPolicy::Block;
+};
+
+/// Snapshot of one subscriber's metrics
+struct SubscriberStats {
+    size_t queueDepth = 0;         ///< Events waiting for the subscriber
+    size_t queueCapacity = 0;      ///< Capacity of the queue
+    uint64_t delivered = 0;        ///< Events handed to the subscriber
+    uint64_t dropped = 0;          ///< Events discarded by DropOldest or Coalesce
+    uint64_t lastLagMicros = 0;    ///< Time the last delivered event spent queued
+    uint64_t p99LagMicros = 0;     ///< Upper bound of the 99th percentile of that time
+    uint64_t maxLagMicros = 0;     ///< Longest time an event spent queued
+};
+
+/// Delivers events to subscribers on a thread pool, so that a slow subscriber does
+/// not hold up the publisher or the other subscribers.
+///
+/// Every subscriber has a bounded lock-free queue and receives its events one at a
+/// time, in publishing order; different subscribers run in parallel on the pool.
+/// When a queue is full, the subscriber's overflow policy decides whether publish()
+/// waits (backpressure), drops the oldest event, or coalesces the overflow into the
+/// newest event. Subscribing and unsubscribing are safe while events are published.
+/// @tparam Event The event type; must be default constructible and copyable
+template <typename Event>
+class EventDispatcher {
+public:
+    /// Receives an event
+    using Handler = std::function<void(const Event&)>;
+
+    /// Constructor
+    /// @param pool The pool running the subscribers
+    explicit EventDispatcher(const SharedPtr<ThreadPool>& pool) : pool_(pool), nextId_(1) {
+        if (!pool_) {
+            throw IllegalArgumentException("Dispatcher thread pool cannot be null");
+        }
+    }
+
+    /// Destructor; unsubscribes everyone
+    ~EventDispatcher() {
+        clear();
+    }
+
+    EventDispatcher(const EventDispatcher&) = delete;
+    EventDispatcher& operator=(const EventDispatcher&) = delete;
+
+    /// Add a subscriber
+    /// @param handler Called with each event published from now on
+    /// @param options The queue settings
+    /// @return The subscriber ID
+    uint64_t subscribe(Handler handler, const SubscriberOptions& options = SubscriberOptions()) {
+        if (!handler) {
+            throw IllegalArgumentException("Event handler cannot be empty");
+        }
+        auto subscriber = std::make_shared<Subscriber>(std::move(handler), options);
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t id = nextId_++;
+        subscribers_[id] = subscriber;
+        return id;
+    }
+
+    /// Remove a subscriber. Queued events are discarded; a running handler is waited
+    /// for, unless called from that handler.
+    /// @param id The subscriber ID
+    void unsubscribe(uint64_t id) {
+        SharedPtr<Subscriber> subscriber;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = subscribers_.find(id);
+            if (it == subscribers_.end()) {
+                return;
+            }
+            subscriber = it->second;
+            subscribers_.erase(it);
+        }
+        subscriber->close();
+    }
+
+    /// Remove all subscribers
+    void clear() {
+        std::map<uint64_t, SharedPtr<Subscriber>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers.swap(subscribers_);
+        }
+        for (auto& entry : subscribers) {
+            entry.second->close();
+        }
+    }
+
+    /// Queue an event for every subscriber. Blocks only while a subscriber with the
+    /// Block policy has a full queue.
+    /// @param event The event
+    void publish(const Event& event) {
+        std::vector<SharedPtr<Subscriber>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers.reserve(subscribers_.size());
+            for (const auto& entry : subscribers_) {
+                subscribers.push_back(entry.second);
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& subscriber : subscribers) {
+            if (subscriber->enqueue(Entry{event, now})) {
+                schedule(subscriber);
+            }
+        }
+    }
+
+    /// Wait until every queued event has been handled
+    /// @param timeout The longest time to wait
+    /// @return False if events were still pending after the timeout
+    bool waitIdle(std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<SharedPtr<Subscriber>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : subscribers_) {
+                subscribers.push_back(entry.second);
+            }
+        }
+        for (const auto& subscriber : subscribers) {
+            std::unique_lock<std::mutex> lock(subscriber->mutex);
+            if (!subscriber->changed.wait_until(lock, deadline, [&subscriber]() { return subscriber->idle(); })) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Get the number of subscribers
+    size_t getSubscriberCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return subscribers_.size();
+    }
+
+    /// Get the metrics of a subscriber
+    /// @param id The subscriber ID
+    /// @return The metrics
+    /// @throws IllegalArgumentException if there is no such subscriber
+    SubscriberStats getStats(uint64_t id) const {
+        SharedPtr<Subscriber> subscriber;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = subscribers_.find(id);
+            if (it == subscribers_.end()) {
+                throw IllegalArgumentException("Unknown subscriber " + std::to_string(id));
+            }
+            subscriber = it->second;
+        }
+        SubscriberStats stats;
+        stats.queueDepth = subscriber->queue.size() + (subscriber->hasCoalesced ? 1 : 0);
+        stats.queueCapacity = subscriber->queue.capacity();
+        stats.delivered = subscriber->delivered;
+        stats.dropped = subscriber->dropped;
+        stats.lastLagMicros = subscriber->lastLagMicros;
+        stats.p99LagMicros = subscriber->lag.getPercentile(99);
+        stats.maxLagMicros = subscriber->lag.getMax();
+        return stats;
+    }
+
+private:
+    /// A queued event
+    struct Entry {
+        Event event;
+        std::chrono::steady_clock::time_point published;
+    };
+
+    /// Events handled per pool task before yielding to other subscribers
+    static constexpr size_t BURST = 64;
+
+    /// State of one subscriber, shared with its queued pool tasks
+    struct Subscriber {
+        Handler handler;
+        OverflowPolicy overflow;
+        BoundedQueue<Entry> queue;
+
+        std::atomic<bool> scheduled{false};
+        std::atomic<bool> closed{false};
+        std::atomic<bool> hasCoalesced{false};
+        std::atomic<uint64_t> delivered{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> lastLagMicros{0};
+        Histogram lag;
+
+        std::mutex coalesceMutex;   ///< Guards the coalesced event; used by Coalesce only
+        Entry coalesced;
+        std::mutex deliverMutex;    ///< Held while the handler runs
+        std::atomic<std::thread::id> deliveringThread{std::thread::id()};
+        std::mutex mutex;           ///< Used with changed, to wait for room or for idleness
+        std::condition_variable changed;
+
+        Subscriber(Handler h, const SubscriberOptions& options)
+            : handler(std::move(h)), overflow(options.overflow), queue(options.queueCapacity) {}
+
+        bool idle() const {
+            return closed || (!scheduled && queue.empty() && !hasCoalesced);
+        }
+
+        /// Queue an event according to the overflow policy
+        /// @return False if the subscriber is closed
+        bool enqueue(Entry entry) {
+            if (closed) {
+                return false;
+            }
+            switch (overflow) {
+                case OverflowPolicy::Block:
+                    while (!queue.tryPush(entry)) {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait_for(lock, std::chrono::milliseconds(1));
+                        if (closed) {
+                            return false;
+                        }
+                    }
+                    return true;
+                case OverflowPolicy::DropOldest:
+                    while (!queue.tryPush(entry)) {
+                        Entry oldest;
+                        if (queue.tryPop(oldest)) {
+                            dropped++;
+                        }
+                    }
+                    return true;
+                case OverflowPolicy::Coalesce: {
+                    // Once events overflow, newer ones replace the overflowed one until the
+                    // queue is drained, so order is kept and the newest event is delivered
+                    std::lock_guard<std::mutex> lock(coalesceMutex);
+                    if (hasCoalesced) {
+                        coalesced = std::move(entry);
+                        dropped++;
+                    } else if (!queue.tryPush(entry)) {
+                        coalesced = std::move(entry);
+                        hasCoalesced = true;
+                    }
+                    return true;
+                }
+            }
+            return true;
+        }
+
+        /// Take the next event in order
+        bool next(Entry& entry) {
+            if (queue.tryPop(entry)) {
+                return true;
+            }
+            if (!hasCoalesced) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(coalesceMutex);
+            if (queue.tryPop(entry)) {
+                return true;
+            }
+            if (!hasCoalesced) {
+                return false;
+            }
+            entry = std::move(coalesced);
+            coalesced = Entry();
+            hasCoalesced = false;
+            return true;
+        }
+
+        /// Hand queued events to the handler
+        void drain() {
+            for (size_t handled = 0; handled < BURST && !closed; ++handled) {
+                Entry entry;
+                if (!next(entry)) {
+                    break;
+                }
+                changed.notify_all();
+                std::lock_guard<std::mutex> lock(deliverMutex);
+                if (closed) {
+                    break;
+                }
+                auto lagMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - entry.published).count();
+                lastLagMicros = static_cast<uint64_t>(lagMicros);
+                lag.record(static_cast<uint64_t>(lagMicros));
+                deliveringThread = std::this_thread::get_id();
+                try {
+                    handler(entry.event);
+                } catch (...) {
+                    // Ignore handler errors
+                }
+                deliveringThread = std::thread::id();
+                delivered++;
+            }
+        }
+
+        /// Stop delivering; waits for a running handler unless called from it
+        void close() {
+            closed = true;
+            changed.notify_all();
+            if (deliveringThread != std::this_thread::get_id()) {
+                std::lock_guard<std::mutex> lock(deliverMutex);
+            }
+        }
+    };
+
+    SharedPtr<ThreadPool> pool_;
+    mutable std::mutex mutex_;
+    std::map<uint64_t, SharedPtr<Subscriber>> subscribers_;
+    uint64_t nextId_;
+
+    /// Make sure a pool task drains the subscriber's queue
+    void schedule(const SharedPtr<Subscriber>& subscriber) {
+        if (subscriber->scheduled.exchange(true)) {
+            return;
+        }
+        // The pool outlives its queued tasks, so they need no reference to it
+        ThreadPool* pool = pool_.get();
+        pool->submit([subscriber, pool]() { run(subscriber, pool); });
+    }
+
+    /// Pool task: drain a burst, then hand the pool to others and continue later
+    static void run(const SharedPtr<Subscriber>& subscriber, ThreadPool* pool) {
+        subscriber->drain();
+        subscriber->scheduled = false;
+        if (!subscriber->closed && (!subscriber->queue.empty() || subscriber->hasCoalesced) &&
+            !subscriber->scheduled.exchange(true)) {
+            pool->submit([subscriber, pool]() { run(subscriber, pool); });
+            return;
+        }
+        {
+            // Pairs with the waiting side of waitIdle() and Block
+            std::lock_guard<std::mutex> lock(subscriber->mutex);
+        }
+        subscriber->changed.notify_all();
+    }
+};
+
+} // namespace neocpp
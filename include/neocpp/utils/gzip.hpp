@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+namespace neocpp {
+
+/// gzip compression utilities (available when built with zlib)
+class Gzip {
+public:
+    /// Check whether gzip support was compiled in
+    static bool isAvailable();
+    
+    /// Compress data into the gzip format
+    /// @param data The data to compress
+    /// @param level The zlib compression level (1 fastest to 9 smallest, -1 for the default)
+    /// @return The gzip stream
+    /// @throws IllegalStateException if zlib is not available
+    static std::string compress(const std::string& data, int level = -1);
+    
+    /// Decompress a gzip or zlib stream
+    /// @param data The compressed data
+    /// @return The original data
+    /// @throws IllegalArgumentException if the data is not a valid stream
+    static std::string decompress(const std::string& data);
+};
+
+} // namespace neocpp
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace neocpp {
+
+/// Thread-safe histogram with power-of-two buckets, for latency and size metrics.
+/// Bucket 0 counts zeros; bucket i counts values in [2^(i-1), 2^i).
+class Histogram {
+public:
+    /// Number of buckets
+    static constexpr size_t BUCKET_COUNT = 65;
+    
+    /// Constructor
+    Histogram();
+    
+    /// Record a value
+    /// @param value The value
+    void record(uint64_t value);
+    
+    /// Get the number of recorded values
+    uint64_t getCount() const { return count_; }
+    
+    /// Get the sum of recorded values
+    uint64_t getSum() const { return sum_; }
+    
+    /// Get the largest recorded value
+    uint64_t getMax() const { return max_; }
+    
+    /// Get the mean of recorded values
+    double getMean() const;
+    
+    /// Get an upper bound for a percentile
+    /// @param percentile The percentile in [0, 100]
+    /// @return The upper bound of the bucket holding the percentile (0 if empty)
+    uint64_t getPercentile(double percentile) const;
+    
+    /// Get the count of one bucket
+    /// @param index The bucket index
+    uint64_t getBucketCount(size_t index) const { return buckets_[index]; }
+    
+    /// Get the inclusive upper bound of one bucket
+    /// @param index The bucket index
+    static uint64_t getBucketUpperBound(size_t index);
+    
+    /// Add the values recorded by another histogram
+    /// @param other The histogram to add
+    void merge(const Histogram& other);
+    
+    /// Clear all recorded values
+    void reset();
+    
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+    
+    /// Get the bucket index for a value
+    static size_t bucketFor(uint64_t value);
+};
+
+} // namespace neocpp
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <memory>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+/// Fixed-size pool of worker threads executing queued tasks
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+    
+public:
+    /// Constructor
+    /// @param threads The number of worker threads (at least one)
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    
+    /// Destructor, runs the queued tasks and joins the workers
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /// Get the process-wide default pool
+    /// @return The shared pool
+    static SharedPtr<ThreadPool> getDefault();
+    
+    /// Queue a task; exceptions thrown by the task are discarded
+    /// @param task The task to run
+    void submit(std::function<void()> task);
+    
+    /// Queue a task and get its result as a future
+    /// @param task The task to run
+    /// @return Future holding the result or the exception thrown by the task
+    template<typename F>
+    auto enqueue(F task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        auto future = packaged->get_future();
+        submit([packaged]() { (*packaged)(); });
+        return future;
+    }
+    
+    /// Get the number of worker threads
+    size_t size() const { return workers_.size(); }
+    
+    /// Get the number of tasks waiting for a worker
+    size_t getQueueSize() const;
+    
+private:
+    /// Worker thread body
+    void workerLoop();
+};
+
+} // namespace neocpp
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include "neocpp/types/types.hpp"
+
+namespace neocpp {
+
+/// Runs short tasks after a delay on a single background thread
+class TimerQueue {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        uint64_t id;
+        std::function<void()> task;
+    };
+
+    using Timers = std::multimap<Clock::time_point, Timer>;
+
+    Timers timers_;
+    std::unordered_map<uint64_t, Timers::iterator> index_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    uint64_t nextId_;
+    bool stopping_;
+    std::thread thread_;
+
+public:
+    /// Constructor, starts the timer thread
+    TimerQueue();
+
+    /// Destructor, drops pending timers and joins the thread
+    ~TimerQueue();
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    /// Get the process-wide default timer queue
+    /// @return The shared queue
+    static SharedPtr<TimerQueue> getDefault();
+
+    /// Run a task once the delay has passed; exceptions thrown by the task are discarded
+    /// @param delay The delay
+    /// @param task The task, which should return quickly
+    /// @return Timer ID, for cancel()
+    uint64_t schedule(std::chrono::microseconds delay, std::function<void()> task);
+
+    /// Cancel a timer that has not fired yet
+    /// @param timerId The ID returned by schedule()
+    /// @return True if the timer was pending
+    bool cancel(uint64_t timerId);
+
+    /// Get the number of pending timers
+    size_t getPending();
+
+    /// Check whether the caller runs on the thread of any timer queue, i.e. inside a task
+    static bool isTimerThread();
+
+private:
+    /// Timer thread body
+    void run();
+};
+
+} // namespace neocpp
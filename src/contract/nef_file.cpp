@@ -4,6 +4,7 @@
 #include "neocpp/crypto/hash.hpp"
 #include "neocpp/utils/base64.hpp"
 #include "neocpp/exceptions.hpp"
+#include <array>
 #include <sstream>
 
 namespace neocpp {
@@ -21,54 +22,32 @@ void NefFile::setScript(const Bytes& script) {
     updateChecksum();
 }
 
-void NefFile::updateChecksum() {
-    // Serialize without checksum
-    std::stringstream ss;
-    BinaryWriter writer(ss);
-    writer.writeBytes(Bytes(magic_.begin(), magic_.end()));
-    writer.writeVarString(compiler_);
-    writer.writeVarString(version_);
-    writer.writeVarBytes(script_);
-    
-    // Get serialized data
-    std::string str = ss.str();
-    Bytes data(str.begin(), str.end());
-    
-    // Calculate SHA256 checksum
-    checksum_ = HashUtils::sha256(HashUtils::sha256(data));
+Bytes NefFile::calculateChecksum() const {
+    // Hash the fields without checksum while serializing them
+    Sha256Hasher hasher;
+    {
+        BinaryWriter writer(hasher);
+        writer.writeBytes(reinterpret_cast<const uint8_t*>(magic_.data()), magic_.size());
+        writer.writeVarString(compiler_);
+        writer.writeVarString(version_);
+        writer.writeVarBytes(script_);
+        writer.flush();
+    }
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> first;
+    hasher.finalize(first);
     
-    // Take first 4 bytes
-    checksum_.resize(4);
+    // The checksum is the first 4 bytes of the double SHA256
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::sha256(first.data(), first.size(), hash);
+    return Bytes(hash.begin(), hash.begin() + 4);
+}
+
+void NefFile::updateChecksum() {
+    checksum_ = calculateChecksum();
 }
 
 bool NefFile::verifyChecksum() const {
-    // Serialize without checksum
-    std::stringstream ss;
-    BinaryWriter writer(ss);
-    writer.writeBytes(Bytes(magic_.begin(), magic_.end()));
-    writer.writeVarString(compiler_);
-    writer.writeVarString(version_);
-    writer.writeVarBytes(script_);
-    
-    // Get serialized data
-    std::string str = ss.str();
-    Bytes data(str.begin(), str.end());
-    
-    // Calculate SHA256 checksum
-    auto calculated = HashUtils::sha256(HashUtils::sha256(data));
-    
-    // Compare first 4 bytes
-    if (checksum_.size() != 4) {
-        return false;
-    }
-    
-    for (size_t i = 0; i < 4; ++i) {
-        if (checksum_[i] != calculated[i]) {
-            return false;
-        }
-    }
-    
-    return true;
+    return checksum_.size() == 4 && checksum_ == calculateChecksum();
 }
 
 Bytes NefFile::toBytes() const {
@@ -5,25 +5,102 @@
 #include "neocpp/utils/hex.hpp"
 #include "neocpp/utils/address.hpp"
 #include "neocpp/script/script_builder.hpp"
+#include "neocpp/types/hash160.hpp"
 #include "neocpp/exceptions.hpp"
 #include <openssl/ec.h>
 #include <openssl/ecdsa.h>
 #include <openssl/evp.h>
 #include <openssl/bn.h>
 #include <openssl/obj_mac.h>
-#include <random>
-#include <cstring>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
 
 namespace neocpp {
 
-// ECPrivateKey implementation
+namespace {
+
+/// The secp256k1 group, created once and shared read-only by all keys
+const EC_GROUP* curveGroup() {
+    static const EC_GROUP* group = []() {
+        EC_GROUP* created = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        if (!created) {
+            throw CryptoException("Failed to create EC group");
+        }
+        return created;
+    }();
+    return group;
+}
 
-ECPrivateKey ECPrivateKey::generate() {
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
+/// The group order in big-endian bytes
+const std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE>& curveOrder() {
+    static const std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE> order = []() {
+        std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE> bytes{};
+        BN_bn2binpad(EC_GROUP_get0_order(curveGroup()), bytes.data(), static_cast<int>(bytes.size()));
+        return bytes;
+    }();
+    return order;
+}
+
+/// Scratch space for big number arithmetic, one per thread
+BN_CTX* threadContext() {
+    thread_local std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> context(BN_CTX_new(), BN_CTX_free);
+    if (!context) {
+        throw CryptoException("Failed to create BN_CTX");
+    }
+    return context.get();
+}
+
+/// Create an empty key on the shared group
+EC_KEY* newCurveKey() {
+    EC_KEY* eckey = EC_KEY_new();
+    if (!eckey || EC_KEY_set_group(eckey, curveGroup()) != 1) {
+        EC_KEY_free(eckey);
         throw CryptoException("Failed to create EC_KEY");
     }
+    return eckey;
+}
+
+/// Check that a private key is in [1, n-1]
+void validatePrivateKey(const std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE>& key) {
+    bool zero = std::all_of(key.begin(), key.end(), [](uint8_t byte) { return byte == 0; });
+    if (zero || std::memcmp(key.data(), curveOrder().data(), key.size()) >= 0) {
+        throw IllegalArgumentException("Invalid private key");
+    }
+}
+
+/// Get the native key of a lazily initialized member: the first one stored wins
+template <typename Native, typename Create>
+SharedPtr<const Native> lazyNative(SharedPtr<const Native>& slot, Create create) {
+    auto native = std::atomic_load(&slot);
+    if (native) {
+        return native;
+    }
+    SharedPtr<const Native> created = create();
+    SharedPtr<const Native> expected;
+    if (std::atomic_compare_exchange_strong(&slot, &expected, created)) {
+        return created;
+    }
+    return expected;
+}
+
+} // namespace
+
+// ECPrivateKey implementation
+
+/// The private key with its public point, and the derived public key
+struct ECPrivateKey::Native {
+    EC_KEY* eckey = nullptr;
+    SharedPtr<const ECPublicKey> publicKey;
+    
+    ~Native() {
+        EC_KEY_free(eckey);
+    }
+};
+
+ECPrivateKey ECPrivateKey::generate() {
+    EC_KEY* eckey = newCurveKey();
     
     if (EC_KEY_generate_key(eckey) != 1) {
         EC_KEY_free(eckey);
@@ -44,46 +121,64 @@ ECPrivateKey::ECPrivateKey(const Bytes& bytes) {
         throw IllegalArgumentException("Private key must be 32 bytes");
     }
     std::copy(bytes.begin(), bytes.end(), key_.begin());
-    
-    // Verify the private key is valid using OpenSSL
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
-        throw CryptoException("Failed to create EC_KEY");
-    }
-    
-    BIGNUM* priv_bn = BN_bin2bn(key_.data(), 32, nullptr);
-    if (!priv_bn || EC_KEY_set_private_key(eckey, priv_bn) != 1) {
-        if (priv_bn) BN_free(priv_bn);
-        EC_KEY_free(eckey);
-        throw IllegalArgumentException("Invalid private key");
-    }
-    
-    BN_free(priv_bn);
-    EC_KEY_free(eckey);
+    validatePrivateKey(key_);
 }
 
 ECPrivateKey::ECPrivateKey(const std::array<uint8_t, NeoConstants::PRIVATE_KEY_SIZE>& key) 
     : key_(key) {
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
-        throw CryptoException("Failed to create EC_KEY");
-    }
-    
-    BIGNUM* priv_bn = BN_bin2bn(key_.data(), 32, nullptr);
-    if (!priv_bn || EC_KEY_set_private_key(eckey, priv_bn) != 1) {
-        if (priv_bn) BN_free(priv_bn);
-        EC_KEY_free(eckey);
-        throw IllegalArgumentException("Invalid private key");
-    }
-    
-    BN_free(priv_bn);
-    EC_KEY_free(eckey);
+    validatePrivateKey(key_);
 }
 
 ECPrivateKey::ECPrivateKey(const std::string& hex) 
     : ECPrivateKey(ByteUtils::fromHex(hex)) {
 }
 
+ECPrivateKey::ECPrivateKey(const ECPrivateKey& other)
+    : key_(other.key_), native_(std::atomic_load(&other.native_)) {
+}
+
+ECPrivateKey& ECPrivateKey::operator=(const ECPrivateKey& other) {
+    if (this != &other) {
+        key_ = other.key_;
+        std::atomic_store(&native_, std::atomic_load(&other.native_));
+    }
+    return *this;
+}
+
+SharedPtr<const ECPrivateKey::Native> ECPrivateKey::getNative() const {
+    return lazyNative(native_, [this]() {
+        auto native = std::make_shared<Native>();
+        native->eckey = newCurveKey();
+        
+        BIGNUM* priv_bn = BN_bin2bn(key_.data(), 32, nullptr);
+        if (!priv_bn || EC_KEY_set_private_key(native->eckey, priv_bn) != 1) {
+            BN_clear_free(priv_bn);
+            throw CryptoException("Failed to set private key");
+        }
+        BN_clear_free(priv_bn);
+        
+        // Derive the public point once; signing and getPublicKey() reuse it
+        const EC_GROUP* group = curveGroup();
+        EC_POINT* pub_point = EC_POINT_new(group);
+        BN_CTX* ctx = threadContext();
+        if (!pub_point || !EC_POINT_mul(group, pub_point, EC_KEY_get0_private_key(native->eckey), nullptr, nullptr, ctx) ||
+            EC_KEY_set_public_key(native->eckey, pub_point) != 1) {
+            EC_POINT_free(pub_point);
+            throw CryptoException("Failed to generate public key");
+        }
+        
+        // Get compressed public key (33 bytes)
+        Bytes encoded(33);
+        size_t len = EC_POINT_point2oct(group, pub_point, POINT_CONVERSION_COMPRESSED, encoded.data(), encoded.size(), ctx);
+        EC_POINT_free(pub_point);
+        if (len != encoded.size()) {
+            throw CryptoException("Failed to encode public key");
+        }
+        native->publicKey = std::make_shared<ECPublicKey>(encoded);
+        return native;
+    });
+}
+
 Bytes ECPrivateKey::getBytes() const {
     return Bytes(key_.begin(), key_.end());
 }
@@ -93,65 +188,19 @@ std::string ECPrivateKey::toHex() const {
 }
 
 SharedPtr<ECPublicKey> ECPrivateKey::getPublicKey() const {
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
-        throw CryptoException("Failed to create EC_KEY");
-    }
-    
-    BIGNUM* priv_bn = BN_bin2bn(key_.data(), 32, nullptr);
-    if (!priv_bn || EC_KEY_set_private_key(eckey, priv_bn) != 1) {
-        if (priv_bn) BN_free(priv_bn);
-        EC_KEY_free(eckey);
-        throw CryptoException("Failed to set private key");
-    }
-    BN_free(priv_bn);
-    
-    // Generate public key from private key
-    const EC_GROUP* group = EC_KEY_get0_group(eckey);
-    EC_POINT* pub_point = EC_POINT_new(group);
-    BN_CTX* ctx = BN_CTX_new();
-    
-    if (!EC_POINT_mul(group, pub_point, EC_KEY_get0_private_key(eckey), nullptr, nullptr, ctx)) {
-        BN_CTX_free(ctx);
-        EC_POINT_free(pub_point);
-        EC_KEY_free(eckey);
-        throw CryptoException("Failed to generate public key");
-    }
-    
-    EC_KEY_set_public_key(eckey, pub_point);
-    
-    // Get compressed public key (33 bytes)
-    size_t len = 33;
-    Bytes encoded(len);
-    EC_POINT_point2oct(group, pub_point, POINT_CONVERSION_COMPRESSED, encoded.data(), len, ctx);
-    
-    BN_CTX_free(ctx);
-    EC_POINT_free(pub_point);
-    EC_KEY_free(eckey);
-    return std::make_shared<ECPublicKey>(encoded);
+    return std::make_shared<ECPublicKey>(*getNative()->publicKey);
 }
 
 SharedPtr<ECDSASignature> ECPrivateKey::sign(const Bytes& message) const {
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
-        throw CryptoException("Failed to create EC_KEY");
-    }
-    
-    BIGNUM* priv_bn = BN_bin2bn(key_.data(), 32, nullptr);
-    if (!priv_bn || EC_KEY_set_private_key(eckey, priv_bn) != 1) {
-        if (priv_bn) BN_free(priv_bn);
-        EC_KEY_free(eckey);
-        throw CryptoException("Failed to set private key");
-    }
-    BN_free(priv_bn);
+    auto native = getNative();
     
     // Hash the message
-    Bytes hash = HashUtils::sha256(message);
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::sha256(message.data(), message.size(), hash);
     
     // Sign the hash
-    ECDSA_SIG* sig = ECDSA_do_sign(hash.data(), hash.size(), eckey);
+    ECDSA_SIG* sig = ECDSA_do_sign(hash.data(), hash.size(), native->eckey);
     if (!sig) {
-        EC_KEY_free(eckey);
         throw SignException("Failed to sign message");
     }
     
@@ -166,12 +215,20 @@ SharedPtr<ECDSASignature> ECPrivateKey::sign(const Bytes& message) const {
     BN_bn2binpad(s, signature.data() + 32, 32);
     
     ECDSA_SIG_free(sig);
-    EC_KEY_free(eckey);
     return std::make_shared<ECDSASignature>(signature);
 }
 
 // ECPublicKey implementation
 
+/// The public point, parsed once for verification
+struct ECPublicKey::Native {
+    EC_KEY* eckey = nullptr;
+    
+    ~Native() {
+        EC_KEY_free(eckey);
+    }
+};
+
 ECPublicKey::ECPublicKey(const ECPoint& point) : point_(point) {
 }
 
@@ -181,6 +238,36 @@ ECPublicKey::ECPublicKey(const Bytes& encoded) : point_(encoded) {
 ECPublicKey::ECPublicKey(const std::string& hex) : point_(hex) {
 }
 
+ECPublicKey::ECPublicKey(const ECPublicKey& other)
+    : point_(other.point_), native_(std::atomic_load(&other.native_)) {
+}
+
+ECPublicKey& ECPublicKey::operator=(const ECPublicKey& other) {
+    if (this != &other) {
+        point_ = other.point_;
+        std::atomic_store(&native_, std::atomic_load(&other.native_));
+    }
+    return *this;
+}
+
+SharedPtr<const ECPublicKey::Native> ECPublicKey::getNative() const {
+    return lazyNative(native_, [this]() {
+        auto native = std::make_shared<Native>();
+        native->eckey = newCurveKey();
+        
+        const EC_GROUP* group = curveGroup();
+        EC_POINT* pub_point = EC_POINT_new(group);
+        const Bytes& encoded = point_.getEncoded();
+        if (!pub_point || !EC_POINT_oct2point(group, pub_point, encoded.data(), encoded.size(), threadContext()) ||
+            EC_KEY_set_public_key(native->eckey, pub_point) != 1) {
+            EC_POINT_free(pub_point);
+            throw CryptoException("Failed to parse public key");
+        }
+        EC_POINT_free(pub_point);
+        return native;
+    });
+}
+
 Bytes ECPublicKey::getEncoded() const {
     return point_.getEncodedCompressed();
 }
@@ -194,58 +281,56 @@ std::string ECPublicKey::toHex() const {
 }
 
 bool ECPublicKey::verify(const Bytes& message, const ECDSASignature& signature) const {
-    EC_KEY* eckey = EC_KEY_new_by_curve_name(NID_secp256k1);
-    if (!eckey) {
+    SharedPtr<const Native> native;
+    try {
+        native = getNative();
+    } catch (const CryptoException&) {
         return false;
     }
     
-    // Set public key
-    const EC_GROUP* group = EC_KEY_get0_group(eckey);
-    EC_POINT* pub_point = EC_POINT_new(group);
-    Bytes encoded = getEncoded();
-    
-    if (!EC_POINT_oct2point(group, pub_point, encoded.data(), encoded.size(), nullptr)) {
-        EC_POINT_free(pub_point);
-        EC_KEY_free(eckey);
-        return false;
-    }
-    
-    EC_KEY_set_public_key(eckey, pub_point);
-    EC_POINT_free(pub_point);
-    
     // Parse signature
     Bytes sigBytes = signature.getBytes();
     ECDSA_SIG* sig = ECDSA_SIG_new();
     if (!sig) {
-        EC_KEY_free(eckey);
         return false;
     }
     
     BIGNUM* r = BN_bin2bn(sigBytes.data(), 32, nullptr);
     BIGNUM* s = BN_bin2bn(sigBytes.data() + 32, 32, nullptr);
-    ECDSA_SIG_set0(sig, r, s);
+    if (!r || !s || ECDSA_SIG_set0(sig, r, s) != 1) {
+        BN_free(r);
+        BN_free(s);
+        ECDSA_SIG_free(sig);
+        return false;
+    }
     
     // Hash the message
-    Bytes hash = HashUtils::sha256(message);
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::sha256(message.data(), message.size(), hash);
     
     // Verify
-    int valid = ECDSA_do_verify(hash.data(), hash.size(), sig, eckey);
+    int valid = ECDSA_do_verify(hash.data(), hash.size(), sig, native->eckey);
     
     ECDSA_SIG_free(sig);
-    EC_KEY_free(eckey);
     return valid == 1;
 }
 
+/// The script hash of a public key, hashing its point's encoding in place when it
+/// is already compressed
+static Hash160 scriptHashOf(const ECPoint& point) {
+    const Bytes& encoded = point.getEncoded();
+    if (encoded.size() == NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED) {
+        return Hash160::fromPublicKey(encoded);
+    }
+    return Hash160::fromPublicKey(point.getEncodedCompressed());
+}
+
 Bytes ECPublicKey::getScriptHash() const {
-    Bytes script = ScriptBuilder::buildVerificationScript(std::make_shared<ECPublicKey>(*this));
-    // Hash the script and return as little-endian
-    Bytes hash = HashUtils::sha256ThenRipemd160(script);
-    std::reverse(hash.begin(), hash.end());
-    return hash;
+    return scriptHashOf(point_).toArray();
 }
 
 std::string ECPublicKey::getAddress() const {
-    return AddressUtils::scriptHashToAddress(getScriptHash());
+    return scriptHashOf(point_).toAddress();
 }
 
 bool ECPublicKey::operator==(const ECPublicKey& other) const {
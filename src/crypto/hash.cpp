@@ -1,68 +1,189 @@
 #include "neocpp/crypto/hash.hpp"
+#include "neocpp/exceptions.hpp"
 #include <openssl/sha.h>
 #include <openssl/ripemd.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
+#include <openssl/opensslv.h>
+#include <array>
 #include <cstring>
+#include <memory>
 
 namespace neocpp {
 
+namespace {
+
+/// The digests HashUtils computes
+enum Digest {
+    DIGEST_SHA256,
+    DIGEST_RIPEMD160,
+    DIGEST_SHA3_256,
+    DIGEST_COUNT
+};
+
+/// Fetch an algorithm explicitly, so that calls do not look it up in the providers
+/// again. Falls back to the implicit lookup if no loaded provider offers it
+/// (RIPEMD160 lived in the legacy provider before OpenSSL 3.0.7). OpenSSL 1.1
+/// has no providers and its built-in algorithms need no lookup.
+const EVP_MD* fetchDigest(const char* name, const EVP_MD* fallback) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MD* fetched = EVP_MD_fetch(nullptr, name, nullptr);
+    return fetched ? fetched : fallback;
+#else
+    (void)name;
+    return fallback;
+#endif
+}
+
+/// The fetched algorithms, shared by all threads for the life of the process
+const EVP_MD* digestAlgorithm(Digest digest) {
+    static const std::array<const EVP_MD*, DIGEST_COUNT> algorithms = {
+        fetchDigest("SHA256", EVP_sha256()),
+        fetchDigest("RIPEMD160", EVP_ripemd160()),
+        fetchDigest("SHA3-256", EVP_sha3_256())
+    };
+    return algorithms[digest];
+}
+
+struct ContextDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+
+/// The calling thread's context for a digest; reinitializing it with the same
+/// algorithm reuses its state instead of allocating
+EVP_MD_CTX* digestContext(Digest digest) {
+    thread_local std::array<std::unique_ptr<EVP_MD_CTX, ContextDeleter>, DIGEST_COUNT> contexts;
+    auto& context = contexts[digest];
+    if (!context) {
+        context.reset(EVP_MD_CTX_new());
+        if (!context) {
+            throw CryptoException("Failed to create digest context");
+        }
+    }
+    return context.get();
+}
+
+/// Hash a buffer into one of the digest's size
+void compute(Digest digest, const uint8_t* data, size_t length, uint8_t* hash) {
+    EVP_MD_CTX* ctx = digestContext(digest);
+    if (EVP_DigestInit_ex(ctx, digestAlgorithm(digest), nullptr) != 1 ||
+        EVP_DigestUpdate(ctx, data, length) != 1 ||
+        EVP_DigestFinal_ex(ctx, hash, nullptr) != 1) {
+        throw CryptoException("Failed to compute hash");
+    }
+}
+
+} // namespace
+
+void HashUtils::sha256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash) {
+    compute(DIGEST_SHA256, data, length, hash.data());
+}
+
+void HashUtils::doubleSha256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash) {
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> first;
+    sha256(data, length, first);
+    sha256(first.data(), first.size(), hash);
+}
+
+void HashUtils::ripemd160(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH160_SIZE>& hash) {
+    compute(DIGEST_RIPEMD160, data, length, hash.data());
+}
+
+void HashUtils::sha256ThenRipemd160(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH160_SIZE>& hash) {
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> first;
+    sha256(data, length, first);
+    ripemd160(first.data(), first.size(), hash);
+}
+
+void HashUtils::keccak256(const uint8_t* data, size_t length, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash) {
+    compute(DIGEST_SHA3_256, data, length, hash.data());
+}
+
 Bytes HashUtils::sha256(const Bytes& data) {
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    Bytes result(SHA256_DIGEST_LENGTH);
-    unsigned int len = SHA256_DIGEST_LENGTH;
-    
-    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
-    EVP_DigestUpdate(ctx, data.data(), data.size());
-    EVP_DigestFinal_ex(ctx, result.data(), &len);
-    
-    EVP_MD_CTX_free(ctx);
-    return result;
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    sha256(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.end());
 }
 
 Bytes HashUtils::doubleSha256(const Bytes& data) {
-    return sha256(sha256(data));
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    doubleSha256(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.end());
 }
 
 Bytes HashUtils::ripemd160(const Bytes& data) {
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    Bytes result(20); // RIPEMD160 produces 20 bytes
-    unsigned int len = 20;
-    
-    EVP_DigestInit_ex(ctx, EVP_ripemd160(), nullptr);
-    EVP_DigestUpdate(ctx, data.data(), data.size());
-    EVP_DigestFinal_ex(ctx, result.data(), &len);
-    
-    EVP_MD_CTX_free(ctx);
-    return result;
+    std::array<uint8_t, NeoConstants::HASH160_SIZE> hash;
+    ripemd160(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.end());
 }
 
 Bytes HashUtils::sha256ThenRipemd160(const Bytes& data) {
-    return ripemd160(sha256(data));
+    std::array<uint8_t, NeoConstants::HASH160_SIZE> hash;
+    sha256ThenRipemd160(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.end());
 }
 
 Bytes HashUtils::keccak256(const Bytes& data) {
-    Bytes result(32);
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    const EVP_MD* md = EVP_sha3_256();
-    
-    EVP_DigestInit_ex(ctx, md, nullptr);
-    EVP_DigestUpdate(ctx, data.data(), data.size());
-    unsigned int len = 32;
-    EVP_DigestFinal_ex(ctx, result.data(), &len);
-    
-    EVP_MD_CTX_free(ctx);
-    return result;
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    keccak256(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.end());
 }
 
 Bytes HashUtils::hmacSha256(const Bytes& key, const Bytes& data) {
     Bytes result(SHA256_DIGEST_LENGTH);
     unsigned int len = SHA256_DIGEST_LENGTH;
-    
-    HMAC(EVP_sha256(), key.data(), key.size(), 
+
+    HMAC(digestAlgorithm(DIGEST_SHA256), key.data(), key.size(),
          data.data(), data.size(), result.data(), &len);
-    
+
     return result;
 }
 
-} // namespace neocpp
\ No newline at end of file
+struct Sha256Hasher::Context {
+    std::unique_ptr<EVP_MD_CTX, ContextDeleter> ctx;
+};
+
+Sha256Hasher::Sha256Hasher() : context_(std::make_unique<Context>()) {
+    context_->ctx.reset(EVP_MD_CTX_new());
+    if (!context_->ctx) {
+        throw CryptoException("Failed to create digest context");
+    }
+    reset();
+}
+
+Sha256Hasher::~Sha256Hasher() = default;
+
+Sha256Hasher::Sha256Hasher(Sha256Hasher&& other) noexcept = default;
+
+Sha256Hasher& Sha256Hasher::operator=(Sha256Hasher&& other) noexcept = default;
+
+void Sha256Hasher::update(const uint8_t* data, size_t length) {
+    if (EVP_DigestUpdate(context_->ctx.get(), data, length) != 1) {
+        throw CryptoException("Failed to compute hash");
+    }
+}
+
+void Sha256Hasher::update(const Bytes& data) {
+    update(data.data(), data.size());
+}
+
+void Sha256Hasher::finalize(std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash) {
+    if (EVP_DigestFinal_ex(context_->ctx.get(), hash.data(), nullptr) != 1) {
+        throw CryptoException("Failed to compute hash");
+    }
+    reset();
+}
+
+Bytes Sha256Hasher::finalize() {
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    finalize(hash);
+    return Bytes(hash.begin(), hash.end());
+}
+
+void Sha256Hasher::reset() {
+    if (EVP_DigestInit_ex(context_->ctx.get(), digestAlgorithm(DIGEST_SHA256), nullptr) != 1) {
+        throw CryptoException("Failed to initialize hash");
+    }
+}
+
+} // namespace neocpp
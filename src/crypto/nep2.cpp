@@ -6,6 +6,7 @@
 #include "neocpp/exceptions.hpp"
 #include <openssl/evp.h>
 #include <openssl/aes.h>
+#include <array>
 #include <cstring>
 
 namespace neocpp {
@@ -107,7 +108,8 @@ std::string NEP2::encrypt(const Bytes& privateKey, const std::string& password,
     // Get address for salt
     ECKeyPair keyPair(privateKey);
     std::string address = keyPair.getAddress();
-    Bytes addressHash = HashUtils::sha256(HashUtils::sha256(Bytes(address.begin(), address.end())));
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> addressHash;
+    HashUtils::doubleSha256(reinterpret_cast<const uint8_t*>(address.data()), address.size(), addressHash);
     Bytes salt(addressHash.begin(), addressHash.begin() + 4);
     
     // Derive key using scrypt
@@ -193,7 +195,8 @@ Bytes NEP2::decrypt(const std::string& nep2, const std::string& password, const
     try {
         ECKeyPair keyPair(privateKey);
         std::string address = keyPair.getAddress();
-        Bytes addressHash = HashUtils::sha256(HashUtils::sha256(Bytes(address.begin(), address.end())));
+        std::array<uint8_t, NeoConstants::HASH256_SIZE> addressHash;
+        HashUtils::doubleSha256(reinterpret_cast<const uint8_t*>(address.data()), address.size(), addressHash);
         
         // Verify salt matches
         for (size_t i = 0; i < 4; ++i) {
@@ -0,0 +1,424 @@
+#include "neocpp/crypto/hash.hpp"
+#include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NEOCPP_SHA256_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace neocpp {
+
+namespace {
+
+#ifdef NEOCPP_SHA256_X86
+
+constexpr size_t BLOCK_SIZE = 64;
+
+const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/// Number of 64-byte blocks of a message after padding
+size_t paddedBlockCount(size_t length) {
+    return (length + 9 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+/// Copy block `index` of a padded message: the message, a 0x80 byte, zeros, and the
+/// bit length in big-endian order at the end of the last block
+void paddedBlock(const uint8_t* data, size_t length, size_t index, uint8_t* block) {
+    size_t offset = index * BLOCK_SIZE;
+    if (offset + BLOCK_SIZE <= length) {
+        std::memcpy(block, data + offset, BLOCK_SIZE);
+        return;
+    }
+    std::memset(block, 0, BLOCK_SIZE);
+    if (offset < length) {
+        std::memcpy(block, data + offset, length - offset);
+    }
+    if (length >= offset) {
+        block[length - offset] = 0x80;
+    }
+    if (index == paddedBlockCount(length) - 1) {
+        uint64_t bits = static_cast<uint64_t>(length) * 8;
+        for (int i = 0; i < 8; ++i) {
+            block[BLOCK_SIZE - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+        }
+    }
+}
+
+void storeBigEndian(uint32_t value, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+struct CpuFeatures {
+    bool avx2 = false;
+    bool sha = false;
+};
+
+/// The features of the CPU, checked once with CPUID
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = [] {
+        // CPUID leaf 1 (ECX) and leaf 7 (EBX) feature bits
+        constexpr unsigned SSSE3 = 1u << 9;
+        constexpr unsigned SSE41 = 1u << 19;
+        constexpr unsigned OSXSAVE = 1u << 27;
+        constexpr unsigned AVX = 1u << 28;
+        constexpr unsigned AVX2 = 1u << 5;
+        constexpr unsigned SHA = 1u << 29;
+
+        CpuFeatures result;
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return result;
+        }
+        bool sse = (ecx & SSSE3) && (ecx & SSE41);
+        bool avx = false;
+        if ((ecx & OSXSAVE) && (ecx & AVX)) {
+            // The OS must save the YMM registers on context switches
+            uint32_t xcr0Low, xcr0High;
+            __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            avx = (xcr0Low & 6) == 6;
+        }
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            result.avx2 = avx && (ebx & AVX2);
+            result.sha = sse && (ebx & SHA);
+        }
+        return result;
+    }();
+    return features;
+}
+
+/// Messages the SHA extension kernel hashes side by side
+constexpr int SHA_NI_STREAMS = 2;
+
+/// SHA256 state of one message in the layout of the SHA extensions (ABEF and CDGH)
+struct ShaNiState {
+    __m128i abef;
+    __m128i cdgh;
+};
+
+__attribute__((target("sha,sse4.1")))
+inline ShaNiState loadShaNiState() {
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(INITIAL_STATE)), 0xB1);
+    __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(INITIAL_STATE + 4)), 0x1B);
+    return {_mm_alignr_epi8(tmp, efgh, 8), _mm_blend_epi16(efgh, tmp, 0xF0)};
+}
+
+__attribute__((target("sha,sse4.1")))
+inline void storeShaNiState(const ShaNiState& state, std::array<uint8_t, NeoConstants::HASH256_SIZE>& hash) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i feba = _mm_shuffle_epi32(state.abef, 0x1B);
+    __m128i dchg = _mm_shuffle_epi32(state.cdgh, 0xB1);
+    __m128i dcba = _mm_blend_epi16(feba, dchg, 0xF0);
+    __m128i hgfe = _mm_alignr_epi8(dchg, feba, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hash.data()), _mm_shuffle_epi8(dcba, byteSwap));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hash.data() + 16), _mm_shuffle_epi8(hgfe, byteSwap));
+}
+
+/// Compress one block into each of `Streams` states. The rounds of a single message
+/// form one dependency chain, so interleaving independent messages keeps the SHA
+/// units busy while each chain waits for its previous round.
+template <int Streams>
+__attribute__((target("sha,sse4.1")))
+inline void compressShaNi(ShaNiState* states, const uint8_t* const* blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    ShaNiState saved[Streams];
+    __m128i w[Streams][4];
+    for (int s = 0; s < Streams; ++s) {
+        saved[s] = states[s];
+    }
+
+    // 16 groups of four rounds; w holds the message words of four groups
+#pragma GCC unroll 16
+    for (int group = 0; group < 16; ++group) {
+        __m128i roundConstants = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ROUND_CONSTANTS + group * 4));
+        for (int s = 0; s < Streams; ++s) {
+            __m128i& current = w[s][group & 3];
+            if (group < 4) {
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks[s] + group * 16)),
+                                           byteSwap);
+            }
+            __m128i message = _mm_add_epi32(current, roundConstants);
+            states[s].cdgh = _mm_sha256rnds2_epu32(states[s].cdgh, states[s].abef, message);
+            if (group >= 3 && group <= 14) {
+                __m128i& next = w[s][(group + 1) & 3];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, w[s][(group + 3) & 3], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+            message = _mm_shuffle_epi32(message, 0x0E);
+            states[s].abef = _mm_sha256rnds2_epu32(states[s].abef, states[s].cdgh, message);
+            if (group >= 1 && group <= 12) {
+                __m128i& previous = w[s][(group + 3) & 3];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+    }
+
+    for (int s = 0; s < Streams; ++s) {
+        states[s].abef = _mm_add_epi32(states[s].abef, saved[s].abef);
+        states[s].cdgh = _mm_add_epi32(states[s].cdgh, saved[s].cdgh);
+    }
+}
+
+/// Where block `index` of a message is: in the message itself, or padded into `buffer`
+inline const uint8_t* blockOf(const uint8_t* data, size_t length, size_t index, uint8_t* buffer) {
+    if ((index + 1) * BLOCK_SIZE <= length) {
+        return data + index * BLOCK_SIZE;
+    }
+    paddedBlock(data, length, index, buffer);
+    return buffer;
+}
+
+/// Hash messages SHA_NI_STREAMS at a time, finishing the blocks that the longer ones
+/// have left on their own
+__attribute__((target("sha,sse4.1")))
+void batchShaNi(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes) {
+    uint8_t buffers[SHA_NI_STREAMS][BLOCK_SIZE];
+    const uint8_t* blocks[SHA_NI_STREAMS];
+    size_t m = 0;
+    for (; m + SHA_NI_STREAMS <= count; m += SHA_NI_STREAMS) {
+        ShaNiState states[SHA_NI_STREAMS];
+        size_t blockCounts[SHA_NI_STREAMS];
+        size_t shared = SIZE_MAX;
+        for (int s = 0; s < SHA_NI_STREAMS; ++s) {
+            states[s] = loadShaNiState();
+            blockCounts[s] = paddedBlockCount(lengths[m + s]);
+            shared = std::min(shared, blockCounts[s]);
+        }
+        for (size_t index = 0; index < shared; ++index) {
+            for (int s = 0; s < SHA_NI_STREAMS; ++s) {
+                blocks[s] = blockOf(messages[m + s], lengths[m + s], index, buffers[s]);
+            }
+            compressShaNi<SHA_NI_STREAMS>(states, blocks);
+        }
+        for (int s = 0; s < SHA_NI_STREAMS; ++s) {
+            for (size_t index = shared; index < blockCounts[s]; ++index) {
+                blocks[0] = blockOf(messages[m + s], lengths[m + s], index, buffers[0]);
+                compressShaNi<1>(&states[s], blocks);
+            }
+            storeShaNiState(states[s], hashes[m + s]);
+        }
+    }
+    for (; m < count; ++m) {
+        ShaNiState state = loadShaNiState();
+        for (size_t index = 0; index < paddedBlockCount(lengths[m]); ++index) {
+            blocks[0] = blockOf(messages[m], lengths[m], index, buffers[0]);
+            compressShaNi<1>(&state, blocks);
+        }
+        storeShaNiState(state, hashes[m]);
+    }
+}
+
+template <int N>
+__attribute__((target("avx2")))
+inline __m256i rotateRight(__m256i x) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+constexpr size_t LANES = 8;
+
+/// Hash up to eight messages, one per 32-bit lane. Lanes whose message has fewer
+/// blocks keep their state once it is finished.
+__attribute__((target("avx2")))
+void hashLanesAvx2(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                   std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes) {
+    size_t blockCounts[LANES] = {};
+    size_t maxBlocks = 0;
+    for (size_t lane = 0; lane < count; ++lane) {
+        blockCounts[lane] = paddedBlockCount(lengths[lane]);
+        maxBlocks = std::max(maxBlocks, blockCounts[lane]);
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi32(static_cast<int>(INITIAL_STATE[i]));
+    }
+
+    alignas(32) uint32_t words[16][LANES];
+    alignas(32) int32_t active[LANES];
+    uint8_t block[BLOCK_SIZE];
+    for (size_t index = 0; index < maxBlocks; ++index) {
+        // Transpose the lanes' blocks into big-endian message words
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            bool inBlock = lane < count && index < blockCounts[lane];
+            active[lane] = inBlock ? -1 : 0;
+            if (!inBlock) {
+                for (int t = 0; t < 16; ++t) {
+                    words[t][lane] = 0;
+                }
+                continue;
+            }
+            const uint8_t* source = blockOf(messages[lane], lengths[lane], index, block);
+            for (int t = 0; t < 16; ++t) {
+                uint32_t word;
+                std::memcpy(&word, source + t * 4, sizeof(word));
+                words[t][lane] = __builtin_bswap32(word);
+            }
+        }
+
+        __m256i w[16];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(words[t]));
+        }
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+#pragma GCC unroll 64
+        for (int round = 0; round < 64; ++round) {
+            if (round >= 16) {
+                __m256i w15 = w[(round - 15) & 15];
+                __m256i w2 = w[(round - 2) & 15];
+                __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotateRight<7>(w15), rotateRight<18>(w15)),
+                                                  _mm256_srli_epi32(w15, 3));
+                __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotateRight<17>(w2), rotateRight<19>(w2)),
+                                                  _mm256_srli_epi32(w2, 10));
+                w[round & 15] = _mm256_add_epi32(_mm256_add_epi32(w[round & 15], sigma0),
+                                                 _mm256_add_epi32(w[(round - 7) & 15], sigma1));
+            }
+            __m256i bigSigma1 = _mm256_xor_si256(_mm256_xor_si256(rotateRight<6>(e), rotateRight<11>(e)),
+                                                 rotateRight<25>(e));
+            __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, bigSigma1),
+                                          _mm256_add_epi32(choose, _mm256_add_epi32(w[round & 15],
+                                              _mm256_set1_epi32(static_cast<int>(ROUND_CONSTANTS[round])))));
+            __m256i bigSigma0 = _mm256_xor_si256(_mm256_xor_si256(rotateRight<2>(a), rotateRight<13>(a)),
+                                                 rotateRight<22>(a));
+            __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            __m256i t2 = _mm256_add_epi32(bigSigma0, majority);
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(t1, t2);
+        }
+
+        __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(active));
+        __m256i working[8] = {a, b, c, d, e, f, g, h};
+        for (int i = 0; i < 8; ++i) {
+            state[i] = _mm256_blendv_epi8(state[i], _mm256_add_epi32(state[i], working[i]), mask);
+        }
+    }
+
+    alignas(32) uint32_t lanes[8][LANES];
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[i]), state[i]);
+    }
+    for (size_t lane = 0; lane < count; ++lane) {
+        for (int i = 0; i < 8; ++i) {
+            storeBigEndian(lanes[i][lane], hashes[lane].data() + i * 4);
+        }
+    }
+}
+
+void batchAvx2(const uint8_t* const* messages, const size_t* lengths, size_t count,
+               std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes) {
+    for (size_t first = 0; first < count; first += LANES) {
+        hashLanesAvx2(messages + first, lengths + first, std::min(LANES, count - first), hashes + first);
+    }
+}
+
+#endif // NEOCPP_SHA256_X86
+
+void batchPortable(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                   std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes) {
+    for (size_t m = 0; m < count; ++m) {
+        HashUtils::sha256(messages[m], lengths[m], hashes[m]);
+    }
+}
+
+/// The kernel Auto stands for. The SHA extensions beat eight AVX2 lanes, which in turn
+/// beat OpenSSL's per-call overhead on small messages; sha256Batch() narrows AVX2 down
+/// to the batches where that holds.
+Sha256BatchKernel autoKernel() {
+#ifdef NEOCPP_SHA256_X86
+    if (cpuFeatures().sha) {
+        return Sha256BatchKernel::ShaNi;
+    }
+    if (cpuFeatures().avx2) {
+        return Sha256BatchKernel::Avx2;
+    }
+#endif
+    return Sha256BatchKernel::Portable;
+}
+
+} // namespace
+
+bool HashUtils::isSha256BatchKernelSupported(Sha256BatchKernel kernel) {
+    switch (kernel) {
+        case Sha256BatchKernel::Auto:
+        case Sha256BatchKernel::Portable:
+            return true;
+#ifdef NEOCPP_SHA256_X86
+        case Sha256BatchKernel::Avx2:
+            return cpuFeatures().avx2;
+        case Sha256BatchKernel::ShaNi:
+            return cpuFeatures().sha;
+#endif
+        default:
+            return false;
+    }
+}
+
+void HashUtils::sha256Batch(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                            std::array<uint8_t, NeoConstants::HASH256_SIZE>* hashes, Sha256BatchKernel kernel) {
+    if (!isSha256BatchKernelSupported(kernel)) {
+        throw IllegalArgumentException("SHA256 batch kernel is not supported by this CPU");
+    }
+    if (kernel == Sha256BatchKernel::Auto) {
+        static const Sha256BatchKernel selected = autoKernel();
+        kernel = selected;
+        // Eight AVX2 lanes only outrun OpenSSL's SHA256 on single-block messages
+        if (kernel == Sha256BatchKernel::Avx2
+            && !std::all_of(lengths, lengths + count, [](size_t length) { return paddedBlockCount(length) == 1; })) {
+            kernel = Sha256BatchKernel::Portable;
+        }
+    }
+    switch (kernel) {
+#ifdef NEOCPP_SHA256_X86
+        case Sha256BatchKernel::ShaNi:
+            batchShaNi(messages, lengths, count, hashes);
+            break;
+        case Sha256BatchKernel::Avx2:
+            batchAvx2(messages, lengths, count, hashes);
+            break;
+#endif
+        default:
+            batchPortable(messages, lengths, count, hashes);
+            break;
+    }
+}
+
+std::vector<std::array<uint8_t, NeoConstants::HASH256_SIZE>> HashUtils::sha256Batch(const std::vector<Bytes>& messages) {
+    std::vector<const uint8_t*> data(messages.size());
+    std::vector<size_t> lengths(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        data[i] = messages[i].data();
+        lengths[i] = messages[i].size();
+    }
+    std::vector<std::array<uint8_t, NeoConstants::HASH256_SIZE>> hashes(messages.size());
+    sha256Batch(data.data(), lengths.data(), messages.size(), hashes.data());
+    return hashes;
+}
+
+} // namespace neocpp
@@ -0,0 +1,127 @@
+#include "neocpp/protocol/aimd_limiter.hpp"
+#include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace neocpp {
+
+AimdLimiter::AimdLimiter(const AimdLimiterConfig& config)
+    : config_(config), inFlight_(0), minLatency_(Clock::duration::max()),
+      previousMinLatency_(Clock::duration::max()), windowStart_(Clock::now()) {
+    if (config.minLimit == 0 || config.minLimit > config.maxLimit) {
+        throw IllegalArgumentException("Limiter bounds must satisfy 0 < minLimit <= maxLimit");
+    }
+    if (config.backoffRatio <= 0.0 || config.backoffRatio >= 1.0) {
+        throw IllegalArgumentException("Limiter backoff ratio must be in (0, 1)");
+    }
+    if (config.minLatencyWindow.count() <= 0) {
+        throw IllegalArgumentException("Limiter latency window must be positive");
+    }
+    limit_ = static_cast<double>(std::clamp(config.initialLimit, config.minLimit, config.maxLimit));
+}
+
+void AimdLimiter::acquire(Task start) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (static_cast<double>(inFlight_) >= limit_) {
+            queue_.push_back(std::move(start));
+            return;
+        }
+        inFlight_++;
+    }
+    start();
+}
+
+void AimdLimiter::release(Clock::duration latency, bool dropped) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t inFlight = inFlight_--;
+        auto now = Clock::now();
+
+        // Start a new window; the one before is forgotten after two windows
+        if (now - windowStart_ >= config_.minLatencyWindow) {
+            bool idle = now - windowStart_ >= 2 * config_.minLatencyWindow;
+            previousMinLatency_ = idle ? Clock::duration::max() : minLatency_;
+            minLatency_ = Clock::duration::max();
+            windowStart_ = now;
+        }
+
+        auto fastest = std::min(minLatency_, previousMinLatency_);
+        bool overloaded = dropped;
+        if (!dropped) {
+            if (config_.latencyTarget.count() > 0) {
+                overloaded = latency > config_.latencyTarget;
+            } else if (fastest != Clock::duration::max()) {
+                overloaded = latency > std::chrono::duration_cast<Clock::duration>(fastest * config_.latencyTolerance);
+            }
+            minLatency_ = std::min(minLatency_, latency);
+        }
+
+        if (overloaded) {
+            // Requests started before the last decrease reflect the old limit. The round
+            // trip is the fastest recent one, since failures can return arbitrarily fast.
+            auto roundTrip = fastest != Clock::duration::max() ? fastest : latency;
+            if (now - lastDecrease_ >= roundTrip) {
+                limit_ = std::max(static_cast<double>(config_.minLimit), limit_ * config_.backoffRatio);
+                lastDecrease_ = now;
+            }
+        } else if (static_cast<double>(inFlight) * 2.0 >= limit_) {
+            // Only grow while the limit is actually being used
+            limit_ = std::min(static_cast<double>(config_.maxLimit), limit_ + 1.0 / limit_);
+        }
+    }
+    startQueued();
+}
+
+void AimdLimiter::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlight_--;
+    }
+    startQueued();
+}
+
+void AimdLimiter::startQueued() {
+    // Limiters draining their queue on this thread
+    static thread_local std::vector<const AimdLimiter*> draining;
+    if (std::find(draining.begin(), draining.end(), this) != draining.end()) {
+        return;
+    }
+    struct Guard {
+        const AimdLimiter* limiter;
+        ~Guard() { draining.erase(std::find(draining.begin(), draining.end(), limiter)); }
+    };
+    draining.push_back(this);
+    Guard guard{this};
+
+    while (true) {
+        Task start;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty() || static_cast<double>(inFlight_) >= limit_) {
+                return;
+            }
+            start = std::move(queue_.front());
+            queue_.pop_front();
+            inFlight_++;
+        }
+        start();
+    }
+}
+
+size_t AimdLimiter::getLimit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(limit_);
+}
+
+size_t AimdLimiter::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_;
+}
+
+size_t AimdLimiter::getQueued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+} // namespace neocpp
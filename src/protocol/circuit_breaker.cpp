@@ -0,0 +1,61 @@
+#include "neocpp/protocol/circuit_breaker.hpp"
+#include "neocpp/exceptions.hpp"
+
+namespace neocpp {
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config)
+    : config_(config), state_(State::Closed), failures_(0), trialInFlight_(false), rejected_(0) {
+    if (config.failureThreshold == 0) {
+        throw IllegalArgumentException("Circuit breaker failure threshold must be positive");
+    }
+}
+
+bool CircuitBreaker::allowRequest() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::Open && Clock::now() - openedAt_ >= config_.openDuration) {
+        state_ = State::HalfOpen;
+        trialInFlight_ = false;
+    }
+    if (state_ == State::Closed) {
+        return true;
+    }
+    if (state_ == State::HalfOpen && !trialInFlight_) {
+        trialInFlight_ = true;
+        return true;
+    }
+    rejected_++;
+    return false;
+}
+
+void CircuitBreaker::recordSuccess() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = State::Closed;
+    failures_ = 0;
+    trialInFlight_ = false;
+}
+
+void CircuitBreaker::recordFailure() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failures_++;
+    if (state_ == State::HalfOpen || (state_ == State::Closed && failures_ >= config_.failureThreshold)) {
+        state_ = State::Open;
+        openedAt_ = Clock::now();
+        trialInFlight_ = false;
+    }
+}
+
+void CircuitBreaker::recordAbandoned() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Let another trial through instead of waiting for an outcome that never comes
+    trialInFlight_ = false;
+}
+
+CircuitBreaker::State CircuitBreaker::getState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::Open && Clock::now() - openedAt_ >= config_.openDuration) {
+        return State::HalfOpen;
+    }
+    return state_;
+}
+
+} // namespace neocpp
@@ -0,0 +1,58 @@
+#include "neocpp/protocol/core/polling/adaptive_poll_schedule.hpp"
+#include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace neocpp {
+
+AdaptivePollSchedule::AdaptivePollSchedule(const AdaptivePollingConfig& config)
+    : config_(config), blockIntervalMs_(config.expectedBlockInterval.count()),
+      deviationMs_(config.expectedBlockInterval.count() / 10), lastBlockTimeMs_(-1),
+      lastIndex_(-1), lastDetectionLatency_(0) {
+    if (config.minInterval.count() <= 0 || config.maxInterval < config.minInterval) {
+        throw IllegalArgumentException("Polling intervals must be positive, and the minimum at most the maximum");
+    }
+    if (config.expectedBlockInterval.count() <= 0) {
+        throw IllegalArgumentException("Expected block interval must be positive");
+    }
+    if (!(config.smoothing > 0.0 && config.smoothing <= 1.0)) {
+        throw IllegalArgumentException("Smoothing must be in (0, 1]");
+    }
+}
+
+void AdaptivePollSchedule::onBlock(uint32_t index, int64_t blockTimeMs, int64_t detectedAtMs, bool live) {
+    int64_t previousIndex = lastIndex_;
+    int64_t previousTime = lastBlockTimeMs_;
+    if (live && previousIndex >= 0 && index > previousIndex && blockTimeMs > previousTime) {
+        double observed = static_cast<double>(blockTimeMs - previousTime) / static_cast<double>(index - previousIndex);
+        double learned = static_cast<double>(blockIntervalMs_);
+        double deviation = static_cast<double>(deviationMs_);
+        deviationMs_ = std::llround(deviation + config_.smoothing * (std::abs(observed - learned) - deviation));
+        blockIntervalMs_ = std::max<int64_t>(1, std::llround(learned + config_.smoothing * (observed - learned)));
+    }
+    if (live) {
+        auto latency = static_cast<uint64_t>(std::max<int64_t>(0, detectedAtMs - blockTimeMs));
+        lastDetectionLatency_ = latency;
+        detectionLatency_.record(latency);
+    }
+    lastIndex_ = index;
+    lastBlockTimeMs_ = blockTimeMs;
+}
+
+std::chrono::milliseconds AdaptivePollSchedule::nextDelay(int64_t nowMs) const {
+    int64_t lastTime = lastBlockTimeMs_;
+    int64_t delay;
+    if (lastTime < 0) {
+        // Nothing seen yet
+        delay = config_.minInterval.count();
+    } else {
+        // Sleep until the next block may come, then poll tightly; when it is late,
+        // back off in proportion to how late it is
+        int64_t guard = std::max<int64_t>(config_.minInterval.count(), 2 * deviationMs_);
+        int64_t remaining = lastTime + blockIntervalMs_ - nowMs;
+        delay = remaining > guard ? remaining - guard : -remaining / 2;
+    }
+    return std::chrono::milliseconds(std::clamp<int64_t>(delay, config_.minInterval.count(), config_.maxInterval.count()));
+}
+
+} // namespace neocpp
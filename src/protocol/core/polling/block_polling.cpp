@@ -1,14 +1,32 @@
 #include "neocpp/protocol/core/polling/block_polling.hpp"
 #include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/rpc_policy.hpp"
+#include "neocpp/protocol/core/response.hpp"
+#include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <deque>
+#include <future>
 
 namespace neocpp {
 
-BlockPolling::BlockPolling(const SharedPtr<NeoRpcClient>& rpcClient, std::chrono::milliseconds pollInterval)
-    : rpcClient_(rpcClient), running_(false), lastBlockIndex_(0), pollInterval_(pollInterval) {
+// Local wall-clock time, comparable with block timestamps
+static int64_t unixTimeMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+BlockPolling::BlockPolling(const SharedPtr<NeoRpcClient>& rpcClient, std::chrono::milliseconds pollInterval,
+                           const SharedPtr<ThreadPool>& dispatchPool)
+    : rpcClient_(rpcClient),
+      dispatchPool_(dispatchPool ? dispatchPool : std::make_shared<ThreadPool>(DEFAULT_DISPATCH_THREADS)),
+      dispatcher_(std::make_unique<EventDispatcher<BlockEvent>>(dispatchPool_)), blockSubscribers_(0), running_(false), lastBlockIndex_(0), nextHeight_(-1), lastSeenHead_(-1), headBlockTime_(-1), pollCount_(0),
+      batchSize_(DEFAULT_BATCH_SIZE), batchesInFlight_(DEFAULT_BATCHES_IN_FLIGHT), pollInterval_(pollInterval),
+      maxBackoff_(DEFAULT_MAX_BACKOFF_MS), consecutiveErrors_(0) {
 }
 
 BlockPolling::~BlockPolling() {
     stop();
+    dispatcher_->clear();
 }
 
 void BlockPolling::start() {
@@ -25,47 +43,181 @@ void BlockPolling::stop() {
         return;
     }
     
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wakeup_.notify_all();
     if (pollingThread_ && pollingThread_->joinable()) {
         pollingThread_->join();
     }
 }
 
-void BlockPolling::subscribe(std::function<void(uint32_t)> callback) {
-    callbacks_.push_back(callback);
+uint64_t BlockPolling::subscribe(std::function<void(uint32_t)> callback, const SubscriberOptions& options) {
+    if (!callback) {
+        throw IllegalArgumentException("Block callback cannot be empty");
+    }
+    return dispatcher_->subscribe([callback](const BlockEvent& event) { callback(event.index); }, options);
+}
+
+uint64_t BlockPolling::subscribeBlocks(BlockHandler handler, const SubscriberOptions& options) {
+    if (!handler) {
+        throw IllegalArgumentException("Block handler cannot be empty");
+    }
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    auto id = dispatcher_->subscribe([handler](const BlockEvent& event) {
+        if (event.block) {
+            handler(*event.block);
+        }
+    }, options);
+    blockSubscriptions_.insert(id);
+    blockSubscribers_ = blockSubscriptions_.size();
+    return id;
+}
+
+void BlockPolling::unsubscribe(uint64_t subscriptionId) {
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        blockSubscriptions_.erase(subscriptionId);
+        blockSubscribers_ = blockSubscriptions_.size();
+    }
+    dispatcher_->unsubscribe(subscriptionId);
 }
 
 void BlockPolling::clearSubscriptions() {
-    callbacks_.clear();
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        blockSubscriptions_.clear();
+        blockSubscribers_ = 0;
+    }
+    dispatcher_->clear();
+}
+
+void BlockPolling::setAdaptivePolling(const AdaptivePollingConfig& config) {
+    schedule_ = std::make_shared<AdaptivePollSchedule>(config);
+}
+
+void BlockPolling::setCatchUpWindow(size_t batchSize, size_t batchesInFlight) {
+    if (batchSize == 0 || batchesInFlight == 0) {
+        throw IllegalArgumentException("Catch-up batch size and batches in flight must be positive");
+    }
+    batchSize_ = batchSize;
+    batchesInFlight_ = batchesInFlight;
 }
 
 void BlockPolling::pollLoop() {
     while (running_) {
         try {
             auto blockCount = rpcClient_->getBlockCount();
+            auto detectedAt = unixTimeMillis();
+            pollCount_++;
             if (blockCount > 0) {
-                uint32_t currentBlock = blockCount - 1;
-                if (currentBlock > lastBlockIndex_) {
-                    lastBlockIndex_ = currentBlock;
-                    notifySubscribers(currentBlock);
+                uint32_t head = blockCount - 1;
+                if (nextHeight_ < 0) {
+                    nextHeight_ = head;
+                }
+                headBlockTime_ = -1;
+                catchUp(head);
+                if (schedule_ && static_cast<int64_t>(head) > lastSeenHead_) {
+                    if (headBlockTime_ < 0) {
+                        headBlockTime_ = rpcClient_->getBlockHeader(head, true).value("time", int64_t(0));
+                    }
+                    schedule_->onBlock(head, headBlockTime_, detectedAt, lastSeenHead_ >= 0);
                 }
+                lastSeenHead_ = std::max<int64_t>(lastSeenHead_, head);
             }
+            consecutiveErrors_ = 0;
+        } catch (const std::exception& e) {
+            consecutiveErrors_++;
+            reportError(e);
         } catch (...) {
-            // Ignore errors and continue polling
+            consecutiveErrors_++;
+            reportError(RpcException("Unknown error while polling for blocks"));
         }
         
-        std::this_thread::sleep_for(pollInterval_);
+        auto delay = schedule_ ? schedule_->nextDelay(unixTimeMillis()) : pollInterval_;
+        uint32_t errors = consecutiveErrors_;
+        if (errors > 0) {
+            RpcRetryConfig backoff;
+            backoff.initialBackoff = pollInterval_;
+            backoff.maxBackoff = std::max(maxBackoff_, pollInterval_);
+            delay = std::max(pollInterval_, RpcPolicy::backoff(backoff, errors - 1));
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait_for(lock, delay, [this]() { return !running_; });
     }
 }
 
-void BlockPolling::notifySubscribers(uint32_t blockIndex) {
-    for (const auto& callback : callbacks_) {
-        try {
-            callback(blockIndex);
-        } catch (...) {
-            // Ignore callback errors
+void BlockPolling::catchUp(uint32_t head) {
+    if (blockSubscribers_ == 0) {
+        for (int64_t height = nextHeight_; height <= head && running_; ++height) {
+            notifySubscribers(static_cast<uint32_t>(height), nullptr);
+            nextHeight_ = height + 1;
         }
+        return;
     }
+
+    // A sliding window of batches: while the oldest one is delivered, the next ones are
+    // already in flight. Blocks are only delivered from the front, so order is kept.
+    using Batch = std::future<std::vector<SharedPtr<Response>>>;
+    std::deque<Batch> window;
+    int64_t requested = nextHeight_;
+    auto refill = [&]() {
+        while (window.size() < batchesInFlight_ && requested <= head) {
+            int64_t end = std::min<int64_t>(head, requested + static_cast<int64_t>(batchSize_) - 1);
+            std::vector<std::pair<std::string, nlohmann::json>> requests;
+            for (int64_t height = requested; height <= end; ++height) {
+                requests.emplace_back("getblock", nlohmann::json::array({height, true}));
+            }
+            window.push_back(rpcClient_->sendBatchAsync(requests));
+            requested = end + 1;
+        }
+    };
+
+    refill();
+    while (!window.empty() && running_) {
+        auto responses = window.front().get();
+        window.pop_front();
+        for (const auto& response : responses) {
+            int64_t height = nextHeight_;
+            if (!response || response->hasError()) {
+                throw RpcException("Failed to fetch block " + std::to_string(height) + ": " +
+                                   (response ? response->getError()->message : "no response"));
+            }
+            const auto& block = response->getResult();
+            if (!block.is_object() || block.value("index", int64_t(-1)) != height) {
+                throw RpcException("Node returned an unexpected block for height " + std::to_string(height));
+            }
+            if (height == head) {
+                headBlockTime_ = block.value("time", int64_t(0));
+            }
+            notifySubscribers(static_cast<uint32_t>(height), std::make_shared<const nlohmann::json>(block));
+            nextHeight_ = height + 1;
+            if (!running_) {
+                return;
+            }
+        }
+        refill();
+    }
+}
+
+void BlockPolling::reportError(const std::exception& error) {
+    if (!errorHandler_) {
+        return;
+    }
+    try {
+        errorHandler_(error);
+    } catch (...) {
+        // Ignore handler errors
+    }
+}
+
+void BlockPolling::notifySubscribers(uint32_t blockIndex, SharedPtr<const nlohmann::json> block) {
+    lastBlockIndex_ = blockIndex;
+    BlockEvent event;
+    event.index = blockIndex;
+    event.block = std::move(block);
+    dispatcher_->publish(event);
 }
 
-} // namespace neocpp
\ No newline at end of file
+} // namespace neocpp
@@ -2,7 +2,7 @@
 
 namespace neocpp {
 
-int Request::nextId_ = 1;
+std::atomic<int> Request::nextId_{1};
 
 Request::Request() : jsonrpc_("2.0"), id_(generateId()) {
 }
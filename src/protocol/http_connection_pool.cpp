@@ -0,0 +1,230 @@
+#include "neocpp/protocol/http_connection_pool.hpp"
+#include "neocpp/exceptions.hpp"
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef HAVE_CURL
+#include <curl/curl.h>
+#endif
+
+namespace neocpp {
+
+#ifdef HAVE_CURL
+/// Share object holding the DNS cache, TLS session cache and connection cache
+struct HttpConnectionPool::Share {
+    CURLSH* handle = nullptr;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+
+    Share() {
+        initializeCurl();
+        handle = curl_share_init();
+        if (!handle) {
+            throw RpcException("Failed to initialize CURL share");
+        }
+        curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, &Share::lock);
+        curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, &Share::unlock);
+        curl_share_setopt(handle, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+
+    ~Share() {
+        curl_share_cleanup(handle);
+    }
+
+    static void lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+        static_cast<Share*>(userptr)->locks[data].lock();
+    }
+
+    static void unlock(CURL*, curl_lock_data data, void* userptr) {
+        static_cast<Share*>(userptr)->locks[data].unlock();
+    }
+};
+#else
+struct HttpConnectionPool::Share {};
+#endif
+
+// Extract scheme://host:port so that every path on a node maps to one pool
+static std::string endpointKey(const std::string& url) {
+    if (url.compare(0, 7, "unix://") == 0) {
+        // The socket path is the endpoint
+        return url;
+    }
+    auto schemeEnd = url.find("://");
+    size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+    auto pathStart = url.find_first_of("/?#", hostStart);
+    return pathStart == std::string::npos ? url : url.substr(0, pathStart);
+}
+
+HttpConnectionPool::HttpConnectionPool(size_t maxSize, std::chrono::milliseconds idleTimeout)
+    : maxSize_(maxSize), idleTimeoutMs_(idleTimeout.count()),
+      hits_(0), misses_(0), evictions_(0), share_(std::make_unique<Share>()) {
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    clear();
+}
+
+void HttpConnectionPool::initializeCurl() {
+#ifdef HAVE_CURL
+    static std::once_flag curlInitFlag;
+    std::call_once(curlInitFlag, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        std::atexit([]() { curl_global_cleanup(); });
+    });
+#endif
+}
+
+SharedPtr<HttpConnectionPool> HttpConnectionPool::forEndpoint(const std::string& url) {
+    static std::mutex registryMutex;
+    static std::unordered_map<std::string, WeakPtr<HttpConnectionPool>> registry;
+
+    std::string key = endpointKey(url);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto pool = registry[key].lock();
+    if (!pool) {
+        pool = std::make_shared<HttpConnectionPool>();
+        registry[key] = pool;
+    }
+    return pool;
+}
+
+void* HttpConnectionPool::acquire() {
+#ifdef HAVE_CURL
+    void* handle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evictExpiredLocked(std::chrono::steady_clock::now());
+        if (!idle_.empty()) {
+            // Most recently used first: its connection is the least likely to have been closed
+            handle = idle_.back().handle;
+            idle_.pop_back();
+        }
+    }
+
+    if (handle) {
+        hits_++;
+    } else {
+        misses_++;
+        handle = curl_easy_init();
+        if (!handle) {
+            throw RpcException("Failed to initialize CURL");
+        }
+    }
+    prepareHandle(handle);
+    return handle;
+#else
+    throw RpcException("HTTP support not available (CURL not found)");
+#endif
+}
+
+void HttpConnectionPool::release(void* handle) {
+    if (!handle) {
+        return;
+    }
+#ifdef HAVE_CURL
+    // Drops per-request options but keeps live connections and caches
+    curl_easy_reset(static_cast<CURL*>(handle));
+
+    auto now = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    evictExpiredLocked(now);
+    if (idle_.size() < maxSize_) {
+        idle_.push_back({handle, now});
+        return;
+    }
+    lock.unlock();
+    evictions_++;
+    destroyHandle(handle);
+#endif
+}
+
+void HttpConnectionPool::clear() {
+    std::vector<IdleHandle> handles;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handles.swap(idle_);
+    }
+    for (const auto& idle : handles) {
+        destroyHandle(idle.handle);
+    }
+}
+
+void HttpConnectionPool::setMaxSize(size_t maxSize) {
+    maxSize_ = maxSize;
+    std::vector<IdleHandle> excess;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (idle_.size() > maxSize) {
+            excess.push_back(idle_.front());
+            idle_.erase(idle_.begin());
+        }
+    }
+    evictions_ += excess.size();
+    for (const auto& idle : excess) {
+        destroyHandle(idle.handle);
+    }
+}
+
+void HttpConnectionPool::setIdleTimeout(std::chrono::milliseconds idleTimeout) {
+    idleTimeoutMs_ = idleTimeout.count();
+}
+
+std::chrono::milliseconds HttpConnectionPool::getIdleTimeout() const {
+    return std::chrono::milliseconds(idleTimeoutMs_.load());
+}
+
+HttpPoolStats HttpConnectionPool::getStats() const {
+    HttpPoolStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.idleHandles = idle_.size();
+    return stats;
+}
+
+void HttpConnectionPool::resetStats() {
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+void HttpConnectionPool::evictExpiredLocked(std::chrono::steady_clock::time_point now) {
+    auto timeout = std::chrono::milliseconds(idleTimeoutMs_.load());
+    // idle_ is ordered by release time, so expired handles are at the front
+    auto firstLive = std::find_if(idle_.begin(), idle_.end(), [&](const IdleHandle& idle) {
+        return now - idle.releasedAt < timeout;
+    });
+    for (auto it = idle_.begin(); it != firstLive; ++it) {
+        destroyHandle(it->handle);
+        evictions_++;
+    }
+    idle_.erase(idle_.begin(), firstLive);
+}
+
+void HttpConnectionPool::prepareHandle(void* handle) const {
+#ifdef HAVE_CURL
+    CURL* curl = static_cast<CURL*>(handle);
+    curl_easy_setopt(curl, CURLOPT_SHARE, share_->handle);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    // Let curl close cached connections that sat idle longer than the pool allows
+    long maxAgeSeconds = static_cast<long>(std::max<int64_t>(1, idleTimeoutMs_.load() / 1000));
+    curl_easy_setopt(curl, CURLOPT_MAXAGE_CONN, maxAgeSeconds);
+#else
+    (void)handle;
+#endif
+}
+
+void HttpConnectionPool::destroyHandle(void* handle) {
+#ifdef HAVE_CURL
+    curl_easy_cleanup(static_cast<CURL*>(handle));
+#else
+    (void)handle;
+#endif
+}
+
+} // namespace neocpp
@@ -0,0 +1,181 @@
+#include "neocpp/protocol/http_event_loop.hpp"
+#include "neocpp/protocol/http_connection_pool.hpp"
+#include "neocpp/exceptions.hpp"
+#include <unordered_map>
+
+#ifdef HAVE_CURL
+#include <curl/curl.h>
+
+// curl_multi_poll() and curl_multi_wakeup() appeared in 7.68.0
+#if LIBCURL_VERSION_NUM < 0x074400
+#error "libcurl 7.68.0 or newer is required"
+#endif
+#endif
+
+namespace neocpp {
+
+#ifdef HAVE_CURL
+/// The multi handle and the transfers currently attached to it (loop thread only)
+struct HttpEventLoop::Multi {
+    struct Active {
+        uint64_t id;
+        CompletionHandler onComplete;
+    };
+
+    CURLM* handle = nullptr;
+    std::unordered_map<CURL*, Active> active;
+};
+#else
+struct HttpEventLoop::Multi {};
+#endif
+
+// Set on event loop threads
+static thread_local bool onLoopThread = false;
+
+// Run a completion handler, keeping the loop alive if it throws
+static void complete(const HttpEventLoop::CompletionHandler& onComplete, int resultCode) {
+    try {
+        onComplete(resultCode);
+    } catch (...) {
+        // Ignore handler errors
+    }
+}
+
+HttpEventLoop::HttpEventLoop()
+    : multi_(std::make_unique<Multi>()), running_(true), inFlight_(0), nextTransferId_(1) {
+#ifdef HAVE_CURL
+    HttpConnectionPool::initializeCurl();
+    multi_->handle = curl_multi_init();
+    if (!multi_->handle) {
+        throw RpcException("Failed to initialize CURL multi handle");
+    }
+    thread_ = std::thread(&HttpEventLoop::run, this);
+#endif
+}
+
+HttpEventLoop::~HttpEventLoop() {
+    running_ = false;
+    wakeup();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifdef HAVE_CURL
+    curl_multi_cleanup(multi_->handle);
+#endif
+}
+
+SharedPtr<HttpEventLoop> HttpEventLoop::getDefault() {
+    static SharedPtr<HttpEventLoop> loop = std::make_shared<HttpEventLoop>();
+    return loop;
+}
+
+bool HttpEventLoop::isLoopThread() {
+    return onLoopThread;
+}
+
+uint64_t HttpEventLoop::submit(void* handle, CompletionHandler onComplete) {
+#ifdef HAVE_CURL
+    uint64_t id = nextTransferId_++;
+    inFlight_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        submitted_.push_back({id, handle, std::move(onComplete)});
+    }
+    wakeup();
+    return id;
+#else
+    (void)handle;
+    (void)onComplete;
+    throw RpcException("HTTP support not available (CURL not found)");
+#endif
+}
+
+void HttpEventLoop::cancel(uint64_t transferId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_.push_back(transferId);
+    }
+    wakeup();
+}
+
+void HttpEventLoop::wakeup() {
+#ifdef HAVE_CURL
+    if (multi_->handle) {
+        curl_multi_wakeup(multi_->handle);
+    }
+#endif
+}
+
+void HttpEventLoop::run() {
+#ifdef HAVE_CURL
+    onLoopThread = true;
+    auto& active = multi_->active;
+
+    auto finish = [&](CURL* easy, int resultCode) {
+        auto it = active.find(easy);
+        if (it == active.end()) {
+            return;
+        }
+        auto onComplete = std::move(it->second.onComplete);
+        active.erase(it);
+        curl_multi_remove_handle(multi_->handle, easy);
+        inFlight_--;
+        complete(onComplete, resultCode);
+    };
+
+    while (true) {
+        std::vector<Pending> submitted;
+        std::vector<uint64_t> cancelled;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            submitted.swap(submitted_);
+            cancelled.swap(cancelled_);
+        }
+
+        for (auto& pending : submitted) {
+            CURL* easy = static_cast<CURL*>(pending.handle);
+            if (!running_ || curl_multi_add_handle(multi_->handle, easy) != CURLM_OK) {
+                inFlight_--;
+                complete(pending.onComplete, running_ ? CURLE_FAILED_INIT : CURLE_ABORTED_BY_CALLBACK);
+                continue;
+            }
+            active[easy] = {pending.id, std::move(pending.onComplete)};
+        }
+
+        for (uint64_t id : cancelled) {
+            for (const auto& entry : active) {
+                if (entry.second.id == id) {
+                    finish(entry.first, CURLE_ABORTED_BY_CALLBACK);
+                    break;
+                }
+            }
+        }
+
+        if (!running_) {
+            while (!active.empty()) {
+                finish(active.begin()->first, CURLE_ABORTED_BY_CALLBACK);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (submitted_.empty()) {
+                break;
+            }
+            continue;
+        }
+
+        int stillRunning = 0;
+        curl_multi_perform(multi_->handle, &stillRunning);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_->handle, &queued)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+
+        // Sleeps until a socket is ready, a timer is due or wakeup() is called
+        curl_multi_poll(multi_->handle, nullptr, 0, 1000, nullptr);
+    }
+#endif
+}
+
+} // namespace neocpp
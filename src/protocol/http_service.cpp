@@ -1,8 +1,9 @@
 #include "neocpp/protocol/http_service.hpp"
+#include "neocpp/protocol/json_stream_parser.hpp"
+#include "neocpp/utils/gzip.hpp"
 #include "neocpp/exceptions.hpp"
 #include <sstream>
-#include <mutex>
-#include <cstdlib>
+#include <cstring>
 
 #ifdef HAVE_CURL
 #include <curl/curl.h>
@@ -17,117 +18,474 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::stri
     response->append((char*)contents, totalSize);
     return totalSize;
 }
-#endif
 
-HttpService::HttpService(const std::string& baseUrl) 
-    : baseUrl_(baseUrl) {
-#ifdef HAVE_CURL
-    // Thread-safe CURL initialization using std::once_flag
-    static std::once_flag curlInitFlag;
-    std::call_once(curlInitFlag, []() {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
-        // Register cleanup handler
-        std::atexit([]() { curl_global_cleanup(); });
-    });
+// Callback for CURL to collect response headers
+static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, HttpResponse* response) {
+    size_t totalSize = size * nitems;
+    std::string line(buffer, totalSize);
+    auto colon = line.find(':');
+    if (colon != std::string::npos) {
+        auto valueStart = line.find_first_not_of(" \t", colon + 1);
+        auto valueEnd = line.find_last_not_of("\r\n");
+        std::string value;
+        if (valueStart != std::string::npos && valueEnd != std::string::npos && valueEnd >= valueStart) {
+            value = line.substr(valueStart, valueEnd - valueStart + 1);
+        }
+        response->headers[line.substr(0, colon)] = value;
+    } else if (line.compare(0, 5, "HTTP/") == 0) {
+        // Status line; the final code is read from the handle once the transfer ends
+        auto space = line.find(' ');
+        if (space != std::string::npos) {
+            response->statusCode = std::atoi(line.c_str() + space + 1);
+        }
+    }
+    return totalSize;
+}
+
+namespace {
+
+/// Handle borrowed from a connection pool, returned when it goes out of scope
+class PooledHandle {
+public:
+    explicit PooledHandle(HttpConnectionPool& pool)
+        : pool_(pool), curl_(static_cast<CURL*>(pool.acquire())) {}
+    ~PooledHandle() { pool_.release(curl_); }
+    PooledHandle(const PooledHandle&) = delete;
+    PooledHandle& operator=(const PooledHandle&) = delete;
+    CURL* get() const { return curl_; }
+
+private:
+    HttpConnectionPool& pool_;
+    CURL* curl_;
+};
+
+/// State of one request; must outlive the transfer on its handle
+struct Transfer {
+    std::string url;
+    std::string body;
+    struct curl_slist* headerList = nullptr;
+    HttpResponse response;
+    uint64_t wireBytes = 0;
+    std::unique_ptr<JsonStreamParser> parser;
+    uint64_t parsedBytes = 0;
+    char errorBuffer[CURL_ERROR_SIZE] = {};
+
+    Transfer() = default;
+    Transfer(const Transfer&) = delete;
+    Transfer& operator=(const Transfer&) = delete;
+    ~Transfer() { curl_slist_free_all(headerList); }
+
+    /// Apply the request options to a handle
+    void configure(CURL* curl, const char* method, const HttpService::Headers& headers, int timeoutSeconds,
+                   bool acceptEncoding, const std::string& unixSocketPath) {
+        for (const auto& [name, value] : headers) {
+            headerList = curl_slist_append(headerList, (name + ": " + value).c_str());
+        }
+
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+        if (parser) {
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, JsonWriteCallback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+        }
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errorBuffer);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, static_cast<long>(timeoutSeconds));
+        // An empty string offers every encoding libcurl was built with; null turns decoding off
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, acceptEncoding ? "" : nullptr);
+        // Always set, since a pooled handle may have been used for another endpoint
+        curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, unixSocketPath.empty() ? nullptr : unixSocketPath.c_str());
+
+        std::string verb(method);
+        if (verb == "GET") {
+            curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+            return;
+        }
+        if (verb == "POST") {
+            curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method);
+        }
+        if (verb != "DELETE" || !body.empty()) {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+        }
+    }
+
+    /// Feed body chunks of a successful reply to the JSON parser instead of buffering them
+    static size_t JsonWriteCallback(void* contents, size_t size, size_t nmemb, Transfer* transfer) {
+        size_t totalSize = size * nmemb;
+        if (transfer->response.isSuccess()) {
+            transfer->parsedBytes += totalSize;
+            // After a syntax error the rest is dropped; finish() reports the error
+            transfer->parser->feed(static_cast<const char*>(contents), totalSize);
+        } else {
+            transfer->response.body.append(static_cast<const char*>(contents), totalSize);
+        }
+        return totalSize;
+    }
+
+    /// Get the decoded size of the response body
+    uint64_t responseBytes() const {
+        // A failed streaming parse leaves its error message in the body
+        return response.json ? parsedBytes : response.body.size() + parsedBytes;
+    }
+
+    /// Record the outcome of the transfer into the response
+    void finish(CURL* curl, int resultCode) {
+        long statusCode = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+        response.statusCode = static_cast<int>(statusCode);
+        curl_off_t downloaded = 0;
+        curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+        wireBytes = static_cast<uint64_t>(downloaded);
+        if (parser && resultCode == CURLE_OK && response.isSuccess()) {
+            response.json = std::make_shared<nlohmann::json>(nlohmann::json::value_t::discarded);
+            if (parser->finish()) {
+                *response.json = std::move(parser->getDocument());
+            } else {
+                response.body = parser->getError();
+            }
+        }
+        if (resultCode != CURLE_OK) {
+            response.error = errorBuffer[0] != '\0'
+                ? std::string(errorBuffer)
+                : std::string(curl_easy_strerror(static_cast<CURLcode>(resultCode)));
+        }
+    }
+};
+
+} // namespace
 #endif
+
+nlohmann::json HttpService::parseJsonResponse(const HttpResponse& response) {
+    if (!response.error.empty()) {
+        throw RpcException("HTTP request failed: " + response.error);
+    }
+    if (response.json) {
+        if (response.json->is_discarded()) {
+            throw RpcException("Failed to parse JSON response: " + response.body);
+        }
+        return *response.json;
+    }
+    try {
+        return nlohmann::json::parse(response.body);
+    } catch (const nlohmann::json::exception& e) {
+        throw RpcException("Failed to parse JSON response: " + std::string(e.what()));
+    }
+}
+
+nlohmann::json HttpService::parseJsonResponse(HttpResponse&& response) {
+    if (response.error.empty() && response.json && !response.json->is_discarded()
+        && response.json.use_count() == 1) {
+        // Copies of the response, such as one kept by a recording transport, still read it otherwise
+        return std::move(*response.json);
+    }
+    return parseJsonResponse(static_cast<const HttpResponse&>(response));
+}
+
+const HttpService::Headers& HttpService::jsonHeaders() {
+    static const HttpService::Headers headers = {
+        {"Content-Type", "application/json"},
+        {"Accept", "application/json"}
+    };
+    return headers;
+}
+
+// Report the outcome of a request to the endpoint's circuit breaker
+static void recordOutcome(CircuitBreaker* breaker, const HttpResponse& response, bool abandoned) {
+    if (!breaker) {
+        return;
+    }
+    if (abandoned) {
+        breaker->recordAbandoned();
+    } else if (response.isTransientFailure()) {
+        breaker->recordFailure();
+    } else {
+        breaker->recordSuccess();
+    }
+}
+
+HttpService::HttpService(const std::string& baseUrl)
+    : baseUrl_(baseUrl), requestUrl_(baseUrl), pool_(HttpConnectionPool::forEndpoint(baseUrl)),
+      timeoutSeconds_(DEFAULT_TIMEOUT_SECONDS), acceptEncoding_(true), compressionThreshold_(0),
+      counters_(std::make_shared<Counters>()) {
+    if (baseUrl.compare(0, std::strlen(UNIX_SCHEME), UNIX_SCHEME) == 0) {
+        unixSocketPath_ = baseUrl.substr(std::strlen(UNIX_SCHEME));
+        if (unixSocketPath_.empty()) {
+            throw IllegalArgumentException("Missing socket path in URL: " + baseUrl);
+        }
+        // The host only fills the Host header; the connection goes to the socket
+        requestUrl_ = "http://localhost";
+    }
 }
 
 HttpService::~HttpService() {
     // Cleanup is handled globally
 }
 
-nlohmann::json HttpService::post(const nlohmann::json& data, const std::string& endpoint) {
+SharedPtr<HttpConnectionPool> HttpService::getConnectionPool() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_;
+}
+
+void HttpService::setConnectionPool(const SharedPtr<HttpConnectionPool>& pool) {
+    if (!pool) {
+        throw IllegalArgumentException("Connection pool cannot be null");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool_ = pool;
+}
+
+SharedPtr<HttpEventLoop> HttpService::getEventLoop() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The default loop thread is only started once something goes async
+    return eventLoop_ ? eventLoop_ : HttpEventLoop::getDefault();
+}
+
+void HttpService::setEventLoop(const SharedPtr<HttpEventLoop>& eventLoop) {
+    if (!eventLoop) {
+        throw IllegalArgumentException("Event loop cannot be null");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    eventLoop_ = eventLoop;
+}
+
+void HttpService::setTimeout(int seconds) {
+    if (seconds <= 0) {
+        throw IllegalArgumentException("Timeout must be positive");
+    }
+    timeoutSeconds_ = seconds;
+}
+
+void HttpService::setRequestCompressionThreshold(size_t bytes) {
+    if (bytes > 0 && !Gzip::isAvailable()) {
+        throw IllegalStateException("Request compression requires zlib");
+    }
+    compressionThreshold_ = bytes;
+}
+
+HttpTransferStats HttpService::getTransferStats() const {
+    HttpTransferStats stats;
+    stats.requestBytes = counters_->requestBytes;
+    stats.requestWireBytes = counters_->requestWireBytes;
+    stats.responseBytes = counters_->responseBytes;
+    stats.responseWireBytes = counters_->responseWireBytes;
+    return stats;
+}
+
+void HttpService::recordTransfer(Counters& counters, uint64_t requestBytes, uint64_t requestWireBytes,
+                                 uint64_t responseBytes, uint64_t responseWireBytes) {
+    counters.requestBytes += requestBytes;
+    counters.requestWireBytes += requestWireBytes;
+    counters.responseBytes += responseBytes;
+    counters.responseWireBytes += responseWireBytes;
+}
+
+void HttpService::encodeBody(std::string& body, Headers& headers) const {
+    size_t threshold = compressionThreshold_;
+    if (threshold == 0 || body.size() < threshold) {
+        return;
+    }
+    body = Gzip::compress(body);
+    headers["Content-Encoding"] = "gzip";
+}
+
+SharedPtr<CircuitBreaker> HttpService::getCircuitBreaker() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return circuitBreaker_;
+}
+
+void HttpService::setCircuitBreaker(const SharedPtr<CircuitBreaker>& breaker) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    circuitBreaker_ = breaker;
+}
+
+void HttpService::setDefaultHeaders(const Headers& headers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    defaultHeaders_ = headers;
+}
+
+HttpService::Headers HttpService::getDefaultHeaders() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return defaultHeaders_;
+}
+
+HttpResponse HttpService::circuitOpenResponse() const {
+    HttpResponse response;
+    response.error = "Circuit breaker open for " + baseUrl_;
+    response.circuitOpen = true;
+    return response;
+}
+
+std::string HttpService::resolveUrl(const std::string& url) const {
+    if (url.find("://") != std::string::npos) {
+        return url;
+    }
+    return requestUrl_ + url;
+}
+
+HttpService::Headers HttpService::mergeHeaders(const Headers& headers) const {
+    Headers merged = getDefaultHeaders();
+    for (const auto& [name, value] : headers) {
+        merged[name] = value;
+    }
+    return merged;
+}
+
+HttpResponse HttpService::perform(const char* method, const std::string& url, const std::string& body, const Headers& headers,
+                                  bool streamJson) {
 #ifdef HAVE_CURL
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw RpcException("Failed to initialize CURL");
-    }
-    
-    std::string url = baseUrl_ + endpoint;
-    std::string jsonStr = data.dump();
-    std::string response;
-    
-    // Set CURL options
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonStr.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, jsonStr.length());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    
-    // Set headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, "Accept: application/json");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    
-    // Perform request
-    CURLcode res = curl_easy_perform(curl);
-    
-    // Cleanup
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        throw RpcException("HTTP request failed: " + std::string(curl_easy_strerror(res)));
-    }
-    
-    // Parse response
-    try {
-        return nlohmann::json::parse(response);
-    } catch (const nlohmann::json::exception& e) {
-        throw RpcException("Failed to parse JSON response: " + std::string(e.what()));
+    auto breaker = getCircuitBreaker();
+    if (breaker && !breaker->allowRequest()) {
+        return circuitOpenResponse();
+    }
+    auto pool = getConnectionPool();
+    PooledHandle handle(*pool);
+    Transfer transfer;
+    transfer.url = resolveUrl(url);
+    transfer.body = body;
+    if (streamJson) {
+        transfer.parser = std::make_unique<JsonStreamParser>();
     }
+    auto merged = mergeHeaders(headers);
+    encodeBody(transfer.body, merged);
+    transfer.configure(handle.get(), method, merged, timeoutSeconds_, acceptEncoding_, unixSocketPath_);
+
+    CURLcode res = curl_easy_perform(handle.get());
+    transfer.finish(handle.get(), res);
+    recordTransfer(*counters_, body.size(), transfer.body.size(), transfer.responseBytes(), transfer.wireBytes);
+    recordOutcome(breaker.get(), transfer.response, false);
+    return std::move(transfer.response);
 #else
-    (void)data;
-    (void)endpoint;
+    (void)method;
+    (void)url;
+    (void)body;
+    (void)headers;
+    (void)streamJson;
     throw RpcException("HTTP support not available (CURL not found)");
 #endif
 }
 
-nlohmann::json HttpService::get(const std::string& endpoint) {
+uint64_t HttpService::performAsync(const char* method, const std::string& url, const std::string& body,
+                                   const Headers& headers, ResponseCallback callback, bool streamJson) {
 #ifdef HAVE_CURL
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        throw RpcException("Failed to initialize CURL");
-    }
-    
-    std::string url = baseUrl_ + endpoint;
-    std::string response;
-    
-    // Set CURL options
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    
-    // Set headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: application/json");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    
-    // Perform request
-    CURLcode res = curl_easy_perform(curl);
-    
-    // Cleanup
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        throw RpcException("HTTP request failed: " + std::string(curl_easy_strerror(res)));
-    }
-    
-    // Parse response
-    try {
-        return nlohmann::json::parse(response);
-    } catch (const nlohmann::json::exception& e) {
-        throw RpcException("Failed to parse JSON response: " + std::string(e.what()));
+    auto breaker = getCircuitBreaker();
+    if (breaker && !breaker->allowRequest()) {
+        if (callback) {
+            callback(circuitOpenResponse());
+        }
+        return 0;
+    }
+    auto pool = getConnectionPool();
+    auto transfer = std::make_shared<Transfer>();
+    transfer->url = resolveUrl(url);
+    transfer->body = body;
+    if (streamJson) {
+        transfer->parser = std::make_unique<JsonStreamParser>();
     }
+    auto merged = mergeHeaders(headers);
+    encodeBody(transfer->body, merged);
+    CURL* curl = static_cast<CURL*>(pool->acquire());
+    transfer->configure(curl, method, merged, timeoutSeconds_, acceptEncoding_, unixSocketPath_);
+
+    auto counters = counters_;
+    size_t requestBytes = body.size();
+    return getEventLoop()->submit(curl, [pool, breaker, counters, requestBytes, transfer, curl,
+                                         callback = std::move(callback)](int resultCode) {
+        transfer->finish(curl, resultCode);
+        pool->release(curl);
+        recordTransfer(*counters, requestBytes, transfer->body.size(), transfer->responseBytes(), transfer->wireBytes);
+        recordOutcome(breaker.get(), transfer->response, resultCode == CURLE_ABORTED_BY_CALLBACK);
+        if (callback) {
+            callback(transfer->response);
+        }
+    });
 #else
-    (void)endpoint;
+    (void)method;
+    (void)url;
+    (void)body;
+    (void)headers;
+    (void)callback;
+    (void)streamJson;
     throw RpcException("HTTP support not available (CURL not found)");
 #endif
 }
 
-} // namespace neocpp
\ No newline at end of file
+nlohmann::json HttpService::post(const nlohmann::json& data, const std::string& endpoint) {
+    return parseJsonResponse(perform("POST", requestUrl_ + endpoint, data.dump(), jsonHeaders(), true));
+}
+
+HttpResponse HttpService::postJson(const std::string& body) {
+    return perform("POST", requestUrl_, body, jsonHeaders(), true);
+}
+
+nlohmann::json HttpService::get(const std::string& endpoint) {
+    return parseJsonResponse(perform("GET", requestUrl_ + endpoint, "", {{"Accept", "application/json"}}, true));
+}
+
+HttpResponse HttpService::get(const std::string& url, const Headers& headers) {
+    return perform("GET", url, "", headers);
+}
+
+HttpResponse HttpService::post(const std::string& url, const std::string& body, const Headers& headers) {
+    return perform("POST", url, body, headers);
+}
+
+HttpResponse HttpService::put(const std::string& url, const std::string& body, const Headers& headers) {
+    return perform("PUT", url, body, headers);
+}
+
+HttpResponse HttpService::del(const std::string& url, const Headers& headers) {
+    return perform("DELETE", url, "", headers);
+}
+
+uint64_t HttpService::getAsync(const std::string& url, ResponseCallback callback, const Headers& headers) {
+    return performAsync("GET", url, "", headers, std::move(callback));
+}
+
+uint64_t HttpService::postAsync(const std::string& url, const std::string& body, ResponseCallback callback, const Headers& headers) {
+    return performAsync("POST", url, body, headers, std::move(callback));
+}
+
+uint64_t HttpService::postJsonAsync(const std::string& body, ResponseCallback callback) {
+    return performAsync("POST", requestUrl_, body, jsonHeaders(), std::move(callback), true);
+}
+
+void HttpService::cancel(uint64_t transferId) {
+    getEventLoop()->cancel(transferId);
+}
+
+std::future<HttpResponse> HttpService::getAsync(const std::string& url, const Headers& headers) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    performAsync("GET", url, "", headers, [promise](const HttpResponse& response) {
+        promise->set_value(response);
+    });
+    return promise->get_future();
+}
+
+std::future<HttpResponse> HttpService::postAsync(const std::string& url, const std::string& body, const Headers& headers) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    performAsync("POST", url, body, headers, [promise](const HttpResponse& response) {
+        promise->set_value(response);
+    });
+    return promise->get_future();
+}
+
+std::future<nlohmann::json> HttpService::postJsonAsync(const nlohmann::json& data, const std::string& endpoint) {
+    auto promise = std::make_shared<std::promise<nlohmann::json>>();
+    performAsync("POST", requestUrl_ + endpoint, data.dump(), jsonHeaders(), [promise](const HttpResponse& response) {
+        try {
+            promise->set_value(parseJsonResponse(response));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    }, true);
+    return promise->get_future();
+}
+
+} // namespace neocpp
@@ -0,0 +1,425 @@
+#include "neocpp/protocol/json_stream_parser.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace neocpp {
+
+static bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Check a number token against the JSON grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+static bool isValidNumber(const std::string& token, bool& integral) {
+    size_t i = 0;
+    size_t n = token.size();
+    if (i < n && token[i] == '-') i++;
+    if (i >= n || !isDigit(token[i])) return false;
+    if (token[i] == '0') {
+        i++;
+    } else {
+        while (i < n && isDigit(token[i])) i++;
+    }
+    integral = true;
+    if (i < n && token[i] == '.') {
+        integral = false;
+        i++;
+        if (i >= n || !isDigit(token[i])) return false;
+        while (i < n && isDigit(token[i])) i++;
+    }
+    if (i < n && (token[i] == 'e' || token[i] == 'E')) {
+        integral = false;
+        i++;
+        if (i < n && (token[i] == '+' || token[i] == '-')) i++;
+        if (i >= n || !isDigit(token[i])) return false;
+        while (i < n && isDigit(token[i])) i++;
+    }
+    return i == n;
+}
+
+static void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+JsonStreamParser::JsonStreamParser()
+    : state_(State::Value), stringIsKey_(false), unicode_(0), unicodeDigits_(0), highSurrogate_(0),
+      utf8Pending_(0), utf8Lower_(0x80), utf8Upper_(0xBF), literal_(nullptr), literalMatched_(0), consumed_(0) {
+}
+
+bool JsonStreamParser::feed(const char* data, size_t size) {
+    if (hasError()) {
+        return false;
+    }
+    size_t i = 0;
+    while (i < size) {
+        // Copy runs of plain ASCII string characters in one go
+        if (state_ == State::String && highSurrogate_ == 0 && utf8Pending_ == 0) {
+            size_t start = i;
+            while (i < size && data[i] != '"' && data[i] != '\\' && static_cast<unsigned char>(data[i]) >= 0x20
+                   && static_cast<unsigned char>(data[i]) < 0x80) {
+                i++;
+            }
+            token_.append(data + start, i - start);
+            consumed_ += i - start;
+            if (i == size) {
+                break;
+            }
+        }
+        if (!step(data[i])) {
+            return false;
+        }
+        consumed_++;
+        i++;
+    }
+    return true;
+}
+
+bool JsonStreamParser::finish() {
+    if (hasError()) {
+        return false;
+    }
+    if (state_ == State::Number && !finishNumber()) {
+        return false;
+    }
+    if (state_ != State::Done) {
+        return fail("unexpected end of input");
+    }
+    return true;
+}
+
+bool JsonStreamParser::step(char c) {
+    switch (state_) {
+        case State::Value:
+        case State::FirstValue:
+            if (isWhitespace(c)) {
+                return true;
+            }
+            if (state_ == State::FirstValue && c == ']') {
+                return closeContainer(c);
+            }
+            switch (c) {
+                case '{':
+                    openContainer(nlohmann::json::object());
+                    state_ = State::FirstKey;
+                    return true;
+                case '[':
+                    openContainer(nlohmann::json::array());
+                    state_ = State::FirstValue;
+                    return true;
+                case '"':
+                    token_.clear();
+                    stringIsKey_ = false;
+                    state_ = State::String;
+                    return true;
+                case 't':
+                    literal_ = "true";
+                    break;
+                case 'f':
+                    literal_ = "false";
+                    break;
+                case 'n':
+                    literal_ = "null";
+                    break;
+                default:
+                    if (c == '-' || isDigit(c)) {
+                        token_.assign(1, c);
+                        state_ = State::Number;
+                        return true;
+                    }
+                    return fail(std::string("unexpected character '") + c + "'");
+            }
+            literalMatched_ = 1;
+            state_ = State::Literal;
+            return true;
+
+        case State::Key:
+        case State::FirstKey:
+            if (isWhitespace(c)) {
+                return true;
+            }
+            if (state_ == State::FirstKey && c == '}') {
+                return closeContainer(c);
+            }
+            if (c != '"') {
+                return fail("expected an object key");
+            }
+            token_.clear();
+            stringIsKey_ = true;
+            state_ = State::String;
+            return true;
+
+        case State::Colon:
+            if (isWhitespace(c)) {
+                return true;
+            }
+            if (c != ':') {
+                return fail("expected ':'");
+            }
+            state_ = State::Value;
+            return true;
+
+        case State::AfterValue:
+            if (isWhitespace(c)) {
+                return true;
+            }
+            if (c == ',') {
+                state_ = stack_.back()->is_object() ? State::Key : State::Value;
+                return true;
+            }
+            if (c == ']' || c == '}') {
+                return closeContainer(c);
+            }
+            return fail("expected ',' or a closing bracket");
+
+        case State::String:
+            if (utf8Pending_ != 0 || static_cast<unsigned char>(c) >= 0x80) {
+                return stepUtf8(static_cast<unsigned char>(c));
+            }
+            if (highSurrogate_ != 0 && c != '\\') {
+                return fail("unpaired UTF-16 surrogate");
+            }
+            if (c == '"') {
+                if (stringIsKey_) {
+                    key_.swap(token_);
+                    state_ = State::Colon;
+                } else {
+                    addValue(nlohmann::json(std::move(token_)));
+                    token_.clear();
+                }
+                return true;
+            }
+            if (c == '\\') {
+                state_ = State::Escape;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return fail("control character in string");
+            }
+            token_ += c;
+            return true;
+
+        case State::Escape:
+            if (highSurrogate_ != 0 && c != 'u') {
+                return fail("unpaired UTF-16 surrogate");
+            }
+            state_ = State::String;
+            switch (c) {
+                case '"': token_ += '"'; return true;
+                case '\\': token_ += '\\'; return true;
+                case '/': token_ += '/'; return true;
+                case 'b': token_ += '\b'; return true;
+                case 'f': token_ += '\f'; return true;
+                case 'n': token_ += '\n'; return true;
+                case 'r': token_ += '\r'; return true;
+                case 't': token_ += '\t'; return true;
+                case 'u':
+                    unicode_ = 0;
+                    unicodeDigits_ = 0;
+                    state_ = State::Unicode;
+                    return true;
+                default:
+                    return fail("invalid escape sequence");
+            }
+
+        case State::Unicode: {
+            int value = hexValue(c);
+            if (value < 0) {
+                return fail("invalid \\u escape");
+            }
+            unicode_ = unicode_ * 16 + static_cast<uint32_t>(value);
+            if (++unicodeDigits_ < 4) {
+                return true;
+            }
+            state_ = State::String;
+            return finishUnicode();
+        }
+
+        case State::Number:
+            if (isDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                token_ += c;
+                return true;
+            }
+            // The character ending the number belongs to the next token
+            return finishNumber() && step(c);
+
+        case State::Literal:
+            if (c != literal_[literalMatched_]) {
+                return fail("invalid literal");
+            }
+            if (literal_[++literalMatched_] == '\0') {
+                if (literal_[0] == 'n') {
+                    addValue(nlohmann::json(nullptr));
+                } else {
+                    addValue(nlohmann::json(literal_[0] == 't'));
+                }
+            }
+            return true;
+
+        case State::Done:
+            if (isWhitespace(c)) {
+                return true;
+            }
+            return fail("unexpected data after the document");
+    }
+    return fail("invalid parser state");
+}
+
+void JsonStreamParser::addValue(nlohmann::json&& value) {
+    if (stack_.empty()) {
+        document_ = std::move(value);
+        state_ = State::Done;
+        return;
+    }
+    auto* container = stack_.back();
+    if (container->is_array()) {
+        container->push_back(std::move(value));
+    } else {
+        (*container)[key_] = std::move(value);
+    }
+    state_ = State::AfterValue;
+}
+
+void JsonStreamParser::openContainer(nlohmann::json&& container) {
+    nlohmann::json* slot;
+    if (stack_.empty()) {
+        document_ = std::move(container);
+        slot = &document_;
+    } else if (stack_.back()->is_array()) {
+        // The parent is not touched again until this container is closed, so the pointer stays valid
+        stack_.back()->push_back(std::move(container));
+        slot = &stack_.back()->back();
+    } else {
+        slot = &((*stack_.back())[key_] = std::move(container));
+    }
+    stack_.push_back(slot);
+}
+
+bool JsonStreamParser::closeContainer(char bracket) {
+    bool isArray = stack_.back()->is_array();
+    if ((bracket == ']') != isArray) {
+        return fail("mismatched closing bracket");
+    }
+    stack_.pop_back();
+    state_ = stack_.empty() ? State::Done : State::AfterValue;
+    return true;
+}
+
+bool JsonStreamParser::finishNumber() {
+    bool integral = false;
+    if (!isValidNumber(token_, integral)) {
+        return fail("invalid number '" + token_ + "'");
+    }
+    const char* first = token_.data();
+    const char* last = first + token_.size();
+    if (integral) {
+        if (token_[0] == '-') {
+            int64_t value;
+            if (std::from_chars(first, last, value).ec == std::errc()) {
+                addValue(nlohmann::json(value));
+                return true;
+            }
+        } else {
+            uint64_t value;
+            if (std::from_chars(first, last, value).ec == std::errc()) {
+                addValue(nlohmann::json(value));
+                return true;
+            }
+        }
+    }
+    // Floats and integers out of range; nlohmann converts them independently of the locale
+    addValue(nlohmann::json::parse(token_));
+    return true;
+}
+
+bool JsonStreamParser::finishUnicode() {
+    uint32_t codeUnit = unicode_;
+    if (highSurrogate_ != 0) {
+        if (codeUnit < 0xDC00 || codeUnit > 0xDFFF) {
+            return fail("unpaired UTF-16 surrogate");
+        }
+        appendUtf8(token_, 0x10000 + ((highSurrogate_ - 0xD800) << 10) + (codeUnit - 0xDC00));
+        highSurrogate_ = 0;
+        return true;
+    }
+    if (codeUnit >= 0xD800 && codeUnit <= 0xDBFF) {
+        highSurrogate_ = codeUnit;
+        return true;
+    }
+    if (codeUnit >= 0xDC00 && codeUnit <= 0xDFFF) {
+        return fail("unpaired UTF-16 surrogate");
+    }
+    appendUtf8(token_, codeUnit);
+    return true;
+}
+
+bool JsonStreamParser::stepUtf8(unsigned char byte) {
+    if (highSurrogate_ != 0) {
+        return fail("unpaired UTF-16 surrogate");
+    }
+    if (utf8Pending_ != 0) {
+        if (byte < utf8Lower_ || byte > utf8Upper_) {
+            return fail("invalid UTF-8 in string");
+        }
+        utf8Pending_--;
+        utf8Lower_ = 0x80;
+        utf8Upper_ = 0xBF;
+        token_ += static_cast<char>(byte);
+        return true;
+    }
+    // Lead bytes per RFC 3629; the range of the first continuation byte
+    // excludes overlong forms, UTF-16 surrogates and code points past U+10FFFF
+    if (byte >= 0xC2 && byte <= 0xDF) {
+        utf8Pending_ = 1;
+    } else if (byte >= 0xE0 && byte <= 0xEF) {
+        utf8Pending_ = 2;
+        if (byte == 0xE0) {
+            utf8Lower_ = 0xA0;
+        } else if (byte == 0xED) {
+            utf8Upper_ = 0x9F;
+        }
+    } else if (byte >= 0xF0 && byte <= 0xF4) {
+        utf8Pending_ = 3;
+        if (byte == 0xF0) {
+            utf8Lower_ = 0x90;
+        } else if (byte == 0xF4) {
+            utf8Upper_ = 0x8F;
+        }
+    } else {
+        return fail("invalid UTF-8 in string");
+    }
+    token_ += static_cast<char>(byte);
+    return true;
+}
+
+bool JsonStreamParser::fail(const std::string& message) {
+    if (error_.empty()) {
+        error_ = message + " at byte " + std::to_string(consumed_);
+    }
+    return false;
+}
+
+} // namespace neocpp
@@ -0,0 +1,98 @@
+#include "neocpp/protocol/loopback_transport.hpp"
+
+namespace neocpp {
+
+LoopbackTransport::LoopbackTransport(const std::string& url) : url_(url), calls_(0) {
+}
+
+void LoopbackTransport::setAnswer(const std::string& method, SharedPtr<const Answer> answer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    answers_[method] = std::move(answer);
+}
+
+void LoopbackTransport::setResult(const std::string& method, const nlohmann::json& result) {
+    setAnswer(method, std::make_shared<Answer>(Answer{"result", result.dump(), nullptr}));
+}
+
+void LoopbackTransport::setError(const std::string& method, int code, const std::string& message) {
+    nlohmann::json error = {{"code", code}, {"message", message}};
+    setAnswer(method, std::make_shared<Answer>(Answer{"error", error.dump(), nullptr}));
+}
+
+void LoopbackTransport::setHandler(const std::string& method, Handler handler) {
+    setAnswer(method, std::make_shared<Answer>(Answer{"result", "", std::move(handler)}));
+}
+
+void LoopbackTransport::answer(const nlohmann::json& call, std::string& out) {
+    calls_++;
+    std::string id = call.is_object() && call.contains("id") ? call["id"].dump() : "null";
+    std::string method = call.is_object() ? call.value("method", "") : "";
+
+    SharedPtr<const Answer> found;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = answers_.find(method);
+        if (it != answers_.end()) {
+            found = it->second;
+        }
+    }
+
+    // Canned answers are appended as stored; only computed ones are serialized here
+    const char* member = "error";
+    std::string computed;
+    const std::string* value = &computed;
+    if (!found) {
+        computed = nlohmann::json{{"code", -32601}, {"message", "Method not found"}}.dump();
+    } else if (found->handler) {
+        try {
+            computed = found->handler(call.value("params", nlohmann::json::array())).dump();
+            member = "result";
+        } catch (const std::exception& e) {
+            computed = nlohmann::json{{"code", -32603}, {"message", e.what()}}.dump();
+        }
+    } else {
+        member = found->member.c_str();
+        value = &found->json;
+    }
+
+    out += "{\"jsonrpc\":\"2.0\",\"id\":";
+    out += id;
+    out += ",\"";
+    out += member;
+    out += "\":";
+    out += *value;
+    out += '}';
+}
+
+HttpResponse LoopbackTransport::postJson(const std::string& body) {
+    HttpResponse response;
+    response.statusCode = 200;
+    response.headers["Content-Type"] = "application/json";
+
+    nlohmann::json request = nlohmann::json::parse(body, nullptr, false);
+    if (request.is_discarded()) {
+        calls_++;
+        response.body = R"({"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Parse error"}})";
+        return response;
+    }
+    if (!request.is_array()) {
+        answer(request, response.body);
+        return response;
+    }
+    response.body += '[';
+    for (size_t i = 0; i < request.size(); ++i) {
+        if (i > 0) {
+            response.body += ',';
+        }
+        answer(request[i], response.body);
+    }
+    response.body += ']';
+    return response;
+}
+
+uint64_t LoopbackTransport::postJsonAsync(const std::string& body, ResponseCallback callback) {
+    callback(postJson(body));
+    return 0;
+}
+
+} // namespace neocpp
@@ -1,18 +1,19 @@
 #include "neocpp/protocol/neo_cpp.hpp"
 #include "neocpp/protocol/neo_rpc_client.hpp"
 #include "neocpp/protocol/http_service.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
 #include "neocpp/transaction/transaction.hpp"
 #include "neocpp/exceptions.hpp"
+#include <algorithm>
 
 namespace neocpp {
 
-NeoCpp::NeoCpp(const NeoCppConfig& config, SharedPtr<HttpService> httpService)
-    : config_(config), httpService_(httpService) {
-    if (!httpService) {
-        throw IllegalArgumentException("HTTP service cannot be null");
+NeoCpp::NeoCpp(const NeoCppConfig& config, SharedPtr<RpcTransport> transport)
+    : config_(config), transport_(transport) {
+    if (!transport) {
+        throw IllegalArgumentException("Transport cannot be null");
     }
-    // Extract base URL from HTTP service if needed
-    rpcClient_ = std::make_shared<NeoRpcClient>(httpService->getUrl());
+    rpcClient_ = std::make_shared<NeoRpcClient>(transport);
 }
 
 NeoCpp::NeoCpp(const std::string& url)
@@ -20,12 +21,12 @@ NeoCpp::NeoCpp(const std::string& url)
     if (url.empty()) {
         throw IllegalArgumentException("URL cannot be empty");
     }
-    httpService_ = std::make_shared<HttpService>(url);
-    rpcClient_ = std::make_shared<NeoRpcClient>(url);
+    transport_ = std::make_shared<HttpService>(url);
+    rpcClient_ = std::make_shared<NeoRpcClient>(transport_);
 }
 
-SharedPtr<NeoCpp> NeoCpp::build(SharedPtr<HttpService> httpService, const NeoCppConfig& config) {
-    return std::make_shared<NeoCpp>(config, httpService);
+SharedPtr<NeoCpp> NeoCpp::build(SharedPtr<RpcTransport> transport, const NeoCppConfig& config) {
+    return std::make_shared<NeoCpp>(config, transport);
 }
 
 SharedPtr<NeoCpp> NeoCpp::build(const std::string& url, const NeoCppConfig& config) {
@@ -33,6 +34,16 @@ SharedPtr<NeoCpp> NeoCpp::build(const std::string& url, const NeoCppConfig& conf
     return std::make_shared<NeoCpp>(config, httpService);
 }
 
+SharedPtr<BlockPolling> NeoCpp::createBlockPolling() {
+    auto polling = std::make_shared<BlockPolling>(rpcClient_, std::chrono::milliseconds(config_.pollingInterval));
+    AdaptivePollingConfig adaptive;
+    adaptive.expectedBlockInterval = std::chrono::milliseconds(config_.blockInterval);
+    adaptive.maxInterval = std::chrono::milliseconds(config_.pollingInterval);
+    adaptive.minInterval = std::min(adaptive.minInterval, adaptive.maxInterval);
+    polling->setAdaptivePolling(adaptive);
+    return polling;
+}
+
 // Convenience methods that delegate to RPC client
 
 uint32_t NeoCpp::getBlockCount() {
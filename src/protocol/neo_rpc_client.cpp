@@ -6,16 +6,260 @@
 #include "neocpp/serialization/binary_writer.hpp"
 #include "neocpp/utils/hex.hpp"
 #include "neocpp/utils/base64.hpp"
+#include "neocpp/utils/thread_pool.hpp"
 #include "neocpp/types/contract_parameter.hpp"
 #include "neocpp/exceptions.hpp"
 #include "neocpp/logger.hpp"
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
 
 namespace neocpp {
 
-NeoRpcClient::NeoRpcClient(const std::string& url) 
-    : url_(url), requestId_(1) {
-    httpService_ = std::make_shared<HttpService>(url);
+NeoRpcClient::NeoRpcClient(const std::string& url)
+    : url_(url), executor_(ThreadPool::getDefault()), singleFlight_(std::make_shared<RpcSingleFlight>()),
+      broadcastWrites_(false), deduplicate_(true), requestId_(1), batchChunkSize_(DEFAULT_BATCH_CHUNK_SIZE) {
+    transport_ = std::make_shared<HttpService>(url);
+}
+
+NeoRpcClient::NeoRpcClient(const std::vector<std::string>& urls, const RpcEndpointConfig& config)
+    : executor_(ThreadPool::getDefault()), singleFlight_(std::make_shared<RpcSingleFlight>()),
+      broadcastWrites_(false), deduplicate_(true), requestId_(1), batchChunkSize_(DEFAULT_BATCH_CHUNK_SIZE) {
+    endpoints_ = std::make_shared<RpcEndpointSet>(urls, config);
+    url_ = urls.front();
+    transport_ = endpoints_->getHttpService(0);
+}
+
+NeoRpcClient::NeoRpcClient(const SharedPtr<RpcTransport>& transport)
+    : transport_(transport), executor_(ThreadPool::getDefault()), singleFlight_(std::make_shared<RpcSingleFlight>()),
+      broadcastWrites_(false), deduplicate_(true), requestId_(1), batchChunkSize_(DEFAULT_BATCH_CHUNK_SIZE) {
+    if (!transport) {
+        throw IllegalArgumentException("Transport cannot be null");
+    }
+    url_ = transport->getUrl();
+}
+
+std::string NeoRpcClient::getUrl() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return url_;
+}
+
+void NeoRpcClient::setUrl(const std::string& url) {
+    auto httpService = std::make_shared<HttpService>(url);
+    auto policy = getPolicy();
+    guard(httpService, policy);
+    auto batcher = getBatcher();
+    if (batcher) {
+        batcher = makeBatcher(httpService, nullptr, policy, batcher->getConfig());
+    }
+    SharedPtr<RpcEndpointSet> endpoints;
+    std::lock_guard<std::mutex> lock(mutex_);
+    url_ = url;
+    transport_ = httpService;
+    endpoints_.swap(endpoints);
+    batcher_.swap(batcher);
+}
+
+SharedPtr<RpcEndpointSet> NeoRpcClient::getEndpoints() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return endpoints_;
+}
+
+SharedPtr<RpcPolicy> NeoRpcClient::getPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void NeoRpcClient::setPolicy(const SharedPtr<RpcPolicy>& policy) {
+    auto endpoints = getEndpoints();
+    if (endpoints) {
+        for (size_t i = 0; i < endpoints->size(); ++i) {
+            guard(endpoints->getHttpService(i), policy);
+        }
+    } else {
+        guard(getTransport(), policy);
+    }
+    auto batcher = getBatcher();
+    if (batcher) {
+        batcher = makeBatcher(getTransport(), endpoints, policy, batcher->getConfig());
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+    batcher_.swap(batcher);
+}
+
+void NeoRpcClient::guard(const SharedPtr<RpcTransport>& transport, const SharedPtr<RpcPolicy>& policy) {
+    auto httpService = std::dynamic_pointer_cast<HttpService>(transport);
+    if (httpService) {
+        httpService->setCircuitBreaker(policy ? policy->getCircuitBreaker(httpService->getUrl()) : nullptr);
+    }
+}
+
+SharedPtr<RpcTransport> NeoRpcClient::getTransport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transport_;
+}
+
+SharedPtr<HttpService> NeoRpcClient::getHttpService() const {
+    return std::dynamic_pointer_cast<HttpService>(getTransport());
+}
+
+HttpTransferStats NeoRpcClient::getTransferStats() const {
+    auto endpoints = getEndpoints();
+    if (!endpoints) {
+        auto httpService = getHttpService();
+        return httpService ? httpService->getTransferStats() : HttpTransferStats();
+    }
+    HttpTransferStats stats;
+    for (size_t i = 0; i < endpoints->size(); ++i) {
+        stats += endpoints->getHttpService(i)->getTransferStats();
+    }
+    return stats;
+}
+
+SharedPtr<ThreadPool> NeoRpcClient::getExecutor() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return executor_;
+}
+
+void NeoRpcClient::setExecutor(const SharedPtr<ThreadPool>& executor) {
+    if (!executor) {
+        throw IllegalArgumentException("Executor cannot be null");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_ = executor;
+}
+
+void NeoRpcClient::enableBatching(const RpcBatchingConfig& config) {
+    auto batcher = makeBatcher(getTransport(), getEndpoints(), getPolicy(), config);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The previous batcher, if any, flushes when its last user lets go of it
+    batcher_.swap(batcher);
+}
+
+void NeoRpcClient::disableBatching() {
+    SharedPtr<RpcBatcher> batcher;
+    std::lock_guard<std::mutex> lock(mutex_);
+    batcher_.swap(batcher);
+}
+
+SharedPtr<RpcBatcher> NeoRpcClient::getBatcher() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batcher_;
+}
+
+SharedPtr<RpcResponseCache> NeoRpcClient::getResponseCache() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_;
+}
+
+void NeoRpcClient::setResponseCache(const SharedPtr<RpcResponseCache>& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_ = cache;
+}
+
+void NeoRpcClient::setBatchChunkSize(size_t chunkSize) {
+    if (chunkSize == 0) {
+        throw IllegalArgumentException("Batch chunk size must be positive");
+    }
+    batchChunkSize_ = chunkSize;
+}
+
+// Post a body through the endpoint set when there is one, otherwise through the single transport
+static void transmitVia(const SharedPtr<RpcTransport>& transport, const SharedPtr<RpcEndpointSet>& endpoints,
+                        const std::string& body, RpcTransport::ResponseCallback callback) {
+    if (endpoints) {
+        endpoints->postAsync(body, std::move(callback));
+    } else {
+        transport->postJsonAsync(body, std::move(callback));
+    }
+}
+
+// Run an attempt under the policy when there is one, otherwise just once
+static void guarded(const SharedPtr<RpcPolicy>& policy, RpcPolicy::Attempt attempt,
+                    HttpService::ResponseCallback callback, bool idempotent) {
+    if (policy) {
+        policy->execute(std::move(attempt), std::move(callback), idempotent);
+    } else {
+        attempt(std::move(callback));
+    }
+}
+
+// Methods that only read node state, so concurrent identical calls may share a reply
+// and a slow request may be hedged on a second endpoint.
+// invokefunction and invokescript are left out because they can open iterator sessions.
+static bool isReadOnlyMethod(const std::string& method) {
+    static const std::unordered_set<std::string> methods = {
+        "calculatenetworkfee", "findstorage", "getapplicationlog", "getbestblockhash",
+        "getblock", "getblockcount", "getblockhash", "getblockheader", "getcommittee",
+        "getconnectioncount", "getcontractstate", "getnep17balances", "getnep17transfers",
+        "getnextblockvalidators", "getpeers", "getproof", "getrawtransaction", "getstateheight",
+        "getstateroot", "getstorage", "gettransactionheight", "getunclaimedgas", "getversion",
+        "getwalletbalance", "validateaddress", "verifyproof"
+    };
+    return methods.count(method) > 0;
+}
+
+// Methods that change node state; with broadcasting on they go to every endpoint
+static bool isBroadcastMethod(const std::string& method) {
+    return method == "sendrawtransaction" || method == "submitblock";
+}
+
+// Check whether a request object or batch contains a write, which is not retried by default
+static bool containsWrite(const nlohmann::json& payload) {
+    if (payload.is_object()) {
+        return isBroadcastMethod(payload.value("method", ""));
+    }
+    for (const auto& request : payload) {
+        if (request.is_object() && isBroadcastMethod(request.value("method", ""))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SharedPtr<RpcBatcher> NeoRpcClient::makeBatcher(const SharedPtr<RpcTransport>& transport,
+                                                const SharedPtr<RpcEndpointSet>& endpoints,
+                                                const SharedPtr<RpcPolicy>& policy,
+                                                const RpcBatchingConfig& config) {
+    return std::make_shared<RpcBatcher>([transport, endpoints, policy](const nlohmann::json& payload, RpcBatcher::ReplyHandler onReply) {
+        auto body = payload.dump();
+        auto attempt = [transport, endpoints, body](RpcTransport::ResponseCallback callback) {
+            transmitVia(transport, endpoints, body, std::move(callback));
+        };
+        guarded(policy, attempt, [onReply](const HttpResponse& response) {
+            nlohmann::json reply;
+            try {
+                reply = HttpService::parseJsonResponse(response);
+            } catch (...) {
+                onReply(nullptr, std::current_exception());
+                return;
+            }
+            onReply(reply, nullptr);
+        }, !containsWrite(payload));
+    }, config);
+}
+
+void NeoRpcClient::transmit(const nlohmann::json& payload, RpcTransport::ResponseCallback callback) {
+    auto endpoints = getEndpoints();
+    auto transport = getTransport();
+    auto body = payload.dump();
+    RpcPolicy::Attempt attempt;
+    if (endpoints && broadcastWrites_ && payload.is_object() && isBroadcastMethod(payload.value("method", ""))) {
+        attempt = [endpoints, body](HttpService::ResponseCallback onResponse) {
+            endpoints->broadcastAsync(body, std::move(onResponse));
+        };
+    } else if (endpoints && payload.is_object() && isReadOnlyMethod(payload.value("method", "")) && endpoints->isHedging()) {
+        attempt = [endpoints, body](HttpService::ResponseCallback onResponse) {
+            endpoints->hedgedPostAsync(body, std::move(onResponse));
+        };
+    } else {
+        attempt = [transport, endpoints, body](RpcTransport::ResponseCallback onResponse) {
+            transmitVia(transport, endpoints, body, std::move(onResponse));
+        };
+    }
+    guarded(getPolicy(), std::move(attempt), std::move(callback), !containsWrite(payload));
 }
 
 // Helper method to create JSON-RPC request
@@ -28,359 +272,555 @@ static nlohmann::json createRequest(const std::string& method, const nlohmann::j
     };
 }
 
-// Helper method to handle response
-static nlohmann::json handleResponse(const nlohmann::json& response) {
+// Helper method to check a response for errors
+static void checkResponse(const nlohmann::json& response) {
     if (response.contains("error")) {
         std::string message = response["error"]["message"];
         throw RpcException("RPC error: " + message);
     }
-    
+
     if (!response.contains("result")) {
         throw RpcException("Invalid RPC response: missing result");
     }
-    
+}
+
+// Helper method to handle response
+static nlohmann::json handleResponse(const nlohmann::json& response) {
+    checkResponse(response);
     return response["result"];
 }
 
+// Take the result out of a response that is no longer needed, without copying it
+static nlohmann::json handleResponse(nlohmann::json&& response) {
+    checkResponse(response);
+    return std::move(response["result"]);
+}
+
+// Result converters shared by the synchronous and asynchronous methods
+
+template<typename T>
+static SharedPtr<T> parseAs(const nlohmann::json& result) {
+    auto response = std::make_shared<T>();
+    response->parseJson(result);
+    return response;
+}
+
+static nlohmann::json asJson(const nlohmann::json& result) {
+    return result;
+}
+
+template<typename T>
+static T asValue(const nlohmann::json& result) {
+    return result.get<T>();
+}
+
+static Hash256 asHash256(const nlohmann::json& result) {
+    return Hash256::fromHexString(result.get<std::string>());
+}
+
+static Hash256 asTransactionHash(const nlohmann::json& result) {
+    return Hash256::fromHexString(result["hash"].get<std::string>());
+}
+
+static int64_t asNetworkFee(const nlohmann::json& result) {
+    return result["networkfee"].get<int64_t>();
+}
+
+static std::vector<std::string> asStringList(const nlohmann::json& result) {
+    std::vector<std::string> items;
+    for (const auto& item : result) {
+        items.push_back(item.get<std::string>());
+    }
+    return items;
+}
+
+static std::vector<nlohmann::json> asJsonList(const nlohmann::json& result) {
+    std::vector<nlohmann::json> items;
+    for (const auto& item : result) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// JSON-RPC "Internal error", used for entries the node never answered
+static constexpr int BATCH_ENTRY_ERROR_CODE = -32603;
+
+static SharedPtr<Response> errorResponse(int id, const Response::Error& error) {
+    auto response = std::make_shared<Response>(error);
+    response->setId(id);
+    return response;
+}
+
+namespace {
+
+/// Shared state of one sendBatch call while its chunks are in flight
+struct BatchCall {
+    std::mutex mutex;
+    std::vector<SharedPtr<Response>> responses;
+    std::unordered_map<int, size_t> indexById;
+    size_t remainingChunks = 0;
+    std::promise<std::vector<SharedPtr<Response>>> promise;
+
+    /// Record the reply to one chunk; completes the call after the last chunk
+    void complete(const nlohmann::json& chunk, const nlohmann::json& reply, const std::string& failure) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure.empty() && reply.is_array()) {
+            for (const auto& item : reply) {
+                if (!item.contains("id") || !item["id"].is_number_integer()) {
+                    continue;
+                }
+                int id = item["id"].get<int>();
+                auto it = indexById.find(id);
+                if (it == indexById.end()) {
+                    continue;
+                }
+                // A malformed entry fails on its own instead of leaving the call incomplete
+                try {
+                    responses[it->second] = Response::fromJson(item);
+                } catch (const std::exception& e) {
+                    responses[it->second] = errorResponse(id, Response::Error(BATCH_ENTRY_ERROR_CODE,
+                        std::string("Malformed response for request id ") + std::to_string(id) + ": " + e.what()));
+                }
+            }
+        } else {
+            // The whole chunk failed: a transport error, or a single error object for the batch
+            Response::Error error(BATCH_ENTRY_ERROR_CODE, failure.empty() ? "Invalid batch response" : failure);
+            if (failure.empty()) {
+                try {
+                    auto whole = Response::fromJson(reply);
+                    if (whole->hasError()) {
+                        error = *whole->getError();
+                    }
+                } catch (const std::exception&) {
+                    // Keep the generic error for a reply that is not a response object
+                }
+            }
+            for (const auto& request : chunk) {
+                int id = request["id"].get<int>();
+                responses[indexById[id]] = errorResponse(id, error);
+            }
+        }
+
+        if (--remainingChunks > 0) {
+            return;
+        }
+        for (const auto& [id, index] : indexById) {
+            if (!responses[index]) {
+                responses[index] = errorResponse(id, Response::Error(BATCH_ENTRY_ERROR_CODE,
+                    "Missing response for request id " + std::to_string(id)));
+            }
+        }
+        promise.set_value(std::move(responses));
+    }
+};
+
+} // namespace
+
+// Parameter encoders shared by the synchronous and asynchronous methods
+
+static std::string encodeTransaction(const SharedPtr<Transaction>& transaction) {
+    BinaryWriter writer;
+    transaction->serialize(writer);
+    return Base64::encode(writer.toArray());
+}
+
+static std::string encodeStorageKey(const std::string& hexKey) {
+    return Base64::encode(Hex::decode(hexKey));
+}
+
+static nlohmann::json invokeFunctionParams(const Hash160& scriptHash, const std::string& method,
+                                           const nlohmann::json& params, const nlohmann::json& signers) {
+    return nlohmann::json::array({scriptHash.toString(), method, params, signers});
+}
+
+static nlohmann::json batchPayload(const std::vector<std::pair<std::string, nlohmann::json>>& requests,
+                                   const std::function<int()>& nextId) {
+    nlohmann::json batch = nlohmann::json::array();
+    for (const auto& [method, params] : requests) {
+        batch.push_back(createRequest(method, params, nextId()));
+    }
+    return batch;
+}
+
+std::string NeoRpcClient::sharedCallKey(const std::string& method, const nlohmann::json& params) const {
+    if (!deduplicate_ || !isReadOnlyMethod(method)) {
+        return "";
+    }
+    return RpcSingleFlight::makeKey(method, params);
+}
+
+void NeoRpcClient::send(const nlohmann::json& payload, RpcBatcher::ReplyHandler onReply) {
+    auto executor = getExecutor();
+
+    auto batcher = getBatcher();
+    bool broadcast = broadcastWrites_ && payload.is_object() && isBroadcastMethod(payload.value("method", ""));
+    if (batcher && payload.is_object() && !broadcast) {
+        batcher->submit(payload, [executor, onReply](const nlohmann::json& reply, std::exception_ptr error) {
+            executor->submit([onReply, reply, error]() {
+                onReply(reply, error);
+            });
+        });
+        return;
+    }
+
+    // The event loop thread only hands the raw reply over; parsing runs on the executor
+    transmit(payload, [executor, onReply](const HttpResponse& response) {
+        executor->submit([onReply, response]() mutable {
+            nlohmann::json reply;
+            try {
+                reply = HttpService::parseJsonResponse(std::move(response));
+            } catch (...) {
+                onReply(nullptr, std::current_exception());
+                return;
+            }
+            onReply(reply, nullptr);
+        });
+    });
+}
+
+nlohmann::json NeoRpcClient::exchange(const nlohmann::json& request) {
+    auto endpoints = getEndpoints();
+    bool broadcast = broadcastWrites_ && isBroadcastMethod(request.value("method", ""));
+    auto batcher = getBatcher();
+    if (batcher && !broadcast) {
+        return batcher->submit(request).get();
+    }
+    if (getPolicy()) {
+        // Retries and the concurrency limit are driven by the asynchronous path
+        std::promise<HttpResponse> done;
+        transmit(request, [&done](const HttpResponse& response) {
+            done.set_value(response);
+        });
+        return HttpService::parseJsonResponse(done.get_future().get());
+    }
+    if (!endpoints) {
+        return HttpService::parseJsonResponse(getTransport()->postJson(request.dump()));
+    }
+    bool hedge = endpoints->isHedging() && isReadOnlyMethod(request.value("method", ""));
+    if (!broadcast && !hedge) {
+        return HttpService::parseJsonResponse(endpoints->post(request.dump()));
+    }
+    std::promise<HttpResponse> done;
+    auto onResponse = [&done](const HttpResponse& response) {
+        done.set_value(response);
+    };
+    if (broadcast) {
+        endpoints->broadcastAsync(request.dump(), onResponse);
+    } else {
+        endpoints->hedgedPostAsync(request.dump(), onResponse);
+    }
+    return HttpService::parseJsonResponse(done.get_future().get());
+}
+
+// Methods whose results may be cached, with how long each result stays valid.
+// Verbose blocks and transactions carry a confirmation count, so they only last
+// until the next block; invocations that opened an iterator session are not cached.
+static bool isCacheableMethod(const std::string& method) {
+    static const std::unordered_set<std::string> methods = {
+        "getblockhash", "getapplicationlog", "gettransactionheight", "validateaddress",
+        "verifyproof", "getproof", "getstateroot", "getblock", "getblockheader",
+        "getrawtransaction", "getblockcount", "getbestblockhash", "getnep17balances",
+        "getnep17transfers", "getcontractstate", "getstorage", "findstorage", "getcommittee",
+        "getnextblockvalidators", "getunclaimedgas", "getstateheight", "calculatenetworkfee",
+        "invokefunction", "invokescript"
+    };
+    return methods.count(method) > 0;
+}
+
+static bool cacheLifetime(const std::string& method, const nlohmann::json& result,
+                          RpcResponseCache::Lifetime& lifetime) {
+    static const std::unordered_set<std::string> immutable = {
+        "getblockhash", "getapplicationlog", "gettransactionheight", "validateaddress",
+        "verifyproof", "getproof", "getstateroot", "getblock", "getblockheader", "getrawtransaction"
+    };
+    if (!isCacheableMethod(method)) {
+        return false;
+    }
+    if ((method == "invokefunction" || method == "invokescript") && result.contains("session")) {
+        return false;
+    }
+    bool confirmations = result.is_object() && result.contains("confirmations");
+    // A verbose transaction still in the mempool gains its block fields once included;
+    // only the raw bytes never change
+    bool unconfirmed = method == "getrawtransaction" && result.is_object() && !result.contains("blockhash");
+    lifetime = immutable.count(method) > 0 && !confirmations && !unconfirmed
+        ? RpcResponseCache::Lifetime::Immutable
+        : RpcResponseCache::Lifetime::UntilNextBlock;
+    return true;
+}
+
+static void cacheResult(RpcResponseCache& cache, const std::string& key, const std::string& method,
+                        const nlohmann::json& reply, uint64_t generation) {
+    if (!reply.is_object() || reply.contains("error") || !reply.contains("result")) {
+        return;
+    }
+    RpcResponseCache::Lifetime lifetime;
+    if (cacheLifetime(method, reply["result"], lifetime)) {
+        cache.put(key, reply["result"], lifetime, generation);
+    }
+}
+
+// Wrap a reply handler so that successful results are cached before it runs
+static RpcBatcher::ReplyHandler storingResult(const SharedPtr<RpcResponseCache>& cache, const std::string& key,
+                                              const std::string& method, uint64_t generation,
+                                              RpcBatcher::ReplyHandler onReply) {
+    if (!cache || key.empty()) {
+        return onReply;
+    }
+    return [cache, key, method, generation, onReply](const nlohmann::json& reply, std::exception_ptr error) {
+        if (!error) {
+            cacheResult(*cache, key, method, reply, generation);
+        }
+        onReply(reply, error);
+    };
+}
+
+// Resolve a promise from a reply handler, converting the reply on the way
+template<typename T, typename Convert>
+static RpcBatcher::ReplyHandler resolveWith(const SharedPtr<std::promise<T>>& promise, Convert convert) {
+    return [promise, convert](const nlohmann::json& reply, std::exception_ptr error) {
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            promise->set_value(convert(reply));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    };
+}
+
+template<typename T, typename Convert>
+std::future<T> NeoRpcClient::callAsync(const std::string& method, const nlohmann::json& params, Convert convert) {
+    auto promise = std::make_shared<std::promise<T>>();
+    auto cache = getResponseCache();
+    std::string cacheKey;
+    uint64_t generation = 0;
+    if (cache && isCacheableMethod(method)) {
+        cacheKey = RpcSingleFlight::makeKey(method, params);
+        nlohmann::json cached;
+        if (cache->get(cacheKey, cached)) {
+            resolveWith(promise, convert)(cached, nullptr);
+            return promise->get_future();
+        }
+        generation = cache->getGeneration();
+    }
+
+    auto onReply = resolveWith(promise, [convert](const nlohmann::json& response) {
+        return convert(handleResponse(response));
+    });
+    auto request = createRequest(method, params, getNextRequestId());
+
+    auto key = sharedCallKey(method, params);
+    if (key.empty()) {
+        send(request, storingResult(cache, cacheKey, method, generation, onReply));
+    } else if (singleFlight_->join(key, onReply)) {
+        auto singleFlight = singleFlight_;
+        send(request, storingResult(cache, cacheKey, method, generation,
+            [singleFlight, key](const nlohmann::json& reply, std::exception_ptr error) {
+                singleFlight->complete(key, reply, error);
+            }));
+    }
+    return promise->get_future();
+}
+
+// Node methods
+
 SharedPtr<NeoGetVersionResponse> NeoRpcClient::getVersion() {
-    auto request = createRequest("getversion", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto versionResponse = std::make_shared<NeoGetVersionResponse>();
-    versionResponse->parseJson(result);
-    return versionResponse;
+    return parseAs<NeoGetVersionResponse>(sendRequest("getversion"));
 }
 
 int NeoRpcClient::getConnectionCount() {
-    auto request = createRequest("getconnectioncount", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result.get<int>();
+    return sendRequest("getconnectioncount").get<int>();
 }
 
 SharedPtr<NeoGetPeersResponse> NeoRpcClient::getPeers() {
-    auto request = createRequest("getpeers", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto peersResponse = std::make_shared<NeoGetPeersResponse>();
-    peersResponse->parseJson(result);
-    return peersResponse;
+    return parseAs<NeoGetPeersResponse>(sendRequest("getpeers"));
 }
 
 nlohmann::json NeoRpcClient::validateAddress(const std::string& address) {
-    auto request = createRequest("validateaddress", nlohmann::json::array({address}), requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("validateaddress", nlohmann::json::array({address}));
 }
 
+// Blockchain methods
+
 Hash256 NeoRpcClient::getBestBlockHash() {
-    auto request = createRequest("getbestblockhash", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return Hash256::fromHexString(result.get<std::string>());
+    return asHash256(sendRequest("getbestblockhash"));
 }
 
 SharedPtr<NeoGetBlockResponse> NeoRpcClient::getBlock(const Hash256& hash, bool verbose) {
-    auto params = nlohmann::json::array({hash.toString(), verbose});
-    auto request = createRequest("getblock", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto blockResponse = std::make_shared<NeoGetBlockResponse>();
-    blockResponse->parseJson(result);
-    return blockResponse;
+    return parseAs<NeoGetBlockResponse>(sendRequest("getblock", nlohmann::json::array({hash.toString(), verbose})));
 }
 
 SharedPtr<NeoGetBlockResponse> NeoRpcClient::getBlock(uint32_t index, bool verbose) {
-    auto params = nlohmann::json::array({index, verbose});
-    auto request = createRequest("getblock", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto blockResponse = std::make_shared<NeoGetBlockResponse>();
-    blockResponse->parseJson(result);
-    return blockResponse;
+    return parseAs<NeoGetBlockResponse>(sendRequest("getblock", nlohmann::json::array({index, verbose})));
 }
 
 uint32_t NeoRpcClient::getBlockCount() {
-    auto request = createRequest("getblockcount", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result.get<uint32_t>();
+    return sendRequest("getblockcount").get<uint32_t>();
 }
 
 Hash256 NeoRpcClient::getBlockHash(uint32_t index) {
-    auto request = createRequest("getblockhash", nlohmann::json::array({index}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return Hash256::fromHexString(result.get<std::string>());
+    return asHash256(sendRequest("getblockhash", nlohmann::json::array({index})));
 }
 
 nlohmann::json NeoRpcClient::getBlockHeader(const Hash256& hash, bool verbose) {
-    auto params = nlohmann::json::array({hash.toString(), verbose});
-    auto request = createRequest("getblockheader", params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getblockheader", nlohmann::json::array({hash.toString(), verbose}));
 }
 
 nlohmann::json NeoRpcClient::getBlockHeader(uint32_t index, bool verbose) {
-    auto params = nlohmann::json::array({index, verbose});
-    auto request = createRequest("getblockheader", params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getblockheader", nlohmann::json::array({index, verbose}));
 }
 
 std::vector<std::string> NeoRpcClient::getCommittee() {
-    auto request = createRequest("getcommittee", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    std::vector<std::string> committee;
-    for (const auto& item : result) {
-        committee.push_back(item.get<std::string>());
-    }
-    return committee;
+    return asStringList(sendRequest("getcommittee"));
 }
 
 SharedPtr<NeoGetContractStateResponse> NeoRpcClient::getContractState(const Hash160& hash) {
-    auto request = createRequest("getcontractstate", nlohmann::json::array({hash.toString()}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto contractResponse = std::make_shared<NeoGetContractStateResponse>();
-    contractResponse->parseJson(result);
-    return contractResponse;
+    return parseAs<NeoGetContractStateResponse>(sendRequest("getcontractstate", nlohmann::json::array({hash.toString()})));
 }
 
-
 std::vector<nlohmann::json> NeoRpcClient::getNextBlockValidators() {
-    auto request = createRequest("getnextblockvalidators", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    std::vector<nlohmann::json> validators;
-    for (const auto& item : result) {
-        validators.push_back(item);
-    }
-    return validators;
+    return asJsonList(sendRequest("getnextblockvalidators"));
 }
 
 SharedPtr<NeoGetRawTransactionResponse> NeoRpcClient::getRawTransaction(const Hash256& hash, bool verbose) {
-    auto params = nlohmann::json::array({hash.toString(), verbose});
-    auto request = createRequest("getrawtransaction", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto txResponse = std::make_shared<NeoGetRawTransactionResponse>();
-    txResponse->parseJson(result);
-    return txResponse;
+    return parseAs<NeoGetRawTransactionResponse>(sendRequest("getrawtransaction", nlohmann::json::array({hash.toString(), verbose})));
 }
 
 SharedPtr<NeoGetApplicationLogResponse> NeoRpcClient::getApplicationLog(const Hash256& hash) {
-    auto request = createRequest("getapplicationlog", nlohmann::json::array({hash.toString()}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto logResponse = std::make_shared<NeoGetApplicationLogResponse>();
-    logResponse->parseJson(result);
-    return logResponse;
+    return parseAs<NeoGetApplicationLogResponse>(sendRequest("getapplicationlog", nlohmann::json::array({hash.toString()})));
 }
 
 std::string NeoRpcClient::getStorage(const Hash160& scriptHash, const std::string& key) {
-    Bytes keyBytes = Hex::decode(key);
-    std::string base64Key = Base64::encode(keyBytes);
-    auto params = nlohmann::json::array({scriptHash.toString(), base64Key});
-    auto request = createRequest("getstorage", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result.get<std::string>();
+    return sendRequest("getstorage", nlohmann::json::array({scriptHash.toString(), encodeStorageKey(key)})).get<std::string>();
 }
 
 uint32_t NeoRpcClient::getTransactionHeight(const Hash256& txId) {
-    auto request = createRequest("gettransactionheight", nlohmann::json::array({txId.toString()}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result.get<uint32_t>();
+    return sendRequest("gettransactionheight", nlohmann::json::array({txId.toString()})).get<uint32_t>();
 }
 
 SharedPtr<NeoGetUnclaimedGasResponse> NeoRpcClient::getUnclaimedGas(const std::string& address) {
-    auto request = createRequest("getunclaimedgas", nlohmann::json::array({address}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto gasResponse = std::make_shared<NeoGetUnclaimedGasResponse>();
-    gasResponse->parseJson(result);
-    return gasResponse;
+    return parseAs<NeoGetUnclaimedGasResponse>(sendRequest("getunclaimedgas", nlohmann::json::array({address})));
 }
 
 SharedPtr<NeoGetNep17BalancesResponse> NeoRpcClient::getNep17Balances(const std::string& address) {
-    auto request = createRequest("getnep17balances", nlohmann::json::array({address}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto balancesResponse = std::make_shared<NeoGetNep17BalancesResponse>();
-    balancesResponse->parseJson(result);
-    return balancesResponse;
+    return parseAs<NeoGetNep17BalancesResponse>(sendRequest("getnep17balances", nlohmann::json::array({address})));
 }
 
 nlohmann::json NeoRpcClient::getNep17Transfers(const std::string& address, uint64_t startTime, uint64_t endTime) {
-    auto params = nlohmann::json::array({address, startTime, endTime});
-    auto request = createRequest("getnep17transfers", params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getnep17transfers", nlohmann::json::array({address, startTime, endTime}));
 }
 
+// Invocation methods
 
-SharedPtr<NeoInvokeResultResponse> NeoRpcClient::invokeFunction(const Hash160& scriptHash, 
+SharedPtr<NeoInvokeResultResponse> NeoRpcClient::invokeFunction(const Hash160& scriptHash,
                                                                 const std::string& method,
                                                                 const nlohmann::json& params,
                                                                 const nlohmann::json& signers) {
-    auto requestParams = nlohmann::json::array({
-        scriptHash.toString(),
-        method,
-        params,
-        signers
-    });
-    
-    auto request = createRequest("invokefunction", requestParams, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto invokeResponse = std::make_shared<NeoInvokeResultResponse>();
-    invokeResponse->parseJson(result);
-    return invokeResponse;
+    return parseAs<NeoInvokeResultResponse>(sendRequest("invokefunction", invokeFunctionParams(scriptHash, method, params, signers)));
 }
 
 SharedPtr<NeoInvokeResultResponse> NeoRpcClient::invokeScript(const Bytes& script,
                                                               const nlohmann::json& signers) {
-    std::string base64Script = Base64::encode(script);
-    
-    auto params = nlohmann::json::array({base64Script, signers});
-    auto request = createRequest("invokescript", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto invokeResponse = std::make_shared<NeoInvokeResultResponse>();
-    invokeResponse->parseJson(result);
-    return invokeResponse;
+    return invokeScript(Base64::encode(script), signers);
 }
 
 SharedPtr<NeoInvokeResultResponse> NeoRpcClient::invokeScript(const std::string& base64Script,
                                                               const nlohmann::json& signers) {
-    auto params = nlohmann::json::array({base64Script, signers});
-    auto request = createRequest("invokescript", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto invokeResponse = std::make_shared<NeoInvokeResultResponse>();
-    invokeResponse->parseJson(result);
-    return invokeResponse;
+    return parseAs<NeoInvokeResultResponse>(sendRequest("invokescript", nlohmann::json::array({base64Script, signers})));
 }
 
+// Transaction methods
 
 Hash256 NeoRpcClient::sendRawTransaction(const SharedPtr<Transaction>& transaction) {
-    BinaryWriter writer;
-    transaction->serialize(writer);
-    Bytes rawTx = writer.toArray();
-    std::string base64Tx = Base64::encode(rawTx);
-    
-    auto request = createRequest("sendrawtransaction", nlohmann::json::array({base64Tx}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    return Hash256::fromHexString(result["hash"].get<std::string>());
+    return sendRawTransaction(encodeTransaction(transaction));
 }
 
 Hash256 NeoRpcClient::sendRawTransaction(const std::string& hex) {
-    auto request = createRequest("sendrawtransaction", nlohmann::json::array({hex}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    return Hash256::fromHexString(result["hash"].get<std::string>());
+    return asTransactionHash(sendRequest("sendrawtransaction", nlohmann::json::array({hex})));
 }
 
 SharedPtr<NeoGetWalletBalanceResponse> NeoRpcClient::getWalletBalance(const Hash160& assetHash, const std::string& address) {
-    auto request = createRequest("getwalletbalance", nlohmann::json::array({assetHash.toString(), address}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    
-    auto balanceResponse = std::make_shared<NeoGetWalletBalanceResponse>();
-    balanceResponse->parseJson(result);
-    return balanceResponse;
+    return parseAs<NeoGetWalletBalanceResponse>(sendRequest("getwalletbalance", nlohmann::json::array({assetHash.toString(), address})));
 }
 
-
 int64_t NeoRpcClient::calculateNetworkFee(const SharedPtr<Transaction>& transaction) {
-    BinaryWriter writer;
-    transaction->serialize(writer);
-    Bytes rawTx = writer.toArray();
-    std::string base64Tx = Base64::encode(rawTx);
-    
-    auto request = createRequest("calculatenetworkfee", nlohmann::json::array({base64Tx}), requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result["networkfee"].get<int64_t>();
+    return asNetworkFee(sendRequest("calculatenetworkfee", nlohmann::json::array({encodeTransaction(transaction)})));
 }
 
+// State methods
 
 nlohmann::json NeoRpcClient::getStateHeight() {
-    auto request = createRequest("getstateheight", nlohmann::json::array(), requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getstateheight");
 }
 
 nlohmann::json NeoRpcClient::getStateRoot(uint32_t index) {
-    auto request = createRequest("getstateroot", nlohmann::json::array({index}), requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getstateroot", nlohmann::json::array({index}));
 }
 
 nlohmann::json NeoRpcClient::getProof(const Hash256& rootHash, const Hash160& contractHash, const std::string& key) {
-    Bytes keyBytes = Hex::decode(key);
-    std::string base64Key = Base64::encode(keyBytes);
-    auto params = nlohmann::json::array({rootHash.toString(), contractHash.toString(), base64Key});
-    auto request = createRequest("getproof", params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("getproof", nlohmann::json::array({rootHash.toString(), contractHash.toString(), encodeStorageKey(key)}));
 }
 
 bool NeoRpcClient::verifyProof(const Hash256& rootHash, const std::string& proof) {
-    auto params = nlohmann::json::array({rootHash.toString(), proof});
-    auto request = createRequest("verifyproof", params, requestId_++);
-    auto response = httpService_->post(request);
-    auto result = handleResponse(response);
-    return result.get<bool>();
+    return sendRequest("verifyproof", nlohmann::json::array({rootHash.toString(), proof})).get<bool>();
 }
 
-
 nlohmann::json NeoRpcClient::findStorage(const Hash160& scriptHash, const std::string& prefix) {
-    auto params = nlohmann::json::array({scriptHash.toString(), prefix});
-    auto request = createRequest("findstorage", params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
+    return sendRequest("findstorage", nlohmann::json::array({scriptHash.toString(), prefix}));
 }
 
+// Raw JSON-RPC methods
+
 nlohmann::json NeoRpcClient::sendRequest(const std::string& method, const nlohmann::json& params) {
-    auto request = createRequest(method, params, requestId_++);
-    auto response = httpService_->post(request);
-    return handleResponse(response);
-}
+    auto cache = getResponseCache();
+    std::string cacheKey;
+    uint64_t generation = 0;
+    if (cache && isCacheableMethod(method)) {
+        cacheKey = RpcSingleFlight::makeKey(method, params);
+        nlohmann::json cached;
+        if (cache->get(cacheKey, cached)) {
+            return cached;
+        }
+        generation = cache->getGeneration();
+    }
 
-std::vector<nlohmann::json> NeoRpcClient::sendBatch(const std::vector<std::pair<std::string, nlohmann::json>>& requests) {
-    nlohmann::json batch = nlohmann::json::array();
-    for (const auto& [method, params] : requests) {
-        batch.push_back(createRequest(method, params, requestId_++));
+    auto request = createRequest(method, params, getNextRequestId());
+    auto key = sharedCallKey(method, params);
+    if (key.empty()) {
+        auto reply = exchange(request);
+        if (cache && !cacheKey.empty()) {
+            cacheResult(*cache, cacheKey, method, reply, generation);
+        }
+        return handleResponse(std::move(reply));
     }
-    
-    auto response = httpService_->post(batch);
-    
-    std::vector<nlohmann::json> results;
-    for (const auto& item : response) {
-        results.push_back(handleResponse(item));
+
+    std::promise<nlohmann::json> shared;
+    auto future = shared.get_future();
+    bool leader = singleFlight_->join(key, [&shared](const nlohmann::json& reply, std::exception_ptr error) {
+        if (error) {
+            shared.set_exception(error);
+        } else {
+            shared.set_value(reply);
+        }
+    });
+    if (leader) {
+        try {
+            auto reply = exchange(request);
+            if (cache && !cacheKey.empty()) {
+                cacheResult(*cache, cacheKey, method, reply, generation);
+            }
+            singleFlight_->complete(key, reply, nullptr);
+        } catch (...) {
+            singleFlight_->complete(key, nullptr, std::current_exception());
+        }
     }
-    return results;
+    return handleResponse(future.get());
+}
+
+std::vector<SharedPtr<Response>> NeoRpcClient::sendBatch(const std::vector<std::pair<std::string, nlohmann::json>>& requests) {
+    return sendBatchAsync(requests).get();
 }
 
 int NeoRpcClient::getNextRequestId() {
@@ -388,7 +828,7 @@ int NeoRpcClient::getNextRequestId() {
 }
 
 nlohmann::json NeoRpcClient::buildRequest(const std::string& method, const nlohmann::json& params) {
-    return createRequest(method, params, requestId_++);
+    return createRequest(method, params, getNextRequestId());
 }
 
 nlohmann::json NeoRpcClient::parseResponse(const std::string& response) {
@@ -403,19 +843,214 @@ void NeoRpcClient::handleError(const nlohmann::json& error) {
     throw RpcException(message);
 }
 
+// Iterator methods
+
 nlohmann::json NeoRpcClient::traverseIterator(const std::string& sessionId, const std::string& iteratorId, uint32_t count) {
-    nlohmann::json params = nlohmann::json::array();
-    params.push_back(sessionId);
-    params.push_back(iteratorId);
-    params.push_back(count);
-    return sendRequest("traverseiterator", params);
+    return sendRequest("traverseiterator", nlohmann::json::array({sessionId, iteratorId, count}));
 }
 
 bool NeoRpcClient::terminateSession(const std::string& sessionId) {
-    nlohmann::json params = nlohmann::json::array();
-    params.push_back(sessionId);
-    auto result = sendRequest("terminatesession", params);
-    return result.contains("result") && result["result"].get<bool>();
+    return sendRequest("terminatesession", nlohmann::json::array({sessionId})).get<bool>();
+}
+
+// Asynchronous methods
+
+std::future<SharedPtr<NeoGetVersionResponse>> NeoRpcClient::getVersionAsync() {
+    return callAsync<SharedPtr<NeoGetVersionResponse>>("getversion", nlohmann::json::array(), parseAs<NeoGetVersionResponse>);
+}
+
+std::future<int> NeoRpcClient::getConnectionCountAsync() {
+    return callAsync<int>("getconnectioncount", nlohmann::json::array(), asValue<int>);
+}
+
+std::future<SharedPtr<NeoGetPeersResponse>> NeoRpcClient::getPeersAsync() {
+    return callAsync<SharedPtr<NeoGetPeersResponse>>("getpeers", nlohmann::json::array(), parseAs<NeoGetPeersResponse>);
+}
+
+std::future<nlohmann::json> NeoRpcClient::validateAddressAsync(const std::string& address) {
+    return callAsync<nlohmann::json>("validateaddress", nlohmann::json::array({address}), asJson);
+}
+
+std::future<Hash256> NeoRpcClient::getBestBlockHashAsync() {
+    return callAsync<Hash256>("getbestblockhash", nlohmann::json::array(), asHash256);
+}
+
+std::future<SharedPtr<NeoGetBlockResponse>> NeoRpcClient::getBlockAsync(const Hash256& hash, bool verbose) {
+    return callAsync<SharedPtr<NeoGetBlockResponse>>("getblock", nlohmann::json::array({hash.toString(), verbose}),
+                                                     parseAs<NeoGetBlockResponse>);
+}
+
+std::future<SharedPtr<NeoGetBlockResponse>> NeoRpcClient::getBlockAsync(uint32_t index, bool verbose) {
+    return callAsync<SharedPtr<NeoGetBlockResponse>>("getblock", nlohmann::json::array({index, verbose}),
+                                                     parseAs<NeoGetBlockResponse>);
+}
+
+std::future<uint32_t> NeoRpcClient::getBlockCountAsync() {
+    return callAsync<uint32_t>("getblockcount", nlohmann::json::array(), asValue<uint32_t>);
+}
+
+std::future<Hash256> NeoRpcClient::getBlockHashAsync(uint32_t index) {
+    return callAsync<Hash256>("getblockhash", nlohmann::json::array({index}), asHash256);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getBlockHeaderAsync(const Hash256& hash, bool verbose) {
+    return callAsync<nlohmann::json>("getblockheader", nlohmann::json::array({hash.toString(), verbose}), asJson);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getBlockHeaderAsync(uint32_t index, bool verbose) {
+    return callAsync<nlohmann::json>("getblockheader", nlohmann::json::array({index, verbose}), asJson);
+}
+
+std::future<SharedPtr<NeoGetRawTransactionResponse>> NeoRpcClient::getRawTransactionAsync(const Hash256& txId, bool verbose) {
+    return callAsync<SharedPtr<NeoGetRawTransactionResponse>>("getrawtransaction", nlohmann::json::array({txId.toString(), verbose}),
+                                                              parseAs<NeoGetRawTransactionResponse>);
+}
+
+std::future<uint32_t> NeoRpcClient::getTransactionHeightAsync(const Hash256& txId) {
+    return callAsync<uint32_t>("gettransactionheight", nlohmann::json::array({txId.toString()}), asValue<uint32_t>);
+}
+
+std::future<SharedPtr<NeoGetContractStateResponse>> NeoRpcClient::getContractStateAsync(const Hash160& scriptHash) {
+    return callAsync<SharedPtr<NeoGetContractStateResponse>>("getcontractstate", nlohmann::json::array({scriptHash.toString()}),
+                                                             parseAs<NeoGetContractStateResponse>);
+}
+
+std::future<SharedPtr<NeoGetNep17BalancesResponse>> NeoRpcClient::getNep17BalancesAsync(const std::string& address) {
+    return callAsync<SharedPtr<NeoGetNep17BalancesResponse>>("getnep17balances", nlohmann::json::array({address}),
+                                                             parseAs<NeoGetNep17BalancesResponse>);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getNep17TransfersAsync(const std::string& address, uint64_t startTime, uint64_t endTime) {
+    return callAsync<nlohmann::json>("getnep17transfers", nlohmann::json::array({address, startTime, endTime}), asJson);
+}
+
+std::future<std::string> NeoRpcClient::getStorageAsync(const Hash160& scriptHash, const std::string& key) {
+    return callAsync<std::string>("getstorage", nlohmann::json::array({scriptHash.toString(), encodeStorageKey(key)}),
+                                  asValue<std::string>);
+}
+
+std::future<nlohmann::json> NeoRpcClient::findStorageAsync(const Hash160& scriptHash, const std::string& prefix) {
+    return callAsync<nlohmann::json>("findstorage", nlohmann::json::array({scriptHash.toString(), prefix}), asJson);
+}
+
+std::future<SharedPtr<NeoInvokeResultResponse>> NeoRpcClient::invokeFunctionAsync(const Hash160& scriptHash,
+                                                                                   const std::string& method,
+                                                                                   const nlohmann::json& params,
+                                                                                   const nlohmann::json& signers) {
+    return callAsync<SharedPtr<NeoInvokeResultResponse>>("invokefunction", invokeFunctionParams(scriptHash, method, params, signers),
+                                                         parseAs<NeoInvokeResultResponse>);
+}
+
+std::future<SharedPtr<NeoInvokeResultResponse>> NeoRpcClient::invokeScriptAsync(const Bytes& script,
+                                                                                 const nlohmann::json& signers) {
+    return invokeScriptAsync(Base64::encode(script), signers);
+}
+
+std::future<SharedPtr<NeoInvokeResultResponse>> NeoRpcClient::invokeScriptAsync(const std::string& base64Script,
+                                                                                 const nlohmann::json& signers) {
+    return callAsync<SharedPtr<NeoInvokeResultResponse>>("invokescript", nlohmann::json::array({base64Script, signers}),
+                                                         parseAs<NeoInvokeResultResponse>);
+}
+
+std::future<Hash256> NeoRpcClient::sendRawTransactionAsync(const SharedPtr<Transaction>& transaction) {
+    return sendRawTransactionAsync(encodeTransaction(transaction));
+}
+
+std::future<Hash256> NeoRpcClient::sendRawTransactionAsync(const std::string& hex) {
+    return callAsync<Hash256>("sendrawtransaction", nlohmann::json::array({hex}), asTransactionHash);
+}
+
+std::future<int64_t> NeoRpcClient::calculateNetworkFeeAsync(const SharedPtr<Transaction>& transaction) {
+    return callAsync<int64_t>("calculatenetworkfee", nlohmann::json::array({encodeTransaction(transaction)}), asNetworkFee);
+}
+
+std::future<SharedPtr<NeoGetApplicationLogResponse>> NeoRpcClient::getApplicationLogAsync(const Hash256& txId) {
+    return callAsync<SharedPtr<NeoGetApplicationLogResponse>>("getapplicationlog", nlohmann::json::array({txId.toString()}),
+                                                              parseAs<NeoGetApplicationLogResponse>);
+}
+
+std::future<SharedPtr<NeoGetUnclaimedGasResponse>> NeoRpcClient::getUnclaimedGasAsync(const std::string& address) {
+    return callAsync<SharedPtr<NeoGetUnclaimedGasResponse>>("getunclaimedgas", nlohmann::json::array({address}),
+                                                            parseAs<NeoGetUnclaimedGasResponse>);
+}
+
+std::future<SharedPtr<NeoGetWalletBalanceResponse>> NeoRpcClient::getWalletBalanceAsync(const Hash160& assetHash, const std::string& address) {
+    return callAsync<SharedPtr<NeoGetWalletBalanceResponse>>("getwalletbalance", nlohmann::json::array({assetHash.toString(), address}),
+                                                             parseAs<NeoGetWalletBalanceResponse>);
+}
+
+std::future<std::vector<std::string>> NeoRpcClient::getCommitteeAsync() {
+    return callAsync<std::vector<std::string>>("getcommittee", nlohmann::json::array(), asStringList);
+}
+
+std::future<std::vector<nlohmann::json>> NeoRpcClient::getNextBlockValidatorsAsync() {
+    return callAsync<std::vector<nlohmann::json>>("getnextblockvalidators", nlohmann::json::array(), asJsonList);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getStateRootAsync(uint32_t index) {
+    return callAsync<nlohmann::json>("getstateroot", nlohmann::json::array({index}), asJson);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getProofAsync(const Hash256& rootHash, const Hash160& contractHash, const std::string& key) {
+    return callAsync<nlohmann::json>("getproof", nlohmann::json::array({rootHash.toString(), contractHash.toString(), encodeStorageKey(key)}),
+                                     asJson);
+}
+
+std::future<bool> NeoRpcClient::verifyProofAsync(const Hash256& rootHash, const std::string& proof) {
+    return callAsync<bool>("verifyproof", nlohmann::json::array({rootHash.toString(), proof}), asValue<bool>);
+}
+
+std::future<nlohmann::json> NeoRpcClient::getStateHeightAsync() {
+    return callAsync<nlohmann::json>("getstateheight", nlohmann::json::array(), asJson);
+}
+
+std::future<nlohmann::json> NeoRpcClient::traverseIteratorAsync(const std::string& sessionId, const std::string& iteratorId, uint32_t count) {
+    return callAsync<nlohmann::json>("traverseiterator", nlohmann::json::array({sessionId, iteratorId, count}), asJson);
+}
+
+std::future<bool> NeoRpcClient::terminateSessionAsync(const std::string& sessionId) {
+    return callAsync<bool>("terminatesession", nlohmann::json::array({sessionId}), asValue<bool>);
+}
+
+std::future<nlohmann::json> NeoRpcClient::sendRequestAsync(const std::string& method, const nlohmann::json& params) {
+    return callAsync<nlohmann::json>(method, params, asJson);
+}
+
+std::future<std::vector<SharedPtr<Response>>> NeoRpcClient::sendBatchAsync(const std::vector<std::pair<std::string, nlohmann::json>>& requests) {
+    auto batch = batchPayload(requests, [this]() { return getNextRequestId(); });
+    auto call = std::make_shared<BatchCall>();
+    auto future = call->promise.get_future();
+    if (batch.empty()) {
+        call->promise.set_value({});
+        return future;
+    }
+
+    call->responses.resize(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        call->indexById[batch[i]["id"].get<int>()] = i;
+    }
+
+    // Oversized batches go out as several POSTs in flight together on the event loop
+    size_t chunkSize = getBatchChunkSize();
+    call->remainingChunks = (batch.size() + chunkSize - 1) / chunkSize;
+    auto executor = getExecutor();
+    for (size_t start = 0; start < batch.size(); start += chunkSize) {
+        auto end = batch.begin() + std::min(start + chunkSize, batch.size());
+        nlohmann::json chunk(batch.begin() + start, end);
+        transmit(chunk, [call, executor, chunk](const HttpResponse& response) {
+            executor->submit([call, chunk, response]() mutable {
+                nlohmann::json reply;
+                std::string failure;
+                try {
+                    reply = HttpService::parseJsonResponse(std::move(response));
+                } catch (const std::exception& e) {
+                    failure = e.what();
+                }
+                call->complete(chunk, reply, failure);
+            });
+        });
+    }
+    return future;
 }
 
-} // namespace neocpp
\ No newline at end of file
+} // namespace neocpp
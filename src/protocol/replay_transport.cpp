@@ -0,0 +1,188 @@
+#include "neocpp/protocol/replay_transport.hpp"
+#include "neocpp/protocol/rpc_single_flight.hpp"
+#include "neocpp/exceptions.hpp"
+#include <fstream>
+#include <istream>
+#include <ostream>
+
+namespace neocpp {
+
+static std::string methodOf(const nlohmann::json& call) {
+    return call.is_object() ? call.value("method", "") : "";
+}
+
+RecordingTransport::RecordingTransport(SharedPtr<RpcTransport> inner)
+    : inner_(std::move(inner)), log_(std::make_shared<Log>()) {
+    if (!inner_) {
+        throw IllegalArgumentException("Transport cannot be null");
+    }
+}
+
+std::vector<RpcExchange> RecordingTransport::getExchanges() const {
+    std::lock_guard<std::mutex> lock(log_->mutex);
+    return log_->exchanges;
+}
+
+void RecordingTransport::save(std::ostream& out) const {
+    for (const auto& exchange : getExchanges()) {
+        out << nlohmann::json{{"request", exchange.request}, {"response", exchange.response}}.dump() << '\n';
+    }
+}
+
+void RecordingTransport::save(const std::string& path) const {
+    std::ofstream out(path);
+    save(out);
+    if (!out) {
+        throw IllegalStateException("Cannot write recording to " + path);
+    }
+}
+
+void RecordingTransport::record(Log& log, const std::string& body, const HttpResponse& response) {
+    if (!response.isSuccess()) {
+        return;
+    }
+    nlohmann::json reply;
+    if (response.json) {
+        reply = *response.json;
+    } else {
+        reply = nlohmann::json::parse(response.body, nullptr, false);
+    }
+    nlohmann::json request = nlohmann::json::parse(body, nullptr, false);
+    if (reply.is_discarded() || request.is_discarded()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(log.mutex);
+    if (request.is_object() && reply.is_object()) {
+        log.exchanges.push_back({std::move(request), std::move(reply)});
+        return;
+    }
+    if (!request.is_array() || !reply.is_array()) {
+        return;
+    }
+    // Batch replies may come back in any order
+    std::unordered_map<std::string, const nlohmann::json*> byId;
+    for (const auto& item : reply) {
+        if (item.is_object() && item.contains("id")) {
+            byId[item["id"].dump()] = &item;
+        }
+    }
+    for (auto& call : request) {
+        if (!call.is_object() || !call.contains("id")) {
+            continue;
+        }
+        auto it = byId.find(call["id"].dump());
+        if (it != byId.end()) {
+            log.exchanges.push_back({call, *it->second});
+        }
+    }
+}
+
+HttpResponse RecordingTransport::postJson(const std::string& body) {
+    HttpResponse response = inner_->postJson(body);
+    record(*log_, body, response);
+    return response;
+}
+
+uint64_t RecordingTransport::postJsonAsync(const std::string& body, ResponseCallback callback) {
+    auto log = log_;
+    return inner_->postJsonAsync(body, [log, body, callback](const HttpResponse& response) {
+        record(*log, body, response);
+        callback(response);
+    });
+}
+
+ReplayTransport::ReplayTransport(const std::vector<RpcExchange>& exchanges, const std::string& url)
+    : url_(url), misses_(0) {
+    for (const auto& exchange : exchanges) {
+        replies_[key(exchange.request)].responses.push_back(exchange.response);
+    }
+}
+
+SharedPtr<ReplayTransport> ReplayTransport::load(std::istream& in, const std::string& url) {
+    std::vector<RpcExchange> exchanges;
+    std::string line;
+    size_t number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        auto entry = nlohmann::json::parse(line, nullptr, false);
+        if (!entry.is_object() || !entry.contains("request") || !entry.contains("response")) {
+            throw IllegalArgumentException("Line " + std::to_string(number) + " is not a recorded call");
+        }
+        exchanges.push_back({std::move(entry["request"]), std::move(entry["response"])});
+    }
+    return std::make_shared<ReplayTransport>(exchanges, url);
+}
+
+SharedPtr<ReplayTransport> ReplayTransport::load(const std::string& path, const std::string& url) {
+    std::ifstream in(path);
+    if (!in) {
+        throw IllegalArgumentException("Cannot read recording " + path);
+    }
+    return load(in, url);
+}
+
+std::string ReplayTransport::key(const nlohmann::json& call) {
+    if (!call.is_object()) {
+        return std::string();
+    }
+    return RpcSingleFlight::makeKey(methodOf(call), call.value("params", nlohmann::json::array()));
+}
+
+bool ReplayTransport::answer(const nlohmann::json& call, nlohmann::json& reply) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = replies_.find(key(call));
+        if (it == replies_.end()) {
+            misses_++;
+            return false;
+        }
+        auto& replies = it->second;
+        reply = replies.responses[replies.next];
+        if (replies.next + 1 < replies.responses.size()) {
+            replies.next++;
+        }
+    }
+    reply["id"] = call.is_object() && call.contains("id") ? call["id"] : nlohmann::json(nullptr);
+    return true;
+}
+
+HttpResponse ReplayTransport::postJson(const std::string& body) {
+    HttpResponse response;
+    nlohmann::json request = nlohmann::json::parse(body, nullptr, false);
+    if (request.is_discarded()) {
+        response.error = "Request body is not JSON";
+        return response;
+    }
+
+    nlohmann::json reply;
+    if (request.is_array()) {
+        reply = nlohmann::json::array();
+        for (const auto& call : request) {
+            nlohmann::json item;
+            if (!answer(call, item)) {
+                response.error = "No recorded reply for " + methodOf(call);
+                return response;
+            }
+            reply.push_back(std::move(item));
+        }
+    } else if (!answer(request, reply)) {
+        response.error = "No recorded reply for " + methodOf(request);
+        return response;
+    }
+
+    response.statusCode = 200;
+    response.headers["Content-Type"] = "application/json";
+    response.body = reply.dump();
+    return response;
+}
+
+uint64_t ReplayTransport::postJsonAsync(const std::string& body, ResponseCallback callback) {
+    callback(postJson(body));
+    return 0;
+}
+
+} // namespace neocpp
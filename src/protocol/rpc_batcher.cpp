@@ -0,0 +1,167 @@
+#include "neocpp/protocol/rpc_batcher.hpp"
+#include "neocpp/exceptions.hpp"
+#include <unordered_map>
+#include <algorithm>
+
+namespace neocpp {
+
+// Deliver a reply, keeping the batcher alive if the handler throws
+static void deliver(const RpcBatcher::ReplyHandler& onReply, const nlohmann::json& reply, std::exception_ptr error) {
+    try {
+        onReply(reply, error);
+    } catch (...) {
+        // Ignore handler errors
+    }
+}
+
+RpcBatcher::RpcBatcher(Sender sender, const RpcBatchingConfig& config)
+    : sender_(std::move(sender)), config_(config), stopping_(false) {
+    if (!sender_) {
+        throw IllegalArgumentException("Batch sender cannot be null");
+    }
+    if (config_.maxBatchSize == 0) {
+        throw IllegalArgumentException("Maximum batch size must be positive");
+    }
+    flusher_ = std::thread(&RpcBatcher::flushLoop, this);
+}
+
+RpcBatcher::~RpcBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+void RpcBatcher::submit(const nlohmann::json& request, ReplyHandler onReply) {
+    if (!request.contains("id")) {
+        throw IllegalArgumentException("Batched requests need an id");
+    }
+    size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw IllegalStateException("Batcher is shutting down");
+        }
+        pending_.push_back({request, std::move(onReply), std::chrono::steady_clock::now()});
+        queued = pending_.size();
+    }
+    // The flusher only needs waking for the first request of a window or a full batch
+    if (queued == 1 || queued >= config_.maxBatchSize) {
+        condition_.notify_one();
+    }
+}
+
+std::future<nlohmann::json> RpcBatcher::submit(const nlohmann::json& request) {
+    auto promise = std::make_shared<std::promise<nlohmann::json>>();
+    submit(request, [promise](const nlohmann::json& reply, std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(reply);
+        }
+    });
+    return promise->get_future();
+}
+
+void RpcBatcher::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        condition_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;
+        }
+
+        // Hold the window open until it expires or the batch is full
+        auto deadline = pending_.front().enqueuedAt + config_.window;
+        condition_.wait_until(lock, deadline, [this]() {
+            return stopping_ || pending_.size() >= config_.maxBatchSize;
+        });
+
+        size_t count = std::min(pending_.size(), config_.maxBatchSize);
+        std::vector<Pending> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(pending_.front()));
+            pending_.pop_front();
+        }
+
+        lock.unlock();
+        dispatch(std::move(batch));
+        lock.lock();
+    }
+}
+
+void RpcBatcher::dispatch(std::vector<Pending> batch) {
+    auto now = std::chrono::steady_clock::now();
+    batchSizes_.record(batch.size());
+    nlohmann::json payload = nlohmann::json::array();
+    for (const auto& entry : batch) {
+        windowWaits_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - entry.enqueuedAt).count()));
+        payload.push_back(entry.request);
+    }
+    if (batch.size() == 1) {
+        // A lone request goes out as-is rather than as a one-element batch
+        payload = payload[0];
+    }
+
+    auto entries = std::make_shared<std::vector<Pending>>(std::move(batch));
+    auto onReply = [entries](const nlohmann::json& reply, std::exception_ptr error) {
+        if (error) {
+            for (const auto& entry : *entries) {
+                deliver(entry.onReply, nullptr, error);
+            }
+            return;
+        }
+
+        if (!reply.is_array()) {
+            if (entries->size() == 1) {
+                deliver(entries->front().onReply, reply, nullptr);
+                return;
+            }
+            // A single object answering a batch is a batch-level error
+            std::string message = "Batch rejected";
+            // Read defensively: a throw here would leave every entry unanswered
+            if (reply.is_object() && reply.contains("error") && reply["error"].is_object()) {
+                const auto& details = reply["error"];
+                if (details.contains("message") && details["message"].is_string()) {
+                    message += ": " + details.value("message", std::string());
+                }
+            }
+            auto batchError = std::make_exception_ptr(RpcException(message));
+            for (const auto& entry : *entries) {
+                deliver(entry.onReply, nullptr, batchError);
+            }
+            return;
+        }
+
+        std::unordered_map<std::string, const nlohmann::json*> repliesById;
+        for (const auto& item : reply) {
+            if (item.contains("id")) {
+                repliesById[item["id"].dump()] = &item;
+            }
+        }
+        for (const auto& entry : *entries) {
+            std::string id = entry.request["id"].dump();
+            auto it = repliesById.find(id);
+            if (it != repliesById.end()) {
+                deliver(entry.onReply, *it->second, nullptr);
+            } else {
+                deliver(entry.onReply, nullptr,
+                        std::make_exception_ptr(RpcException("Missing response for request id " + id)));
+            }
+        }
+    };
+
+    try {
+        sender_(payload, onReply);
+    } catch (...) {
+        onReply(nullptr, std::current_exception());
+    }
+}
+
+} // namespace neocpp
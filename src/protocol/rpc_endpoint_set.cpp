@@ -0,0 +1,481 @@
+#include "neocpp/protocol/rpc_endpoint_set.hpp"
+#include "neocpp/protocol/http_event_loop.hpp"
+#include "neocpp/utils/timer_queue.hpp"
+#include "neocpp/exceptions.hpp"
+#include <limits>
+#include <algorithm>
+
+namespace neocpp {
+
+// Extra latency weight per unit of error rate when ranking endpoints
+static constexpr double ERROR_RATE_PENALTY = 4.0;
+
+static const std::string& probeBody() {
+    static const std::string body = nlohmann::json{
+        {"jsonrpc", "2.0"}, {"method", "getblockcount"}, {"params", nlohmann::json::array()}, {"id", 1}
+    }.dump();
+    return body;
+}
+
+RpcEndpointSet::RpcEndpointSet(const std::vector<std::string>& urls, const RpcEndpointConfig& config)
+    : config_(config), probes_(std::make_shared<ProbeState>()), hedging_(false),
+      currentWindow_(0), windowStart_(std::chrono::steady_clock::now()),
+      hedgedRequests_(0), hedgesFired_(0), hedgesWon_(0) {
+    if (urls.empty()) {
+        throw IllegalArgumentException("At least one endpoint is required");
+    }
+    if (config_.ewmaAlpha <= 0.0 || config_.ewmaAlpha > 1.0) {
+        throw IllegalArgumentException("EWMA weight must be in (0, 1]");
+    }
+    for (const auto& url : urls) {
+        Endpoint endpoint;
+        endpoint.httpService = std::make_shared<HttpService>(url);
+        endpoint.stats.url = url;
+        endpoints_.push_back(endpoint);
+    }
+    probes_->set = this;
+    if (config_.probeInterval.count() > 0) {
+        prober_ = std::thread(&RpcEndpointSet::probeLoop, probes_, config_.probeInterval);
+    }
+}
+
+RpcEndpointSet::~RpcEndpointSet() {
+    {
+        std::lock_guard<std::recursive_mutex> lock(probes_->mutex);
+        probes_->set = nullptr;
+    }
+    probes_->condition.notify_all();
+    if (prober_.joinable()) {
+        // The last reference may drop in a completion handler or timer task. The prober
+        // no longer touches the set, so let it exit on its own instead of blocking there.
+        if (HttpEventLoop::isLoopThread() || TimerQueue::isTimerThread()) {
+            prober_.detach();
+        } else {
+            prober_.join();
+        }
+    }
+}
+
+HttpResponse RpcEndpointSet::post(const std::string& body) {
+    std::vector<bool> tried(endpoints_.size(), false);
+    HttpResponse response;
+    for (size_t index = select(tried); index < endpoints_.size(); index = select(tried)) {
+        tried[index] = true;
+        auto start = std::chrono::steady_clock::now();
+        response = endpoints_[index].httpService->postJson(body);
+        bool failed = isTransportFailure(response);
+        record(index, std::chrono::steady_clock::now() - start, !failed);
+        if (!failed) {
+            break;
+        }
+    }
+    return response;
+}
+
+void RpcEndpointSet::postAsync(const std::string& body, HttpService::ResponseCallback callback) {
+    attemptAsync(body, std::move(callback), std::make_shared<std::vector<bool>>(endpoints_.size(), false));
+}
+
+void RpcEndpointSet::attemptAsync(const std::string& body, HttpService::ResponseCallback callback,
+                                  SharedPtr<std::vector<bool>> tried) {
+    size_t index = select(*tried);
+    (*tried)[index] = true;
+    auto self = shared_from_this();
+    auto start = std::chrono::steady_clock::now();
+    endpoints_[index].httpService->postJsonAsync(body, [self, index, start, body, callback, tried](const HttpResponse& response) {
+        bool failed = isTransportFailure(response);
+        self->record(index, std::chrono::steady_clock::now() - start, !failed);
+        if (failed && self->select(*tried) < self->endpoints_.size()) {
+            self->attemptAsync(body, callback, tried);
+            return;
+        }
+        callback(response);
+    });
+}
+
+void RpcEndpointSet::broadcastAsync(const std::string& body, HttpService::ResponseCallback callback) {
+    struct Broadcast {
+        std::mutex mutex;
+        size_t remaining;
+        bool delivered = false;
+        int bestRank = -1;
+        HttpResponse best;
+    };
+    auto state = std::make_shared<Broadcast>();
+    state->remaining = endpoints_.size();
+    auto self = shared_from_this();
+
+    for (size_t index = 0; index < endpoints_.size(); ++index) {
+        auto start = std::chrono::steady_clock::now();
+        endpoints_[index].httpService->postJsonAsync(body, [self, state, index, start, callback](const HttpResponse& response) {
+            bool failed = isTransportFailure(response);
+            self->record(index, std::chrono::steady_clock::now() - start, !failed);
+
+            // Rank: 0 failed, 1 answered, 2 answered without a JSON-RPC error
+            int rank = 0;
+            if (!failed && response.isSuccess()) {
+                rank = 1;
+                try {
+                    // Peek without consuming a streamed document; the caller parses it later
+                    auto isClean = [](const nlohmann::json& reply) {
+                        return reply.is_object() && !reply.contains("error");
+                    };
+                    if (response.json ? isClean(*response.json) : isClean(nlohmann::json::parse(response.body))) {
+                        rank = 2;
+                    }
+                } catch (...) {
+                    // Unparseable replies keep rank 1
+                }
+            }
+
+            bool deliverNow = false;
+            HttpResponse chosen;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->remaining--;
+                if (rank > state->bestRank || (rank == 0 && state->bestRank == 0)) {
+                    state->bestRank = rank;
+                    state->best = response;
+                }
+                if (!state->delivered && (rank == 2 || state->remaining == 0)) {
+                    state->delivered = true;
+                    deliverNow = true;
+                    chosen = state->best;
+                }
+            }
+            if (deliverNow) {
+                callback(chosen);
+            }
+        });
+    }
+}
+
+void RpcEndpointSet::hedgedPostAsync(const std::string& body, HttpService::ResponseCallback callback) {
+    // Shared by the primary request, the hedge timer and the hedge
+    struct Race {
+        std::mutex mutex;
+        bool done = false;
+        bool hedged = false;
+        size_t outstanding = 0;
+        uint64_t timerId = 0;
+        size_t endpoints[2] = {0, 0};
+        uint64_t transfers[2] = {0, 0};
+        bool finished[2] = {false, false};
+        // Set when the other attempt won before this one's transfer id was stored
+        bool cancelPending[2] = {false, false};
+        std::chrono::steady_clock::time_point starts[2];
+        std::vector<bool> tried;
+    };
+    auto race = std::make_shared<Race>();
+    race->tried.assign(endpoints_.size(), false);
+    auto self = shared_from_this();
+    hedgedRequests_++;
+
+    // Send the request to the next best endpoint as attempt 0 (primary) or 1 (hedge).
+    // The launcher refers to itself weakly; its callbacks and the timer keep it alive.
+    auto launch = std::make_shared<std::function<void(size_t)>>();
+    std::weak_ptr<std::function<void(size_t)>> weakLaunch = launch;
+    *launch = [self, race, body, callback, weakLaunch](size_t attempt) {
+        auto launch = weakLaunch.lock();
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            index = self->select(race->tried);
+            if (race->done || (attempt == 1 && race->hedged) || index >= self->endpoints_.size()) {
+                return;
+            }
+            race->tried[index] = true;
+            race->endpoints[attempt] = index;
+            race->starts[attempt] = std::chrono::steady_clock::now();
+            race->outstanding++;
+            if (attempt == 1) {
+                race->hedged = true;
+            }
+        }
+
+        uint64_t transfer = self->endpoints_[index].httpService->postJsonAsync(body,
+            [self, race, attempt, index, callback, launch](const HttpResponse& response) {
+                bool failed = isTransportFailure(response);
+                bool startHedge = false;
+                uint64_t timerId = 0;
+                uint64_t loser = 0;
+                size_t loserIndex = 0;
+                auto now = std::chrono::steady_clock::now();
+                auto start = now;
+                auto loserStart = now;
+                {
+                    std::lock_guard<std::mutex> lock(race->mutex);
+                    race->outstanding--;
+                    race->finished[attempt] = true;
+                    timerId = race->timerId;
+                    start = race->starts[attempt];
+                    if (race->done) {
+                        // The other attempt already won; this one was cancelled
+                        return;
+                    }
+                    if (failed && race->outstanding > 0) {
+                        // Let the other attempt decide the outcome
+                        self->record(index, now - start, false);
+                        return;
+                    }
+                    if (failed && !race->hedged && self->select(race->tried) < self->endpoints_.size()) {
+                        // Fail over right away instead of waiting for the hedge timer
+                        startHedge = true;
+                    } else {
+                        race->done = true;
+                        size_t other = 1 - attempt;
+                        if (race->outstanding > 0) {
+                            loser = race->transfers[other];
+                            loserIndex = race->endpoints[other];
+                            loserStart = race->starts[other];
+                            // Still being sent; the launcher cancels it once it has the id
+                            race->cancelPending[other] = loser == 0;
+                        }
+                    }
+                }
+                self->record(index, now - start, !failed);
+                TimerQueue::getDefault()->cancel(timerId);
+                if (startHedge) {
+                    (*launch)(1);
+                    return;
+                }
+                if (loser != 0) {
+                    self->endpoints_[loserIndex].httpService->cancel(loser);
+                    // The loser took at least this long, so selection learns to avoid it
+                    self->recordSlow(loserIndex, now - loserStart);
+                }
+                if (attempt == 1 && !failed) {
+                    self->hedgesWon_++;
+                }
+                callback(response);
+            });
+
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            race->transfers[attempt] = transfer;
+            if (!race->cancelPending[attempt] || race->finished[attempt]) {
+                return;
+            }
+        }
+        self->endpoints_[index].httpService->cancel(transfer);
+        self->recordSlow(index, std::chrono::steady_clock::now() - race->starts[attempt]);
+    };
+
+    (*launch)(0);
+    auto timerId = TimerQueue::getDefault()->schedule(getHedgeDelay(), [self, race, launch]() {
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            if (race->done || race->hedged || self->select(race->tried) >= self->endpoints_.size()) {
+                return;
+            }
+        }
+        self->hedgesFired_++;
+        (*launch)(1);
+    });
+    std::lock_guard<std::mutex> lock(race->mutex);
+    race->timerId = timerId;
+}
+
+void RpcEndpointSet::enableHedging(const RpcHedgingConfig& config) {
+    if (config.percentile <= 0.0 || config.percentile > 100.0) {
+        throw IllegalArgumentException("Hedging percentile must be in (0, 100]");
+    }
+    if (config.window.count() <= 0) {
+        throw IllegalArgumentException("Hedging latency window must be positive");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    hedgingConfig_ = config;
+    hedging_ = true;
+}
+
+void RpcEndpointSet::disableHedging() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hedging_ = false;
+}
+
+bool RpcEndpointSet::isHedging() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hedging_;
+}
+
+std::chrono::microseconds RpcEndpointSet::getHedgeDelay() const {
+    RpcHedgingConfig config;
+    Histogram recent;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config = hedgingConfig_;
+        // Windows that record() has not rotated yet may already be over
+        auto age = std::chrono::steady_clock::now() - windowStart_;
+        if (age < 2 * config.window) {
+            recent.merge(recentLatencies_[currentWindow_]);
+        }
+        if (age < config.window) {
+            recent.merge(recentLatencies_[1 - currentWindow_]);
+        }
+    }
+    if (recent.getCount() < config.minSamples) {
+        return config.initialDelay;
+    }
+    auto delay = std::chrono::microseconds(recent.getPercentile(config.percentile));
+    return std::max<std::chrono::microseconds>(delay, config.minDelay);
+}
+
+RpcHedgeStats RpcEndpointSet::getHedgeStats() const {
+    RpcHedgeStats stats;
+    stats.requests = hedgedRequests_;
+    stats.fired = hedgesFired_;
+    stats.won = hedgesWon_;
+    return stats;
+}
+
+std::future<void> RpcEndpointSet::probe() {
+    struct Round {
+        std::atomic<size_t> remaining;
+        std::promise<void> done;
+    };
+    auto round = std::make_shared<Round>();
+    round->remaining = endpoints_.size();
+    auto done = round->done.get_future();
+    auto probes = probes_;
+    for (size_t index = 0; index < endpoints_.size(); ++index) {
+        auto start = std::chrono::steady_clock::now();
+        endpoints_[index].httpService->postJsonAsync(probeBody(), [probes, round, index, start](const HttpResponse& response) {
+            bool failed = isTransportFailure(response);
+            uint32_t blockCount = 0;
+            if (!failed) {
+                try {
+                    blockCount = HttpService::parseJsonResponse(response)["result"].get<uint32_t>();
+                } catch (...) {
+                    failed = true;
+                }
+            }
+            {
+                std::lock_guard<std::recursive_mutex> lock(probes->mutex);
+                if (auto* set = probes->set) {
+                    set->record(index, std::chrono::steady_clock::now() - start, !failed);
+                    if (!failed) {
+                        std::lock_guard<std::mutex> setLock(set->mutex_);
+                        set->endpoints_[index].stats.blockCount = blockCount;
+                    }
+                }
+            }
+            if (--round->remaining == 0) {
+                round->done.set_value();
+            }
+        });
+    }
+    return done;
+}
+
+SharedPtr<HttpService> RpcEndpointSet::getHttpService(size_t index) const {
+    if (index >= endpoints_.size()) {
+        throw IllegalArgumentException("Endpoint index out of range");
+    }
+    return endpoints_[index].httpService;
+}
+
+std::vector<RpcEndpointStats> RpcEndpointSet::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<RpcEndpointStats> stats;
+    for (const auto& endpoint : endpoints_) {
+        stats.push_back(endpoint.stats);
+    }
+    return stats;
+}
+
+size_t RpcEndpointSet::select(const std::vector<bool>& tried) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t highest = 0;
+    for (const auto& endpoint : endpoints_) {
+        if (endpoint.stats.healthy && endpoint.stats.blockCount > highest) {
+            highest = endpoint.stats.blockCount;
+        }
+    }
+
+    // Prefer healthy nodes that keep up with the chain; fall back to any untried node
+    size_t best = endpoints_.size();
+    size_t fallback = endpoints_.size();
+    double bestScore = std::numeric_limits<double>::max();
+    double fallbackScore = std::numeric_limits<double>::max();
+    for (size_t index = 0; index < endpoints_.size(); ++index) {
+        if (tried[index]) {
+            continue;
+        }
+        const auto& stats = endpoints_[index].stats;
+        double score = (stats.latencyMs + 1.0) * (1.0 + ERROR_RATE_PENALTY * stats.errorRate);
+        bool lagging = stats.blockCount != 0 && stats.blockCount + config_.maxBlockLag < highest;
+        if (stats.healthy && !lagging && score < bestScore) {
+            best = index;
+            bestScore = score;
+        }
+        if (score < fallbackScore) {
+            fallback = index;
+            fallbackScore = score;
+        }
+    }
+    return best < endpoints_.size() ? best : fallback;
+}
+
+void RpcEndpointSet::record(size_t index, std::chrono::steady_clock::duration latency, bool success) {
+    double alpha = config_.ewmaAlpha;
+    double latencyMs = std::chrono::duration<double, std::milli>(latency).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& endpoint = endpoints_[index];
+    auto& stats = endpoint.stats;
+    stats.requests++;
+    stats.errorRate = alpha * (success ? 0.0 : 1.0) + (1.0 - alpha) * stats.errorRate;
+    if (success) {
+        auto us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+        latencies_.record(us);
+        rotateLatencyWindows(std::chrono::steady_clock::now());
+        recentLatencies_[currentWindow_].record(us);
+        bool first = stats.latencyMs == 0.0;
+        stats.latencyMs = first ? latencyMs : alpha * latencyMs + (1.0 - alpha) * stats.latencyMs;
+        endpoint.consecutiveFailures = 0;
+        stats.healthy = true;
+    } else if (++endpoint.consecutiveFailures >= config_.unhealthyAfter) {
+        stats.healthy = false;
+    }
+}
+
+void RpcEndpointSet::rotateLatencyWindows(std::chrono::steady_clock::time_point now) {
+    auto age = now - windowStart_;
+    if (age < hedgingConfig_.window) {
+        return;
+    }
+    // The current window becomes the previous one, unless it is over as well
+    currentWindow_ = 1 - currentWindow_;
+    recentLatencies_[currentWindow_].reset();
+    if (age >= 2 * hedgingConfig_.window) {
+        recentLatencies_[1 - currentWindow_].reset();
+    }
+    windowStart_ = now;
+}
+
+void RpcEndpointSet::recordSlow(size_t index, std::chrono::steady_clock::duration elapsed) {
+    double latencyMs = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stats = endpoints_[index].stats;
+    if (latencyMs > stats.latencyMs) {
+        bool first = stats.latencyMs == 0.0;
+        stats.latencyMs = first ? latencyMs : config_.ewmaAlpha * latencyMs + (1.0 - config_.ewmaAlpha) * stats.latencyMs;
+    }
+}
+
+void RpcEndpointSet::probeLoop(SharedPtr<ProbeState> probes, std::chrono::milliseconds interval) {
+    // Holding the lock while probing only covers submitting the requests, which never
+    // waits for the event loop, so the destructor is not held up by a probe round
+    std::unique_lock<std::recursive_mutex> lock(probes->mutex);
+    while (probes->set) {
+        probes->set->probe();
+        probes->condition.wait_for(lock, interval, [&probes]() { return probes->set == nullptr; });
+    }
+}
+
+bool RpcEndpointSet::isTransportFailure(const HttpResponse& response) {
+    return response.isTransientFailure();
+}
+
+} // namespace neocpp
@@ -0,0 +1,86 @@
+#include "neocpp/protocol/rpc_policy.hpp"
+#include "neocpp/utils/timer_queue.hpp"
+#include "neocpp/exceptions.hpp"
+#include <random>
+#include <algorithm>
+
+namespace neocpp {
+
+/// One request while its attempts are running
+struct RpcPolicy::Call {
+    Attempt attempt;
+    HttpService::ResponseCallback callback;
+    bool retryable;
+    uint32_t attempts = 0;
+};
+
+RpcPolicy::RpcPolicy(const RpcPolicyConfig& config) : config_(config), retries_(0) {
+    if (config.retry.maxAttempts == 0) {
+        throw IllegalArgumentException("Retry policy needs at least one attempt");
+    }
+    if (config.limitConcurrency) {
+        limiter_ = std::make_shared<AimdLimiter>(config.limiter);
+    }
+}
+
+SharedPtr<CircuitBreaker> RpcPolicy::getCircuitBreaker(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& breaker = breakers_[url];
+    if (!breaker) {
+        breaker = std::make_shared<CircuitBreaker>(config_.circuitBreaker);
+    }
+    return breaker;
+}
+
+std::chrono::milliseconds RpcPolicy::backoff(const RpcRetryConfig& config, uint32_t retry) {
+    thread_local std::mt19937_64 random(std::random_device{}());
+    int64_t cap = config.maxBackoff.count();
+    int64_t delay = config.initialBackoff.count();
+    for (uint32_t i = 0; i < retry && delay < cap; ++i) {
+        delay *= 2;
+    }
+    delay = std::min(delay, cap);
+    std::uniform_int_distribution<int64_t> jitter(0, delay / 2);
+    return std::chrono::milliseconds(delay - delay / 2 + jitter(random));
+}
+
+void RpcPolicy::execute(Attempt attempt, HttpService::ResponseCallback callback, bool idempotent) {
+    auto call = std::make_shared<Call>();
+    call->attempt = std::move(attempt);
+    call->callback = std::move(callback);
+    call->retryable = idempotent || config_.retry.retryWrites;
+    run(call);
+}
+
+void RpcPolicy::run(const SharedPtr<Call>& call) {
+    auto self = shared_from_this();
+    auto start = [self, call]() {
+        auto begin = std::chrono::steady_clock::now();
+        call->attempt([self, call, begin](const HttpResponse& response) {
+            bool transient = isTransient(response);
+            if (self->limiter_ && response.circuitOpen) {
+                // Failed fast without reaching the node; says nothing about its load
+                self->limiter_->release();
+            } else if (self->limiter_) {
+                self->limiter_->release(std::chrono::steady_clock::now() - begin, transient);
+            }
+            uint32_t retry = call->attempts++;
+            if (!transient || !call->retryable || call->attempts >= self->config_.retry.maxAttempts) {
+                call->callback(response);
+                return;
+            }
+            self->retries_++;
+            TimerQueue::getDefault()->schedule(backoff(self->config_.retry, retry), [self, call]() {
+                self->run(call);
+            });
+        });
+    };
+
+    if (limiter_) {
+        limiter_->acquire(std::move(start));
+    } else {
+        start();
+    }
+}
+
+} // namespace neocpp
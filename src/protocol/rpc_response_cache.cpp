@@ -0,0 +1,116 @@
+#include "neocpp/protocol/rpc_response_cache.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/exceptions.hpp"
+
+namespace neocpp {
+
+void RpcResponseCache::invalidateOn(const SharedPtr<RpcResponseCache>& cache, BlockPolling& polling) {
+    if (!cache) {
+        throw IllegalArgumentException("Cache cannot be null");
+    }
+    polling.subscribe([cache](uint32_t blockIndex) {
+        cache->onNewBlock(blockIndex);
+    });
+}
+
+LruResponseCache::LruResponseCache(size_t maxBytes, std::chrono::milliseconds maxVolatileAge)
+    : maxBytes_(maxBytes), maxVolatileAge_(maxVolatileAge), bytes_(0), generation_(0) {
+}
+
+bool LruResponseCache::get(const std::string& key, nlohmann::json& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second->lifetime == Lifetime::UntilNextBlock &&
+        std::chrono::steady_clock::now() - it->second->storedAt > maxVolatileAge_) {
+        erase(it->second);
+        it = index_.end();
+    }
+    if (it == index_.end()) {
+        stats_.misses++;
+        return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    result = it->second->result;
+    stats_.hits++;
+    return true;
+}
+
+void LruResponseCache::put(const std::string& key, const nlohmann::json& result, Lifetime lifetime, uint64_t generation) {
+    // Approximate the footprint by the serialized size; computed outside the lock
+    size_t bytes = key.size() + result.dump().size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (lifetime == Lifetime::UntilNextBlock && generation != generation_) {
+        // A block arrived while the request was in flight, so the result may be stale
+        return;
+    }
+    if (bytes > maxBytes_) {
+        return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        erase(it->second);
+    }
+    entries_.push_front({key, result, lifetime, bytes, std::chrono::steady_clock::now()});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+    evict();
+}
+
+uint64_t LruResponseCache::getGeneration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+void LruResponseCache::onNewBlock(uint32_t blockIndex) {
+    (void)blockIndex;
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto current = it++;
+        if (current->lifetime == Lifetime::UntilNextBlock) {
+            erase(current);
+        }
+    }
+}
+
+void LruResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+RpcCacheStats LruResponseCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RpcCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    return stats;
+}
+
+size_t LruResponseCache::getMaxBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxBytes_;
+}
+
+void LruResponseCache::setMaxBytes(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxBytes_ = maxBytes;
+    evict();
+}
+
+void LruResponseCache::erase(std::list<Entry>::iterator it) {
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+void LruResponseCache::evict() {
+    while (bytes_ > maxBytes_ && !entries_.empty()) {
+        erase(std::prev(entries_.end()));
+        stats_.evictions++;
+    }
+}
+
+} // namespace neocpp
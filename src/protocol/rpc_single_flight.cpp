@@ -0,0 +1,46 @@
+#include "neocpp/protocol/rpc_single_flight.hpp"
+
+namespace neocpp {
+
+std::string RpcSingleFlight::makeKey(const std::string& method, const nlohmann::json& params) {
+    // nlohmann::json keeps object members sorted, so dump() is canonical
+    return method + '\n' + params.dump();
+}
+
+bool RpcSingleFlight::join(const std::string& key, ReplyHandler onReply) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& handlers = calls_[key];
+    handlers.push_back(std::move(onReply));
+    if (handlers.size() > 1) {
+        sharedCount_++;
+        return false;
+    }
+    return true;
+}
+
+void RpcSingleFlight::complete(const std::string& key, const nlohmann::json& reply, std::exception_ptr error) {
+    std::vector<ReplyHandler> handlers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = calls_.find(key);
+        if (it == calls_.end()) {
+            return;
+        }
+        handlers.swap(it->second);
+        calls_.erase(it);
+    }
+    for (const auto& handler : handlers) {
+        try {
+            handler(reply, error);
+        } catch (...) {
+            // Ignore handler errors
+        }
+    }
+}
+
+size_t RpcSingleFlight::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_.size();
+}
+
+} // namespace neocpp
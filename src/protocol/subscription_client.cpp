@@ -0,0 +1,475 @@
+#include "neocpp/protocol/subscription_client.hpp"
+#include "neocpp/protocol/websocket_connection.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/rpc_policy.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/exceptions.hpp"
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace neocpp {
+
+// JSON-RPC error code of an unknown method
+static constexpr int METHOD_NOT_FOUND = -32601;
+
+static const SubscriptionEvent ALL_EVENTS[] = {
+    SubscriptionEvent::BlockAdded, SubscriptionEvent::TransactionAdded,
+    SubscriptionEvent::NotificationFromExecution, SubscriptionEvent::TransactionExecuted
+};
+
+// Compare two script hashes or transaction hashes regardless of case and 0x prefix
+static bool sameHash(const nlohmann::json& a, const nlohmann::json& b) {
+    if (!a.is_string() || !b.is_string()) {
+        return false;
+    }
+    auto normalize = [](std::string hash) {
+        if (hash.compare(0, 2, "0x") == 0 || hash.compare(0, 2, "0X") == 0) {
+            hash.erase(0, 2);
+        }
+        std::transform(hash.begin(), hash.end(), hash.begin(), [](unsigned char c) { return std::tolower(c); });
+        return hash;
+    };
+    return normalize(a.get<std::string>()) == normalize(b.get<std::string>());
+}
+
+// Get a member of a JSON object, or null if it is missing or the value is not an object
+static const nlohmann::json& member(const nlohmann::json& object, const char* key) {
+    static const nlohmann::json missing;
+    if (!object.is_object()) {
+        return missing;
+    }
+    auto it = object.find(key);
+    return it == object.end() ? missing : *it;
+}
+
+// Read an optional non-negative integer member; false if it holds anything else
+static bool readUnsigned(const nlohmann::json& object, const char* key, uint64_t& value) {
+    const auto& field = member(object, key);
+    if (field.is_null()) {
+        return true;
+    }
+    if (!field.is_number_unsigned() && !(field.is_number_integer() && field.get<int64_t>() >= 0)) {
+        return false;
+    }
+    value = field.get<uint64_t>();
+    return true;
+}
+
+const char* SubscriptionClient::eventName(SubscriptionEvent event) {
+    switch (event) {
+        case SubscriptionEvent::BlockAdded: return "block_added";
+        case SubscriptionEvent::TransactionAdded: return "transaction_added";
+        case SubscriptionEvent::NotificationFromExecution: return "notification_from_execution";
+        case SubscriptionEvent::TransactionExecuted: return "transaction_executed";
+    }
+    return "";
+}
+
+bool SubscriptionClient::matches(SubscriptionEvent event, const nlohmann::json& filter, const nlohmann::json& payload) {
+    if (!filter.is_object()) {
+        return true;
+    }
+    if (!payload.is_object()) {
+        return false;
+    }
+    switch (event) {
+        case SubscriptionEvent::BlockAdded: {
+            // Fields of an unexpected type fail the match rather than the connection
+            uint64_t index = 0;
+            uint64_t since = 0;
+            uint64_t till = std::numeric_limits<uint64_t>::max();
+            if (!readUnsigned(payload, "index", index) || !readUnsigned(filter, "since", since) ||
+                !readUnsigned(filter, "till", till)) {
+                return false;
+            }
+            if (filter.contains("primary")) {
+                const auto& primary = member(payload, "primary");
+                if (!primary.is_number_integer() || !filter["primary"].is_number_integer() ||
+                    primary.get<int64_t>() != filter["primary"].get<int64_t>()) {
+                    return false;
+                }
+            }
+            return index >= since && index <= till;
+        }
+        case SubscriptionEvent::TransactionAdded: {
+            // The sender is the first signer
+            static const nlohmann::json noSigners = nlohmann::json::array();
+            const auto& listed = member(payload, "signers");
+            const auto& signers = listed.is_array() ? listed : noSigners;
+            if (filter.contains("sender") && (signers.empty() || !sameHash(member(signers[0], "account"), filter["sender"]))) {
+                return false;
+            }
+            if (filter.contains("signer")) {
+                return std::any_of(signers.begin(), signers.end(), [&filter](const nlohmann::json& signer) {
+                    return sameHash(member(signer, "account"), filter["signer"]);
+                });
+            }
+            return true;
+        }
+        case SubscriptionEvent::NotificationFromExecution:
+            if (filter.contains("contract") && !sameHash(member(payload, "contract"), filter["contract"])) {
+                return false;
+            }
+            return !filter.contains("name") || member(payload, "eventname") == filter["name"];
+        case SubscriptionEvent::TransactionExecuted:
+            if (filter.contains("state") && member(payload, "vmstate") != filter["state"]) {
+                return false;
+            }
+            return !filter.contains("container") || sameHash(member(payload, "container"), filter["container"]);
+    }
+    return true;
+}
+
+SubscriptionClient::SubscriptionClient(const std::string& url, const SharedPtr<NeoRpcClient>& rpcClient,
+                                       const SubscriptionConfig& config)
+    : url_(url), rpcClient_(rpcClient), config_(config), nextSubscriptionId_(1), nextRequestId_(1),
+      running_(false), connected_(false),
+      polling_(false), unsupported_(false), reconnects_(0) {
+    if (url.compare(0, 5, "ws://") != 0 && url.compare(0, 6, "wss://") != 0) {
+        throw IllegalArgumentException("Not a WebSocket URL: " + url);
+    }
+}
+
+SubscriptionClient::~SubscriptionClient() {
+    stop();
+}
+
+void SubscriptionClient::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&SubscriptionClient::run, this);
+}
+
+void SubscriptionClient::stop() {
+    if (!running_) {
+        return;
+    }
+    SharedPtr<WebSocketConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        connection = connection_;
+    }
+    wakeup_.notify_all();
+    if (connection) {
+        connection->interrupt();
+    }
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    stopPolling();
+}
+
+uint64_t SubscriptionClient::subscribe(SubscriptionEvent event, EventHandler handler, const nlohmann::json& filter) {
+    if (!handler) {
+        throw IllegalArgumentException("Event handler cannot be empty");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = nextSubscriptionId_++;
+    auto& subscription = subscriptions_[id];
+    subscription.event = event;
+    subscription.handler = std::move(handler);
+    subscription.filter = filter;
+    if (connected_ && connection_) {
+        sendSubscribe(connection_, id, subscription);
+    }
+    return id;
+}
+
+void SubscriptionClient::unsubscribe(uint64_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(subscriptionId);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+    if (!it->second.serverId.empty() && connection_ && connection_->isOpen()) {
+        nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "unsubscribe"},
+                                  {"params", nlohmann::json::array({it->second.serverId})}, {"id", nextRequestId_++}};
+        try {
+            connection_->sendText(request.dump());
+        } catch (const NetworkException&) {
+            // The node drops the subscription with the connection
+        }
+    }
+    subscriptions_.erase(it);
+}
+
+void SubscriptionClient::sendSubscribe(const SharedPtr<WebSocketConnection>& connection, uint64_t subscriptionId,
+                                       const Subscription& subscription) {
+    int64_t requestId = nextRequestId_++;
+    nlohmann::json params = nlohmann::json::array({eventName(subscription.event)});
+    if (!subscription.filter.is_null()) {
+        params.push_back(subscription.filter);
+    }
+    nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "subscribe"}, {"params", params}, {"id", requestId}};
+    pendingSubscribes_[requestId] = subscriptionId;
+    try {
+        connection->sendText(request.dump());
+    } catch (const NetworkException&) {
+        // Sent again after reconnecting
+    }
+}
+
+void SubscriptionClient::run() {
+    uint32_t failures = 0;
+    bool connectedBefore = false;
+    while (running_ && !unsupported_) {
+        auto connection = std::make_shared<WebSocketConnection>();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                break;
+            }
+            connection_ = connection;
+        }
+
+        std::chrono::milliseconds delay(0);
+        try {
+            connection->connect(url_, config_.connectTimeout);
+            failures = 0;
+            if (connectedBefore) {
+                reconnects_++;
+            }
+            connectedBefore = true;
+            stopPolling();
+            serve(connection);
+        } catch (const UnsupportedOperationException& e) {
+            unsupported_ = true;
+            reportError(e);
+        } catch (const std::exception& e) {
+            failures++;
+            reportError(e);
+            if (failures >= config_.fallbackAfterFailures) {
+                startPolling();
+            }
+        }
+        connection->close();
+        connected_ = false;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            connection_.reset();
+            pendingSubscribes_.clear();
+            for (auto& entry : subscriptions_) {
+                entry.second.serverId.clear();
+            }
+            if (unsupported_) {
+                break;
+            }
+            RpcRetryConfig backoff;
+            backoff.initialBackoff = config_.reconnectDelay;
+            backoff.maxBackoff = std::max(config_.maxReconnectDelay, config_.reconnectDelay);
+            delay = RpcPolicy::backoff(backoff, failures > 0 ? failures - 1 : 0);
+            wakeup_.wait_for(lock, delay, [this]() { return !running_; });
+        }
+    }
+
+    if (unsupported_ && running_) {
+        // The node cannot push events; polling serves them until stop()
+        startPolling();
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait(lock, [this]() { return !running_; });
+    }
+}
+
+void SubscriptionClient::serve(const SharedPtr<WebSocketConnection>& connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : subscriptions_) {
+            sendSubscribe(connection, entry.first, entry.second);
+        }
+        // Later subscriptions are sent by subscribe()
+        connected_ = true;
+    }
+
+    auto lastPing = std::chrono::steady_clock::now();
+    std::string message;
+    while (running_ && !unsupported_) {
+        auto result = connection->receive(message, config_.pingInterval);
+        if (result == WebSocketConnection::ReadResult::Closed) {
+            if (running_) {
+                throw NetworkException("WebSocket connection to " + url_ + " lost");
+            }
+            return;
+        }
+        if (result == WebSocketConnection::ReadResult::Message) {
+            handleMessage(connection, message);
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastPing >= config_.pingInterval) {
+            connection->ping();
+            lastPing = now;
+        }
+    }
+}
+
+void SubscriptionClient::handleMessage(const SharedPtr<WebSocketConnection>& connection, const std::string& message) {
+    auto json = nlohmann::json::parse(message, nullptr, false);
+    if (!json.is_object()) {
+        return;
+    }
+
+    if (json.contains("method")) {
+        std::string method = json["method"].is_string() ? json["method"].get<std::string>() : "";
+        if (method == "event_missed") {
+            reportError(RpcException("The node dropped events for this client"));
+            return;
+        }
+        const auto& params = json.contains("params") ? json["params"] : nlohmann::json::array();
+        nlohmann::json payload = params.is_array() && !params.empty() ? params[0] : nlohmann::json();
+        for (auto event : ALL_EVENTS) {
+            if (method == eventName(event)) {
+                dispatch(event, payload);
+                break;
+            }
+        }
+        return;
+    }
+
+    if (!json.contains("id") || !json["id"].is_number_integer()) {
+        return;
+    }
+    std::string failure;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto pending = pendingSubscribes_.find(json["id"].get<int64_t>());
+        if (pending == pendingSubscribes_.end()) {
+            return;
+        }
+        uint64_t subscriptionId = pending->second;
+        pendingSubscribes_.erase(pending);
+        auto subscription = subscriptions_.find(subscriptionId);
+
+        if (json.contains("error")) {
+            const auto& error = json["error"];
+            if (error.is_object() && error.value("code", 0) == METHOD_NOT_FOUND) {
+                unsupported_ = true;
+            } else {
+                failure = "Subscription failed: " + (error.is_object() ? error.value("message", error.dump()) : error.dump());
+            }
+        } else if (json.contains("result") && json["result"].is_string()) {
+            std::string serverId = json["result"].get<std::string>();
+            if (subscription != subscriptions_.end()) {
+                subscription->second.serverId = serverId;
+            } else {
+                // Unsubscribed while the request was in flight
+                nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "unsubscribe"},
+                                          {"params", nlohmann::json::array({serverId})}, {"id", nextRequestId_++}};
+                try {
+                    connection->sendText(request.dump());
+                } catch (const NetworkException&) {
+                    // The node drops the subscription with the connection
+                }
+            }
+        }
+    }
+    if (unsupported_) {
+        reportError(UnsupportedOperationException("The node at " + url_ + " does not support subscriptions"));
+    } else if (!failure.empty()) {
+        reportError(RpcException(failure));
+    }
+}
+
+void SubscriptionClient::dispatch(SubscriptionEvent event, const nlohmann::json& payload) {
+    std::vector<EventHandler> handlers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : subscriptions_) {
+            if (entry.second.event == event && matches(event, entry.second.filter, payload)) {
+                handlers.push_back(entry.second.handler);
+            }
+        }
+    }
+    for (const auto& handler : handlers) {
+        try {
+            handler(payload);
+        } catch (...) {
+            // Ignore handler errors
+        }
+    }
+}
+
+void SubscriptionClient::startPolling() {
+    if (!rpcClient_ || polling_ || !running_) {
+        return;
+    }
+    auto poller = std::make_shared<BlockPolling>(rpcClient_, config_.fallbackPollInterval);
+    poller->subscribeBlocks([this](const nlohmann::json& block) { onPolledBlock(block); });
+    poller->setErrorHandler([this](const std::exception& error) { reportError(error); });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        poller_ = poller;
+    }
+    polling_ = true;
+    poller->start();
+}
+
+void SubscriptionClient::stopPolling() {
+    SharedPtr<BlockPolling> poller;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        poller.swap(poller_);
+    }
+    // Cleared first, so that events of blocks still being delivered are dropped
+    polling_ = false;
+    if (poller) {
+        poller->stop();
+    }
+}
+
+void SubscriptionClient::onPolledBlock(const nlohmann::json& block) {
+    if (!polling_) {
+        return;
+    }
+    bool wantExecutions = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : subscriptions_) {
+            wantExecutions |= entry.second.event == SubscriptionEvent::NotificationFromExecution ||
+                              entry.second.event == SubscriptionEvent::TransactionExecuted;
+        }
+    }
+
+    dispatch(SubscriptionEvent::BlockAdded, block);
+    if (!wantExecutions || !block.contains("tx")) {
+        return;
+    }
+    for (const auto& tx : block["tx"]) {
+        auto hash = tx.value("hash", std::string());
+        try {
+            auto log = rpcClient_->sendRequest("getapplicationlog", nlohmann::json::array({hash}));
+            if (!log.contains("executions")) {
+                continue;
+            }
+            for (auto execution : log["executions"]) {
+                execution["container"] = hash;
+                if (execution.contains("notifications")) {
+                    for (auto notification : execution["notifications"]) {
+                        notification["container"] = hash;
+                        dispatch(SubscriptionEvent::NotificationFromExecution, notification);
+                    }
+                }
+                dispatch(SubscriptionEvent::TransactionExecuted, execution);
+            }
+        } catch (const std::exception& e) {
+            reportError(e);
+        }
+    }
+}
+
+void SubscriptionClient::reportError(const std::exception& error) {
+    if (!errorHandler_) {
+        return;
+    }
+    try {
+        errorHandler_(error);
+    } catch (...) {
+        // Ignore handler errors
+    }
+}
+
+} // namespace neocpp
@@ -0,0 +1,328 @@
+#include "neocpp/protocol/transaction_broadcaster.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/http_service.hpp"
+#include "neocpp/protocol/rpc_transport.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/transaction/transaction.hpp"
+#include "neocpp/serialization/binary_writer.hpp"
+#include "neocpp/utils/base64.hpp"
+#include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+
+namespace neocpp {
+
+namespace {
+
+/// How a node answered sendrawtransaction
+enum class NodeReply {
+    Accepted,
+    AlreadyKnown,
+    Rejected
+};
+
+// Neo N3 error codes for a transaction the node already holds: AlreadyExists (in the
+// ledger) and AlreadyInPool. Older nodes and neo-go only say so in the message.
+constexpr int ERROR_ALREADY_EXISTS = -501;
+constexpr int ERROR_ALREADY_IN_POOL = -503;
+
+NodeReply classifyReply(const HttpResponse& response, std::string& error) {
+    nlohmann::json reply;
+    try {
+        reply = HttpService::parseJsonResponse(response);
+    } catch (const std::exception& e) {
+        error = e.what();
+        return NodeReply::Rejected;
+    }
+    if (reply.is_object() && reply.contains("error") && reply["error"].is_object()) {
+        const auto& rpcError = reply["error"];
+        int code = rpcError.value("code", 0);
+        std::string message = rpcError.value("message", "");
+        if (rpcError.contains("data") && rpcError["data"].is_string()) {
+            message += ": " + rpcError["data"].get<std::string>();
+        }
+        std::string lower = message;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (code == ERROR_ALREADY_EXISTS || code == ERROR_ALREADY_IN_POOL || lower.find("already") != std::string::npos) {
+            return NodeReply::AlreadyKnown;
+        }
+        error = message.empty() ? "error " + std::to_string(code) : message;
+        return NodeReply::Rejected;
+    }
+    if (!reply.is_object() || !reply.contains("result")) {
+        error = "Invalid RPC response: missing result";
+        return NodeReply::Rejected;
+    }
+    return NodeReply::Accepted;
+}
+
+/// A transaction waiting for inclusion; guarded by State::mutex
+struct Pending {
+    BroadcastResult result;
+    std::string body;
+    uint32_t validUntilBlock = 0;
+    size_t replies = 0;
+    uint32_t blocksSinceSubmit = 0;
+    std::chrono::steady_clock::time_point started;
+    std::vector<std::promise<BroadcastResult>> promises;
+};
+
+} // namespace
+
+struct TransactionBroadcaster::State : std::enable_shared_from_this<TransactionBroadcaster::State> {
+    std::vector<SharedPtr<RpcTransport>> transports;
+    BroadcastConfig config;
+    std::atomic<uint64_t> nextRequestId{1};
+    mutable std::mutex mutex;
+    std::unordered_map<Hash256, SharedPtr<Pending>, Hash256::Hasher> pending;
+
+    /// Remove a transaction and hand its promises over
+    std::vector<std::promise<BroadcastResult>> finish(const SharedPtr<Pending>& entry) {
+        pending.erase(entry->result.hash);
+        entry->result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - entry->started);
+        return std::move(entry->promises);
+    }
+
+    /// Post sendrawtransaction to every node. Only the replies to the first round
+    /// decide whether the transaction is taken; later rounds just refresh mempools.
+    void submit(const SharedPtr<Pending>& entry, bool firstRound) {
+        auto self = shared_from_this();
+        for (const auto& transport : transports) {
+            std::string url = transport->getUrl();
+            transport->postJsonAsync(entry->body, [self, entry, firstRound, url](const HttpResponse& response) {
+                if (firstRound) {
+                    self->onReply(entry, url, response);
+                }
+            });
+        }
+    }
+
+    /// Count a node's answer to the first round
+    void onReply(const SharedPtr<Pending>& entry, const std::string& url, const HttpResponse& response) {
+        std::string error;
+        NodeReply reply = classifyReply(response, error);
+        std::vector<std::promise<BroadcastResult>> failed;
+        std::string reason;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            switch (reply) {
+                case NodeReply::Accepted:
+                    entry->result.accepted++;
+                    break;
+                case NodeReply::AlreadyKnown:
+                    entry->result.alreadyKnown++;
+                    break;
+                case NodeReply::Rejected:
+                    entry->result.rejections.push_back(url + ": " + error);
+                    break;
+            }
+            entry->replies++;
+            auto it = pending.find(entry->result.hash);
+            bool stillPending = it != pending.end() && it->second == entry;
+            if (stillPending && entry->replies == transports.size() &&
+                entry->result.accepted + entry->result.alreadyKnown < config.minAccepted) {
+                for (const auto& rejection : entry->result.rejections) {
+                    reason += (reason.empty() ? "" : "; ") + rejection;
+                }
+                failed = finish(entry);
+            }
+        }
+        for (auto& promise : failed) {
+            promise.set_exception(std::make_exception_ptr(
+                RpcException("Transaction " + entry->result.hash.toString() + " was not accepted: " + reason)));
+        }
+    }
+
+    /// Resolve the transactions a block includes or outlives
+    void onBlock(const nlohmann::json& block) {
+        if (!block.is_object() || !block.contains("index")) {
+            return;
+        }
+        uint32_t index = block["index"].get<uint32_t>();
+        std::vector<Hash256> included;
+        if (block.contains("tx") && block["tx"].is_array()) {
+            for (const auto& tx : block["tx"]) {
+                if (tx.is_object() && tx.contains("hash") && tx["hash"].is_string()) {
+                    try {
+                        included.push_back(Hash256::fromHexString(tx["hash"].get<std::string>()));
+                    } catch (const std::exception&) {
+                        // Not a transaction hash; cannot be one of ours
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<BroadcastResult, std::vector<std::promise<BroadcastResult>>>> resolved;
+        std::vector<SharedPtr<Pending>> resend;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& hash : included) {
+                auto it = pending.find(hash);
+                if (it == pending.end()) {
+                    continue;
+                }
+                auto entry = it->second;
+                entry->result.status = BroadcastStatus::Included;
+                entry->result.blockIndex = index;
+                auto promises = finish(entry);
+                resolved.emplace_back(entry->result, std::move(promises));
+            }
+            for (auto it = pending.begin(); it != pending.end();) {
+                auto entry = (it++)->second;
+                if (index >= entry->validUntilBlock) {
+                    entry->result.status = BroadcastStatus::Expired;
+                    entry->result.blockIndex = index;
+                    auto promises = finish(entry);
+                    resolved.emplace_back(entry->result, std::move(promises));
+                } else if (config.rebroadcastAfterBlocks > 0 && ++entry->blocksSinceSubmit >= config.rebroadcastAfterBlocks) {
+                    entry->blocksSinceSubmit = 0;
+                    entry->result.rebroadcasts++;
+                    resend.push_back(entry);
+                }
+            }
+        }
+        for (auto& [result, promises] : resolved) {
+            for (auto& promise : promises) {
+                promise.set_value(result);
+            }
+        }
+        for (const auto& entry : resend) {
+            submit(entry, false);
+        }
+    }
+};
+
+static const std::vector<SharedPtr<NeoRpcClient>>& requireNodes(const std::vector<SharedPtr<NeoRpcClient>>& nodes) {
+    if (nodes.empty()) {
+        throw IllegalArgumentException("At least one node is required");
+    }
+    for (const auto& node : nodes) {
+        if (!node) {
+            throw IllegalArgumentException("Node cannot be null");
+        }
+    }
+    return nodes;
+}
+
+static const BroadcastConfig& requireReachable(const BroadcastConfig& config, size_t nodeCount) {
+    if (config.minAccepted == 0 || config.minAccepted > nodeCount) {
+        throw IllegalArgumentException("Required accepting nodes must be between 1 and " + std::to_string(nodeCount));
+    }
+    return config;
+}
+
+static std::string encodeTransaction(const SharedPtr<Transaction>& transaction) {
+    BinaryWriter writer;
+    transaction->serialize(writer);
+    return Base64::encode(writer.toArray());
+}
+
+TransactionBroadcaster::TransactionBroadcaster(const std::vector<SharedPtr<NeoRpcClient>>& nodes,
+                                               const BroadcastConfig& config)
+    : nodes_(requireNodes(nodes)), ownsWatcher_(true), subscriptionId_(0), state_(std::make_shared<State>()) {
+    state_->config = requireReachable(config, nodes_.size());
+    // Start at the next block, so that no block produced after a broadcast is missed
+    watcher_ = std::make_shared<BlockPolling>(nodes_.front());
+    watcher_->setStartHeight(nodes_.front()->getBlockCount());
+    watcher_->setAdaptivePolling(config.polling);
+    watch();
+    watcher_->start();
+}
+
+TransactionBroadcaster::TransactionBroadcaster(const std::vector<SharedPtr<NeoRpcClient>>& nodes,
+                                               const SharedPtr<BlockPolling>& watcher,
+                                               const BroadcastConfig& config)
+    : nodes_(requireNodes(nodes)), watcher_(watcher), ownsWatcher_(false), subscriptionId_(0),
+      state_(std::make_shared<State>()) {
+    if (!watcher_) {
+        throw IllegalArgumentException("Block watcher cannot be null");
+    }
+    state_->config = requireReachable(config, nodes_.size());
+    watch();
+}
+
+TransactionBroadcaster::~TransactionBroadcaster() {
+    watcher_->unsubscribe(subscriptionId_);
+    if (ownsWatcher_) {
+        watcher_->stop();
+    }
+    std::vector<std::promise<BroadcastResult>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        for (auto& entry : state_->pending) {
+            for (auto& promise : entry.second->promises) {
+                abandoned.push_back(std::move(promise));
+            }
+        }
+        state_->pending.clear();
+    }
+    for (auto& promise : abandoned) {
+        promise.set_exception(std::make_exception_ptr(IllegalStateException("Transaction broadcaster stopped")));
+    }
+}
+
+void TransactionBroadcaster::watch() {
+    for (const auto& node : nodes_) {
+        state_->transports.push_back(node->getTransport());
+    }
+    auto state = state_;
+    subscriptionId_ = watcher_->subscribeBlocks([state](const nlohmann::json& block) {
+        state->onBlock(block);
+    });
+}
+
+std::future<BroadcastResult> TransactionBroadcaster::broadcast(const SharedPtr<Transaction>& transaction) {
+    if (!transaction) {
+        throw IllegalArgumentException("Transaction cannot be null");
+    }
+    // getHash() holds the digest in serialization order; nodes print the ID reversed
+    Hash256 txId(transaction->getHash().toLittleEndianArray());
+    return broadcast(encodeTransaction(transaction), txId, transaction->getValidUntilBlock());
+}
+
+std::future<BroadcastResult> TransactionBroadcaster::broadcast(const std::string& base64Transaction, const Hash256& hash,
+                                                               uint32_t validUntilBlock) {
+    std::promise<BroadcastResult> promise;
+    auto future = promise.get_future();
+    SharedPtr<Pending> entry;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto it = state_->pending.find(hash);
+        if (it != state_->pending.end()) {
+            // Already on its way; share the outcome instead of sending it again
+            it->second->promises.push_back(std::move(promise));
+            return future;
+        }
+        entry = std::make_shared<Pending>();
+        entry->result.hash = hash;
+        entry->validUntilBlock = validUntilBlock;
+        entry->started = std::chrono::steady_clock::now();
+        entry->body = nlohmann::json{
+            {"jsonrpc", "2.0"},
+            {"method", "sendrawtransaction"},
+            {"params", nlohmann::json::array({base64Transaction})},
+            {"id", state_->nextRequestId++}
+        }.dump();
+        entry->promises.push_back(std::move(promise));
+        // Tracked before it is sent, so that a block including it cannot be missed
+        state_->pending[hash] = entry;
+    }
+    state_->submit(entry, true);
+    return future;
+}
+
+void TransactionBroadcaster::onBlock(const nlohmann::json& block) {
+    state_->onBlock(block);
+}
+
+size_t TransactionBroadcaster::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->pending.size();
+}
+
+} // namespace neocpp
@@ -0,0 +1,521 @@
+#include "neocpp/protocol/websocket_connection.hpp"
+#include "neocpp/utils/base64.hpp"
+#include "neocpp/exceptions.hpp"
+#include <openssl/ssl.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+
+namespace neocpp {
+
+namespace {
+
+constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+constexpr uint8_t OPCODE_TEXT = 0x1;
+constexpr uint8_t OPCODE_BINARY = 0x2;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+constexpr uint8_t OPCODE_PONG = 0xA;
+
+// Appended to the client key to derive Sec-WebSocket-Accept (RFC 6455, section 1.3)
+constexpr const char* ACCEPT_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+/// Parts of a ws:// or wss:// URL
+struct WebSocketUrl {
+    bool secure = false;
+    std::string host;
+    std::string port;
+    std::string path;
+};
+
+WebSocketUrl parseUrl(const std::string& url) {
+    WebSocketUrl parsed;
+    std::string rest;
+    if (url.compare(0, 5, "ws://") == 0) {
+        rest = url.substr(5);
+    } else if (url.compare(0, 6, "wss://") == 0) {
+        parsed.secure = true;
+        rest = url.substr(6);
+    } else {
+        throw IllegalArgumentException("Not a WebSocket URL: " + url);
+    }
+
+    auto pathStart = rest.find('/');
+    std::string authority = rest.substr(0, pathStart);
+    parsed.path = pathStart == std::string::npos ? "/" : rest.substr(pathStart);
+
+    size_t portSeparator;
+    if (!authority.empty() && authority[0] == '[') {
+        auto end = authority.find(']');
+        if (end == std::string::npos) {
+            throw IllegalArgumentException("Invalid IPv6 address in URL: " + url);
+        }
+        parsed.host = authority.substr(1, end - 1);
+        portSeparator = authority.find(':', end);
+    } else {
+        portSeparator = authority.find(':');
+        parsed.host = authority.substr(0, portSeparator);
+    }
+    parsed.port = portSeparator == std::string::npos ? (parsed.secure ? "443" : "80") : authority.substr(portSeparator + 1);
+    if (parsed.host.empty()) {
+        throw IllegalArgumentException("Missing host in URL: " + url);
+    }
+    return parsed;
+}
+
+std::string acceptKey(const std::string& key) {
+    std::string input = key + ACCEPT_GUID;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(input.data(), input.size(), digest, &length, EVP_sha1(), nullptr);
+    return Base64::encode(Bytes(digest, digest + length));
+}
+
+SSL_CTX* clientContext() {
+    static SSL_CTX* context = []() {
+        SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+        if (ctx) {
+            SSL_CTX_set_default_verify_paths(ctx);
+            SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+        }
+        return ctx;
+    }();
+    return context;
+}
+
+void setTimeouts(int fd, std::chrono::milliseconds timeout) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+void setBlocking(int fd, bool blocking) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    ::fcntl(fd, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+}
+
+// Connect with a timeout to the first address that accepts
+int openSocket(const WebSocketUrl& url, std::chrono::milliseconds timeout) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    int status = ::getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &addresses);
+    if (status != 0) {
+        throw NetworkException("Cannot resolve " + url.host + ": " + ::gai_strerror(status));
+    }
+
+    std::string failure = "no address";
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) {
+            failure = std::strerror(errno);
+            continue;
+        }
+        setBlocking(fd, false);
+        int result = ::connect(fd, address->ai_addr, address->ai_addrlen);
+        if (result < 0 && errno == EINPROGRESS) {
+            pollfd pfd{fd, POLLOUT, 0};
+            result = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (result == 0) {
+                error = ETIMEDOUT;
+            } else if (result > 0) {
+                ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            } else {
+                error = errno;
+            }
+            result = error == 0 ? 0 : -1;
+            errno = error;
+        }
+        if (result < 0) {
+            failure = std::strerror(errno);
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0) {
+        throw NetworkException("Cannot connect to " + url.host + ":" + url.port + ": " + failure);
+    }
+
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setBlocking(fd, true);
+    setTimeouts(fd, timeout);
+    return fd;
+}
+
+// Statuses that say the endpoint will never upgrade, as opposed to failing for now
+bool refusesUpgrade(int status) {
+    switch (status) {
+        case 404: // Not Found
+        case 405: // Method Not Allowed
+        case 426: // Upgrade Required
+        case 501: // Not Implemented
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+/// TLS session of a wss:// connection
+struct WebSocketConnection::Tls {
+    SSL* ssl = nullptr;
+    ~Tls() { SSL_free(ssl); }
+};
+
+WebSocketConnection::WebSocketConnection() : fd_(-1), tls_(nullptr), open_(false) {
+}
+
+WebSocketConnection::~WebSocketConnection() {
+    close();
+}
+
+void WebSocketConnection::connect(const std::string& url, std::chrono::milliseconds timeout) {
+    close();
+    WebSocketUrl parsed = parseUrl(url);
+    int fd = openSocket(parsed, timeout);
+    {
+        std::lock_guard<std::mutex> lock(fdMutex_);
+        fd_ = fd;
+    }
+
+    try {
+        if (parsed.secure) {
+            SSL_CTX* context = clientContext();
+            if (!context) {
+                throw NetworkException("Cannot create a TLS context");
+            }
+            tls_ = new Tls();
+            tls_->ssl = SSL_new(context);
+            SSL_set_fd(tls_->ssl, fd);
+            SSL_set_tlsext_host_name(tls_->ssl, parsed.host.c_str());
+            SSL_set1_host(tls_->ssl, parsed.host.c_str());
+            if (SSL_connect(tls_->ssl) != 1) {
+                throw NetworkException("TLS handshake with " + parsed.host + " failed");
+            }
+        }
+
+        bool defaultPort = parsed.port == (parsed.secure ? "443" : "80");
+        std::string host = parsed.host.find(':') != std::string::npos ? "[" + parsed.host + "]" : parsed.host;
+        handshake(defaultPort ? host : host + ":" + parsed.port, parsed.path);
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    // From here on reads wait in poll() and writes wait for POLLOUT
+    setTimeouts(fd, std::chrono::milliseconds(0));
+    setBlocking(fd, false);
+    open_ = true;
+}
+
+void WebSocketConnection::handshake(const std::string& host, const std::string& path) {
+    unsigned char nonce[16];
+    RAND_bytes(nonce, sizeof(nonce));
+    std::string key = Base64::encode(Bytes(nonce, nonce + sizeof(nonce)));
+
+    writeAll("GET " + path + " HTTP/1.1\r\n"
+             "Host: " + host + "\r\n"
+             "Upgrade: websocket\r\n"
+             "Connection: Upgrade\r\n"
+             "Sec-WebSocket-Key: " + key + "\r\n"
+             "Sec-WebSocket-Version: 13\r\n"
+             "\r\n");
+
+    size_t headerEnd;
+    char chunk[4096];
+    while ((headerEnd = buffer_.find("\r\n\r\n")) == std::string::npos) {
+        long n = readSome(chunk, sizeof(chunk));
+        if (n == -2) {
+            throw NetworkException("WebSocket handshake timed out");
+        }
+        if (n <= 0) {
+            throw NetworkException("Connection closed during the WebSocket handshake");
+        }
+        buffer_.append(chunk, static_cast<size_t>(n));
+        if (buffer_.size() > 64 * 1024) {
+            throw NetworkException("WebSocket handshake response too large");
+        }
+    }
+    std::string headers = buffer_.substr(0, headerEnd + 2);
+    buffer_.erase(0, headerEnd + 4);
+
+    auto space = headers.find(' ');
+    int status = space == std::string::npos ? 0 : std::atoi(headers.c_str() + space + 1);
+    if (status != 101) {
+        if (refusesUpgrade(status)) {
+            throw UnsupportedOperationException("WebSocket upgrade rejected with HTTP status " + std::to_string(status));
+        }
+        // Overload, rate limiting or a garbled answer may pass; the caller retries
+        throw NetworkException("WebSocket upgrade failed with HTTP status " + std::to_string(status));
+    }
+
+    std::string lower = headers;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    auto accept = lower.find("\r\nsec-websocket-accept:");
+    if (accept == std::string::npos) {
+        throw NetworkException("WebSocket handshake response lacks Sec-WebSocket-Accept");
+    }
+    size_t valueStart = headers.find_first_not_of(' ', accept + 23);
+    size_t valueEnd = headers.find("\r\n", valueStart);
+    std::string value = headers.substr(valueStart, valueEnd - valueStart);
+    while (!value.empty() && value.back() == ' ') {
+        value.pop_back();
+    }
+    if (value != acceptKey(key)) {
+        throw NetworkException("WebSocket handshake response has a wrong Sec-WebSocket-Accept");
+    }
+}
+
+long WebSocketConnection::readSome(char* data, size_t size) {
+    if (!tls_) {
+        ssize_t n = ::recv(fd_, data, size, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return -2;
+        }
+        return static_cast<long>(n);
+    }
+    // OpenSSL does not allow a read and a write on one session at the same time
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    int n = SSL_read(tls_->ssl, data, static_cast<int>(std::min<size_t>(size, INT32_MAX)));
+    if (n > 0) {
+        return n;
+    }
+    int error = SSL_get_error(tls_->ssl, n);
+    return error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE ? -2 : -1;
+}
+
+void WebSocketConnection::writeAll(const std::string& data) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    size_t sent = 0;
+    while (sent < data.size()) {
+        if (fd_ < 0) {
+            throw NetworkException("WebSocket connection is closed");
+        }
+        long n;
+        short waitFor = POLLOUT;
+        if (tls_) {
+            int result = SSL_write(tls_->ssl, data.data() + sent, static_cast<int>(std::min<size_t>(data.size() - sent, INT32_MAX)));
+            n = result;
+            if (result <= 0) {
+                int error = SSL_get_error(tls_->ssl, result);
+                if (error == SSL_ERROR_WANT_READ) {
+                    waitFor = POLLIN;
+                } else if (error != SSL_ERROR_WANT_WRITE) {
+                    throw NetworkException("WebSocket write failed");
+                }
+            }
+        } else {
+            n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw NetworkException(std::string("WebSocket write failed: ") + std::strerror(errno));
+            }
+        }
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        pollfd pfd{fd_, waitFor, 0};
+        ::poll(&pfd, 1, 1000);
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            throw NetworkException("WebSocket connection is closed");
+        }
+    }
+}
+
+void WebSocketConnection::sendFrame(uint8_t opcode, const std::string& payload) {
+    std::string frame;
+    frame.reserve(payload.size() + 14);
+    frame += static_cast<char>(0x80 | opcode);
+    size_t length = payload.size();
+    if (length < 126) {
+        frame += static_cast<char>(0x80 | length);
+    } else if (length <= 0xFFFF) {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>(length >> 8);
+        frame += static_cast<char>(length & 0xFF);
+    } else {
+        frame += static_cast<char>(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame += static_cast<char>((static_cast<uint64_t>(length) >> shift) & 0xFF);
+        }
+    }
+    // Client frames are masked with a fresh random key (RFC 6455, section 5.3)
+    unsigned char mask[4];
+    RAND_bytes(mask, sizeof(mask));
+    frame.append(reinterpret_cast<const char*>(mask), sizeof(mask));
+    for (size_t i = 0; i < length; ++i) {
+        frame += static_cast<char>(payload[i] ^ mask[i % 4]);
+    }
+    writeAll(frame);
+}
+
+void WebSocketConnection::sendText(const std::string& text) {
+    if (!open_) {
+        throw NetworkException("WebSocket connection is closed");
+    }
+    sendFrame(OPCODE_TEXT, text);
+}
+
+void WebSocketConnection::ping() {
+    if (open_) {
+        sendFrame(OPCODE_PING, std::string());
+    }
+}
+
+bool WebSocketConnection::fill(std::chrono::milliseconds timeout) {
+    bool buffered = tls_ && SSL_pending(tls_->ssl) > 0;
+    if (!buffered) {
+        pollfd pfd{fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(std::max<int64_t>(0, timeout.count())));
+        if (ready < 0) {
+            return errno == EINTR;
+        }
+        if (ready == 0) {
+            return true;
+        }
+    }
+    char chunk[65536];
+    long n = readSome(chunk, sizeof(chunk));
+    if (n == -2) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    buffer_.append(chunk, static_cast<size_t>(n));
+    return true;
+}
+
+WebSocketConnection::ReadResult WebSocketConnection::receive(std::string& message, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (open_) {
+        // Parse one frame if the buffer holds all of it
+        if (buffer_.size() >= 2) {
+            auto* bytes = reinterpret_cast<const uint8_t*>(buffer_.data());
+            bool fin = (bytes[0] & 0x80) != 0;
+            uint8_t opcode = bytes[0] & 0x0F;
+            bool masked = (bytes[1] & 0x80) != 0;
+            uint64_t length = bytes[1] & 0x7F;
+            size_t header = 2;
+            if (length == 126 && buffer_.size() >= 4) {
+                length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+                header = 4;
+            } else if (length == 127 && buffer_.size() >= 10) {
+                length = 0;
+                for (int i = 0; i < 8; ++i) {
+                    length = (length << 8) | bytes[2 + i];
+                }
+                header = 10;
+            } else if (length >= 126) {
+                header = SIZE_MAX;
+            }
+            if (header != SIZE_MAX && (length > MAX_MESSAGE_SIZE || length + fragments_.size() > MAX_MESSAGE_SIZE)) {
+                close();
+                return ReadResult::Closed;
+            }
+            size_t maskOffset = header;
+            if (header != SIZE_MAX && masked) {
+                header += 4;
+            }
+            if (header != SIZE_MAX && buffer_.size() >= header + length) {
+                std::string payload = buffer_.substr(header, static_cast<size_t>(length));
+                if (masked) {
+                    for (size_t i = 0; i < payload.size(); ++i) {
+                        payload[i] = static_cast<char>(payload[i] ^ buffer_[maskOffset + i % 4]);
+                    }
+                }
+                buffer_.erase(0, header + static_cast<size_t>(length));
+
+                switch (opcode) {
+                    case OPCODE_TEXT:
+                    case OPCODE_BINARY:
+                    case OPCODE_CONTINUATION:
+                        fragments_ += payload;
+                        if (fin) {
+                            message.swap(fragments_);
+                            fragments_.clear();
+                            return ReadResult::Message;
+                        }
+                        break;
+                    case OPCODE_PING:
+                        try {
+                            sendFrame(OPCODE_PONG, payload);
+                        } catch (const NetworkException&) {
+                            close();
+                            return ReadResult::Closed;
+                        }
+                        break;
+                    case OPCODE_CLOSE:
+                        close();
+                        return ReadResult::Closed;
+                    default:
+                        break;
+                }
+                continue;
+            }
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return ReadResult::Timeout;
+        }
+        if (!fill(remaining)) {
+            close();
+            return ReadResult::Closed;
+        }
+    }
+    return ReadResult::Closed;
+}
+
+void WebSocketConnection::interrupt() {
+    // Not the write lock: a writer may be blocked until the shutdown
+    std::lock_guard<std::mutex> lock(fdMutex_);
+    if (fd_ >= 0) {
+        ::shutdown(fd_, SHUT_RDWR);
+    }
+}
+
+void WebSocketConnection::close() {
+    if (open_.exchange(false)) {
+        try {
+            sendFrame(OPCODE_CLOSE, std::string("\x03\xE8", 2));
+        } catch (const NetworkException&) {
+            // The peer is already gone
+        }
+    }
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (tls_) {
+        SSL_shutdown(tls_->ssl);
+        delete tls_;
+        tls_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        std::lock_guard<std::mutex> fdLock(fdMutex_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    buffer_.clear();
+    fragments_.clear();
+}
+
+} // namespace neocpp
@@ -169,6 +169,21 @@ Bytes ScriptBuilder::buildVerificationScript(const SharedPtr<ECPublicKey>& publi
     return buildVerificationScript(publicKey->getEncoded());
 }
 
+void ScriptBuilder::buildVerificationScript(const uint8_t* encodedPublicKey,
+                                            std::array<uint8_t, SINGLE_SIG_VERIFICATION_SCRIPT_SIZE>& script) {
+    static const uint32_t checkSig = ScriptBuilder().getInteropServiceHash("System.Crypto.CheckSig");
+    
+    // The same bytes as pushData() and emitSysCall() produce
+    uint8_t* out = script.data();
+    *out++ = NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED;
+    std::memcpy(out, encodedPublicKey, NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED);
+    out += NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED;
+    *out++ = OpCodeHelper::toByte(OpCode::SYSCALL);
+    for (int i = 0; i < 4; ++i) {
+        *out++ = (checkSig >> (i * 8)) & 0xFF;
+    }
+}
+
 Bytes ScriptBuilder::buildVerificationScript(const std::vector<SharedPtr<ECPublicKey>>& publicKeys, 
                                             int signingThreshold) {
     if (signingThreshold <= 0 || signingThreshold > publicKeys.size()) {
@@ -257,8 +272,8 @@ void ScriptBuilder::emitPushData(const Bytes& data) {
 
 uint32_t ScriptBuilder::getInteropServiceHash(const std::string& method) {
     // Calculate SHA256 hash of the method name and take first 4 bytes
-    Bytes methodBytes(method.begin(), method.end());
-    Bytes hash = HashUtils::sha256(methodBytes);
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::sha256(reinterpret_cast<const uint8_t*>(method.data()), method.size(), hash);
     
     uint32_t result = 0;
     for (int i = 0; i < 4; ++i) {
@@ -1,13 +1,44 @@
 #include "neocpp/serialization/binary_writer.hpp"
+#include "neocpp/crypto/hash.hpp"
 #include <cstring>
 
 namespace neocpp {
 
+BinaryWriter::BinaryWriter(Sha256Hasher& hasher) : stream_(nullptr), hasher_(&hasher) {
+    buffer_.reserve(HASH_CHUNK_SIZE);
+}
+
+BinaryWriter::~BinaryWriter() {
+    if (hasher_) {
+        try {
+            flushToHasher();
+        } catch (...) {
+            // Destructors must not throw; flush() reports the failure instead
+        }
+    }
+}
+
+void BinaryWriter::flush() {
+    if (hasher_) {
+        flushToHasher();
+    }
+}
+
+void BinaryWriter::flushToHasher() {
+    if (!buffer_.empty()) {
+        hasher_->update(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+}
+
 void BinaryWriter::writeByte(uint8_t value) {
     if (stream_) {
         stream_->write(reinterpret_cast<const char*>(&value), 1);
     } else {
         buffer_.push_back(value);
+        if (hasher_ && buffer_.size() >= HASH_CHUNK_SIZE) {
+            flushToHasher();
+        }
     }
 }
 
@@ -16,16 +47,19 @@ void BinaryWriter::writeBool(bool value) {
 }
 
 void BinaryWriter::writeBytes(const Bytes& bytes) {
-    if (stream_) {
-        stream_->write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
-    } else {
-        buffer_.insert(buffer_.end(), bytes.begin(), bytes.end());
-    }
+    writeBytes(bytes.data(), bytes.size());
 }
 
 void BinaryWriter::writeBytes(const uint8_t* data, size_t length) {
     if (stream_) {
         stream_->write(reinterpret_cast<const char*>(data), length);
+    } else if (hasher_ && buffer_.size() + length >= HASH_CHUNK_SIZE) {
+        flushToHasher();
+        if (length >= HASH_CHUNK_SIZE) {
+            hasher_->update(data, length);
+        } else {
+            buffer_.insert(buffer_.end(), data, data + length);
+        }
     } else {
         buffer_.insert(buffer_.end(), data, data + length);
     }
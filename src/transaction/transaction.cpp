@@ -8,6 +8,7 @@
 #include "neocpp/neo_constants.hpp"
 #include "neocpp/exceptions.hpp"
 #include <algorithm>
+#include <array>
 #include <random>
 #include <limits>
 
@@ -52,8 +53,13 @@ std::string Transaction::getTxId() const {
 }
 
 Hash256 Transaction::calculateHash() const {
-    Bytes hashData = getHashData();
-    Bytes hash = HashUtils::sha256(hashData);
+    // Hash while serializing, so that large scripts are not buffered
+    Sha256Hasher hasher;
+    BinaryWriter writer(hasher);
+    serializeUnsigned(writer);
+    writer.flush();
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    hasher.finalize(hash);
     return Hash256(hash);
 }
 
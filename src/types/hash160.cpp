@@ -56,12 +56,21 @@ std::string Hash160::toAddress() const {
     return AddressUtils::scriptHashToAddress(toArray());
 }
 
+void Hash160::toAddress(std::string& address) const {
+    AddressUtils::scriptHashToAddress(hash_, address);
+}
+
 Hash160 Hash160::fromAddress(const std::string& address) {
     return Hash160(AddressUtils::addressToScriptHash(address));
 }
 
 Hash160 Hash160::fromScript(const Bytes& script) {
-    Bytes hash = HashUtils::sha256ThenRipemd160(script);
+    return fromScript(script.data(), script.size());
+}
+
+Hash160 Hash160::fromScript(const uint8_t* script, size_t length) {
+    std::array<uint8_t, NeoConstants::HASH160_SIZE> hash;
+    HashUtils::sha256ThenRipemd160(script, length, hash);
     std::reverse(hash.begin(), hash.end());
     return Hash160(hash);
 }
@@ -71,6 +80,11 @@ Hash160 Hash160::fromScript(const std::string& script) {
 }
 
 Hash160 Hash160::fromPublicKey(const Bytes& encodedPublicKey) {
+    if (encodedPublicKey.size() == NeoConstants::PUBLIC_KEY_SIZE_COMPRESSED) {
+        std::array<uint8_t, ScriptBuilder::SINGLE_SIG_VERIFICATION_SCRIPT_SIZE> script;
+        ScriptBuilder::buildVerificationScript(encodedPublicKey.data(), script);
+        return fromScript(script.data(), script.size());
+    }
     return fromScript(ScriptBuilder::buildVerificationScript(encodedPublicKey));
 }
 
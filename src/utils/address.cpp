@@ -3,6 +3,7 @@
 #include "neocpp/crypto/hash.hpp"
 #include "neocpp/neo_constants.hpp"
 #include "neocpp/exceptions.hpp"
+#include <algorithm>
 
 namespace neocpp {
 
@@ -11,11 +12,19 @@ std::string AddressUtils::scriptHashToAddress(const Bytes& scriptHash) {
         throw IllegalArgumentException("Script hash must be 20 bytes");
     }
     
-    Bytes data;
-    data.push_back(getAddressVersion());
-    data.insert(data.end(), scriptHash.begin(), scriptHash.end());
-    
-    return Base58::encodeCheck(data);
+    std::array<uint8_t, NeoConstants::HASH160_SIZE> hash;
+    std::copy(scriptHash.begin(), scriptHash.end(), hash.begin());
+    std::string address;
+    scriptHashToAddress(hash, address);
+    return address;
+}
+
+void AddressUtils::scriptHashToAddress(const std::array<uint8_t, NeoConstants::HASH160_SIZE>& scriptHash,
+                                       std::string& address) {
+    std::array<uint8_t, 1 + NeoConstants::HASH160_SIZE> data;
+    data[0] = getAddressVersion();
+    std::copy(scriptHash.begin(), scriptHash.end(), data.begin() + 1);
+    Base58::encodeCheck(data.data(), data.size(), address);
 }
 
 Bytes AddressUtils::addressToScriptHash(const std::string& address) {
@@ -2,6 +2,8 @@
 #include "neocpp/crypto/hash.hpp"
 #include "neocpp/exceptions.hpp"
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <vector>
 
 namespace neocpp {
@@ -9,51 +11,63 @@ namespace neocpp {
 const char* Base58::ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 const int Base58::BASE = 58;
 
+namespace {
+
+/// Inputs up to this size are encoded in a stack buffer
+constexpr size_t SMALL_INPUT_SIZE = 64;
+
+/// Bytes of the double SHA256 appended by Base58Check
+constexpr size_t CHECKSUM_SIZE = 4;
+
+} // namespace
+
 std::string Base58::encode(const Bytes& data) {
-    if (data.empty()) {
-        return "";
+    std::string result;
+    encode(data.data(), data.size(), result);
+    return result;
+}
+
+void Base58::encode(const uint8_t* data, size_t length, std::string& encoded) {
+    encoded.clear();
+    if (length == 0) {
+        return;
     }
     
     // Count leading zeros
     size_t zeros = 0;
-    for (const auto& byte : data) {
-        if (byte == 0) {
-            zeros++;
-        } else {
-            break;
-        }
+    while (zeros < length && data[zeros] == 0) {
+        zeros++;
     }
     
-    // Allocate enough space
-    size_t size = (data.size() * 138 / 100) + 1;
-    std::vector<uint8_t> buffer(size);
+    // Allocate enough space; short inputs such as addresses fit on the stack
+    size_t size = (length * 138 / 100) + 1;
+    std::array<uint8_t, SMALL_INPUT_SIZE * 138 / 100 + 1> stackBuffer{};
+    std::vector<uint8_t> heapBuffer;
+    uint8_t* buffer = stackBuffer.data();
+    if (size > stackBuffer.size()) {
+        heapBuffer.resize(size);
+        buffer = heapBuffer.data();
+    }
     
-    size_t length = 0;
-    for (const auto& byte : data) {
-        int carry = byte;
-        for (size_t i = 0; i < length || carry; ++i) {
+    size_t digits = 0;
+    for (size_t n = 0; n < length; ++n) {
+        int carry = data[n];
+        for (size_t i = 0; i < digits || carry; ++i) {
             carry += 256 * buffer[i];
             buffer[i] = carry % BASE;
             carry /= BASE;
-            if (i >= length) {
-                length = i + 1;
+            if (i >= digits) {
+                digits = i + 1;
             }
         }
     }
     
     // Build result string
-    std::string result;
-    result.reserve(zeros + length);
-    
-    for (size_t i = 0; i < zeros; ++i) {
-        result += ALPHABET[0];
-    }
-    
-    for (size_t i = 0; i < length; ++i) {
-        result += ALPHABET[buffer[length - 1 - i]];
+    encoded.reserve(zeros + digits);
+    encoded.append(zeros, ALPHABET[0]);
+    for (size_t i = 0; i < digits; ++i) {
+        encoded += ALPHABET[buffer[digits - 1 - i]];
     }
-    
-    return result;
 }
 
 Bytes Base58::decode(const std::string& encoded) {
@@ -110,10 +124,25 @@ Bytes Base58::decode(const std::string& encoded) {
 }
 
 std::string Base58::encodeCheck(const Bytes& data) {
-    Bytes checksum = calculateChecksum(data);
-    Bytes dataWithChecksum = data;
-    dataWithChecksum.insert(dataWithChecksum.end(), checksum.begin(), checksum.end());
-    return encode(dataWithChecksum);
+    std::string result;
+    encodeCheck(data.data(), data.size(), result);
+    return result;
+}
+
+void Base58::encodeCheck(const uint8_t* data, size_t length, std::string& encoded) {
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::doubleSha256(data, length, hash);
+    
+    std::array<uint8_t, SMALL_INPUT_SIZE> stackBuffer;
+    Bytes heapBuffer;
+    uint8_t* dataWithChecksum = stackBuffer.data();
+    if (length + CHECKSUM_SIZE > stackBuffer.size()) {
+        heapBuffer.resize(length + CHECKSUM_SIZE);
+        dataWithChecksum = heapBuffer.data();
+    }
+    std::copy(data, data + length, dataWithChecksum);
+    std::copy(hash.begin(), hash.begin() + CHECKSUM_SIZE, dataWithChecksum + length);
+    encode(dataWithChecksum, length + CHECKSUM_SIZE, encoded);
 }
 
 Bytes Base58::decodeCheck(const std::string& encoded) {
@@ -133,8 +162,9 @@ Bytes Base58::decodeCheck(const std::string& encoded) {
 }
 
 Bytes Base58::calculateChecksum(const Bytes& data) {
-    Bytes hash = HashUtils::doubleSha256(data);
-    return Bytes(hash.begin(), hash.begin() + 4);
+    std::array<uint8_t, NeoConstants::HASH256_SIZE> hash;
+    HashUtils::doubleSha256(data.data(), data.size(), hash);
+    return Bytes(hash.begin(), hash.begin() + CHECKSUM_SIZE);
 }
 
 bool Base58::verifyChecksum(const Bytes& dataWithChecksum) {
@@ -0,0 +1,82 @@
+#include "neocpp/utils/gzip.hpp"
+#include "neocpp/exceptions.hpp"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace neocpp {
+
+#ifdef HAVE_ZLIB
+// windowBits selecting the gzip wrapper for deflate, and automatic gzip/zlib detection for inflate
+static constexpr int GZIP_WINDOW_BITS = 15 + 16;
+static constexpr int AUTO_WINDOW_BITS = 15 + 32;
+#endif
+
+bool Gzip::isAvailable() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string Gzip::compress(const std::string& data, int level) {
+#ifdef HAVE_ZLIB
+    z_stream stream = {};
+    if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw IllegalStateException("Failed to initialize gzip compression");
+    }
+    std::string output(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw IllegalStateException("gzip compression failed");
+    }
+    return output;
+#else
+    (void)data;
+    (void)level;
+    throw IllegalStateException("gzip support not available (zlib not found)");
+#endif
+}
+
+std::string Gzip::decompress(const std::string& data) {
+#ifdef HAVE_ZLIB
+    z_stream stream = {};
+    if (inflateInit2(&stream, AUTO_WINDOW_BITS) != Z_OK) {
+        throw IllegalStateException("Failed to initialize gzip decompression");
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+
+    std::string output;
+    char buffer[16384];
+    int result;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        result = inflate(&stream, Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END) {
+            inflateEnd(&stream);
+            throw IllegalArgumentException("Invalid gzip data");
+        }
+        output.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (result != Z_STREAM_END && (stream.avail_in > 0 || stream.avail_out == 0));
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw IllegalArgumentException("Truncated gzip data");
+    }
+    return output;
+#else
+    (void)data;
+    throw IllegalStateException("gzip support not available (zlib not found)");
+#endif
+}
+
+} // namespace neocpp
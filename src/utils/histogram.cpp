@@ -0,0 +1,86 @@
+#include "neocpp/utils/histogram.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace neocpp {
+
+Histogram::Histogram() : count_(0), sum_(0), max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket = 0;
+    }
+}
+
+size_t Histogram::bucketFor(uint64_t value) {
+    size_t index = 0;
+    while (value != 0) {
+        value >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+uint64_t Histogram::getBucketUpperBound(size_t index) {
+    if (index == 0) {
+        return 0;
+    }
+    if (index >= 64) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return (uint64_t(1) << index) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    buckets_[bucketFor(value)]++;
+    count_++;
+    sum_ += value;
+    uint64_t currentMax = max_;
+    while (value > currentMax && !max_.compare_exchange_weak(currentMax, value)) {
+    }
+}
+
+double Histogram::getMean() const {
+    uint64_t count = count_;
+    return count == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count);
+}
+
+uint64_t Histogram::getPercentile(double percentile) const {
+    uint64_t count = count_;
+    if (count == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count));
+    rank = std::max<uint64_t>(1, rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(getBucketUpperBound(i), max_.load());
+        }
+    }
+    return max_;
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    uint64_t otherMax = other.max_;
+    uint64_t currentMax = max_;
+    while (otherMax > currentMax && !max_.compare_exchange_weak(currentMax, otherMax)) {
+    }
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket = 0;
+    }
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+}
+
+} // namespace neocpp
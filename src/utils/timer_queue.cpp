@@ -0,0 +1,97 @@
+#include "neocpp/utils/timer_queue.hpp"
+
+namespace neocpp {
+
+// Set on timer threads
+static thread_local bool onTimerThread = false;
+
+TimerQueue::TimerQueue() : nextId_(1), stopping_(false) {
+    thread_ = std::thread(&TimerQueue::run, this);
+}
+
+TimerQueue::~TimerQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+SharedPtr<TimerQueue> TimerQueue::getDefault() {
+    static SharedPtr<TimerQueue> queue = std::make_shared<TimerQueue>();
+    return queue;
+}
+
+uint64_t TimerQueue::schedule(std::chrono::microseconds delay, std::function<void()> task) {
+    uint64_t id;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        auto it = timers_.emplace(Clock::now() + delay, Timer{id, std::move(task)});
+        index_.emplace(id, it);
+        earliest = it == timers_.begin();
+    }
+    // Only a new earliest deadline shortens the thread's wait
+    if (earliest) {
+        condition_.notify_one();
+    }
+    return id;
+}
+
+bool TimerQueue::cancel(uint64_t timerId) {
+    // Destroyed after unlocking, since the task's captures may run arbitrary destructors
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = index_.find(timerId);
+        if (found == index_.end()) {
+            return false;
+        }
+        task = std::move(found->second->second.task);
+        timers_.erase(found->second);
+        index_.erase(found);
+    }
+    return true;
+}
+
+size_t TimerQueue::getPending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.size();
+}
+
+bool TimerQueue::isTimerThread() {
+    return onTimerThread;
+}
+
+void TimerQueue::run() {
+    onTimerThread = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (timers_.empty()) {
+            condition_.wait(lock);
+            continue;
+        }
+        auto next = timers_.begin();
+        if (next->first > Clock::now()) {
+            condition_.wait_until(lock, next->first);
+            continue;
+        }
+        auto task = std::move(next->second.task);
+        index_.erase(next->second.id);
+        timers_.erase(next);
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // Ignore task errors
+        }
+        task = nullptr;
+        lock.lock();
+    }
+}
+
+} // namespace neocpp
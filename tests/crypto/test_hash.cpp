@@ -1,6 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include "neocpp/crypto/hash.hpp"
 #include "neocpp/utils/hex.hpp"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace neocpp;
 
@@ -100,4 +108,210 @@ TEST_CASE("Hash Tests", "[crypto]") {
         Bytes result4 = HashUtils::ripemd160(input);
         REQUIRE(result3 == result4);
     }
-}
\ No newline at end of file
+    
+    SECTION("Interleaved digests give the same results") {
+        Bytes input = {0x01, 0x02, 0x03, 0x04};
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(Hex::encode(HashUtils::sha256(input)) == "9f64a747e1b97f131fabb6b447296c9b6f0201e79fb3c5356e6c77e89b6a806a");
+            REQUIRE(Hex::encode(HashUtils::ripemd160(input)) == "179bb366e5e224b8bf4ce302cefc5744961839c5");
+            REQUIRE(HashUtils::keccak256(input) == HashUtils::keccak256(input));
+            REQUIRE(Hex::encode(HashUtils::sha256(Bytes())) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        }
+    }
+    
+    SECTION("Hashing from several threads") {
+        Bytes input(4096, 0x5a);
+        Bytes expected = HashUtils::sha256ThenRipemd160(input);
+        std::vector<int> matches(8, 0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < matches.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < 100; ++i) {
+                    if (HashUtils::sha256ThenRipemd160(input) == expected) {
+                        matches[t]++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(matches == std::vector<int>(8, 100));
+    }
+    
+    SECTION("Fixed-size overloads give the same digests") {
+        for (size_t size : {0, 1, 55, 56, 64, 1000}) {
+            Bytes data(size);
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = static_cast<uint8_t>(i * 7);
+            }
+            std::array<uint8_t, 32> hash256;
+            std::array<uint8_t, 20> hash160;
+            
+            HashUtils::sha256(data.data(), data.size(), hash256);
+            REQUIRE(Bytes(hash256.begin(), hash256.end()) == HashUtils::sha256(data));
+            HashUtils::doubleSha256(data.data(), data.size(), hash256);
+            REQUIRE(Bytes(hash256.begin(), hash256.end()) == HashUtils::doubleSha256(data));
+            HashUtils::keccak256(data.data(), data.size(), hash256);
+            REQUIRE(Bytes(hash256.begin(), hash256.end()) == HashUtils::keccak256(data));
+            HashUtils::ripemd160(data.data(), data.size(), hash160);
+            REQUIRE(Bytes(hash160.begin(), hash160.end()) == HashUtils::ripemd160(data));
+            HashUtils::sha256ThenRipemd160(data.data(), data.size(), hash160);
+            REQUIRE(Bytes(hash160.begin(), hash160.end()) == HashUtils::sha256ThenRipemd160(data));
+        }
+    }
+    
+    SECTION("Incremental SHA256 matches the one-shot hash") {
+        Bytes data(1000);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(i * 13);
+        }
+        Sha256Hasher hasher;
+        for (size_t split : {0, 1, 63, 64, 65, 999, 1000}) {
+            hasher.update(data.data(), split);
+            hasher.update(data.data() + split, data.size() - split);
+            REQUIRE(hasher.finalize() == HashUtils::sha256(data));
+        }
+        
+        // Byte by byte, into a fixed-size array
+        for (uint8_t byte : data) {
+            hasher.update(&byte, 1);
+        }
+        std::array<uint8_t, 32> hash;
+        hasher.finalize(hash);
+        REQUIRE(Bytes(hash.begin(), hash.end()) == HashUtils::sha256(data));
+        
+        // Nothing added since the last finalize
+        REQUIRE(hasher.finalize() == HashUtils::sha256(Bytes()));
+        
+        hasher.update(data);
+        hasher.reset();
+        hasher.update(Bytes{0x61, 0x62, 0x63});
+        REQUIRE(Hex::encode(hasher.finalize()) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    }
+    
+    SECTION("Batch SHA256 matches sha256 with every supported kernel") {
+        // Every padding case up to three blocks, in a count that is no multiple of the lanes
+        std::vector<Bytes> messages;
+        for (size_t size = 0; size <= 200; ++size) {
+            Bytes message(size);
+            for (size_t i = 0; i < size; ++i) {
+                message[i] = static_cast<uint8_t>(size * 31 + i);
+            }
+            messages.push_back(message);
+        }
+        messages.push_back(Bytes(5000, 0xab));
+        std::vector<const uint8_t*> data;
+        std::vector<size_t> lengths;
+        for (const auto& message : messages) {
+            data.push_back(message.data());
+            lengths.push_back(message.size());
+        }
+        
+        for (auto kernel : {Sha256BatchKernel::Auto, Sha256BatchKernel::Portable,
+                            Sha256BatchKernel::Avx2, Sha256BatchKernel::ShaNi}) {
+            if (!HashUtils::isSha256BatchKernelSupported(kernel)) {
+                continue;
+            }
+            std::vector<std::array<uint8_t, 32>> hashes(messages.size());
+            HashUtils::sha256Batch(data.data(), lengths.data(), messages.size(), hashes.data(), kernel);
+            for (size_t i = 0; i < messages.size(); ++i) {
+                REQUIRE(Bytes(hashes[i].begin(), hashes[i].end()) == HashUtils::sha256(messages[i]));
+            }
+        }
+        
+        auto hashes = HashUtils::sha256Batch(messages);
+        REQUIRE(hashes.size() == messages.size());
+        REQUIRE(Hex::encode(Bytes(hashes[0].begin(), hashes[0].end())) ==
+                "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        REQUIRE(HashUtils::sha256Batch(std::vector<Bytes>()).empty());
+    }
+    
+    SECTION("HMAC-SHA256") {
+        // RFC 4231, test case 2
+        std::string key = "Jefe";
+        std::string data = "what do ya want for nothing?";
+        Bytes result = HashUtils::hmacSha256(Bytes(key.begin(), key.end()), Bytes(data.begin(), data.end()));
+        REQUIRE(Hex::encode(result) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    }
+}
+
+TEST_CASE("Hash per-call cost", "[.][benchmark]") {
+    // What every call used to do: a new context and an implicit algorithm lookup
+    auto freshContext = [](const EVP_MD* md, const Bytes& data) {
+        Bytes result(EVP_MD_size(md));
+        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+        EVP_DigestInit_ex(ctx, md, nullptr);
+        EVP_DigestUpdate(ctx, data.data(), data.size());
+        EVP_DigestFinal_ex(ctx, result.data(), nullptr);
+        EVP_MD_CTX_free(ctx);
+        return result;
+    };
+    auto perCall = [](size_t calls, auto operation) {
+        auto started = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; ++i) {
+            operation();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / calls;
+    };
+    
+    std::cout << "ns per call: size, sha256 fresh/cached, ripemd160 fresh/cached" << std::endl;
+    for (size_t size : {32, 256, 4096, 65536, 1048576}) {
+        Bytes data(size, 0xab);
+        size_t calls = std::max<size_t>(20, (64u << 20) / size / 4);
+        double sha256Fresh = perCall(calls, [&]() { freshContext(EVP_sha256(), data); });
+        double sha256Cached = perCall(calls, [&]() { HashUtils::sha256(data); });
+        double ripemdFresh = perCall(calls, [&]() { freshContext(EVP_ripemd160(), data); });
+        double ripemdCached = perCall(calls, [&]() { HashUtils::ripemd160(data); });
+        std::cout << "  " << size << " B: " << sha256Fresh << " / " << sha256Cached << ", "
+                  << ripemdFresh << " / " << ripemdCached << std::endl;
+    }
+}
+
+TEST_CASE("SHA256 batch cost", "[.][benchmark]") {
+    const size_t count = 10000;
+    std::cout << "ns per message: size, sha256 per call";
+    std::vector<std::pair<const char*, Sha256BatchKernel>> kernels;
+    for (auto kernel : {std::make_pair("portable", Sha256BatchKernel::Portable),
+                        std::make_pair("avx2", Sha256BatchKernel::Avx2),
+                        std::make_pair("sha-ni", Sha256BatchKernel::ShaNi)}) {
+        if (HashUtils::isSha256BatchKernelSupported(kernel.second)) {
+            kernels.push_back(kernel);
+            std::cout << ", batch " << kernel.first;
+        }
+    }
+    std::cout << std::endl;
+    
+    // Script hashes, verification scripts, transactions and larger payloads
+    for (size_t size : {21, 39, 64, 250, 1024}) {
+        std::vector<Bytes> messages(count, Bytes(size, 0x5a));
+        std::vector<const uint8_t*> data;
+        std::vector<size_t> lengths;
+        for (const auto& message : messages) {
+            data.push_back(message.data());
+            lengths.push_back(message.size());
+        }
+        std::vector<std::array<uint8_t, 32>> hashes(count);
+        auto perMessage = [&](auto operation) {
+            size_t rounds = std::max<size_t>(1, (8u << 20) / (count * size));
+            auto started = std::chrono::steady_clock::now();
+            for (size_t round = 0; round < rounds; ++round) {
+                operation();
+            }
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() /
+                   (rounds * count);
+        };
+        
+        std::cout << "  " << size << " B: " << perMessage([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                HashUtils::sha256(data[i], lengths[i], hashes[i]);
+            }
+        });
+        for (const auto& kernel : kernels) {
+            std::cout << ", " << perMessage([&]() {
+                HashUtils::sha256Batch(data.data(), lengths.data(), count, hashes.data(), kernel.second);
+            });
+        }
+        std::cout << std::endl;
+    }
+}
@@ -4,7 +4,12 @@
 #include "neocpp/crypto/ecdsa_signature.hpp"
 #include "neocpp/utils/hex.hpp"
 #include "neocpp/exceptions.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace neocpp;
@@ -116,4 +121,94 @@ TEST_CASE("Sign Tests", "[crypto]") {
         REQUIRE(signature->getBytes().size() == 64);
     }
     */
-}
\ No newline at end of file
+}
+
+TEST_CASE("Signing with long-lived keys", "[crypto]") {
+    
+    const std::string privateKeyHex = "1dd37fba80fec4e6a6f13fd708d8dcb3b29def768017052f6c930fa1c5d90bbb";
+    const std::string publicKeyHex = "02b379356267a5d01cb0777ef97509e061ff2d0c9a5cb718720c67005aabefc74f";
+    ECPrivateKey privateKey(Hex::decode(privateKeyHex));
+    Bytes message = {0x01, 0x02, 0x03, 0x04, 0x05};
+    
+    SECTION("The derived public key is stable") {
+        auto first = privateKey.getPublicKey();
+        auto second = privateKey.getPublicKey();
+        REQUIRE(Hex::encode(first->getEncoded()) == publicKeyHex);
+        REQUIRE(*first == *second);
+        REQUIRE(first != second);
+    }
+    
+    SECTION("Copies sign and verify like the original") {
+        auto signature = privateKey.sign(message);
+        ECPrivateKey copy = privateKey;
+        auto publicKey = privateKey.getPublicKey();
+        ECPublicKey publicCopy = *publicKey;
+        REQUIRE(publicCopy.verify(message, *copy.sign(message)));
+        REQUIRE(publicKey->verify(message, *signature));
+        
+        ECPrivateKey other(Hex::decode("9117f4bf9be717c9a90994326897f4243503accd06712162267e77f18b49c3a3"));
+        other = copy;
+        REQUIRE(publicKey->verify(message, *other.sign(message)));
+        REQUIRE(Hex::encode(other.getPublicKey()->getEncoded()) == publicKeyHex);
+    }
+    
+    SECTION("A signature does not verify for another message or key") {
+        auto signature = privateKey.sign(message);
+        REQUIRE_FALSE(privateKey.getPublicKey()->verify(Bytes{0x01}, *signature));
+        ECPrivateKey other(Hex::decode("9117f4bf9be717c9a90994326897f4243503accd06712162267e77f18b49c3a3"));
+        REQUIRE_FALSE(other.getPublicKey()->verify(message, *signature));
+    }
+    
+    SECTION("Keys can be shared between threads") {
+        auto publicKey = privateKey.getPublicKey();
+        ECPrivateKey fresh(Hex::decode(privateKeyHex));
+        ECPublicKey freshPublic(Hex::decode(publicKeyHex));
+        std::atomic<int> valid{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < 10; ++i) {
+                    Bytes data = {static_cast<uint8_t>(t), static_cast<uint8_t>(i)};
+                    // The fresh keys create their native state concurrently on first use
+                    if (freshPublic.verify(data, *fresh.sign(data)) && publicKey->verify(data, *privateKey.sign(data))) {
+                        valid++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(valid == 80);
+    }
+    
+    SECTION("Private keys outside [1, n-1] are rejected") {
+        REQUIRE_THROWS_AS(ECPrivateKey(Bytes(32, 0)), IllegalArgumentException);
+        REQUIRE_THROWS_AS(ECPrivateKey(Bytes(32, 0xff)), IllegalArgumentException);
+        // The secp256k1 group order, and the largest valid key below it
+        const std::string order = "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141";
+        REQUIRE_THROWS_AS(ECPrivateKey(Hex::decode(order)), IllegalArgumentException);
+        REQUIRE_NOTHROW(ECPrivateKey(Hex::decode("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140")));
+    }
+}
+
+TEST_CASE("Signing throughput with a hot key", "[.][benchmark]") {
+    ECPrivateKey privateKey(Hex::decode("9117f4bf9be717c9a90994326897f4243503accd06712162267e77f18b49c3a3"));
+    auto publicKey = privateKey.getPublicKey();
+    Bytes message(200, 0x42);
+    auto signature = privateKey.sign(message);
+    
+    auto measure = [](const char* name, int count, const std::function<void()>& operation) {
+        auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            operation();
+        }
+        auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count() / count;
+        std::cout << "  " << name << ": " << micros << " us" << std::endl;
+    };
+    std::cout << "Per call, same key:" << std::endl;
+    measure("sign", 2000, [&]() { privateKey.sign(message); });
+    measure("verify", 2000, [&]() { publicKey->verify(message, *signature); });
+    measure("getPublicKey", 2000, [&]() { privateKey.getPublicKey(); });
+    measure("ECPrivateKey(bytes)", 2000, [&]() { ECPrivateKey key(Hex::decode("9117f4bf9be717c9a90994326897f4243503accd06712162267e77f18b49c3a3")); });
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace neocpp {
+namespace test {
+
+/// Minimal HTTP/1.1 keep-alive server on 127.0.0.1, or on a Unix domain socket, for
+/// tests that need a real socket
+class LocalHttpServer {
+public:
+    /// Request as seen by the server
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string body;
+        std::string headers;
+    };
+
+    /// Reply produced by the handler
+    struct Reply {
+        int status = 200;
+        std::string body;
+        std::string extraHeaders;
+    };
+
+    using Handler = std::function<Reply(const Request&)>;
+
+private:
+    Handler handler_;
+    int listenFd_ = -1;
+    int port_ = 0;
+    std::string socketPath_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> connections_{0};
+    std::atomic<int> requests_{0};
+    std::thread acceptThread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+    std::vector<int> clientFds_;
+
+public:
+    explicit LocalHttpServer(Handler handler) : handler_(std::move(handler)) {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 128);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        acceptThread_ = std::thread([this]() { acceptLoop(); });
+    }
+
+    /// Listen on a Unix domain socket instead; an existing file at the path is replaced
+    LocalHttpServer(Handler handler, const std::string& socketPath)
+        : handler_(std::move(handler)), socketPath_(socketPath) {
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(socketPath.c_str());
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 128);
+
+        running_ = true;
+        acceptThread_ = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~LocalHttpServer() {
+        stop();
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        if (acceptThread_.joinable()) {
+            acceptThread_.join();
+        }
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : clientFds_) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            workers.swap(workers_);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (!socketPath_.empty()) {
+            ::unlink(socketPath_.c_str());
+        }
+    }
+
+    int getPort() const { return port_; }
+    std::string getUrl() const {
+        return socketPath_.empty() ? "http://127.0.0.1:" + std::to_string(port_) : "unix://" + socketPath_;
+    }
+
+    /// Number of TCP connections accepted so far
+    int getConnectionCount() const { return connections_; }
+
+    /// Number of HTTP requests served so far
+    int getRequestCount() const { return requests_; }
+
+    /// Build a JSON-RPC success body
+    static std::string rpcResult(const std::string& resultJson, const std::string& idJson = "1") {
+        return "{\"jsonrpc\":\"2.0\",\"id\":" + idJson + ",\"result\":" + resultJson + "}";
+    }
+
+private:
+    void acceptLoop() {
+        while (running_) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) {
+                break;
+            }
+            if (socketPath_.empty()) {
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+            connections_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            clientFds_.push_back(fd);
+            workers_.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[65536];
+        while (running_) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    closeClient(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+
+            Request request;
+            request.headers = buffer.substr(0, headerEnd);
+            auto firstSpace = request.headers.find(' ');
+            auto secondSpace = request.headers.find(' ', firstSpace + 1);
+            request.method = request.headers.substr(0, firstSpace);
+            request.path = request.headers.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+
+            size_t contentLength = 0;
+            auto lengthPos = findHeader(request.headers, "content-length:");
+            if (lengthPos != std::string::npos) {
+                contentLength = std::strtoul(request.headers.c_str() + lengthPos + 15, nullptr, 10);
+            }
+            while (buffer.size() < headerEnd + 4 + contentLength) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    closeClient(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            request.body = buffer.substr(headerEnd + 4, contentLength);
+            buffer.erase(0, headerEnd + 4 + contentLength);
+
+            requests_++;
+            Reply reply = handler_(request);
+            std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " OK\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: " + std::to_string(reply.body.size()) + "\r\n" +
+                reply.extraHeaders +
+                "\r\n" + reply.body;
+            size_t sent = 0;
+            while (sent < response.size()) {
+                ssize_t n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    closeClient(fd);
+                    return;
+                }
+                sent += static_cast<size_t>(n);
+            }
+        }
+        closeClient(fd);
+    }
+
+    void closeClient(int fd) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clientFds_.erase(std::remove(clientFds_.begin(), clientFds_.end(), fd), clientFds_.end());
+        ::close(fd);
+    }
+
+    static size_t findHeader(const std::string& headers, const std::string& lowerName) {
+        std::string lower = headers;
+        for (auto& c : lower) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return lower.find(lowerName);
+    }
+};
+
+} // namespace test
+} // namespace neocpp
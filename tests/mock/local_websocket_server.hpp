@@ -0,0 +1,346 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <openssl/evp.h>
+#include <nlohmann/json.hpp>
+#include "neocpp/utils/base64.hpp"
+
+namespace neocpp {
+namespace test {
+
+/// Minimal WebSocket server on 127.0.0.1 standing in for a node's /ws endpoint.
+/// It answers subscribe and unsubscribe like neo-go and pushes events on request.
+class LocalWebSocketServer {
+public:
+    /// Controls how the stand-in behaves
+    enum class Mode {
+        Subscriptions,     ///< Accepts subscriptions
+        NoSubscribe,       ///< Upgrades, but answers subscribe with "Method not found"
+        RejectUpgrade,     ///< Answers the upgrade with 404, like a node without WebSocket support
+        Unavailable        ///< Answers the upgrade with 503, like a proxy in front of a restarting node
+    };
+
+private:
+    /// One client connection
+    struct Session {
+        int fd;
+        std::mutex writeMutex;
+        std::vector<std::string> subscriptions;
+    };
+
+    Mode mode_;
+    int listenFd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<int> handshakes_{0};
+    std::atomic<int> connections_{0};
+    std::atomic<int> subscribeRequests_{0};
+    std::atomic<int> nextSubscriptionId_{1};
+    std::thread acceptThread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+
+public:
+    explicit LocalWebSocketServer(Mode mode = Mode::Subscriptions) : mode_(mode) {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 16);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        acceptThread_ = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~LocalWebSocketServer() {
+        stop();
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        if (acceptThread_.joinable()) {
+            acceptThread_.join();
+        }
+        dropConnections();
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers.swap(workers_);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::string getUrl() const { return "ws://127.0.0.1:" + std::to_string(port_) + "/ws"; }
+
+    /// Number of WebSocket connections accepted so far
+    int getConnectionCount() const { return connections_; }
+
+    /// Number of upgrade requests received, whether or not they were accepted
+    int getHandshakeCount() const { return handshakes_; }
+
+    /// Number of subscribe requests received so far
+    int getSubscribeCount() const { return subscribeRequests_; }
+
+    /// Number of subscriptions currently active over all connections
+    size_t getActiveSubscriptionCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& session : sessions_) {
+            count += session->subscriptions.size();
+        }
+        return count;
+    }
+
+    /// Push an event to every connected client
+    void push(const std::string& event, const nlohmann::json& payload) {
+        nlohmann::json message = {{"jsonrpc", "2.0"}, {"method", event}, {"params", nlohmann::json::array({payload})}};
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& session : sessions_) {
+            send(*session, message.dump());
+        }
+    }
+
+    /// Close every client connection, as a restarting node would
+    void dropConnections() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& session : sessions_) {
+            ::shutdown(session->fd, SHUT_RDWR);
+        }
+    }
+
+private:
+    void acceptLoop() {
+        while (running_) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    static std::string acceptKey(const std::string& key) {
+        std::string input = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(input.data(), input.size(), digest, &length, EVP_sha1(), nullptr);
+        return Base64::encode(Bytes(digest, digest + length));
+    }
+
+    static bool readMore(int fd, std::string& buffer) {
+        char chunk[65536];
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    static void writeAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    /// Send an unmasked text frame
+    static void send(Session& session, const std::string& text) {
+        std::string frame;
+        frame += static_cast<char>(0x81);
+        if (text.size() < 126) {
+            frame += static_cast<char>(text.size());
+        } else if (text.size() <= 0xFFFF) {
+            frame += static_cast<char>(126);
+            frame += static_cast<char>(text.size() >> 8);
+            frame += static_cast<char>(text.size() & 0xFF);
+        } else {
+            frame += static_cast<char>(127);
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                frame += static_cast<char>((static_cast<uint64_t>(text.size()) >> shift) & 0xFF);
+            }
+        }
+        frame += text;
+        std::lock_guard<std::mutex> lock(session.writeMutex);
+        writeAll(session.fd, frame);
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!readMore(fd, buffer)) {
+                ::close(fd);
+                return;
+            }
+        }
+        std::string request = buffer.substr(0, headerEnd);
+        buffer.erase(0, headerEnd + 4);
+
+        handshakes_++;
+        if (mode_ == Mode::RejectUpgrade) {
+            writeAll(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            ::close(fd);
+            return;
+        }
+        if (mode_ == Mode::Unavailable) {
+            writeAll(fd, "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            ::close(fd);
+            return;
+        }
+        std::string lower = request;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        auto keyStart = lower.find("sec-websocket-key:") + 18;
+        keyStart = request.find_first_not_of(' ', keyStart);
+        std::string key = request.substr(keyStart, request.find("\r\n", keyStart) - keyStart);
+        writeAll(fd, "HTTP/1.1 101 Switching Protocols\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Accept: " + acceptKey(key) + "\r\n\r\n");
+
+        auto session = std::make_shared<Session>();
+        session->fd = fd;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.push_back(session);
+        }
+        connections_++;
+
+        while (running_) {
+            // Client frames are always masked
+            while (buffer.size() < 2 || buffer.size() < frameLength(buffer)) {
+                if (!readMore(fd, buffer)) {
+                    closeSession(session);
+                    return;
+                }
+            }
+            size_t length = frameLength(buffer);
+            uint8_t opcode = static_cast<uint8_t>(buffer[0]) & 0x0F;
+            size_t payloadLength = static_cast<uint8_t>(buffer[1]) & 0x7F;
+            size_t header = 2;
+            if (payloadLength == 126) {
+                payloadLength = (static_cast<uint8_t>(buffer[2]) << 8) | static_cast<uint8_t>(buffer[3]);
+                header = 4;
+            } else if (payloadLength == 127) {
+                payloadLength = 0;
+                for (int i = 0; i < 8; ++i) {
+                    payloadLength = (payloadLength << 8) | static_cast<uint8_t>(buffer[2 + i]);
+                }
+                header = 10;
+            }
+            std::string payload = buffer.substr(header + 4, payloadLength);
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] = static_cast<char>(payload[i] ^ buffer[header + i % 4]);
+            }
+            buffer.erase(0, length);
+
+            if (opcode == 0x8) {
+                closeSession(session);
+                return;
+            }
+            if (opcode == 0x9) {
+                std::string pong = "\x8A";
+                pong += static_cast<char>(payload.size());
+                pong += payload;
+                std::lock_guard<std::mutex> lock(session->writeMutex);
+                writeAll(fd, pong);
+                continue;
+            }
+            if (opcode == 0x1) {
+                handleRequest(*session, payload);
+            }
+        }
+        closeSession(session);
+    }
+
+    static size_t frameLength(const std::string& buffer) {
+        size_t length = static_cast<uint8_t>(buffer[1]) & 0x7F;
+        if (length == 126) {
+            if (buffer.size() < 4) {
+                return SIZE_MAX;
+            }
+            return 4 + 4 + ((static_cast<uint8_t>(buffer[2]) << 8) | static_cast<uint8_t>(buffer[3]));
+        }
+        if (length == 127) {
+            if (buffer.size() < 10) {
+                return SIZE_MAX;
+            }
+            size_t value = 0;
+            for (int i = 0; i < 8; ++i) {
+                value = (value << 8) | static_cast<uint8_t>(buffer[2 + i]);
+            }
+            return 10 + 4 + value;
+        }
+        return 2 + 4 + length;
+    }
+
+    void handleRequest(Session& session, const std::string& text) {
+        auto request = nlohmann::json::parse(text);
+        nlohmann::json reply = {{"jsonrpc", "2.0"}, {"id", request["id"]}};
+        std::string method = request["method"];
+        if (method == "subscribe" && mode_ == Mode::Subscriptions) {
+            subscribeRequests_++;
+            std::string id = std::to_string(nextSubscriptionId_++);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                session.subscriptions.push_back(id);
+            }
+            reply["result"] = id;
+        } else if (method == "unsubscribe") {
+            std::string id = request["params"][0];
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& subscriptions = session.subscriptions;
+            subscriptions.erase(std::remove(subscriptions.begin(), subscriptions.end(), id), subscriptions.end());
+            reply["result"] = true;
+        } else {
+            if (method == "subscribe") {
+                subscribeRequests_++;
+            }
+            reply["error"] = {{"code", -32601}, {"message", "Method not found"}};
+        }
+        send(session, reply.dump());
+    }
+
+    void closeSession(const std::shared_ptr<Session>& session) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.erase(std::remove(sessions_.begin(), sessions_.end(), session), sessions_.end());
+        ::close(session->fd);
+    }
+};
+
+} // namespace test
+} // namespace neocpp
@@ -0,0 +1,406 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/protocol/loopback_transport.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/utils/histogram.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace neocpp;
+using neocpp::test::LocalHttpServer;
+
+namespace {
+
+// Wait until a condition holds or a few seconds have passed
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+nlohmann::json makeBlock(uint32_t index) {
+    return {{"index", index}, {"hash", "0x" + std::to_string(index)}, {"tx", nlohmann::json::array()}};
+}
+
+// A chain of height blocks; getblock fails for the heights in failing
+SharedPtr<LoopbackTransport> makeChain(std::atomic<uint32_t>& height, std::atomic<int64_t>& failing) {
+    auto node = std::make_shared<LoopbackTransport>();
+    node->setHandler("getblockcount", [&height](const nlohmann::json&) -> nlohmann::json {
+        return height.load();
+    });
+    node->setHandler("getblock", [&height, &failing](const nlohmann::json& params) -> nlohmann::json {
+        uint32_t index = params.at(0).get<uint32_t>();
+        if (index >= height || static_cast<int64_t>(index) == failing) {
+            throw RpcException("Unknown block");
+        }
+        return makeBlock(index);
+    });
+    return node;
+}
+
+// Collects what the poller delivers
+struct Stream {
+    std::mutex mutex;
+    std::vector<int64_t> blocks;
+    std::vector<uint32_t> indices;
+
+    void attach(BlockPolling& polling) {
+        polling.subscribeBlocks([this](const nlohmann::json& block) {
+            std::lock_guard<std::mutex> lock(mutex);
+            blocks.push_back(block["index"].get<int64_t>());
+        });
+        polling.subscribe([this](uint32_t index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            indices.push_back(index);
+        });
+    }
+
+    // Both subscribers run independently; count what both have seen
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::min(blocks.size(), indices.size());
+    }
+
+    bool inOrderFrom(int64_t first) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            if (blocks[i] != first + static_cast<int64_t>(i) || indices[i] != blocks[i]) {
+                return false;
+            }
+        }
+        return blocks.size() == indices.size();
+    }
+};
+
+// Milliseconds since the Unix epoch, the unit of block timestamps
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// A node producing a block every interval, starting now at height 100
+SharedPtr<LoopbackTransport> makeLiveChain(std::chrono::milliseconds interval) {
+    auto node = std::make_shared<LoopbackTransport>();
+    int64_t start = nowMillis();
+    int64_t step = interval.count();
+    auto time = [start, step](uint32_t index) { return start + (static_cast<int64_t>(index) - 100) * step; };
+    node->setHandler("getblockcount", [start, step](const nlohmann::json&) -> nlohmann::json {
+        return 101 + (nowMillis() - start) / step;
+    });
+    node->setHandler("getblockheader", [time](const nlohmann::json& params) -> nlohmann::json {
+        uint32_t index = params.at(0).get<uint32_t>();
+        return {{"index", index}, {"time", time(index)}};
+    });
+    node->setHandler("getblock", [time](const nlohmann::json& params) -> nlohmann::json {
+        uint32_t index = params.at(0).get<uint32_t>();
+        return {{"index", index}, {"time", time(index)}, {"tx", nlohmann::json::array()}};
+    });
+    return node;
+}
+
+} // namespace
+
+TEST_CASE("AdaptivePollSchedule", "[protocol][polling]") {
+
+    AdaptivePollingConfig config;
+    config.expectedBlockInterval = std::chrono::milliseconds(15000);
+    config.minInterval = std::chrono::milliseconds(100);
+    config.maxInterval = std::chrono::milliseconds(15000);
+    AdaptivePollSchedule schedule(config);
+
+    SECTION("Polls sparsely after a block and tightly when the next is due") {
+        REQUIRE(schedule.nextDelay(0) == std::chrono::milliseconds(100));
+        schedule.onBlock(10, 1000, 1050, false);
+        // Sleeps until twice the assumed deviation (1.5 s) before the block is due
+        REQUIRE(schedule.nextDelay(1050) == std::chrono::milliseconds(11950));
+        REQUIRE(schedule.nextDelay(12000) == std::chrono::milliseconds(1000));
+        REQUIRE(schedule.nextDelay(13500) == std::chrono::milliseconds(100));
+        REQUIRE(schedule.nextDelay(15900) == std::chrono::milliseconds(100));
+
+        // Late blocks are polled for less often the later they are
+        REQUIRE(schedule.nextDelay(16100) == std::chrono::milliseconds(100));
+        REQUIRE(schedule.nextDelay(17000) == std::chrono::milliseconds(500));
+        REQUIRE(schedule.nextDelay(100000) == std::chrono::milliseconds(15000));
+    }
+
+    SECTION("Learns the block interval from live blocks") {
+        schedule.onBlock(10, 1000, 1050, false);
+        REQUIRE(schedule.getDetectionLatency().getCount() == 0);
+        schedule.onBlock(11, 11000, 11120, true);
+        REQUIRE(schedule.getBlockInterval() == std::chrono::milliseconds(14000));
+        REQUIRE(schedule.getBlockIntervalDeviation() == std::chrono::milliseconds(2200));
+        REQUIRE(schedule.getLastDetectionLatency() == 120);
+
+        // Two blocks between polls count as two intervals
+        schedule.onBlock(13, 31000, 31300, true);
+        REQUIRE(schedule.getBlockInterval() == std::chrono::milliseconds(13200));
+        REQUIRE(schedule.getDetectionLatency().getCount() == 2);
+        REQUIRE(schedule.getDetectionLatency().getMax() == 300);
+
+        // A node clock ahead of ours gives no negative latency
+        schedule.onBlock(14, 45000, 44000, true);
+        REQUIRE(schedule.getLastDetectionLatency() == 0);
+    }
+
+    SECTION("Rejects invalid configurations") {
+        AdaptivePollingConfig invalid = config;
+        invalid.minInterval = std::chrono::milliseconds(0);
+        REQUIRE_THROWS_AS(AdaptivePollSchedule(invalid), IllegalArgumentException);
+        invalid = config;
+        invalid.maxInterval = std::chrono::milliseconds(50);
+        REQUIRE_THROWS_AS(AdaptivePollSchedule(invalid), IllegalArgumentException);
+        invalid = config;
+        invalid.smoothing = 0.0;
+        REQUIRE_THROWS_AS(AdaptivePollSchedule(invalid), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("BlockPolling adaptive polling", "[protocol][polling]") {
+    auto client = std::make_shared<NeoRpcClient>(makeLiveChain(std::chrono::milliseconds(100)));
+    BlockPolling polling(client, std::chrono::milliseconds(300));
+    AdaptivePollingConfig config;
+    config.expectedBlockInterval = std::chrono::milliseconds(300);
+    config.minInterval = std::chrono::milliseconds(5);
+    config.maxInterval = std::chrono::milliseconds(300);
+    polling.setAdaptivePolling(config);
+    std::atomic<int> blocks{0};
+    polling.subscribe([&blocks](uint32_t) { blocks++; });
+    polling.start();
+    REQUIRE(waitFor([&]() { return blocks >= 15; }));
+    polling.stop();
+
+    auto schedule = polling.getAdaptiveSchedule();
+    REQUIRE(schedule != nullptr);
+    REQUIRE(schedule->getBlockInterval() < std::chrono::milliseconds(200));
+    REQUIRE(schedule->getDetectionLatency().getCount() >= 10);
+    REQUIRE(schedule->getDetectionLatency().getMean() < 100);
+    REQUIRE(polling.getPollCount() > 0);
+}
+
+TEST_CASE("BlockPolling block stream", "[protocol][polling]") {
+
+    std::atomic<uint32_t> height{1000};
+    std::atomic<int64_t> failing{-1};
+    auto client = std::make_shared<NeoRpcClient>(makeChain(height, failing));
+
+    SECTION("Catches up from a checkpoint in height order") {
+        BlockPolling polling(client, std::chrono::milliseconds(5));
+        polling.setStartHeight(100);
+        polling.setCatchUpWindow(32, 3);
+        Stream stream;
+        stream.attach(polling);
+        polling.start();
+        REQUIRE(waitFor([&]() { return stream.size() == 900; }));
+        REQUIRE(stream.inOrderFrom(100));
+        REQUIRE(polling.getLastBlockIndex() == 999);
+        REQUIRE(polling.getNextHeight() == 1000);
+
+        // Several blocks between two polls are all delivered
+        height = 1005;
+        REQUIRE(waitFor([&]() { return stream.size() == 905; }));
+        polling.stop();
+        REQUIRE(stream.inOrderFrom(100));
+    }
+
+    SECTION("Starts at the head without a checkpoint") {
+        BlockPolling polling(client, std::chrono::milliseconds(5));
+        REQUIRE(polling.getNextHeight() == -1);
+        Stream stream;
+        stream.attach(polling);
+        polling.start();
+        REQUIRE(waitFor([&]() { return stream.size() == 1; }));
+        height = 1003;
+        REQUIRE(waitFor([&]() { return stream.size() == 4; }));
+        polling.stop();
+        REQUIRE(stream.inOrderFrom(999));
+    }
+
+    SECTION("Index subscribers alone see every height without fetching blocks") {
+        BlockPolling polling(client, std::chrono::milliseconds(5));
+        polling.setStartHeight(990);
+        std::vector<uint32_t> indices;
+        std::mutex mutex;
+        polling.subscribe([&](uint32_t index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            indices.push_back(index);
+        });
+        polling.start();
+        REQUIRE(waitFor([&]() { std::lock_guard<std::mutex> lock(mutex); return indices.size() == 10; }));
+        polling.stop();
+        REQUIRE(indices.front() == 990);
+        REQUIRE(indices.back() == 999);
+    }
+
+    SECTION("A failed fetch resumes at the missing height") {
+        failing = 50;
+        BlockPolling polling(client, std::chrono::milliseconds(5));
+        polling.setMaxBackoff(std::chrono::milliseconds(10));
+        polling.setStartHeight(0);
+        polling.setCatchUpWindow(16, 2);
+        std::atomic<int> errors{0};
+        polling.setErrorHandler([&errors](const std::exception&) { errors++; });
+        Stream stream;
+        stream.attach(polling);
+        polling.start();
+        REQUIRE(waitFor([&]() { return errors >= 2 && stream.size() == 50; }));
+        REQUIRE(polling.waitIdle(std::chrono::seconds(1)));
+        REQUIRE(stream.size() == 50);
+        REQUIRE(polling.getNextHeight() == 50);
+
+        failing = -1;
+        REQUIRE(waitFor([&]() { return stream.size() == 1000; }));
+        polling.stop();
+        REQUIRE(stream.inOrderFrom(0));
+        REQUIRE(polling.getConsecutiveErrors() == 0);
+    }
+
+    SECTION("A slow subscriber does not hold up the others") {
+        BlockPolling polling(client, std::chrono::milliseconds(5));
+        polling.setStartHeight(0);
+        Stream stream;
+        stream.attach(polling);
+        SubscriberOptions latest;
+        latest.queueCapacity = 4;
+        latest.overflow = OverflowPolicy::Coalesce;
+        std::atomic<bool> release{false};
+        std::atomic<int64_t> slowLast{-1};
+        auto slow = polling.subscribe([&](uint32_t index) {
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            slowLast = index;
+        }, latest);
+        polling.start();
+        REQUIRE(waitFor([&]() { return stream.size() == 1000; }));
+
+        // One height is in the handler; the rest is queued, or was coalesced away
+        SubscriberStats stats;
+        REQUIRE(waitFor([&]() {
+            stats = polling.getSubscriberStats(slow);
+            return stats.queueDepth + stats.dropped == 999;
+        }));
+        REQUIRE(stats.queueCapacity == 4);
+        REQUIRE(stats.queueDepth <= 5);
+        REQUIRE(stats.delivered == 0);
+        release = true;
+        REQUIRE(polling.waitIdle(std::chrono::seconds(5)));
+        REQUIRE(slowLast == 999);
+        REQUIRE(polling.getSubscriberStats(slow).delivered == stats.queueDepth + 1);
+        polling.stop();
+        REQUIRE(stream.inOrderFrom(0));
+    }
+
+    SECTION("Subscribers can come and go while polling") {
+        BlockPolling polling(client, std::chrono::milliseconds(1));
+        polling.setStartHeight(0);
+        polling.setCatchUpWindow(8, 2);
+        polling.start();
+        std::atomic<int> calls{0};
+        for (int i = 0; i < 50; ++i) {
+            auto id = polling.subscribe([&calls](uint32_t) { calls++; });
+            auto blockId = polling.subscribeBlocks([&calls](const nlohmann::json&) { calls++; });
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            polling.unsubscribe(id);
+            polling.unsubscribe(blockId);
+        }
+        polling.stop();
+        REQUIRE_THROWS_AS(polling.getSubscriberStats(1), IllegalArgumentException);
+    }
+
+    SECTION("Rejects an empty catch-up window") {
+        BlockPolling polling(client);
+        REQUIRE_THROWS_AS(polling.setCatchUpWindow(0, 1), IllegalArgumentException);
+        REQUIRE_THROWS_AS(polling.setCatchUpWindow(1, 0), IllegalArgumentException);
+    }
+}
+
+#ifdef HAVE_CURL
+TEST_CASE("BlockPolling catch-up throughput", "[.][benchmark]") {
+    // Every POST costs a millisecond of node latency
+    static constexpr uint32_t blocks = 2000;
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto body = nlohmann::json::parse(request.body);
+        auto answer = [](const nlohmann::json& call) -> nlohmann::json {
+            nlohmann::json result = call["method"] == "getblockcount"
+                ? nlohmann::json(blocks) : makeBlock(call["params"][0].get<uint32_t>());
+            return {{"jsonrpc", "2.0"}, {"id", call["id"]}, {"result", result}};
+        };
+        nlohmann::json reply;
+        if (body.is_array()) {
+            reply = nlohmann::json::array();
+            for (const auto& call : body) {
+                reply.push_back(answer(call));
+            }
+        } else {
+            reply = answer(body);
+        }
+        LocalHttpServer::Reply response;
+        response.body = reply.dump();
+        return response;
+    });
+    auto client = std::make_shared<NeoRpcClient>(server.getUrl());
+
+    auto measure = [&](size_t batchSize, size_t batchesInFlight) {
+        BlockPolling polling(client, std::chrono::milliseconds(1000));
+        polling.setStartHeight(0);
+        polling.setCatchUpWindow(batchSize, batchesInFlight);
+        Stream stream;
+        stream.attach(polling);
+        auto started = std::chrono::steady_clock::now();
+        polling.start();
+        waitFor([&]() { return stream.size() == blocks; });
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        polling.stop();
+        REQUIRE(stream.inOrderFrom(0));
+        return elapsed;
+    };
+
+    double oneByOne = measure(1, 1);
+    double windowed = measure(BlockPolling::DEFAULT_BATCH_SIZE, BlockPolling::DEFAULT_BATCHES_IN_FLIGHT);
+    std::cout << "Catching up " << blocks << " blocks: one getblock at a time " << oneByOne
+              << " ms, " << BlockPolling::DEFAULT_BATCHES_IN_FLIGHT << " batches of "
+              << BlockPolling::DEFAULT_BATCH_SIZE << " in flight " << windowed << " ms" << std::endl;
+}
+#endif
+
+TEST_CASE("BlockPolling adaptive polling latency", "[.][benchmark]") {
+    // A 200 ms chain, watched for 4 s
+    auto chain = makeLiveChain(std::chrono::milliseconds(200));
+    auto measure = [&](bool adaptive) {
+        auto client = std::make_shared<NeoRpcClient>(chain);
+        BlockPolling polling(client, std::chrono::milliseconds(50));
+        if (adaptive) {
+            AdaptivePollingConfig config;
+            config.expectedBlockInterval = std::chrono::milliseconds(200);
+            config.minInterval = std::chrono::milliseconds(5);
+            config.maxInterval = std::chrono::milliseconds(200);
+            polling.setAdaptivePolling(config);
+        }
+        auto detection = std::make_shared<Histogram>();
+        polling.subscribeBlocks([detection](const nlohmann::json& block) {
+            detection->record(static_cast<uint64_t>(std::max<int64_t>(0, nowMillis() - block["time"].get<int64_t>())));
+        });
+        polling.start();
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+        polling.stop();
+        std::cout << (adaptive ? "Adaptive polling:   " : "Polling every 50 ms: ") << polling.getPollCount()
+                  << " polls, mean detection latency " << detection->getMean() << " ms, p99 "
+                  << detection->getPercentile(99) << " ms" << std::endl;
+    };
+    measure(false);
+    measure(true);
+}
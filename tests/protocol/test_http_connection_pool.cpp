@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/http_connection_pool.hpp"
+#include "neocpp/protocol/http_service.hpp"
+#include <thread>
+
+using namespace neocpp;
+
+#ifdef HAVE_CURL
+
+TEST_CASE("HttpConnectionPool Tests", "[protocol][http]") {
+
+    SECTION("Reuses released handles") {
+        HttpConnectionPool pool(4);
+        void* first = pool.acquire();
+        pool.release(first);
+        void* second = pool.acquire();
+
+        REQUIRE(second == first);
+        auto stats = pool.getStats();
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.hitRatio() == 0.5);
+        pool.release(second);
+    }
+
+    SECTION("Evicts beyond max size") {
+        HttpConnectionPool pool(1);
+        void* a = pool.acquire();
+        void* b = pool.acquire();
+        pool.release(a);
+        pool.release(b);
+
+        auto stats = pool.getStats();
+        REQUIRE(stats.idleHandles == 1);
+        REQUIRE(stats.evictions == 1);
+    }
+
+    SECTION("Shrinking max size closes excess idle handles") {
+        HttpConnectionPool pool(4);
+        void* a = pool.acquire();
+        void* b = pool.acquire();
+        pool.release(a);
+        pool.release(b);
+        pool.setMaxSize(0);
+
+        REQUIRE(pool.getStats().idleHandles == 0);
+        REQUIRE(pool.getStats().evictions == 2);
+    }
+
+    SECTION("Evicts handles past idle timeout") {
+        HttpConnectionPool pool(4, std::chrono::milliseconds(10));
+        pool.release(pool.acquire());
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        pool.release(pool.acquire());
+
+        auto stats = pool.getStats();
+        REQUIRE(stats.misses == 2);
+        REQUIRE(stats.hits == 0);
+        REQUIRE(stats.evictions == 1);
+    }
+
+    SECTION("Services on the same endpoint share a pool") {
+        HttpService a("http://127.0.0.1:10332");
+        HttpService b("http://127.0.0.1:10332/rpc");
+        HttpService c("http://127.0.0.1:20332");
+
+        REQUIRE(a.getConnectionPool() == b.getConnectionPool());
+        REQUIRE(a.getConnectionPool() != c.getConnectionPool());
+    }
+}
+
+#endif
@@ -0,0 +1,320 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/http_service.hpp"
+#include "neocpp/utils/gzip.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <unistd.h>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+#ifdef HAVE_CURL
+
+TEST_CASE("HttpService Tests", "[protocol][http]") {
+
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        if (request.path == "/slow") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        if (request.path == "/missing") {
+            reply.status = 404;
+        }
+        bool hasCustomHeader = request.headers.find("X-Test: yes") != std::string::npos;
+        reply.body = "{\"method\":\"" + request.method + "\",\"body\":" +
+                     (request.body.empty() ? std::string("null") : request.body) +
+                     ",\"custom\":" + (hasCustomHeader ? "true" : "false") + "}";
+        reply.extraHeaders = "X-Server: local\r\n";
+        return reply;
+    });
+    HttpService service(server.getUrl());
+
+    SECTION("Synchronous verbs") {
+        auto getResponse = service.get("/resource", HttpService::Headers{});
+        REQUIRE(getResponse.isSuccess());
+        REQUIRE(nlohmann::json::parse(getResponse.body)["method"] == "GET");
+        REQUIRE(getResponse.headers["X-Server"] == "local");
+
+        auto putResponse = service.put("/resource", "{\"a\":1}");
+        REQUIRE(nlohmann::json::parse(putResponse.body)["method"] == "PUT");
+        REQUIRE(nlohmann::json::parse(putResponse.body)["body"]["a"] == 1);
+
+        auto delResponse = service.del("/resource");
+        REQUIRE(nlohmann::json::parse(delResponse.body)["method"] == "DELETE");
+
+        auto missing = service.get("/missing", HttpService::Headers{});
+        REQUIRE(missing.statusCode == 404);
+        REQUIRE_FALSE(missing.isSuccess());
+    }
+
+    SECTION("JSON-RPC post") {
+        auto result = service.post(nlohmann::json{{"x", 2}});
+        REQUIRE(result["method"] == "POST");
+        REQUIRE(result["body"]["x"] == 2);
+    }
+
+    SECTION("Default headers are merged into every request") {
+        service.setDefaultHeaders({{"X-Test", "yes"}});
+        auto result = service.post(nlohmann::json::object());
+        REQUIRE(result["custom"] == true);
+    }
+
+    SECTION("Sequential requests reuse one connection") {
+        for (int i = 0; i < 5; ++i) {
+            service.post(nlohmann::json{{"i", i}});
+        }
+        REQUIRE(server.getConnectionCount() == 1);
+        REQUIRE(service.getPoolStats().hits >= 4);
+    }
+
+    SECTION("Async callback") {
+        std::promise<HttpResponse> done;
+        service.postAsync("/resource", "{\"k\":\"v\"}", [&done](const HttpResponse& response) {
+            done.set_value(response);
+        });
+        auto response = done.get_future().get();
+        REQUIRE(response.isSuccess());
+        REQUIRE(nlohmann::json::parse(response.body)["body"]["k"] == "v");
+    }
+
+    SECTION("Async requests run concurrently") {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<HttpResponse>> futures;
+        for (int i = 0; i < 20; ++i) {
+            futures.push_back(service.getAsync("/slow"));
+        }
+        for (auto& future : futures) {
+            REQUIRE(future.get().isSuccess());
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(elapsed < std::chrono::milliseconds(20 * 200));
+    }
+
+    SECTION("Async JSON-RPC post") {
+        auto future = service.postJsonAsync(nlohmann::json{{"id", 7}});
+        REQUIRE(future.get()["body"]["id"] == 7);
+    }
+
+    SECTION("Transport errors surface through the future") {
+        server.stop();
+        HttpService unreachable(server.getUrl());
+        REQUIRE_FALSE(unreachable.getAsync("/").get().error.empty());
+        REQUIRE_THROWS_AS(unreachable.postJsonAsync(nlohmann::json::object()).get(), RpcException);
+    }
+
+    SECTION("Timeout must be positive") {
+        REQUIRE_THROWS_AS(service.setTimeout(0), IllegalArgumentException);
+        service.setTimeout(5);
+        REQUIRE(service.getTimeout() == 5);
+    }
+}
+
+TEST_CASE("HttpService compression", "[protocol][http][compression]") {
+
+    std::string block = "{\"result\":[" ;
+    for (int i = 0; i < 200; ++i) {
+        block += std::string(i == 0 ? "" : ",") + "{\"hash\":\"0x00\",\"size\":123,\"confirmations\":7}";
+    }
+    block += "]}";
+
+    LocalHttpServer server([&block](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        bool gzipBody = request.headers.find("Content-Encoding: gzip") != std::string::npos;
+        if (request.path == "/echo") {
+            reply.body = gzipBody ? Gzip::decompress(request.body) : request.body;
+            return reply;
+        }
+        if (request.headers.find("Accept-Encoding:") != std::string::npos &&
+            request.headers.find("gzip") != std::string::npos) {
+            reply.body = Gzip::compress(block);
+            reply.extraHeaders = "Content-Encoding: gzip\r\n";
+        } else {
+            reply.body = block;
+        }
+        return reply;
+    });
+    HttpService service(server.getUrl());
+
+    if (!Gzip::isAvailable()) {
+        return;
+    }
+
+    SECTION("Compressed responses are decoded and counted") {
+        REQUIRE(service.get("/block", HttpService::Headers{}).body == block);
+        REQUIRE(service.getAsync("/block").get().body == block);
+
+        auto stats = service.getTransferStats();
+        REQUIRE(stats.responseBytes == 2 * block.size());
+        REQUIRE(stats.responseWireBytes < stats.responseBytes / 4);
+        REQUIRE(stats.getSavings() > 0.75);
+    }
+
+    SECTION("Accept-Encoding can be turned off") {
+        service.setAcceptEncoding(false);
+        REQUIRE(service.get("/block", HttpService::Headers{}).body == block);
+        auto stats = service.getTransferStats();
+        REQUIRE(stats.responseWireBytes == stats.responseBytes);
+    }
+
+    SECTION("Large request bodies are compressed") {
+        service.setRequestCompressionThreshold(1024);
+        REQUIRE(service.post("/echo", "small", HttpService::Headers{}).body == "small");
+        REQUIRE(service.post("/echo", block, HttpService::Headers{}).body == block);
+        REQUIRE(service.postAsync("/echo", block).get().body == block);
+
+        auto stats = service.getTransferStats();
+        REQUIRE(stats.requestBytes == 5 + 2 * block.size());
+        REQUIRE(stats.requestWireBytes < stats.requestBytes / 4);
+    }
+}
+
+TEST_CASE("HttpService streaming JSON", "[protocol][http][json]") {
+
+    nlohmann::json block = {{"hash", "0x" + std::string(64, 'b')}, {"tx", nlohmann::json::array()}};
+    for (int i = 0; i < 5000; ++i) {
+        block["tx"].push_back({{"hash", "0x" + std::to_string(i)}, {"netfee", "0.0123"}, {"vmstate", "HALT"}});
+    }
+    std::string reply = nlohmann::json{{"jsonrpc", "2.0"}, {"id", 1}, {"result", block}}.dump();
+
+    LocalHttpServer server([&reply](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply response;
+        if (request.body == "broken") {
+            response.body = "{\"result\": [1, 2";
+        } else if (request.body == "failing") {
+            response.status = 500;
+            response.body = "{\"error\":\"internal\"}";
+        } else {
+            response.body = reply;
+        }
+        return response;
+    });
+    HttpService service(server.getUrl());
+
+    SECTION("Replies are parsed while they are received") {
+        auto response = service.postJson("{}");
+        REQUIRE(response.body.empty());
+        REQUIRE(response.json);
+        REQUIRE((*response.json)["result"] == block);
+        REQUIRE(HttpService::parseJsonResponse(response)["result"]["tx"].size() == 5000);
+        REQUIRE(service.getTransferStats().responseBytes == reply.size());
+    }
+
+    SECTION("Asynchronous replies are parsed while they are received") {
+        std::promise<HttpResponse> done;
+        service.postJsonAsync("{}", [&done](const HttpResponse& response) { done.set_value(response); });
+        auto response = done.get_future().get();
+        REQUIRE(HttpService::parseJsonResponse(response)["result"] == block);
+        REQUIRE(service.post(nlohmann::json::object())["result"]["hash"] == block["hash"]);
+    }
+
+    SECTION("Copies of a response keep the parsed document") {
+        auto response = service.postJson("{}");
+        HttpResponse copy = response;
+        REQUIRE(HttpService::parseJsonResponse(std::move(response))["result"] == block);
+        REQUIRE(HttpService::parseJsonResponse(copy)["result"] == block);
+    }
+
+    SECTION("A response can be parsed repeatedly") {
+        auto response = service.postJson("{}");
+        REQUIRE(HttpService::parseJsonResponse(response)["result"] == block);
+        REQUIRE(HttpService::parseJsonResponse(response)["result"] == block);
+        REQUIRE((*response.json)["result"] == block);
+    }
+
+    SECTION("Invalid replies fail to parse") {
+        auto response = service.postJson("broken");
+        REQUIRE(response.isSuccess());
+        REQUIRE_THROWS_AS(HttpService::parseJsonResponse(response), RpcException);
+    }
+
+    SECTION("Error statuses keep their body") {
+        auto response = service.postJson("failing");
+        REQUIRE(response.statusCode == 500);
+        REQUIRE_FALSE(response.json);
+        REQUIRE(HttpService::parseJsonResponse(response)["error"] == "internal");
+    }
+}
+
+TEST_CASE("HttpService over a Unix domain socket", "[protocol][http][unix]") {
+
+    std::string socketPath = "/tmp/neocpp-test-" + std::to_string(::getpid()) + ".sock";
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        reply.body = LocalHttpServer::rpcResult("\"" + request.path + "\"");
+        return reply;
+    }, socketPath);
+    HttpService service(server.getUrl());
+
+    SECTION("The socket path is taken from the URL") {
+        REQUIRE(service.getUrl() == "unix://" + socketPath);
+        REQUIRE(service.getUnixSocketPath() == socketPath);
+        REQUIRE(HttpService("http://127.0.0.1:10332").getUnixSocketPath().empty());
+        REQUIRE_THROWS_AS(HttpService("unix://"), IllegalArgumentException);
+    }
+
+    SECTION("Requests are sent over the socket") {
+        REQUIRE(HttpService::parseJsonResponse(service.postJson("{}"))["result"] == "/");
+        REQUIRE(service.post(nlohmann::json::object(), "/rpc")["result"] == "/rpc");
+
+        std::promise<HttpResponse> done;
+        service.postJsonAsync("{}", [&done](const HttpResponse& response) { done.set_value(response); });
+        REQUIRE(HttpService::parseJsonResponse(done.get_future().get())["result"] == "/");
+        REQUIRE(server.getRequestCount() == 3);
+        REQUIRE(server.getConnectionCount() == 1);
+    }
+
+    SECTION("A missing socket is a transport failure") {
+        server.stop();
+        auto response = service.postJson("{}");
+        REQUIRE(response.statusCode == 0);
+        REQUIRE_FALSE(response.error.empty());
+        REQUIRE(response.isTransientFailure());
+    }
+}
+
+// Hidden benchmark, run with: neocpp_tests "[benchmark]"
+TEST_CASE("HttpService loopback transport latency", "[.][benchmark][http]") {
+
+    const int calls = 5000;
+    std::string body = LocalHttpServer::rpcResult("1234");
+    auto handler = [&body](const LocalHttpServer::Request&) {
+        LocalHttpServer::Reply reply;
+        reply.body = body;
+        return reply;
+    };
+    LocalHttpServer tcpServer(handler);
+    LocalHttpServer unixServer(handler, "/tmp/neocpp-bench-" + std::to_string(::getpid()) + ".sock");
+    std::string request = R"({"jsonrpc":"2.0","method":"getblockcount","params":[],"id":1})";
+
+    auto measure = [&](const std::string& url) {
+        HttpService service(url);
+        for (int i = 0; i < 100; ++i) {
+            service.postJson(request);
+        }
+        std::vector<double> micros;
+        micros.reserve(calls);
+        for (int i = 0; i < calls; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            REQUIRE(service.postJson(request).isSuccess());
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(micros.begin(), micros.end());
+        double total = 0;
+        for (double value : micros) {
+            total += value;
+        }
+        std::cout << url << ": mean " << total / calls << "us, p50 " << micros[calls / 2]
+                  << "us, p99 " << micros[calls * 99 / 100] << "us" << std::endl;
+        return micros[calls / 2];
+    };
+
+    double tcp = measure(tcpServer.getUrl());
+    double unixSocket = measure(unixServer.getUrl());
+    std::cout << "Unix socket median latency is " << 100.0 * (1.0 - unixSocket / tcp) << "% below TCP" << std::endl;
+}
+
+#endif
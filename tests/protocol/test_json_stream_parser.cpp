@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/json_stream_parser.hpp"
+#include <string>
+#include <vector>
+
+using namespace neocpp;
+
+namespace {
+
+/// Parse a document split into chunks of the given size
+nlohmann::json parseInChunks(const std::string& text, size_t chunkSize) {
+    JsonStreamParser parser;
+    for (size_t offset = 0; offset < text.size(); offset += chunkSize) {
+        REQUIRE(parser.feed(text.data() + offset, std::min(chunkSize, text.size() - offset)));
+    }
+    REQUIRE(parser.finish());
+    return std::move(parser.getDocument());
+}
+
+bool rejects(const std::string& text) {
+    JsonStreamParser parser;
+    return !parser.feed(text.data(), text.size()) || !parser.finish();
+}
+
+} // namespace
+
+TEST_CASE("JsonStreamParser Tests", "[protocol][json]") {
+
+    SECTION("Documents match nlohmann's parser for every chunk size") {
+        std::vector<std::string> documents = {
+            R"({"jsonrpc":"2.0","id":1,"result":{"hash":"0xabc","size":697,"tx":[],"confirmations":12}})",
+            R"([1, -2, 3.5, -0.25e-3, 1E10, 0, -0, 18446744073709551615, 18446744073709551616, -9223372036854775809])",
+            R"({"a": {"b": [true, false, null, {"c": []}, [[]]]}, "d": "", "e": {}})",
+            R"("escapes \" \\ \/ \b \f \n \r \t \u0041 \u00e9 \u20ac \ud83d\ude00")",
+            "  \n\t {\"dup\": 1, \"dup\": 2}  \r\n",
+            "42",
+            "\"plain \xc3\xa9 utf-8\"",
+            "[\"\xe2\x82\xac\xed\x9f\xbf\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf\", \"\xc2\x80\"]"
+        };
+        for (const auto& text : documents) {
+            auto expected = nlohmann::json::parse(text);
+            for (size_t chunk : {size_t(1), size_t(2), size_t(3), size_t(7), text.size()}) {
+                auto parsed = parseInChunks(text, chunk);
+                REQUIRE(parsed == expected);
+                REQUIRE(parsed.dump() == expected.dump());
+            }
+        }
+    }
+
+    SECTION("Integer types follow nlohmann") {
+        auto parsed = parseInChunks("[1, -1, 2.0]", 1);
+        REQUIRE(parsed[0].is_number_unsigned());
+        REQUIRE(parsed[1].is_number_integer());
+        REQUIRE(parsed[2].is_number_float());
+    }
+
+    SECTION("Invalid documents are rejected") {
+        for (const char* text : {"", "{", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "[1 2]", "01", "1.", "-", "1e",
+                                 "tru", "nul", "truex", "\"unterminated", "\"bad \\x escape\"", "\"\\ud83d\"",
+                                 "\"\\ude00\"", "[}", "{]", "{} {}", "{1:2}", "\"tab\there\""}) {
+            INFO(text);
+            REQUIRE(rejects(text));
+        }
+    }
+
+    SECTION("Invalid UTF-8 is rejected like nlohmann does") {
+        // Stray continuation, truncated sequence, overlong forms, a surrogate,
+        // a code point past U+10FFFF, and bytes that never occur in UTF-8
+        for (const char* text : {"\"\x80\"", "\"\xc3\"", "\"\xe2\x82\"", "\"\xc0\xaf\"", "\"\xe0\x80\xaf\"",
+                                 "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xf5\x80\x80\x80\"",
+                                 "\"\xff\"", "{\"\xc3\x28\": 1}", "\"\xc3\\n\""}) {
+            INFO(text);
+            REQUIRE_THROWS(nlohmann::json::parse(text));
+            REQUIRE(rejects(text));
+        }
+    }
+
+    SECTION("Errors stop further input") {
+        JsonStreamParser parser;
+        REQUIRE_FALSE(parser.feed("[1,,", 4));
+        REQUIRE(parser.hasError());
+        REQUIRE_FALSE(parser.feed("2]", 2));
+        REQUIRE_FALSE(parser.finish());
+    }
+
+    SECTION("Large documents") {
+        nlohmann::json block = {{"hash", "0x" + std::string(64, 'f')}, {"tx", nlohmann::json::array()}};
+        for (int i = 0; i < 2000; ++i) {
+            block["tx"].push_back({{"hash", "0x" + std::to_string(i)}, {"sysfee", "0.0997775"}, {"size", i}});
+        }
+        auto text = block.dump();
+        REQUIRE(parseInChunks(text, 16384) == block);
+    }
+}
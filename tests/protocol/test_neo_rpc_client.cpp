@@ -0,0 +1,361 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/response_types_impl.hpp"
+#include "neocpp/protocol/core/request.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <vector>
+#include <set>
+#include <atomic>
+#include <unistd.h>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+#ifdef HAVE_CURL
+
+namespace {
+
+/// Stand-in node answering a handful of JSON-RPC methods
+LocalHttpServer::Reply nodeReply(const LocalHttpServer::Request& request) {
+    auto json = nlohmann::json::parse(request.body);
+    auto answer = [](const nlohmann::json& call) {
+        nlohmann::json reply = {{"jsonrpc", "2.0"}, {"id", call["id"]}};
+        std::string method = call["method"];
+        if (method == "getblockcount") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            reply["result"] = 1234;
+        } else if (method == "getversion") {
+            reply["result"] = {{"tcpport", 10333}, {"useragent", "/Neo:3.6.0/"}};
+        } else if (method == "getblockhash") {
+            reply["result"] = "0x" + std::string(64, 'a');
+        } else if (method == "terminatesession") {
+            reply["result"] = true;
+        } else {
+            reply["error"] = {{"code", -32601}, {"message", "Method not found"}};
+        }
+        return reply;
+    };
+
+    nlohmann::json body;
+    if (json.is_array()) {
+        body = nlohmann::json::array();
+        for (const auto& call : json) {
+            body.push_back(answer(call));
+        }
+    } else {
+        body = answer(json);
+    }
+    LocalHttpServer::Reply reply;
+    reply.body = body.dump();
+    return reply;
+}
+
+} // namespace
+
+TEST_CASE("NeoRpcClient Tests", "[protocol][rpc]") {
+
+    LocalHttpServer server(nodeReply);
+    NeoRpcClient client(server.getUrl());
+
+    SECTION("Synchronous calls") {
+        REQUIRE(client.getBlockCount() == 1234);
+        REQUIRE(client.getVersion()->getTcpPort() == 10333);
+        REQUIRE(client.getBlockHash(1).toString() == std::string(64, 'a'));
+        REQUIRE(client.terminateSession("session"));
+        REQUIRE_THROWS_AS(client.sendRequest("nosuchmethod"), RpcException);
+    }
+
+    SECTION("Transfer statistics count request and response bytes") {
+        client.getVersion();
+        client.getBlockCountAsync().get();
+        auto stats = client.getTransferStats();
+        REQUIRE(stats.requestBytes > 0);
+        REQUIRE(stats.requestWireBytes == stats.requestBytes);
+        REQUIRE(stats.responseBytes > 0);
+    }
+
+    SECTION("Asynchronous calls match synchronous results") {
+        auto count = client.getBlockCountAsync();
+        auto version = client.getVersionAsync();
+        auto hash = client.getBlockHashAsync(1);
+
+        REQUIRE(count.get() == 1234);
+        REQUIRE(version.get()->getUserAgent() == "/Neo:3.6.0/");
+        REQUIRE(hash.get().toString() == std::string(64, 'a'));
+    }
+
+    SECTION("Fan-out overlaps network latency") {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<uint32_t>> futures;
+        for (int i = 0; i < 10; ++i) {
+            futures.push_back(client.getBlockCountAsync());
+        }
+        for (auto& future : futures) {
+            REQUIRE(future.get() == 1234);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10 * 100));
+    }
+
+    SECTION("RPC errors are delivered through the future") {
+        auto future = client.sendRequestAsync("nosuchmethod");
+        REQUIRE_THROWS_AS(future.get(), RpcException);
+    }
+
+    SECTION("Asynchronous batch") {
+        auto results = client.sendBatchAsync({{"getblockcount", nlohmann::json::array()},
+                                              {"getblockhash", nlohmann::json::array({1})}}).get();
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0]->getResult() == 1234);
+    }
+
+    SECTION("Batch entries fail individually") {
+        auto results = client.sendBatch({{"getblockhash", nlohmann::json::array({1})},
+                                         {"nosuchmethod", nlohmann::json::array()},
+                                         {"terminatesession", nlohmann::json::array({"s"})}});
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0]->isSuccess());
+        REQUIRE(results[1]->hasError());
+        REQUIRE(results[1]->getError()->code == -32601);
+        REQUIRE(results[2]->getResult() == true);
+    }
+}
+
+TEST_CASE("NeoRpcClient over a Unix domain socket", "[protocol][rpc][unix]") {
+
+    LocalHttpServer server(nodeReply, "/tmp/neocpp-rpc-" + std::to_string(::getpid()) + ".sock");
+    NeoRpcClient client(server.getUrl());
+
+    REQUIRE(client.getVersion()->getTcpPort() == 10333);
+    REQUIRE(client.getBlockCountAsync().get() == 1234);
+    REQUIRE(server.getRequestCount() == 2);
+}
+
+TEST_CASE("NeoRpcClient batch replies", "[protocol][rpc][batch]") {
+
+    // Answers every batch in reverse order and drops the request with id divisible by 7
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        auto calls = nlohmann::json::parse(request.body);
+        nlohmann::json body = nlohmann::json::array();
+        for (auto it = calls.rbegin(); it != calls.rend(); ++it) {
+            if ((*it)["id"].get<int>() % 7 != 0) {
+                body.push_back({{"jsonrpc", "2.0"}, {"id", (*it)["id"]}, {"result", (*it)["params"][0]}});
+            }
+        }
+        LocalHttpServer::Reply reply;
+        reply.body = body.dump();
+        return reply;
+    });
+    NeoRpcClient client(server.getUrl());
+
+    std::vector<std::pair<std::string, nlohmann::json>> requests;
+    for (int i = 0; i < 1000; ++i) {
+        requests.push_back({"echo", nlohmann::json::array({i})});
+    }
+
+    SECTION("Reordered replies are matched by id") {
+        auto results = client.sendBatch(requests);
+        REQUIRE(results.size() == requests.size());
+        int missing = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i]->hasError()) {
+                REQUIRE(results[i]->getId() % 7 == 0);
+                missing++;
+            } else {
+                REQUIRE(results[i]->getResult() == static_cast<int>(i));
+            }
+        }
+        REQUIRE(missing > 0);
+    }
+
+    SECTION("Oversized batches are split into chunks") {
+        client.setBatchChunkSize(100);
+        auto results = client.sendBatchAsync(requests).get();
+        REQUIRE(results.size() == requests.size());
+        REQUIRE(server.getRequestCount() == 10);
+        REQUIRE_THROWS_AS(client.setBatchChunkSize(0), IllegalArgumentException);
+    }
+
+    SECTION("Transport failures become per-entry errors") {
+        server.stop();
+        auto results = client.sendBatch({{"echo", nlohmann::json::array({1})}, {"echo", nlohmann::json::array({2})}});
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0]->hasError());
+        REQUIRE(results[1]->hasError());
+    }
+}
+
+TEST_CASE("NeoRpcClient malformed batch replies", "[protocol][rpc][batch]") {
+
+    // Answers id 2 with an error whose code is not an integer; a single-request batch
+    // gets an error object in place of the array, with a malformed code as well
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        auto calls = nlohmann::json::parse(request.body);
+        LocalHttpServer::Reply reply;
+        if (calls.size() == 1) {
+            reply.body = R"({"jsonrpc":"2.0","id":null,"error":{"code":"busy","message":"try later"}})";
+            return reply;
+        }
+        nlohmann::json body = nlohmann::json::array();
+        for (const auto& call : calls) {
+            if (call["id"].get<int>() == 2) {
+                body.push_back({{"jsonrpc", "2.0"}, {"id", 2}, {"error", {{"code", "oops"}, {"message", 5}}}});
+            } else {
+                body.push_back({{"jsonrpc", "2.0"}, {"id", call["id"]}, {"result", call["params"][0]}});
+            }
+        }
+        reply.body = body.dump();
+        return reply;
+    });
+    NeoRpcClient client(server.getUrl());
+
+    SECTION("A malformed entry fails on its own") {
+        auto results = client.sendBatchAsync({{"echo", nlohmann::json::array({1})},
+                                              {"echo", nlohmann::json::array({2})},
+                                              {"echo", nlohmann::json::array({3})}});
+        REQUIRE(results.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        auto responses = results.get();
+        REQUIRE(responses.size() == 3);
+        REQUIRE(responses[0]->getResult() == 1);
+        REQUIRE(responses[1]->hasError());
+        REQUIRE(responses[1]->getError()->code == -32603);
+        REQUIRE(responses[2]->getResult() == 3);
+    }
+
+    SECTION("A malformed batch-level error fails every entry") {
+        auto results = client.sendBatchAsync({{"echo", nlohmann::json::array({1})}});
+        REQUIRE(results.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        auto responses = results.get();
+        REQUIRE(responses.size() == 1);
+        REQUIRE(responses[0]->hasError());
+    }
+}
+
+TEST_CASE("NeoRpcClient shared across threads", "[protocol][rpc][concurrency]") {
+
+    std::mutex idsMutex;
+    std::set<int> seenIds;
+    int duplicateIds = 0;
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        auto call = nlohmann::json::parse(request.body);
+        {
+            std::lock_guard<std::mutex> lock(idsMutex);
+            if (!seenIds.insert(call["id"].get<int>()).second) {
+                duplicateIds++;
+            }
+        }
+        LocalHttpServer::Reply reply;
+        reply.body = LocalHttpServer::rpcResult(call["params"][0].dump(), call["id"].dump());
+        return reply;
+    });
+    auto client = std::make_shared<NeoRpcClient>(server.getUrl());
+
+    const int threadCount = 16;
+    const int callsPerThread = 50;
+    std::atomic<int> wrongResults{0};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < callsPerThread; ++i) {
+                int expected = t * callsPerThread + i;
+                try {
+                    auto params = nlohmann::json::array({expected});
+                    auto result = (i % 2 == 0)
+                        ? client->sendRequest("echo", params)
+                        : client->sendRequestAsync("echo", params).get();
+                    if (result.get<int>() != expected) {
+                        wrongResults++;
+                    }
+                } catch (...) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(failures == 0);
+    REQUIRE(wrongResults == 0);
+    REQUIRE(duplicateIds == 0);
+    REQUIRE(seenIds.size() == static_cast<size_t>(threadCount * callsPerThread));
+}
+
+TEST_CASE("NeoRpcClient deduplicates identical in-flight reads", "[protocol][rpc][singleflight]") {
+
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        auto call = nlohmann::json::parse(request.body);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        nlohmann::json result = call["params"].empty() ? nlohmann::json(1234) : call["params"][0];
+        LocalHttpServer::Reply reply;
+        reply.body = LocalHttpServer::rpcResult(result.dump(), call["id"].dump());
+        return reply;
+    });
+    NeoRpcClient client(server.getUrl());
+
+    SECTION("Concurrent identical reads share one request") {
+        std::vector<std::future<uint32_t>> futures;
+        for (int i = 0; i < 10; ++i) {
+            futures.push_back(client.getBlockCountAsync());
+        }
+        uint32_t syncResult = 0;
+        std::thread syncCaller([&]() { syncResult = client.getBlockCount(); });
+        for (auto& future : futures) {
+            REQUIRE(future.get() == 1234);
+        }
+        syncCaller.join();
+        REQUIRE(syncResult == 1234);
+        REQUIRE(server.getRequestCount() == 1);
+        REQUIRE(client.getSingleFlight()->getSharedCount() == 10);
+        REQUIRE(client.getSingleFlight()->getInFlight() == 0);
+    }
+
+    SECTION("Different parameters are not shared") {
+        auto first = client.sendRequestAsync("getblockhash", nlohmann::json::array({1}));
+        auto second = client.sendRequestAsync("getblockhash", nlohmann::json::array({2}));
+        REQUIRE(first.get() == 1);
+        REQUIRE(second.get() == 2);
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("Writes are never shared") {
+        auto first = client.sendRequestAsync("sendrawtransaction", nlohmann::json::array({"tx"}));
+        auto second = client.sendRequestAsync("sendrawtransaction", nlohmann::json::array({"tx"}));
+        first.get();
+        second.get();
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("Deduplication can be turned off") {
+        client.setDeduplication(false);
+        auto first = client.getBlockCountAsync();
+        auto second = client.getBlockCountAsync();
+        first.get();
+        second.get();
+        REQUIRE(server.getRequestCount() == 2);
+    }
+}
+
+TEST_CASE("Request IDs are unique across threads", "[protocol][rpc][concurrency]") {
+    std::mutex idsMutex;
+    std::set<int> ids;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                Request request("getblockcount");
+                std::lock_guard<std::mutex> lock(idsMutex);
+                ids.insert(request.getId());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(ids.size() == 8000);
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/rpc_batcher.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+namespace {
+
+nlohmann::json echoCall(const nlohmann::json& call) {
+    return nlohmann::json{{"jsonrpc", "2.0"}, {"id", call["id"]}, {"result", call["params"][0]}};
+}
+
+/// Sender answering every request in reverse order, as a node is allowed to
+void reversedSender(const nlohmann::json& payload, RpcBatcher::ReplyHandler onReply) {
+    if (!payload.is_array()) {
+        onReply(echoCall(payload), nullptr);
+        return;
+    }
+    nlohmann::json reply = nlohmann::json::array();
+    for (auto it = payload.rbegin(); it != payload.rend(); ++it) {
+        reply.push_back(echoCall(*it));
+    }
+    onReply(reply, nullptr);
+}
+
+nlohmann::json echoRequest(int id, int value) {
+    return nlohmann::json{{"jsonrpc", "2.0"}, {"method", "echo"}, {"params", {value}}, {"id", id}};
+}
+
+} // namespace
+
+TEST_CASE("RpcBatcher Tests", "[protocol][batching]") {
+
+    RpcBatchingConfig config;
+    config.window = std::chrono::milliseconds(20);
+
+    SECTION("Replies are routed by id") {
+        RpcBatcher batcher(reversedSender, config);
+        std::vector<std::future<nlohmann::json>> futures;
+        for (int i = 0; i < 10; ++i) {
+            futures.push_back(batcher.submit(echoRequest(i, i * 100)));
+        }
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(futures[i].get()["result"] == i * 100);
+        }
+        REQUIRE(batcher.getBatchCount() == 1);
+        REQUIRE(batcher.getBatchSizeHistogram().getMax() == 10);
+        REQUIRE(batcher.getWindowWaitHistogram().getCount() == 10);
+    }
+
+    SECTION("Full batches are sent without waiting for the window") {
+        config.window = std::chrono::seconds(10);
+        config.maxBatchSize = 4;
+        RpcBatcher batcher(reversedSender, config);
+        std::vector<std::future<nlohmann::json>> futures;
+        for (int i = 0; i < 8; ++i) {
+            futures.push_back(batcher.submit(echoRequest(i, i)));
+        }
+        for (auto& future : futures) {
+            REQUIRE(future.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+        }
+        REQUIRE(batcher.getBatchCount() == 2);
+    }
+
+    SECTION("Missing replies fail only their own request") {
+        RpcBatcher batcher([](const nlohmann::json& payload, RpcBatcher::ReplyHandler onReply) {
+            onReply(nlohmann::json::array({echoCall(payload[0])}), nullptr);
+        }, config);
+        auto first = batcher.submit(echoRequest(1, 1));
+        auto second = batcher.submit(echoRequest(2, 2));
+        REQUIRE(first.get()["result"] == 1);
+        REQUIRE_THROWS_AS(second.get(), RpcException);
+    }
+
+    SECTION("Transport errors reach every caller") {
+        RpcBatcher batcher([](const nlohmann::json&, RpcBatcher::ReplyHandler onReply) {
+            throw RpcException("connection refused");
+        }, config);
+        auto first = batcher.submit(echoRequest(1, 1));
+        auto second = batcher.submit(echoRequest(2, 2));
+        REQUIRE_THROWS_AS(first.get(), RpcException);
+        REQUIRE_THROWS_AS(second.get(), RpcException);
+    }
+
+    SECTION("Malformed batch-level errors reach every caller") {
+        std::vector<std::thread> replies;
+        // Answer from another thread that swallows errors, as the event loop does
+        RpcBatcher batcher([&replies](const nlohmann::json&, RpcBatcher::ReplyHandler onReply) {
+            replies.emplace_back([onReply]() {
+                try {
+                    onReply(nlohmann::json{{"jsonrpc", "2.0"}, {"id", nullptr},
+                                           {"error", {{"code", -32600}, {"message", 42}}}}, nullptr);
+                } catch (...) {
+                }
+            });
+        }, config);
+        auto first = batcher.submit(echoRequest(1, 1));
+        auto second = batcher.submit(echoRequest(2, 2));
+        REQUIRE(first.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+        REQUIRE(second.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+        REQUIRE_THROWS_AS(first.get(), RpcException);
+        REQUIRE_THROWS_AS(second.get(), RpcException);
+        for (auto& thread : replies) {
+            thread.join();
+        }
+    }
+
+    SECTION("Requests need an id") {
+        RpcBatcher batcher(reversedSender, config);
+        REQUIRE_THROWS_AS(batcher.submit(nlohmann::json{{"method", "echo"}}), IllegalArgumentException);
+    }
+}
+
+#ifdef HAVE_CURL
+
+TEST_CASE("NeoRpcClient batching", "[protocol][rpc][batching]") {
+
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        auto json = nlohmann::json::parse(request.body);
+        nlohmann::json body;
+        if (json.is_array()) {
+            body = nlohmann::json::array();
+            for (const auto& call : json) {
+                body.push_back(echoCall(call));
+            }
+        } else {
+            body = echoCall(json);
+        }
+        LocalHttpServer::Reply reply;
+        reply.body = body.dump();
+        return reply;
+    });
+    NeoRpcClient client(server.getUrl());
+    RpcBatchingConfig config;
+    config.window = std::chrono::milliseconds(20);
+    client.enableBatching(config);
+
+    SECTION("Concurrent calls share one HTTP request") {
+        std::vector<std::future<nlohmann::json>> futures;
+        for (int i = 0; i < 20; ++i) {
+            futures.push_back(client.sendRequestAsync("echo", nlohmann::json::array({i})));
+        }
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE(futures[i].get() == i);
+        }
+        REQUIRE(server.getRequestCount() == 1);
+        REQUIRE(client.getBatcher()->getBatchSizeHistogram().getMax() == 20);
+    }
+
+    SECTION("Synchronous callers on many threads are coalesced") {
+        std::atomic<int> wrongResults{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&, t]() {
+                if (client.sendRequest("echo", nlohmann::json::array({t})) != t) {
+                    wrongResults++;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(wrongResults == 0);
+        REQUIRE(server.getRequestCount() < 8);
+    }
+
+    SECTION("Disabling batching sends calls individually") {
+        client.disableBatching();
+        REQUIRE(client.getBatcher() == nullptr);
+        REQUIRE(client.sendRequest("echo", nlohmann::json::array({5})) == 5);
+        REQUIRE(server.getRequestCount() == 1);
+    }
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/rpc_endpoint_set.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <atomic>
+#include <future>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+#ifdef HAVE_CURL
+
+namespace {
+
+/// Node answering getblockcount with a fixed height and echoing everything else
+LocalHttpServer::Handler node(uint32_t height, std::chrono::milliseconds delay = std::chrono::milliseconds(0)) {
+    return [height, delay](const LocalHttpServer::Request& request) {
+        std::this_thread::sleep_for(delay);
+        auto call = nlohmann::json::parse(request.body);
+        nlohmann::json result = call["method"] == "getblockcount" ? nlohmann::json(height) : call["method"];
+        LocalHttpServer::Reply reply;
+        reply.body = LocalHttpServer::rpcResult(result.dump(), call["id"].dump());
+        return reply;
+    };
+}
+
+RpcEndpointConfig withoutProbes() {
+    RpcEndpointConfig config;
+    config.probeInterval = std::chrono::milliseconds(0);
+    return config;
+}
+
+} // namespace
+
+TEST_CASE("RpcEndpointSet Tests", "[protocol][endpoints]") {
+
+    SECTION("Calls prefer the faster node") {
+        LocalHttpServer slow(node(100, std::chrono::milliseconds(30)));
+        LocalHttpServer fast(node(100));
+        NeoRpcClient client({slow.getUrl(), fast.getUrl()}, withoutProbes());
+        client.getEndpoints()->probe().wait();
+        for (int i = 0; i < 20; ++i) {
+            client.sendRequest("getversion");
+        }
+        REQUIRE(fast.getRequestCount() > slow.getRequestCount());
+        auto stats = client.getEndpoints()->getStats();
+        REQUIRE(stats[0].latencyMs > stats[1].latencyMs);
+    }
+
+    SECTION("Calls fail over from a dead node") {
+        LocalHttpServer dead(node(100));
+        LocalHttpServer alive(node(100));
+        dead.stop();
+        NeoRpcClient client({dead.getUrl(), alive.getUrl()}, withoutProbes());
+        REQUIRE(client.sendRequest("getversion") == "getversion");
+        REQUIRE(client.sendRequestAsync("getpeers").get() == "getpeers");
+
+        auto stats = client.getEndpoints()->getStats();
+        REQUIRE(stats[0].errorRate > 0.0);
+        REQUIRE(stats[1].errorRate == 0.0);
+    }
+
+    SECTION("Lagging nodes are skipped") {
+        LocalHttpServer behind(node(90));
+        LocalHttpServer current(node(100));
+        NeoRpcClient client({behind.getUrl(), current.getUrl()}, withoutProbes());
+        client.getEndpoints()->probe().wait();
+        size_t probes = behind.getRequestCount();
+        for (int i = 0; i < 10; ++i) {
+            client.sendRequest("getversion");
+        }
+        REQUIRE(behind.getRequestCount() == probes);
+        REQUIRE(client.getEndpoints()->getStats()[0].blockCount == 90);
+    }
+
+    SECTION("Background probes run") {
+        LocalHttpServer server(node(100));
+        RpcEndpointConfig config;
+        config.probeInterval = std::chrono::milliseconds(10);
+        NeoRpcClient client({server.getUrl()}, config);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        REQUIRE(server.getRequestCount() >= 2);
+        REQUIRE(client.getEndpoints()->getStats()[0].blockCount == 100);
+    }
+
+    SECTION("The last reference may drop on the event loop thread") {
+        LocalHttpServer server(node(100, std::chrono::milliseconds(20)));
+        RpcEndpointConfig config;
+        config.probeInterval = std::chrono::milliseconds(1);
+        auto set = std::make_shared<RpcEndpointSet>(std::vector<std::string>{server.getUrl()}, config);
+        std::weak_ptr<RpcEndpointSet> weak = set;
+        auto body = nlohmann::json{{"jsonrpc", "2.0"}, {"method", "getversion"}, {"params", nlohmann::json::array()}, {"id", 1}}.dump();
+        set->postAsync(body, [](const HttpResponse&) {});
+        set->probe();
+        // The pending request and the background prober are now the only users
+        set.reset();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!weak.expired() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(weak.expired());
+        // The event loop survived destroying the set from a completion handler
+        REQUIRE(HttpService(server.getUrl()).postJson(body).isSuccess());
+    }
+
+    SECTION("Writes can be broadcast to every node") {
+        LocalHttpServer first(node(100));
+        LocalHttpServer second(node(100));
+        NeoRpcClient client({first.getUrl(), second.getUrl()}, withoutProbes());
+        client.setBroadcastWrites(true);
+        REQUIRE(client.sendRequest("sendrawtransaction", nlohmann::json::array({"tx"})) == "sendrawtransaction");
+        REQUIRE(client.sendRequestAsync("sendrawtransaction", nlohmann::json::array({"tx"})).get() == "sendrawtransaction");
+
+        // The second reply may still be in flight after the first one completed the call
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (first.getRequestCount() + second.getRequestCount() < 4 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(first.getRequestCount() == 2);
+        REQUIRE(second.getRequestCount() == 2);
+    }
+
+    SECTION("At least one endpoint is required") {
+        REQUIRE_THROWS_AS(RpcEndpointSet(std::vector<std::string>{}), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("Hedged requests", "[protocol][endpoints][hedging]") {
+
+    LocalHttpServer slow(node(100, std::chrono::milliseconds(500)));
+    LocalHttpServer fast(node(100));
+    NeoRpcClient client({slow.getUrl(), fast.getUrl()}, withoutProbes());
+    RpcHedgingConfig config;
+    config.initialDelay = std::chrono::milliseconds(20);
+    client.getEndpoints()->enableHedging(config);
+
+    SECTION("A slow primary is overtaken by the hedge") {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(client.sendRequestAsync("getversion").get() == "getversion");
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(400));
+
+        auto stats = client.getEndpoints()->getHedgeStats();
+        REQUIRE(stats.requests == 1);
+        REQUIRE(stats.fired == 1);
+        REQUIRE(stats.won == 1);
+        REQUIRE(stats.winRatio() == 1.0);
+    }
+
+    SECTION("Fast answers need no hedge") {
+        client.sendRequest("getversion");
+        client.sendRequest("getversion");
+        auto stats = client.getEndpoints()->getHedgeStats();
+        REQUIRE(stats.requests == 2);
+        REQUIRE(stats.fired == 1);
+    }
+
+    SECTION("Writes are never hedged") {
+        client.sendRequest("sendrawtransaction", nlohmann::json::array({"tx"}));
+        REQUIRE(client.getEndpoints()->getHedgeStats().requests == 0);
+    }
+
+    SECTION("The hedge delay follows observed latencies") {
+        REQUIRE(client.getEndpoints()->getHedgeDelay() == std::chrono::milliseconds(20));
+        REQUIRE_THROWS_AS(client.getEndpoints()->enableHedging(RpcHedgingConfig{0.0}), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("The hedge delay forgets old latencies", "[protocol][endpoints][hedging]") {
+    LocalHttpServer server(node(100, std::chrono::milliseconds(20)));
+    RpcEndpointSet set({server.getUrl()}, withoutProbes());
+    RpcHedgingConfig config;
+    config.initialDelay = std::chrono::milliseconds(1);
+    config.minSamples = 3;
+    config.window = std::chrono::milliseconds(100);
+    set.enableHedging(config);
+
+    auto body = nlohmann::json{{"jsonrpc", "2.0"}, {"method", "getversion"}, {"params", nlohmann::json::array()}, {"id", 1}}.dump();
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(set.post(body).isSuccess());
+    }
+    REQUIRE(set.getHedgeDelay() >= std::chrono::milliseconds(20));
+
+    // Two windows later the slow samples no longer count, but remain in the totals
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    REQUIRE(set.getHedgeDelay() == std::chrono::milliseconds(1));
+    REQUIRE(set.getLatencyHistogram().getCount() == 3);
+
+    config.window = std::chrono::milliseconds(0);
+    REQUIRE_THROWS_AS(set.enableHedging(config), IllegalArgumentException);
+}
+
+#endif
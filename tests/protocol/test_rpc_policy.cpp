@@ -0,0 +1,268 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/rpc_policy.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <atomic>
+#include <thread>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+TEST_CASE("CircuitBreaker Tests", "[protocol][policy]") {
+
+    CircuitBreakerConfig config;
+    config.failureThreshold = 2;
+    config.openDuration = std::chrono::milliseconds(20);
+    CircuitBreaker breaker(config);
+
+    SECTION("Consecutive failures open the circuit") {
+        REQUIRE(breaker.allowRequest());
+        breaker.recordFailure();
+        breaker.recordSuccess();
+        breaker.recordFailure();
+        REQUIRE(breaker.getState() == CircuitBreaker::State::Closed);
+        breaker.recordFailure();
+        REQUIRE(breaker.getState() == CircuitBreaker::State::Open);
+        REQUIRE_FALSE(breaker.allowRequest());
+        REQUIRE(breaker.getRejectedCount() == 1);
+    }
+
+    SECTION("A single trial request is let through after the open duration") {
+        breaker.recordFailure();
+        breaker.recordFailure();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        REQUIRE(breaker.getState() == CircuitBreaker::State::HalfOpen);
+        REQUIRE(breaker.allowRequest());
+        REQUIRE_FALSE(breaker.allowRequest());
+
+        breaker.recordFailure();
+        REQUIRE(breaker.getState() == CircuitBreaker::State::Open);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        REQUIRE(breaker.allowRequest());
+        breaker.recordSuccess();
+        REQUIRE(breaker.getState() == CircuitBreaker::State::Closed);
+    }
+
+    SECTION("Threshold must be positive") {
+        REQUIRE_THROWS_AS(CircuitBreaker(CircuitBreakerConfig{0}), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("AimdLimiter Tests", "[protocol][policy]") {
+
+    AimdLimiterConfig config;
+    config.initialLimit = 2;
+    config.latencyTarget = std::chrono::milliseconds(50);
+    AimdLimiter limiter(config);
+    int started = 0;
+    auto start = [&started]() { started++; };
+
+    SECTION("Requests over the limit wait for a slot") {
+        limiter.acquire(start);
+        limiter.acquire(start);
+        limiter.acquire(start);
+        REQUIRE(started == 2);
+        REQUIRE(limiter.getQueued() == 1);
+
+        limiter.release(std::chrono::milliseconds(1), false);
+        REQUIRE(started == 3);
+        REQUIRE(limiter.getInFlight() == 2);
+    }
+
+    SECTION("Fast replies grow the limit") {
+        for (int i = 0; i < 20; ++i) {
+            limiter.acquire(start);
+            limiter.acquire(start);
+            limiter.release(std::chrono::milliseconds(1), false);
+            limiter.release(std::chrono::milliseconds(1), false);
+        }
+        REQUIRE(limiter.getLimit() > 2);
+    }
+
+    SECTION("Slow or dropped replies shrink the limit") {
+        AimdLimiterConfig wide = config;
+        wide.initialLimit = 100;
+        AimdLimiter shrinking(wide);
+        shrinking.acquire(start);
+        shrinking.release(std::chrono::milliseconds(200), false);
+        REQUIRE(shrinking.getLimit() == 90);
+        // Within one round trip of the last decrease the limit is left alone
+        shrinking.acquire(start);
+        shrinking.release(std::chrono::milliseconds(0), true);
+        REQUIRE(shrinking.getLimit() == 90);
+
+        AimdLimiter dropping(wide);
+        dropping.acquire(start);
+        dropping.release(std::chrono::milliseconds(0), true);
+        REQUIRE(dropping.getLimit() == 90);
+    }
+
+    SECTION("The fastest latency is forgotten after two windows") {
+        AimdLimiterConfig relative;
+        relative.initialLimit = 100;
+        relative.minLatencyWindow = std::chrono::milliseconds(50);
+        AimdLimiter adaptive(relative);
+        adaptive.acquire(start);
+        adaptive.release(std::chrono::milliseconds(1), false);
+        adaptive.acquire(start);
+        adaptive.release(std::chrono::milliseconds(20), false);
+        REQUIRE(adaptive.getLimit() == 90);
+
+        // The node got slower for good; its new latency becomes the baseline
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        for (int i = 0; i < 5; ++i) {
+            adaptive.acquire(start);
+            adaptive.release(std::chrono::milliseconds(20 + i), false);
+        }
+        REQUIRE(adaptive.getLimit() == 90);
+
+        relative.minLatencyWindow = std::chrono::milliseconds(0);
+        REQUIRE_THROWS_AS(AimdLimiter(relative), IllegalArgumentException);
+    }
+
+    SECTION("Fast failures shrink the limit once per round trip") {
+        AimdLimiterConfig relative;
+        relative.initialLimit = 100;
+        AimdLimiter failing(relative);
+        failing.acquire(start);
+        failing.release(std::chrono::milliseconds(50), false);
+        for (int i = 0; i < 10; ++i) {
+            failing.acquire(start);
+            failing.release(std::chrono::milliseconds(0), true);
+        }
+        REQUIRE(failing.getLimit() == 90);
+    }
+
+    SECTION("Releasing without a measurement keeps the limit") {
+        limiter.acquire(start);
+        limiter.release();
+        REQUIRE(limiter.getInFlight() == 0);
+        REQUIRE(limiter.getLimit() == 2);
+    }
+
+    SECTION("Queued requests that fail synchronously do not nest") {
+        AimdLimiterConfig single;
+        single.initialLimit = 1;
+        AimdLimiter serial(single);
+        serial.acquire(start);
+        static constexpr int queued = 200000;
+        for (int i = 0; i < queued; ++i) {
+            serial.acquire([&serial, &started]() {
+                started++;
+                serial.release();
+            });
+        }
+        REQUIRE(serial.getQueued() == queued);
+        serial.release();
+        REQUIRE(started == queued + 1);
+        REQUIRE(serial.getQueued() == 0);
+        REQUIRE(serial.getInFlight() == 0);
+    }
+}
+
+TEST_CASE("RpcPolicy Tests", "[protocol][policy]") {
+
+    RpcPolicyConfig config;
+    config.retry.initialBackoff = std::chrono::milliseconds(1);
+    config.retry.maxBackoff = std::chrono::milliseconds(5);
+
+    SECTION("Backoff grows exponentially up to the cap") {
+        RpcRetryConfig retry;
+        retry.initialBackoff = std::chrono::milliseconds(100);
+        retry.maxBackoff = std::chrono::milliseconds(1000);
+        for (int i = 0; i < 20; ++i) {
+            auto first = RpcPolicy::backoff(retry, 0);
+            REQUIRE(first >= std::chrono::milliseconds(50));
+            REQUIRE(first <= std::chrono::milliseconds(100));
+            auto third = RpcPolicy::backoff(retry, 2);
+            REQUIRE(third >= std::chrono::milliseconds(200));
+            REQUIRE(third <= std::chrono::milliseconds(400));
+            REQUIRE(RpcPolicy::backoff(retry, 30) <= std::chrono::milliseconds(1000));
+        }
+    }
+
+#ifdef HAVE_CURL
+    std::atomic<int> failuresLeft{2};
+    LocalHttpServer server([&failuresLeft](const LocalHttpServer::Request&) {
+        LocalHttpServer::Reply reply;
+        if (failuresLeft-- > 0) {
+            reply.status = 503;
+            return reply;
+        }
+        reply.body = LocalHttpServer::rpcResult("42");
+        return reply;
+    });
+    NeoRpcClient client(server.getUrl());
+
+    SECTION("Transient failures are retried") {
+        auto policy = std::make_shared<RpcPolicy>(config);
+        client.setPolicy(policy);
+        REQUIRE(client.getBlockCount() == 42);
+        REQUIRE(server.getRequestCount() == 3);
+        REQUIRE(policy->getRetryCount() == 2);
+        REQUIRE(policy->getLimiter()->getInFlight() == 0);
+    }
+
+    SECTION("Asynchronous calls and batches are retried") {
+        client.setPolicy(std::make_shared<RpcPolicy>(config));
+        client.enableBatching();
+        REQUIRE(client.sendRequestAsync("getblockcount").get() == 42);
+        REQUIRE(server.getRequestCount() == 3);
+    }
+
+    SECTION("Writes are not retried") {
+        client.setPolicy(std::make_shared<RpcPolicy>(config));
+        REQUIRE_THROWS_AS(client.sendRequest("sendrawtransaction", nlohmann::json::array({"tx"})), RpcException);
+        REQUIRE(server.getRequestCount() == 1);
+    }
+
+    SECTION("An open circuit fails fast") {
+        config.retry.maxAttempts = 1;
+        config.circuitBreaker.failureThreshold = 2;
+        auto policy = std::make_shared<RpcPolicy>(config);
+        client.setPolicy(policy);
+        REQUIRE_THROWS_AS(client.getBlockCount(), RpcException);
+        REQUIRE_THROWS_AS(client.getBlockCount(), RpcException);
+        REQUIRE(policy->getCircuitBreaker(server.getUrl())->getState() == CircuitBreaker::State::Open);
+        size_t limit = policy->getLimiter()->getLimit();
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE_THROWS_AS(client.getBlockCount(), RpcException);
+        }
+        REQUIRE(server.getRequestCount() == 2);
+        // Rejections by the open circuit are not overload
+        REQUIRE(policy->getLimiter()->getLimit() == limit);
+        REQUIRE(policy->getLimiter()->getInFlight() == 0);
+
+        client.setPolicy(nullptr);
+        REQUIRE(client.getHttpService()->getCircuitBreaker() == nullptr);
+        REQUIRE(client.getBlockCount() == 42);
+    }
+#endif
+}
+
+#ifdef HAVE_CURL
+TEST_CASE("BlockPolling reports errors", "[protocol][policy]") {
+    LocalHttpServer server([](const LocalHttpServer::Request&) {
+        return LocalHttpServer::Reply{};
+    });
+    server.stop();
+    auto client = std::make_shared<NeoRpcClient>(server.getUrl());
+    BlockPolling polling(client, std::chrono::milliseconds(5));
+    polling.setMaxBackoff(std::chrono::milliseconds(20));
+    std::atomic<int> errors{0};
+    polling.setErrorHandler([&errors](const std::exception&) { errors++; });
+
+    polling.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto stopping = std::chrono::steady_clock::now();
+    polling.stop();
+
+    REQUIRE(std::chrono::steady_clock::now() - stopping < std::chrono::milliseconds(50));
+    REQUIRE(errors >= 2);
+    REQUIRE(polling.getConsecutiveErrors() == static_cast<uint32_t>(errors));
+}
+#endif
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/rpc_response_cache.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "../mock/local_http_server.hpp"
+#include <chrono>
+#include <atomic>
+
+using namespace neocpp;
+using namespace neocpp::test;
+
+TEST_CASE("LruResponseCache Tests", "[protocol][cache]") {
+
+    using Lifetime = RpcResponseCache::Lifetime;
+    LruResponseCache cache;
+    nlohmann::json result;
+
+    SECTION("Hits and misses") {
+        REQUIRE_FALSE(cache.get("a", result));
+        cache.put("a", 42, Lifetime::Immutable, cache.getGeneration());
+        REQUIRE(cache.get("a", result));
+        REQUIRE(result == 42);
+
+        auto stats = cache.getStats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hitRatio() == 0.5);
+        REQUIRE(stats.entries == 1);
+        REQUIRE(stats.bytes > 0);
+    }
+
+    SECTION("New blocks drop only height-dependent results") {
+        cache.put("hash", "0xabc", Lifetime::Immutable, cache.getGeneration());
+        cache.put("count", 100, Lifetime::UntilNextBlock, cache.getGeneration());
+        cache.onNewBlock(100);
+        REQUIRE(cache.get("hash", result));
+        REQUIRE_FALSE(cache.get("count", result));
+    }
+
+    SECTION("Results fetched before a new block are not stored") {
+        auto generation = cache.getGeneration();
+        cache.onNewBlock(100);
+        cache.put("count", 100, Lifetime::UntilNextBlock, generation);
+        cache.put("hash", "0xabc", Lifetime::Immutable, generation);
+        REQUIRE_FALSE(cache.get("count", result));
+        REQUIRE(cache.get("hash", result));
+    }
+
+    SECTION("Height-dependent results expire") {
+        LruResponseCache shortLived(LruResponseCache::DEFAULT_MAX_BYTES, std::chrono::milliseconds(20));
+        shortLived.put("count", 100, Lifetime::UntilNextBlock, shortLived.getGeneration());
+        REQUIRE(shortLived.get("count", result));
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        REQUIRE_FALSE(shortLived.get("count", result));
+    }
+
+    SECTION("Least recently used results are evicted beyond the budget") {
+        std::string value(100, 'x');
+        cache.setMaxBytes(350);
+        cache.put("a", value, Lifetime::Immutable, 0);
+        cache.put("b", value, Lifetime::Immutable, 0);
+        cache.put("c", value, Lifetime::Immutable, 0);
+        REQUIRE(cache.get("a", result));
+        cache.put("d", value, Lifetime::Immutable, 0);
+
+        REQUIRE(cache.get("a", result));
+        REQUIRE_FALSE(cache.get("b", result));
+        REQUIRE(cache.getStats().evictions == 1);
+        REQUIRE(cache.getStats().bytes <= 350);
+    }
+}
+
+#ifdef HAVE_CURL
+
+TEST_CASE("NeoRpcClient response cache", "[protocol][rpc][cache]") {
+
+    std::atomic<int> height{100};
+    LocalHttpServer server([&height](const LocalHttpServer::Request& request) {
+        auto call = nlohmann::json::parse(request.body);
+        std::string method = call["method"];
+        nlohmann::json result;
+        if (method == "getblockcount") {
+            result = height.load();
+        } else if (method == "getblockhash") {
+            result = "0x" + std::string(64, 'b');
+        } else if (method == "getrawtransaction" && !call["params"][1].get<bool>()) {
+            result = "AAEC";
+        } else if (method == "getrawtransaction" && call["params"][0] == "0x02" && height < 101) {
+            // Still in the mempool
+            result = {{"hash", "0x" + std::string(64, 'd')}};
+        } else if (method == "getrawtransaction") {
+            result = {{"hash", "0x" + std::string(64, 'c')}, {"blockhash", "0x" + std::string(64, 'b')},
+                      {"confirmations", height.load()}};
+        } else {
+            result = method;
+        }
+        LocalHttpServer::Reply reply;
+        reply.body = LocalHttpServer::rpcResult(result.dump(), call["id"].dump());
+        return reply;
+    });
+    auto client = std::make_shared<NeoRpcClient>(server.getUrl());
+    auto cache = std::make_shared<LruResponseCache>(LruResponseCache::DEFAULT_MAX_BYTES, std::chrono::seconds(60));
+    client->setResponseCache(cache);
+
+    SECTION("Immutable results are fetched once") {
+        auto first = client->getBlockHash(5);
+        auto second = client->getBlockHashAsync(5).get();
+        REQUIRE(first == second);
+        REQUIRE(server.getRequestCount() == 1);
+        REQUIRE(cache->getStats().hitRatio() == 0.5);
+    }
+
+    SECTION("Height-dependent results last until the next block") {
+        REQUIRE(client->getBlockCount() == 100);
+        height = 101;
+        REQUIRE(client->getBlockCount() == 100);
+        cache->onNewBlock(100);
+        REQUIRE(client->getBlockCount() == 101);
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("Results with confirmation counts are not immutable") {
+        client->sendRequest("getrawtransaction", nlohmann::json::array({"0x01", true}));
+        cache->onNewBlock(100);
+        client->sendRequest("getrawtransaction", nlohmann::json::array({"0x01", true}));
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("Mempool transactions are fetched again after the next block") {
+        auto pending = client->sendRequest("getrawtransaction", nlohmann::json::array({"0x02", true}));
+        REQUIRE_FALSE(pending.contains("blockhash"));
+        height = 101;
+        cache->onNewBlock(100);
+        auto included = client->sendRequest("getrawtransaction", nlohmann::json::array({"0x02", true}));
+        REQUIRE(included.contains("blockhash"));
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("Raw transaction bytes are immutable") {
+        REQUIRE(client->sendRequest("getrawtransaction", nlohmann::json::array({"0x02", false})) == "AAEC");
+        cache->onNewBlock(100);
+        REQUIRE(client->sendRequest("getrawtransaction", nlohmann::json::array({"0x02", false})) == "AAEC");
+        REQUIRE(server.getRequestCount() == 1);
+    }
+
+    SECTION("Writes are never cached") {
+        client->sendRequest("sendrawtransaction", nlohmann::json::array({"tx"}));
+        client->sendRequest("sendrawtransaction", nlohmann::json::array({"tx"}));
+        REQUIRE(server.getRequestCount() == 2);
+    }
+
+    SECTION("BlockPolling invalidates the cache") {
+        auto pollingClient = std::make_shared<NeoRpcClient>(server.getUrl());
+        BlockPolling polling(pollingClient, std::chrono::milliseconds(10));
+        RpcResponseCache::invalidateOn(cache, polling);
+        polling.start();
+
+        REQUIRE(client->getBlockCount() == 100);
+        height = 101;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (client->getBlockCount() != 101 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        polling.stop();
+        REQUIRE(client->getBlockCount() == 101);
+    }
+}
+
+#endif
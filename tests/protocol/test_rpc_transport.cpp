@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/loopback_transport.hpp"
+#include "neocpp/protocol/replay_transport.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/protocol/neo_cpp.hpp"
+#include "neocpp/protocol/response_types_impl.hpp"
+#include "neocpp/exceptions.hpp"
+#include <sstream>
+#include <chrono>
+#include <iostream>
+
+using namespace neocpp;
+
+namespace {
+
+SharedPtr<LoopbackTransport> makeNode() {
+    auto node = std::make_shared<LoopbackTransport>();
+    node->setResult("getblockcount", 1234);
+    node->setResult("getversion", {{"tcpport", 10333}, {"useragent", "/Neo:3.6.0/"}});
+    node->setHandler("getblockhash", [](const nlohmann::json& params) {
+        return "0x" + std::string(63, 'a') + std::to_string(params.at(0).get<int>() % 10);
+    });
+    node->setError("sendrawtransaction", -500, "Insufficient funds");
+    return node;
+}
+
+} // namespace
+
+TEST_CASE("LoopbackTransport", "[protocol][transport]") {
+
+    auto node = makeNode();
+    NeoRpcClient client(node);
+
+    SECTION("Canned results answer calls without a network") {
+        REQUIRE(client.getUrl() == LoopbackTransport::DEFAULT_URL);
+        REQUIRE(client.getHttpService() == nullptr);
+        REQUIRE(client.getBlockCount() == 1234);
+        REQUIRE(client.getVersionAsync().get()->getUserAgent() == "/Neo:3.6.0/");
+        REQUIRE(client.getBlockHash(7).toString() == std::string(63, 'a') + "7");
+        REQUIRE(node->getCallCount() == 3);
+        REQUIRE(client.getTransferStats().responseBytes == 0);
+    }
+
+    SECTION("Errors and unknown methods come back as JSON-RPC errors") {
+        REQUIRE_THROWS_AS(client.sendRequest("sendrawtransaction"), RpcException);
+        REQUIRE_THROWS_AS(client.sendRequestAsync("nosuchmethod").get(), RpcException);
+
+        auto response = node->postJson("not json");
+        REQUIRE(response.isSuccess());
+        REQUIRE(nlohmann::json::parse(response.body)["error"]["code"] == -32700);
+    }
+
+    SECTION("Batch calls are answered one by one") {
+        auto results = client.sendBatch({{"getblockcount", nlohmann::json::array()},
+                                         {"nosuchmethod", nlohmann::json::array()},
+                                         {"getblockhash", nlohmann::json::array({3})}});
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0]->getResult() == 1234);
+        REQUIRE(results[1]->getError()->code == -32601);
+        REQUIRE(results[2]->isSuccess());
+    }
+
+    SECTION("Policies and batching run over any transport") {
+        client.setPolicy(std::make_shared<RpcPolicy>());
+        client.enableBatching();
+        std::vector<std::future<uint32_t>> counts;
+        for (int i = 0; i < 20; ++i) {
+            counts.push_back(client.getBlockCountAsync());
+        }
+        for (auto& count : counts) {
+            REQUIRE(count.get() == 1234);
+        }
+    }
+
+    SECTION("NeoCpp accepts a transport") {
+        auto neo = NeoCpp::build(node);
+        REQUIRE(neo->getBlockCount() == 1234);
+        REQUIRE(neo->getRpcClient()->getTransport() == node);
+        REQUIRE_THROWS_AS(NeoCpp::build(SharedPtr<RpcTransport>()), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("Recording and replaying RPC traffic", "[protocol][transport][replay]") {
+
+    auto node = makeNode();
+    auto recorder = std::make_shared<RecordingTransport>(node);
+    NeoRpcClient client(recorder);
+    client.setDeduplication(false);
+
+    client.getBlockCount();
+    node->setResult("getblockcount", 1235);
+    client.getBlockCount();
+    client.getBlockHash(1);
+    client.sendBatch({{"getversion", nlohmann::json::array()}, {"getblockhash", nlohmann::json::array({2})}});
+    REQUIRE(recorder->getExchanges().size() == 5);
+
+    std::stringstream recording;
+    recorder->save(recording);
+    auto replay = ReplayTransport::load(recording);
+    NeoRpcClient replayed(replay);
+    replayed.setDeduplication(false);
+
+    SECTION("Replies are replayed in recording order") {
+        REQUIRE(replayed.getBlockCount() == 1234);
+        REQUIRE(replayed.getBlockCount() == 1235);
+        REQUIRE(replayed.getBlockCount() == 1235);
+        REQUIRE(replayed.getBlockHash(2).toString() == std::string(63, 'a') + "2");
+        REQUIRE(replayed.getVersionAsync().get()->getTcpPort() == 10333);
+        REQUIRE(replay->getMissCount() == 0);
+    }
+
+    SECTION("Calls that were not recorded fail") {
+        REQUIRE_THROWS_AS(replayed.getBlockHash(9), RpcException);
+        REQUIRE(replay->getMissCount() == 1);
+    }
+
+    SECTION("Malformed recordings are rejected") {
+        std::istringstream broken("{\"request\": {}}\n");
+        REQUIRE_THROWS_AS(ReplayTransport::load(broken), IllegalArgumentException);
+        REQUIRE_THROWS_AS(ReplayTransport::load(std::string("/nonexistent/recording.jsonl")), IllegalArgumentException);
+    }
+}
+
+// Hidden benchmark of the SDK's own cost per call, run with: neocpp_tests "[benchmark]"
+TEST_CASE("NeoRpcClient overhead without a network", "[.][benchmark][transport]") {
+
+    auto node = makeNode();
+    NeoRpcClient client(node);
+    client.setDeduplication(false);
+
+    auto measure = [](const char* name, int calls, const std::function<void()>& call) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            call();
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << elapsed / calls << "us per call" << std::endl;
+    };
+
+    measure("getblockcount", 20000, [&]() { client.getBlockCount(); });
+    measure("getversion", 20000, [&]() { client.getVersion(); });
+    measure("getblockcount async", 20000, [&]() { client.getBlockCountAsync().get(); });
+
+    std::vector<std::pair<std::string, nlohmann::json>> batch;
+    for (int i = 0; i < 100; ++i) {
+        batch.emplace_back("getblockhash", nlohmann::json::array({i}));
+    }
+    measure("batch of 100 getblockhash", 500, [&]() { client.sendBatch(batch); });
+}
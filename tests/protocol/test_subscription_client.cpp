@@ -0,0 +1,343 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/subscription_client.hpp"
+#include "neocpp/protocol/websocket_connection.hpp"
+#include "neocpp/protocol/loopback_transport.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/exceptions.hpp"
+#include "../mock/local_websocket_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace neocpp;
+using neocpp::test::LocalWebSocketServer;
+
+namespace {
+
+// Wait until a condition holds or a few seconds have passed
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+SubscriptionConfig fastConfig() {
+    SubscriptionConfig config;
+    config.reconnectDelay = std::chrono::milliseconds(10);
+    config.maxReconnectDelay = std::chrono::milliseconds(50);
+    config.connectTimeout = std::chrono::milliseconds(1000);
+    config.fallbackPollInterval = std::chrono::milliseconds(10);
+    return config;
+}
+
+// Collects event payloads from the client's thread
+struct Received {
+    std::mutex mutex;
+    std::vector<nlohmann::json> events;
+
+    SubscriptionClient::EventHandler handler() {
+        return [this](const nlohmann::json& payload) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(payload);
+        };
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size();
+    }
+
+    nlohmann::json at(size_t index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.at(index);
+    }
+};
+
+// A node serving blocks 0..height over plain JSON-RPC
+SharedPtr<LoopbackTransport> makeChain(std::atomic<uint32_t>& height) {
+    auto node = std::make_shared<LoopbackTransport>();
+    node->setHandler("getblockcount", [&height](const nlohmann::json&) -> nlohmann::json {
+        return height + 1;
+    });
+    node->setHandler("getblock", [](const nlohmann::json& params) -> nlohmann::json {
+        uint32_t index = params.at(0).get<uint32_t>();
+        return {{"index", index}, {"primary", 0},
+                {"tx", nlohmann::json::array({{{"hash", "0x" + std::string(63, '0') + std::to_string(index % 10)}}})}};
+    });
+    node->setHandler("getapplicationlog", [](const nlohmann::json& params) -> nlohmann::json {
+        return {{"txid", params.at(0)},
+                {"executions", nlohmann::json::array({
+                    {{"trigger", "Application"}, {"vmstate", "HALT"},
+                     {"notifications", nlohmann::json::array({
+                         {{"contract", "0xd2a4cff31913016155e38e474a2c06d08be276cf"}, {"eventname", "Transfer"}}})}}})}};
+    });
+    return node;
+}
+
+} // namespace
+
+TEST_CASE("WebSocketConnection", "[protocol][subscription]") {
+
+    SECTION("Rejects non-WebSocket URLs") {
+        WebSocketConnection connection;
+        REQUIRE_THROWS_AS(connection.connect("http://127.0.0.1:1/ws", std::chrono::milliseconds(100)),
+                          IllegalArgumentException);
+    }
+
+    SECTION("A refused upgrade is reported as unsupported") {
+        LocalWebSocketServer server(LocalWebSocketServer::Mode::RejectUpgrade);
+        WebSocketConnection connection;
+        REQUIRE_THROWS_AS(connection.connect(server.getUrl(), std::chrono::milliseconds(1000)),
+                          UnsupportedOperationException);
+        REQUIRE_FALSE(connection.isOpen());
+    }
+
+    SECTION("An unavailable server is a connection failure") {
+        LocalWebSocketServer server(LocalWebSocketServer::Mode::Unavailable);
+        WebSocketConnection connection;
+        REQUIRE_THROWS_AS(connection.connect(server.getUrl(), std::chrono::milliseconds(1000)),
+                          NetworkException);
+        REQUIRE_FALSE(connection.isOpen());
+    }
+
+    SECTION("Exchanges text messages and answers within the timeout") {
+        LocalWebSocketServer server;
+        WebSocketConnection connection;
+        connection.connect(server.getUrl(), std::chrono::milliseconds(1000));
+        REQUIRE(connection.isOpen());
+
+        // Large enough for a 64-bit frame length in both directions
+        std::string filler(70000, 'x');
+        connection.sendText(nlohmann::json({{"jsonrpc", "2.0"}, {"method", "unsubscribe"},
+                                            {"params", nlohmann::json::array({filler})}, {"id", 9}}).dump());
+        connection.ping();
+        std::string message;
+        REQUIRE(connection.receive(message, std::chrono::milliseconds(1000)) == WebSocketConnection::ReadResult::Message);
+        REQUIRE(nlohmann::json::parse(message)["id"] == 9);
+        REQUIRE(connection.receive(message, std::chrono::milliseconds(20)) == WebSocketConnection::ReadResult::Timeout);
+
+        server.push("block_added", {{"index", 1}, {"filler", filler}});
+        REQUIRE(connection.receive(message, std::chrono::milliseconds(1000)) == WebSocketConnection::ReadResult::Message);
+        REQUIRE(nlohmann::json::parse(message)["params"][0]["filler"].get<std::string>().size() == filler.size());
+
+        server.dropConnections();
+        REQUIRE(connection.receive(message, std::chrono::milliseconds(1000)) == WebSocketConnection::ReadResult::Closed);
+        REQUIRE_FALSE(connection.isOpen());
+        REQUIRE_THROWS_AS(connection.sendText("{}"), NetworkException);
+    }
+}
+
+TEST_CASE("SubscriptionClient", "[protocol][subscription]") {
+
+    SECTION("Delivers pushed events to matching subscriptions") {
+        LocalWebSocketServer server;
+        SubscriptionClient client(server.getUrl(), nullptr, fastConfig());
+        Received blocks, transfers, executions;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.subscribe(SubscriptionEvent::NotificationFromExecution, transfers.handler(), {{"name", "Transfer"}});
+        client.start();
+        REQUIRE(waitFor([&]() { return server.getActiveSubscriptionCount() == 2; }));
+        REQUIRE(client.isConnected());
+        REQUIRE_FALSE(client.isPolling());
+
+        // Subscriptions added while connected are sent right away
+        client.subscribe(SubscriptionEvent::TransactionExecuted, executions.handler(), {{"state", "FAULT"}});
+        REQUIRE(waitFor([&]() { return server.getActiveSubscriptionCount() == 3; }));
+
+        server.push("block_added", {{"index", 5}, {"primary", 1}});
+        server.push("notification_from_execution", {{"contract", "0x01"}, {"eventname", "Mint"}});
+        server.push("notification_from_execution", {{"contract", "0x01"}, {"eventname", "Transfer"}});
+        server.push("transaction_executed", {{"container", "0xab"}, {"vmstate", "HALT"}});
+        server.push("transaction_executed", {{"container", "0xcd"}, {"vmstate", "FAULT"}});
+        REQUIRE(waitFor([&]() { return blocks.size() == 1 && transfers.size() == 1 && executions.size() == 1; }));
+        REQUIRE(blocks.at(0)["index"] == 5);
+        REQUIRE(transfers.at(0)["eventname"] == "Transfer");
+        REQUIRE(executions.at(0)["container"] == "0xcd");
+        client.stop();
+        REQUIRE_FALSE(client.isRunning());
+    }
+
+    SECTION("Unsubscribe cancels the subscription on the node") {
+        LocalWebSocketServer server;
+        SubscriptionClient client(server.getUrl(), nullptr, fastConfig());
+        Received blocks;
+        auto id = client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.start();
+        REQUIRE(waitFor([&]() { return server.getActiveSubscriptionCount() == 1; }));
+
+        client.unsubscribe(id);
+        REQUIRE(waitFor([&]() { return server.getActiveSubscriptionCount() == 0; }));
+        server.push("block_added", {{"index", 1}});
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(blocks.size() == 0);
+    }
+
+    SECTION("Subscribes again after the connection is lost") {
+        LocalWebSocketServer server;
+        SubscriptionClient client(server.getUrl(), nullptr, fastConfig());
+        std::atomic<int> errors{0};
+        client.setErrorHandler([&errors](const std::exception&) { errors++; });
+        Received blocks;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.subscribe(SubscriptionEvent::TransactionAdded, [](const nlohmann::json&) {});
+        client.start();
+        REQUIRE(waitFor([&]() { return server.getActiveSubscriptionCount() == 2; }));
+
+        for (int i = 1; i <= 3; ++i) {
+            server.dropConnections();
+            REQUIRE(waitFor([&]() { return server.getConnectionCount() == i + 1 &&
+                                           server.getActiveSubscriptionCount() == 2; }));
+        }
+        REQUIRE(client.getReconnectCount() == 3);
+        REQUIRE(server.getSubscribeCount() == 8);
+        REQUIRE(errors >= 3);
+
+        server.push("block_added", {{"index", 42}});
+        REQUIRE(waitFor([&]() { return blocks.size() == 1; }));
+        REQUIRE(blocks.at(0)["index"] == 42);
+    }
+
+    SECTION("Falls back to polling when the node refuses the upgrade") {
+        LocalWebSocketServer server(LocalWebSocketServer::Mode::RejectUpgrade);
+        std::atomic<uint32_t> height{10};
+        auto rpcClient = std::make_shared<NeoRpcClient>(makeChain(height));
+        SubscriptionClient client(server.getUrl(), rpcClient, fastConfig());
+        Received blocks, transfers, executions;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler(), {{"since", 11}});
+        client.subscribe(SubscriptionEvent::NotificationFromExecution, transfers.handler(), {{"name", "Transfer"}});
+        client.subscribe(SubscriptionEvent::TransactionExecuted, executions.handler());
+        client.start();
+        REQUIRE(waitFor([&]() { return client.isPolling(); }));
+        REQUIRE_FALSE(client.isConnected());
+
+        // The first poll reports the current block, filtered out by "since"
+        REQUIRE(waitFor([&]() { return transfers.size() == 1; }));
+        REQUIRE(blocks.size() == 0);
+
+        height = 12;
+        REQUIRE(waitFor([&]() { return blocks.size() == 2 && executions.size() == 3; }));
+        REQUIRE(blocks.at(0)["index"] == 11);
+        REQUIRE(blocks.at(1)["index"] == 12);
+        REQUIRE(executions.at(2)["vmstate"] == "HALT");
+        REQUIRE(executions.at(2)["container"] == "0x" + std::string(63, '0') + "2");
+        REQUIRE(transfers.at(2)["container"] == executions.at(2)["container"]);
+        client.stop();
+        REQUIRE_FALSE(client.isPolling());
+    }
+
+    SECTION("Keeps retrying the upgrade while the server is unavailable") {
+        LocalWebSocketServer server(LocalWebSocketServer::Mode::Unavailable);
+        std::atomic<uint32_t> height{3};
+        auto rpcClient = std::make_shared<NeoRpcClient>(makeChain(height));
+        SubscriptionClient client(server.getUrl(), rpcClient, fastConfig());
+        Received blocks;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.start();
+        REQUIRE(waitFor([&]() { return blocks.size() == 1; }));
+        REQUIRE(client.isPolling());
+        // Polling bridges the outage; the upgrade is still attempted
+        int handshakes = server.getHandshakeCount();
+        REQUIRE(waitFor([&]() { return server.getHandshakeCount() > handshakes + 1; }));
+        client.stop();
+    }
+
+    SECTION("Falls back to polling when the node does not know subscribe") {
+        LocalWebSocketServer server(LocalWebSocketServer::Mode::NoSubscribe);
+        std::atomic<uint32_t> height{3};
+        auto rpcClient = std::make_shared<NeoRpcClient>(makeChain(height));
+        SubscriptionClient client(server.getUrl(), rpcClient, fastConfig());
+        Received blocks;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.start();
+        REQUIRE(waitFor([&]() { return blocks.size() == 1; }));
+        REQUIRE(client.isPolling());
+        REQUIRE(blocks.at(0)["index"] == 3);
+        REQUIRE(server.getConnectionCount() == 1);
+    }
+
+    SECTION("Polls while the node is unreachable and pushes again once it is back") {
+        // Reserve a port, then close the server so that connecting fails
+        auto server = std::make_unique<LocalWebSocketServer>();
+        std::string url = server->getUrl();
+        server->stop();
+
+        std::atomic<uint32_t> height{7};
+        auto rpcClient = std::make_shared<NeoRpcClient>(makeChain(height));
+        auto config = fastConfig();
+        config.fallbackAfterFailures = 2;
+        SubscriptionClient client(url, rpcClient, config);
+        Received blocks;
+        client.subscribe(SubscriptionEvent::BlockAdded, blocks.handler());
+        client.start();
+        REQUIRE(waitFor([&]() { return client.isPolling() && blocks.size() == 1; }));
+        client.stop();
+    }
+
+    SECTION("Rejects invalid arguments") {
+        REQUIRE_THROWS_AS(SubscriptionClient("http://localhost:10332", nullptr), IllegalArgumentException);
+        SubscriptionClient client("ws://localhost:10332/ws", nullptr);
+        REQUIRE_THROWS_AS(client.subscribe(SubscriptionEvent::BlockAdded, nullptr), IllegalArgumentException);
+    }
+}
+
+TEST_CASE("SubscriptionClient filters", "[protocol][subscription]") {
+
+    SECTION("Blocks by primary and index range") {
+        nlohmann::json block = {{"index", 10}, {"primary", 2}};
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, nullptr, block));
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"primary", 2}}, block));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"primary", 1}}, block));
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"since", 10}, {"till", 10}}, block));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"since", 11}}, block));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"till", 9}}, block));
+    }
+
+    SECTION("Transactions by sender and signer") {
+        nlohmann::json tx = {{"signers", nlohmann::json::array({{{"account", "0xAA"}}, {{"account", "0xbb"}}})}};
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"sender", "aa"}}, tx));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"sender", "0xbb"}}, tx));
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"signer", "0xBB"}}, tx));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"signer", "0xcc"}}, tx));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"sender", "0xaa"}}, nlohmann::json()));
+    }
+
+    SECTION("Notifications and executions") {
+        nlohmann::json notification = {{"contract", "0xd2a4cff31913016155e38e474a2c06d08be276cf"}, {"eventname", "Transfer"}};
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::NotificationFromExecution,
+                                            {{"contract", "d2a4cff31913016155e38e474a2c06d08be276cf"}, {"name", "Transfer"}},
+                                            notification));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::NotificationFromExecution, {{"name", "Mint"}}, notification));
+
+        nlohmann::json execution = {{"container", "0x12"}, {"vmstate", "HALT"}};
+        REQUIRE(SubscriptionClient::matches(SubscriptionEvent::TransactionExecuted, {{"state", "HALT"}, {"container", "0x12"}}, execution));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionExecuted, {{"state", "FAULT"}}, execution));
+    }
+
+    SECTION("Fields of unexpected types do not match") {
+        nlohmann::json block = {{"index", "10"}, {"primary", "2"}};
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"primary", 2}}, block));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"since", 1}}, block));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::BlockAdded, {{"till", -1}}, {{"index", 1}}));
+
+        nlohmann::json tx = {{"signers", nlohmann::json::array({"0xaa", 5})}};
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"sender", "0xaa"}}, tx));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"signer", "0xaa"}}, tx));
+        REQUIRE_FALSE(SubscriptionClient::matches(SubscriptionEvent::TransactionAdded, {{"sender", "0xaa"}}, {{"signers", "0xaa"}}));
+    }
+
+    SECTION("Event names follow the node's API") {
+        REQUIRE(std::string(SubscriptionClient::eventName(SubscriptionEvent::BlockAdded)) == "block_added");
+        REQUIRE(std::string(SubscriptionClient::eventName(SubscriptionEvent::TransactionAdded)) == "transaction_added");
+        REQUIRE(std::string(SubscriptionClient::eventName(SubscriptionEvent::NotificationFromExecution)) ==
+                "notification_from_execution");
+        REQUIRE(std::string(SubscriptionClient::eventName(SubscriptionEvent::TransactionExecuted)) == "transaction_executed");
+    }
+}
@@ -0,0 +1,377 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/protocol/transaction_broadcaster.hpp"
+#include "neocpp/protocol/core/polling/block_polling.hpp"
+#include "neocpp/protocol/loopback_transport.hpp"
+#include "neocpp/protocol/neo_rpc_client.hpp"
+#include "neocpp/transaction/transaction.hpp"
+#include "neocpp/serialization/binary_writer.hpp"
+#include "neocpp/utils/base64.hpp"
+#include "neocpp/utils/hex.hpp"
+#include "neocpp/exceptions.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace neocpp;
+
+namespace {
+
+// A network of nodes sharing one mempool and one chain, starting at height 100
+struct Network {
+    std::mutex mutex;
+    uint32_t height = 100;
+    std::set<std::string> mempool;
+    std::set<std::string> mined;
+    std::map<uint32_t, std::vector<std::string>> blocks;
+    std::map<std::string, std::string> hashOf;   // Sent payload -> transaction hash
+    std::atomic<int> sends{0};
+
+    // Produce a block with the mempool, or with at most limit of its transactions
+    void mine(size_t limit = SIZE_MAX) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto end = std::next(mempool.begin(), static_cast<std::ptrdiff_t>(std::min(limit, mempool.size())));
+        blocks[height] = std::vector<std::string>(mempool.begin(), end);
+        mined.insert(mempool.begin(), end);
+        mempool.erase(mempool.begin(), end);
+        height++;
+    }
+
+    // A node; one that rejects answers every transaction with an error, one that
+    // drops accepts transactions without relaying them
+    SharedPtr<NeoRpcClient> node(const std::string& url, bool rejects = false, bool drops = false) {
+        auto transport = std::make_shared<LoopbackTransport>(url);
+        transport->setHandler("getblockcount", [this](const nlohmann::json&) -> nlohmann::json {
+            std::lock_guard<std::mutex> lock(mutex);
+            return height;
+        });
+        transport->setHandler("getblock", [this](const nlohmann::json& params) -> nlohmann::json {
+            uint32_t index = params.at(0).get<uint32_t>();
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = blocks.find(index);
+            if (it == blocks.end()) {
+                throw RpcException("Unknown block");
+            }
+            nlohmann::json txs = nlohmann::json::array();
+            for (const auto& hash : it->second) {
+                txs.push_back({{"hash", "0x" + hash}});
+            }
+            return {{"index", index}, {"time", 0}, {"tx", txs}};
+        });
+        transport->setHandler("sendrawtransaction", [this, rejects, drops](const nlohmann::json& params) -> nlohmann::json {
+            sends++;
+            if (rejects) {
+                throw RpcException("Insufficient funds");
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string payload = params.at(0).get<std::string>();
+            std::string hash = hashOf.count(payload) ? hashOf[payload] : payload;
+            if (mempool.count(hash) || mined.count(hash)) {
+                throw RpcException("Transaction already in pool");
+            }
+            if (!drops) {
+                mempool.insert(hash);
+            }
+            return {{"hash", "0x" + hash}};
+        });
+        transport->setHandler("getapplicationlog", [this](const nlohmann::json& params) -> nlohmann::json {
+            std::string hash = params.at(0).get<std::string>();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!mined.count(hash)) {
+                throw RpcException("Unknown transaction");
+            }
+            return {{"txid", "0x" + hash}, {"executions", nlohmann::json::array()}};
+        });
+        return std::make_shared<NeoRpcClient>(transport);
+    }
+};
+
+// A transaction hash made from a number
+std::string txHash(int n) {
+    std::string digits = std::to_string(n);
+    return std::string(64 - digits.size(), '0') + digits;
+}
+
+template <typename T>
+bool ready(std::future<T>& future, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    return future.wait_for(timeout) == std::future_status::ready;
+}
+
+SharedPtr<BlockPolling> startWatcher(const SharedPtr<NeoRpcClient>& node) {
+    auto watcher = std::make_shared<BlockPolling>(node, std::chrono::milliseconds(5));
+    watcher->setStartHeight(100);
+    watcher->start();
+    return watcher;
+}
+
+} // namespace
+
+TEST_CASE("TransactionBroadcaster Tests", "[protocol][broadcast]") {
+
+    Network network;
+
+    SECTION("Sends to every node and resolves when a block includes the transaction") {
+        auto a = network.node("http://a");
+        auto watcher = startWatcher(a);
+        TransactionBroadcaster broadcaster({a, network.node("http://b"), network.node("http://c")}, watcher);
+        REQUIRE(broadcaster.getNodeCount() == 3);
+
+        auto future = broadcaster.broadcast(txHash(1), Hash256(txHash(1)), 200);
+        REQUIRE(network.sends == 3);
+        REQUIRE(broadcaster.getPendingCount() == 1);
+
+        network.mine();
+        REQUIRE(ready(future));
+        auto result = future.get();
+        REQUIRE(result.status == BroadcastStatus::Included);
+        REQUIRE(result.blockIndex == 100);
+        REQUIRE(result.hash == Hash256(txHash(1)));
+        // The first node took it; the others already had it from the shared mempool
+        REQUIRE(result.accepted == 1);
+        REQUIRE(result.alreadyKnown == 2);
+        REQUIRE(result.rejections.empty());
+        REQUIRE(broadcaster.getPendingCount() == 0);
+    }
+
+    SECTION("Expires after validUntilBlock, sending again while waiting") {
+        auto a = network.node("http://a", false, true);
+        auto watcher = startWatcher(a);
+        BroadcastConfig config;
+        config.rebroadcastAfterBlocks = 1;
+        TransactionBroadcaster broadcaster({a, network.node("http://b", false, true)}, watcher, config);
+
+        auto future = broadcaster.broadcast(txHash(2), Hash256(txHash(2)), 102);
+        network.mine();
+        network.mine();
+        REQUIRE_FALSE(ready(future, std::chrono::milliseconds(100)));
+        network.mine();
+        REQUIRE(ready(future));
+        auto result = future.get();
+        REQUIRE(result.status == BroadcastStatus::Expired);
+        REQUIRE(result.blockIndex == 102);
+        REQUIRE(result.accepted == 2);
+        REQUIRE(result.rebroadcasts == 2);
+        REQUIRE(network.sends == 6);
+    }
+
+    SECTION("Fails when no node accepts the transaction") {
+        auto a = network.node("http://a", true);
+        auto watcher = startWatcher(a);
+        TransactionBroadcaster broadcaster({a, network.node("http://b", true)}, watcher);
+
+        auto future = broadcaster.broadcast(txHash(3), Hash256(txHash(3)), 200);
+        REQUIRE(ready(future));
+        REQUIRE_THROWS_AS(future.get(), RpcException);
+        REQUIRE(broadcaster.getPendingCount() == 0);
+    }
+
+    SECTION("Tracks a transaction some nodes refused, reporting why") {
+        auto a = network.node("http://a", true);
+        auto watcher = startWatcher(a);
+        TransactionBroadcaster broadcaster({a, network.node("http://b")}, watcher);
+
+        auto future = broadcaster.broadcast(txHash(4), Hash256(txHash(4)), 200);
+        network.mine();
+        REQUIRE(ready(future));
+        auto result = future.get();
+        REQUIRE(result.status == BroadcastStatus::Included);
+        REQUIRE(result.accepted == 1);
+        REQUIRE(result.rejections.size() == 1);
+        REQUIRE(result.rejections[0].find("http://a") == 0);
+        REQUIRE(result.rejections[0].find("Insufficient funds") != std::string::npos);
+    }
+
+    SECTION("Requires the configured number of accepting nodes") {
+        auto a = network.node("http://a", true);
+        auto watcher = startWatcher(a);
+        BroadcastConfig config;
+        config.minAccepted = 2;
+        TransactionBroadcaster broadcaster({a, network.node("http://b")}, watcher, config);
+
+        auto future = broadcaster.broadcast(txHash(5), Hash256(txHash(5)), 200);
+        REQUIRE(ready(future));
+        REQUIRE_THROWS_AS(future.get(), RpcException);
+    }
+
+    SECTION("Broadcasting a pending transaction again shares its outcome") {
+        auto a = network.node("http://a");
+        auto watcher = startWatcher(a);
+        TransactionBroadcaster broadcaster({a, network.node("http://b")}, watcher);
+
+        auto first = broadcaster.broadcast(txHash(6), Hash256(txHash(6)), 200);
+        auto second = broadcaster.broadcast(txHash(6), Hash256(txHash(6)), 200);
+        REQUIRE(network.sends == 2);
+        REQUIRE(broadcaster.getPendingCount() == 1);
+        network.mine();
+        REQUIRE(ready(first));
+        REQUIRE(ready(second));
+        REQUIRE(first.get().blockIndex == 100);
+        REQUIRE(second.get().blockIndex == 100);
+    }
+
+    SECTION("Many transactions resolve from the same blocks") {
+        auto a = network.node("http://a");
+        auto watcher = startWatcher(a);
+        TransactionBroadcaster broadcaster({a, network.node("http://b")}, watcher);
+
+        std::vector<std::future<BroadcastResult>> futures;
+        for (int i = 0; i < 500; ++i) {
+            futures.push_back(broadcaster.broadcast(txHash(1000 + i), Hash256(txHash(1000 + i)), 200));
+            if (i == 249) {
+                network.mine();
+            }
+        }
+        network.mine();
+        for (size_t i = 0; i < futures.size(); ++i) {
+            REQUIRE(ready(futures[i]));
+            REQUIRE(futures[i].get().blockIndex == (i < 250 ? 100u : 101u));
+        }
+    }
+
+    SECTION("Accepts transactions and blocks from other sources") {
+        auto a = network.node("http://a");
+        auto watcher = std::make_shared<BlockPolling>(a);
+        TransactionBroadcaster broadcaster({a}, watcher);
+
+        auto tx = std::make_shared<Transaction>();
+        tx->setNonce(7);
+        tx->setValidUntilBlock(200);
+        BinaryWriter writer;
+        tx->serialize(writer);
+        // Nodes print the transaction ID with the digest bytes reversed
+        std::string txId = Hex::encode(tx->getHash().toLittleEndianArray());
+        REQUIRE(txId != tx->getHash().toString());
+        network.hashOf[Base64::encode(writer.toArray())] = txId;
+
+        auto future = broadcaster.broadcast(tx);
+        nlohmann::json block = {{"index", 100}, {"tx", nlohmann::json::array()}};
+        block["tx"].push_back({{"hash", "0x" + txId}});
+        broadcaster.onBlock(block);
+        REQUIRE(ready(future));
+        auto result = future.get();
+        REQUIRE(result.status == BroadcastStatus::Included);
+        REQUIRE(result.hash == Hash256::fromHexString(txId));
+        REQUIRE(network.mempool.count(txId) == 1);
+    }
+
+    SECTION("Pending transactions fail when the broadcaster goes away") {
+        auto a = network.node("http://a");
+        auto watcher = startWatcher(a);
+        std::future<BroadcastResult> future;
+        {
+            TransactionBroadcaster broadcaster({a}, watcher);
+            future = broadcaster.broadcast(txHash(8), Hash256(txHash(8)), 200);
+        }
+        REQUIRE(ready(future));
+        REQUIRE_THROWS_AS(future.get(), IllegalStateException);
+    }
+
+    SECTION("Watches blocks itself from the current height") {
+        network.mine();
+        BroadcastConfig config;
+        config.polling.expectedBlockInterval = std::chrono::milliseconds(50);
+        config.polling.minInterval = std::chrono::milliseconds(5);
+        config.polling.maxInterval = std::chrono::milliseconds(50);
+        TransactionBroadcaster broadcaster({network.node("http://a")}, config);
+        REQUIRE(broadcaster.getWatcher()->isRunning());
+        REQUIRE(broadcaster.getWatcher()->getNextHeight() == 101);
+
+        auto future = broadcaster.broadcast(txHash(9), Hash256(txHash(9)), 200);
+        network.mine();
+        REQUIRE(ready(future));
+        REQUIRE(future.get().blockIndex == 101);
+    }
+
+    SECTION("Rejects missing nodes and watchers") {
+        REQUIRE_THROWS_AS(TransactionBroadcaster(std::vector<SharedPtr<NeoRpcClient>>{}), IllegalArgumentException);
+        REQUIRE_THROWS_AS(TransactionBroadcaster({nullptr}), IllegalArgumentException);
+        REQUIRE_THROWS_AS(TransactionBroadcaster({network.node("http://a")}, nullptr), IllegalArgumentException);
+    }
+
+    SECTION("Rejects an unreachable number of accepting nodes") {
+        auto a = network.node("http://a");
+        auto watcher = startWatcher(a);
+        BroadcastConfig config;
+        config.minAccepted = 0;
+        REQUIRE_THROWS_AS(TransactionBroadcaster({a}, watcher, config), IllegalArgumentException);
+        REQUIRE_THROWS_AS(TransactionBroadcaster({a}, config), IllegalArgumentException);
+        config.minAccepted = 3;
+        REQUIRE_THROWS_AS(TransactionBroadcaster({a, network.node("http://b")}, watcher, config), IllegalArgumentException);
+        REQUIRE_THROWS_AS(TransactionBroadcaster({a, network.node("http://b")}, config), IllegalArgumentException);
+        config.minAccepted = 2;
+        REQUIRE_NOTHROW(TransactionBroadcaster({a, network.node("http://b")}, watcher, config));
+    }
+}
+
+TEST_CASE("TransactionBroadcaster inclusion tracking cost", "[.][benchmark]") {
+    // 2000 transactions in flight, included over 4 blocks
+    static constexpr int count = 2000;
+    static constexpr size_t perBlock = 500;
+
+    auto callsTo = [](const SharedPtr<NeoRpcClient>& node) {
+        return std::dynamic_pointer_cast<LoopbackTransport>(node->getTransport())->getCallCount();
+    };
+
+    // Baseline: after every block, ask for the application log of each pending transaction
+    Network baseline;
+    auto node = baseline.node("http://a");
+    std::set<std::string> pending;
+    for (int i = 0; i < count; ++i) {
+        node->sendRawTransaction(txHash(i));
+        pending.insert(txHash(i));
+    }
+    uint64_t before = callsTo(node);
+    auto started = std::chrono::steady_clock::now();
+    while (!pending.empty()) {
+        baseline.mine(perBlock);
+        std::vector<std::pair<std::string, std::future<nlohmann::json>>> logs;
+        for (const auto& hash : pending) {
+            logs.emplace_back(hash, node->sendRequestAsync("getapplicationlog", nlohmann::json::array({hash})));
+        }
+        for (auto& [hash, log] : logs) {
+            try {
+                log.get();
+                pending.erase(hash);
+            } catch (const RpcException&) {
+                // Not included yet
+            }
+        }
+    }
+    auto baselineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    uint64_t baselineCalls = callsTo(node) - before;
+
+    // Broadcaster: one getblock per block, matched against every pending transaction
+    Network network;
+    auto watched = network.node("http://a");
+    auto watcher = startWatcher(watched);
+    BroadcastConfig config;
+    config.rebroadcastAfterBlocks = 0;
+    TransactionBroadcaster broadcaster({watched}, watcher, config);
+    std::vector<std::future<BroadcastResult>> futures;
+    for (int i = 0; i < count; ++i) {
+        futures.push_back(broadcaster.broadcast(txHash(i), Hash256(txHash(i)), 1000));
+    }
+    before = callsTo(watched);
+    uint64_t pollsBefore = watcher->getPollCount();
+    started = std::chrono::steady_clock::now();
+    for (size_t mined = 0; mined < count; mined += perBlock) {
+        network.mine(perBlock);
+    }
+    for (auto& future : futures) {
+        REQUIRE(future.get().status == BroadcastStatus::Included);
+    }
+    auto watchedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    uint64_t watchedCalls = callsTo(watched) - before;
+    uint64_t polls = watcher->getPollCount() - pollsBefore;
+
+    std::cout << "Tracking " << count << " transactions over " << count / perBlock << " blocks" << std::endl;
+    std::cout << "  getapplicationlog per transaction: " << baselineCalls << " calls, "
+              << baselineMs << " ms" << std::endl;
+    std::cout << "  block stream:                      " << watchedCalls << " calls ("
+              << polls << " of them getblockcount polls), " << watchedMs << " ms" << std::endl;
+}
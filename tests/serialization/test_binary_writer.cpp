@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include "neocpp/serialization/binary_writer.hpp"
+#include "neocpp/crypto/hash.hpp"
 #include "neocpp/utils/hex.hpp"
 
 using namespace neocpp;
@@ -169,4 +170,32 @@ TEST_CASE("BinaryWriter Tests", "[serialization]") {
         REQUIRE(result[3] == 0x00);
         REQUIRE(result[4] == 0x00);
     }
-}
\ No newline at end of file
+    
+    SECTION("Hashing writer hashes what a buffering writer collects") {
+        Bytes large(3 * BinaryWriter::HASH_CHUNK_SIZE + 7, 0x5a);
+        auto write = [&](BinaryWriter& writer) {
+            writer.writeUInt32(12345);
+            writer.writeVarString("hashing");
+            for (int i = 0; i < 100; ++i) {
+                writer.writeUInt64(i);
+            }
+            writer.writeVarBytes(large);
+            writer.writeBytes(Bytes(BinaryWriter::HASH_CHUNK_SIZE - 1, 0x11));
+            writer.writeByte(0xff);
+        };
+        BinaryWriter buffering;
+        write(buffering);
+        
+        Sha256Hasher hasher;
+        {
+            BinaryWriter hashing(hasher);
+            write(hashing);
+            hashing.flush();
+            REQUIRE(hasher.finalize() == HashUtils::sha256(buffering.toArray()));
+            
+            // The destructor flushes as well
+            write(hashing);
+        }
+        REQUIRE(hasher.finalize() == HashUtils::sha256(buffering.toArray()));
+    }
+}
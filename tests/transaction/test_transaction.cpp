@@ -7,7 +7,11 @@
 #include "neocpp/script/script_builder.hpp"
 #include "neocpp/serialization/binary_writer.hpp"
 #include "neocpp/serialization/binary_reader.hpp"
+#include "neocpp/crypto/hash.hpp"
 #include "neocpp/utils/hex.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 
 using namespace neocpp;
 
@@ -107,6 +111,17 @@ TEST_CASE("Transaction Tests", "[transaction]") {
         REQUIRE(hash != hash3);
     }
     
+    SECTION("Transaction hash is the SHA256 of the unsigned serialization") {
+        Transaction tx;
+        tx.setNonce(12345678);
+        tx.setValidUntilBlock(1000000);
+        for (size_t scriptSize : {0, 10, 300, 70000}) {
+            tx.setScript(Bytes(scriptSize, 0x42));
+            Bytes hash = HashUtils::sha256(tx.getHashData());
+            REQUIRE(tx.getHash() == Hash256(hash));
+        }
+    }
+    
     SECTION("Serialize and deserialize transaction") {
         Transaction tx;
         tx.setVersion(0);
@@ -217,4 +232,25 @@ TEST_CASE("Transaction Tests", "[transaction]") {
         // Since TransactionAttribute is not fully implemented, we skip detailed testing
         REQUIRE(tx.getAttributes().empty());
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Transaction hash cost", "[.][benchmark]") {
+    std::cout << "us per hash: script size, buffered / streamed" << std::endl;
+    for (size_t scriptSize : {100, 10000, 1000000}) {
+        Transaction tx;
+        tx.setValidUntilBlock(1000000);
+        tx.setScript(Bytes(scriptSize, 0x42));
+        size_t calls = std::max<size_t>(10, (256u << 20) / scriptSize / 8);
+        auto perCall = [&](auto operation) {
+            auto started = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < calls; ++i) {
+                operation();
+            }
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count() / calls;
+        };
+        // What calculateHash did before: serialize into a buffer, copy it and hash the copy
+        double buffered = perCall([&]() { HashUtils::sha256(tx.getHashData()); });
+        double streamed = perCall([&]() { tx.calculateHash(); });
+        std::cout << "  " << scriptSize << " B: " << buffered << " / " << streamed << std::endl;
+    }
+}
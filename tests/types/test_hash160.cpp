@@ -2,10 +2,42 @@
 #include "neocpp/types/hash160.hpp"
 #include "neocpp/crypto/ec_key_pair.hpp"
 #include "neocpp/utils/hex.hpp"
+#include "neocpp/crypto/hash.hpp"
+#include "neocpp/script/script_builder.hpp"
+#include "neocpp/utils/address.hpp"
 #include "neocpp/exceptions.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
 
 using namespace neocpp;
 
+namespace {
+
+/// Number of operator new calls in this process, to check allocation-free paths
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
 TEST_CASE("Hash160 Tests", "[types]") {
     
     SECTION("Create Hash160 from bytes") {
@@ -58,6 +90,46 @@ TEST_CASE("Hash160 Tests", "[types]") {
         REQUIRE(hash == hash2);
     }
     
+    SECTION("Hash160 from public key without allocating matches the script builder") {
+        for (int i = 0; i < 5; i++) {
+            Bytes publicKey = ECKeyPair::generate().getPublicKey()->getEncoded();
+            
+            std::array<uint8_t, ScriptBuilder::SINGLE_SIG_VERIFICATION_SCRIPT_SIZE> script;
+            ScriptBuilder::buildVerificationScript(publicKey.data(), script);
+            Bytes expectedScript = ScriptBuilder::buildVerificationScript(publicKey);
+            REQUIRE(Bytes(script.begin(), script.end()) == expectedScript);
+            
+            REQUIRE(Hash160::fromPublicKey(publicKey) == Hash160::fromScript(expectedScript));
+            REQUIRE(Hash160::fromScript(script.data(), script.size()) == Hash160::fromScript(expectedScript));
+        }
+    }
+    
+    SECTION("Hash160 to address into a reused string") {
+        std::string address;
+        for (const char* hashHex : {"23ba2703c53263e8d6e522dc32203339dcd8eee9", "0000000000000000000000000000000000000000"}) {
+            Hash160 hash(std::string{hashHex});
+            hash.toAddress(address);
+            REQUIRE(address == hash.toAddress());
+            REQUIRE(address == AddressUtils::scriptHashToAddress(hash.toArray()));
+        }
+    }
+    
+    SECTION("Address derivation does not allocate") {
+        std::vector<Bytes> publicKeys;
+        for (int i = 0; i < 10; i++) {
+            publicKeys.push_back(ECKeyPair::generate().getPublicKey()->getEncoded());
+        }
+        std::string address;
+        Hash160::fromPublicKey(publicKeys[0]).toAddress(address);
+        
+        size_t before = allocations.load();
+        for (const auto& publicKey : publicKeys) {
+            Hash160::fromPublicKey(publicKey).toAddress(address);
+        }
+        REQUIRE(allocations.load() == before);
+        REQUIRE(address == ECPublicKey(publicKeys.back()).getAddress());
+    }
+    
     SECTION("Hash160 to address") {
         const std::string hashHex = "23ba2703c53263e8d6e522dc32203339dcd8eee9";
         Hash160 hash(hashHex);
@@ -139,4 +211,40 @@ TEST_CASE("Hash160 Tests", "[types]") {
         Hash160 multiSigHash3 = Hash160::fromPublicKeys(publicKeys, 1);
         REQUIRE_FALSE(multiSigHash == multiSigHash3);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Address derivation cost", "[.][benchmark]") {
+    std::vector<Bytes> publicKeys;
+    for (int i = 0; i < 1000; i++) {
+        publicKeys.push_back(ECKeyPair::generate().getPublicKey()->getEncoded());
+    }
+    const size_t rounds = 200;
+    const size_t keys = rounds * publicKeys.size();
+    auto measure = [&](const char* name, auto derive) {
+        size_t before = allocations.load();
+        auto started = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (const auto& publicKey : publicKeys) {
+                derive(publicKey);
+            }
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+        std::cout << "  " << name << ": " << elapsed / keys << " ns, "
+                  << static_cast<double>(allocations.load() - before) / keys << " allocations" << std::endl;
+    };
+    
+    std::cout << "Per address:" << std::endl;
+    size_t characters = 0;
+    measure("Bytes and strings per key", [&](const Bytes& publicKey) {
+        Bytes script = ScriptBuilder::buildVerificationScript(publicKey);
+        Bytes hash = HashUtils::sha256ThenRipemd160(script);
+        std::reverse(hash.begin(), hash.end());
+        characters += AddressUtils::scriptHashToAddress(hash).size();
+    });
+    std::string address;
+    measure("in place", [&](const Bytes& publicKey) {
+        Hash160::fromPublicKey(publicKey).toAddress(address);
+        characters += address.size();
+    });
+    REQUIRE(characters == 2 * keys * address.size());
+}
@@ -0,0 +1,269 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/utils/bounded_queue.hpp"
+#include "neocpp/utils/event_dispatcher.hpp"
+#include "neocpp/exceptions.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace neocpp;
+
+namespace {
+
+// Collects the events of one subscriber
+struct Collector {
+    std::mutex mutex;
+    std::vector<int> events;
+
+    EventDispatcher<int>::Handler handler() {
+        return [this](const int& event) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(event);
+        };
+    }
+
+    std::vector<int> get() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+};
+
+// Handler that waits until released
+struct Gate {
+    std::atomic<bool> open{false};
+    std::atomic<int> entered{0};
+
+    void wait() {
+        entered++;
+        while (!open) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("BoundedQueue Tests", "[utils]") {
+
+    SECTION("Capacity is rounded up to a power of two") {
+        BoundedQueue<int> queue(5);
+        REQUIRE(queue.capacity() == 8);
+        REQUIRE(queue.empty());
+        REQUIRE_THROWS_AS(BoundedQueue<int>(0), IllegalArgumentException);
+    }
+
+    SECTION("First in, first out until full") {
+        BoundedQueue<int> queue(4);
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.tryPush(i));
+        }
+        int extra = 4;
+        REQUIRE_FALSE(queue.tryPush(extra));
+        REQUIRE(extra == 4);
+        REQUIRE(queue.size() == 4);
+
+        int value = -1;
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE_FALSE(queue.tryPop(value));
+    }
+
+    SECTION("Concurrent producers and consumers lose nothing") {
+        BoundedQueue<int> queue(64);
+        const int producers = 4;
+        const int perProducer = 20000;
+        std::atomic<long long> sum{0};
+        std::atomic<int> consumed{0};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, p]() {
+                for (int i = 1; i <= perProducer; ++i) {
+                    int value = p * perProducer + i;
+                    while (!queue.tryPush(value)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&]() {
+                int value;
+                while (consumed < producers * perProducer) {
+                    if (queue.tryPop(value)) {
+                        sum += value;
+                        consumed++;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        long long n = static_cast<long long>(producers) * perProducer;
+        REQUIRE(sum == n * (n + 1) / 2);
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("EventDispatcher Tests", "[utils]") {
+
+    auto pool = std::make_shared<ThreadPool>(2);
+    EventDispatcher<int> dispatcher(pool);
+
+    SECTION("Every subscriber sees every event in order") {
+        Collector a, b;
+        dispatcher.subscribe(a.handler());
+        dispatcher.subscribe(b.handler(), SubscriberOptions{8, OverflowPolicy::Block});
+        for (int i = 0; i < 1000; ++i) {
+            dispatcher.publish(i);
+        }
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        std::vector<int> expected;
+        for (int i = 0; i < 1000; ++i) {
+            expected.push_back(i);
+        }
+        REQUIRE(a.get() == expected);
+        REQUIRE(b.get() == expected);
+        REQUIRE(dispatcher.getSubscriberCount() == 2);
+    }
+
+    SECTION("A slow subscriber does not delay the others") {
+        Gate gate;
+        Collector fast;
+        auto slow = dispatcher.subscribe([&gate](const int&) { gate.wait(); }, SubscriberOptions{4, OverflowPolicy::DropOldest});
+        dispatcher.subscribe(fast.handler());
+        dispatcher.publish(0);
+        while (gate.entered == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (int i = 1; i < 100; ++i) {
+            dispatcher.publish(i);
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (fast.get().size() < 100 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(fast.get().size() == 100);
+        auto stats = dispatcher.getStats(slow);
+        REQUIRE(stats.queueDepth == 4);
+        REQUIRE(stats.dropped == 95);
+        gate.open = true;
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        REQUIRE(dispatcher.getStats(slow).delivered == 5);
+    }
+
+    SECTION("DropOldest keeps the newest events") {
+        Gate gate;
+        Collector seen;
+        dispatcher.subscribe([&](const int& event) {
+            if (event == 0) {
+                gate.wait();
+            }
+            seen.handler()(event);
+        }, SubscriberOptions{4, OverflowPolicy::DropOldest});
+        dispatcher.publish(0);
+        while (gate.entered == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (int i = 1; i <= 10; ++i) {
+            dispatcher.publish(i);
+        }
+        gate.open = true;
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        REQUIRE(seen.get() == std::vector<int>{0, 7, 8, 9, 10});
+    }
+
+    SECTION("Coalesce keeps the queued events and the newest overflow") {
+        Gate gate;
+        Collector seen;
+        auto id = dispatcher.subscribe([&](const int& event) {
+            if (event == 0) {
+                gate.wait();
+            }
+            seen.handler()(event);
+        }, SubscriberOptions{4, OverflowPolicy::Coalesce});
+        dispatcher.publish(0);
+        while (gate.entered == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (int i = 1; i <= 10; ++i) {
+            dispatcher.publish(i);
+        }
+        REQUIRE(dispatcher.getStats(id).queueDepth == 5);
+        REQUIRE(dispatcher.getStats(id).dropped == 5);
+        gate.open = true;
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        REQUIRE(seen.get() == std::vector<int>{0, 1, 2, 3, 4, 10});
+    }
+
+    SECTION("Block makes the publisher wait for room") {
+        Gate gate;
+        Collector seen;
+        dispatcher.subscribe([&](const int& event) {
+            gate.wait();
+            seen.handler()(event);
+        }, SubscriberOptions{2, OverflowPolicy::Block});
+        std::atomic<int> published{0};
+        std::thread publisher([&]() {
+            for (int i = 0; i < 10; ++i) {
+                dispatcher.publish(i);
+                published++;
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        // One event in the handler and two queued
+        REQUIRE(published == 3);
+        gate.open = true;
+        publisher.join();
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        REQUIRE(seen.get().size() == 10);
+    }
+
+    SECTION("Lag is measured per subscriber") {
+        auto id = dispatcher.subscribe([](const int&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        });
+        for (int i = 0; i < 5; ++i) {
+            dispatcher.publish(i);
+        }
+        REQUIRE(dispatcher.waitIdle(std::chrono::seconds(5)));
+        auto stats = dispatcher.getStats(id);
+        REQUIRE(stats.delivered == 5);
+        REQUIRE(stats.queueDepth == 0);
+        REQUIRE(stats.maxLagMicros >= 8000);
+        REQUIRE(stats.p99LagMicros >= 4000);
+        REQUIRE(stats.lastLagMicros == stats.maxLagMicros);
+    }
+
+    SECTION("Unsubscribing stops delivery, also from the handler itself") {
+        Collector seen;
+        uint64_t id = 0;
+        id = dispatcher.subscribe([&](const int& event) {
+            seen.handler()(event);
+            if (event == 2) {
+                dispatcher.unsubscribe(id);
+            }
+        });
+        for (int i = 0; i < 10; ++i) {
+            dispatcher.publish(i);
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (dispatcher.getSubscriberCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(dispatcher.getSubscriberCount() == 0);
+        REQUIRE(seen.get() == std::vector<int>{0, 1, 2});
+        REQUIRE_THROWS_AS(dispatcher.getStats(id), IllegalArgumentException);
+    }
+
+    SECTION("Rejects empty handlers") {
+        REQUIRE_THROWS_AS(dispatcher.subscribe(nullptr), IllegalArgumentException);
+        REQUIRE_THROWS_AS(EventDispatcher<int>(nullptr), IllegalArgumentException);
+    }
+}
@@ -0,0 +1,36 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/utils/gzip.hpp"
+#include "neocpp/exceptions.hpp"
+
+using namespace neocpp;
+
+TEST_CASE("Gzip Tests", "[utils][gzip]") {
+
+    if (!Gzip::isAvailable()) {
+        REQUIRE_THROWS_AS(Gzip::compress("data"), IllegalStateException);
+        return;
+    }
+
+    SECTION("Round trip") {
+        std::string data;
+        for (int i = 0; i < 1000; ++i) {
+            data += "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(i) + "}";
+        }
+        auto compressed = Gzip::compress(data);
+        REQUIRE(compressed.size() < data.size() / 4);
+        REQUIRE(static_cast<unsigned char>(compressed[0]) == 0x1f);
+        REQUIRE(static_cast<unsigned char>(compressed[1]) == 0x8b);
+        REQUIRE(Gzip::decompress(compressed) == data);
+    }
+
+    SECTION("Empty input") {
+        REQUIRE(Gzip::decompress(Gzip::compress("")).empty());
+    }
+
+    SECTION("Invalid data is rejected") {
+        REQUIRE_THROWS_AS(Gzip::decompress("not gzip"), IllegalArgumentException);
+        auto truncated = Gzip::compress(std::string(1000, 'a'));
+        truncated.resize(truncated.size() / 2);
+        REQUIRE_THROWS_AS(Gzip::decompress(truncated), IllegalArgumentException);
+    }
+}
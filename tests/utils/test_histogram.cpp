@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/utils/histogram.hpp"
+
+using namespace neocpp;
+
+TEST_CASE("Histogram Tests", "[utils]") {
+
+    SECTION("Empty histogram") {
+        Histogram histogram;
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMean() == 0.0);
+        REQUIRE(histogram.getPercentile(99) == 0);
+    }
+
+    SECTION("Counts, sum and max") {
+        Histogram histogram;
+        histogram.record(0);
+        histogram.record(1);
+        histogram.record(10);
+        histogram.record(100);
+
+        REQUIRE(histogram.getCount() == 4);
+        REQUIRE(histogram.getSum() == 111);
+        REQUIRE(histogram.getMax() == 100);
+        REQUIRE(histogram.getBucketCount(0) == 1);
+        REQUIRE(histogram.getBucketCount(1) == 1);
+        REQUIRE(histogram.getBucketCount(4) == 1);
+        REQUIRE(histogram.getBucketCount(7) == 1);
+    }
+
+    SECTION("Percentiles are bucket upper bounds") {
+        Histogram histogram;
+        for (uint64_t i = 1; i <= 100; ++i) {
+            histogram.record(i);
+        }
+        REQUIRE(histogram.getPercentile(50) == 63);
+        REQUIRE(histogram.getPercentile(100) == 100);
+    }
+
+    SECTION("Merge") {
+        Histogram first;
+        Histogram second;
+        first.record(3);
+        second.record(0);
+        second.record(40);
+        first.merge(second);
+        REQUIRE(first.getCount() == 3);
+        REQUIRE(first.getSum() == 43);
+        REQUIRE(first.getMax() == 40);
+        REQUIRE(first.getBucketCount(0) == 1);
+        REQUIRE(first.getBucketCount(2) == 1);
+        REQUIRE(first.getBucketCount(6) == 1);
+        REQUIRE(second.getCount() == 2);
+    }
+
+    SECTION("Reset") {
+        Histogram histogram;
+        histogram.record(5);
+        histogram.reset();
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMax() == 0);
+    }
+}
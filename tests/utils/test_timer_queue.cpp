@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+#include "neocpp/utils/timer_queue.hpp"
+#include <vector>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+
+using namespace neocpp;
+
+TEST_CASE("TimerQueue Tests", "[utils][timer]") {
+
+    TimerQueue timers;
+
+    SECTION("Timers fire in deadline order") {
+        std::mutex mutex;
+        std::vector<int> order;
+        std::promise<void> done;
+        timers.schedule(std::chrono::milliseconds(30), [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(2);
+            done.set_value();
+        });
+        timers.schedule(std::chrono::milliseconds(10), [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(1);
+        });
+        done.get_future().wait();
+        REQUIRE(order == std::vector<int>{1, 2});
+        REQUIRE(timers.getPending() == 0);
+    }
+
+    SECTION("Cancelled timers do not fire") {
+        std::atomic<bool> fired{false};
+        auto id = timers.schedule(std::chrono::milliseconds(20), [&]() { fired = true; });
+        REQUIRE(timers.cancel(id));
+        REQUIRE_FALSE(timers.cancel(id));
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        REQUIRE_FALSE(fired);
+    }
+
+    SECTION("Tasks are released outside the queue lock") {
+        // Releasing the captures schedules again, as a dropped last reference may
+        struct Rescheduler {
+            TimerQueue& timers;
+            explicit Rescheduler(TimerQueue& queue) : timers(queue) {}
+            ~Rescheduler() { timers.schedule(std::chrono::hours(1), []() {}); }
+        };
+        auto first = std::make_shared<Rescheduler>(timers);
+        auto id = timers.schedule(std::chrono::hours(1), [first]() {});
+        first.reset();
+        REQUIRE(timers.cancel(id));
+        REQUIRE(timers.getPending() == 1);
+
+        std::promise<void> ran;
+        auto second = std::make_shared<Rescheduler>(timers);
+        timers.schedule(std::chrono::milliseconds(1), [second, &ran]() { ran.set_value(); });
+        second.reset();
+        ran.get_future().wait();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (timers.getPending() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(timers.getPending() == 2);
+    }
+
+    SECTION("Many timers can be cancelled in any order") {
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < 1000; ++i) {
+            ids.push_back(timers.schedule(std::chrono::hours(1), []() {}));
+        }
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            REQUIRE(timers.cancel(ids[i]));
+        }
+        REQUIRE(timers.getPending() == 500);
+        for (size_t i = ids.size() - 1; i < ids.size(); i -= 2) {
+            REQUIRE(timers.cancel(ids[i]));
+            REQUIRE_FALSE(timers.cancel(ids[i - 1]));
+        }
+        REQUIRE(timers.getPending() == 0);
+    }
+}